@@ -0,0 +1,136 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract: Batch access to the toolpath layer reader for the Go binding.
+
+*/
+
+#include "lib3mf_toolpath_batch.h"
+
+#include <string.h>
+
+/**
+* Expands hatches that lib3mf has written in the packed layout of sLib3MFHatch2D to the layout of
+* sLib3MFBatchHatch2D in place. Element k is moved from offset sizeof(sLib3MFHatch2D) * k to offset
+* sizeof(sLib3MFBatchHatch2D) * k, which only overlaps elements k and above; going backwards, these are already moved.
+*/
+static void toolpathBatchExpandHatches(sLib3MFBatchHatch2D * pHatches, Lib3MF_uint64 nHatchCount)
+{
+	const char * pPacked = (const char *)pHatches;
+	Lib3MF_uint64 nIndex = nHatchCount;
+
+	while (nIndex > 0) {
+		sLib3MFHatch2D hatch;
+		nIndex--;
+		memcpy(&hatch, pPacked + nIndex * sizeof(sLib3MFHatch2D), sizeof(sLib3MFHatch2D));
+		pHatches[nIndex].m_Point1Coordinates[0] = hatch.m_Point1Coordinates[0];
+		pHatches[nIndex].m_Point1Coordinates[1] = hatch.m_Point1Coordinates[1];
+		pHatches[nIndex].m_Point2Coordinates[0] = hatch.m_Point2Coordinates[0];
+		pHatches[nIndex].m_Point2Coordinates[1] = hatch.m_Point2Coordinates[1];
+		pHatches[nIndex].m_Tag = hatch.m_Tag;
+	}
+}
+
+static Lib3MFResult toolpathBatchGetSegmentHatches(sLib3MFDynamicWrapperTable * pWrapperTable, Lib3MF_ToolpathLayerReader pToolpathLayerReader, int bDiscrete, Lib3MF_uint32 nSegmentIndex, Lib3MF_uint64 nHatchBufferSize, Lib3MF_uint64 * pHatchNeededCount, void * pHatchBuffer)
+{
+	if (bDiscrete)
+		return pWrapperTable->m_ToolpathLayerReader_GetSegmentHatchDataDiscrete(pToolpathLayerReader, nSegmentIndex, nHatchBufferSize, pHatchNeededCount, (sLib3MFDiscreteHatch2D *)pHatchBuffer);
+
+	return pWrapperTable->m_ToolpathLayerReader_GetSegmentHatchDataInModelUnits(pToolpathLayerReader, nSegmentIndex, nHatchBufferSize, pHatchNeededCount, (sLib3MFHatch2D *)pHatchBuffer);
+}
+
+static Lib3MFResult toolpathBatchGetLayerHatches(Lib3MFHandle libraryHandle, Lib3MF_ToolpathLayerReader pToolpathLayerReader, int bDiscrete, Lib3MF_uint32 nSegmentBufferSize, Lib3MF_uint32 * pSegmentNeededCount, Lib3MF_uint64 * pSegmentOffsets, Lib3MF_int32 * pSegmentTypes, Lib3MF_uint64 nHatchBufferSize, Lib3MF_uint64 * pHatchNeededCount, void * pHatchBuffer, size_t nHatchSize)
+{
+	sLib3MFDynamicWrapperTable * wrapperTable = (sLib3MFDynamicWrapperTable *) libraryHandle;
+	Lib3MF_uint32 nSegmentCount = 0;
+	Lib3MF_uint32 nSegmentIndex;
+	Lib3MF_uint64 nHatchCount = 0;
+	Lib3MFResult nResult;
+	int bFits;
+
+	if (libraryHandle == 0)
+		return LIB3MF_ERROR_INVALIDCAST;
+	if ((pSegmentNeededCount == NULL) || (pHatchNeededCount == NULL))
+		return LIB3MF_ERROR_INVALIDPARAM;
+
+	nResult = wrapperTable->m_ToolpathLayerReader_GetSegmentCount(pToolpathLayerReader, &nSegmentCount);
+	if (nResult != LIB3MF_SUCCESS)
+		return nResult;
+
+	bFits = (pSegmentOffsets != NULL) && (pSegmentTypes != NULL) && (pHatchBuffer != NULL) && (nSegmentBufferSize >= nSegmentCount);
+	for (nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+		Lib3MF_uint64 nSegmentHatchCount = 0;
+
+		if (bFits) {
+			eLib3MFToolpathSegmentType eType;
+			Lib3MF_uint32 nPointCount;
+			nResult = wrapperTable->m_ToolpathLayerReader_GetSegmentInfo(pToolpathLayerReader, nSegmentIndex, &eType, &nPointCount);
+			if (nResult != LIB3MF_SUCCESS)
+				return nResult;
+			pSegmentTypes[nSegmentIndex] = (Lib3MF_int32) eType;
+			pSegmentOffsets[nSegmentIndex] = nHatchCount;
+		}
+
+		nResult = toolpathBatchGetSegmentHatches(wrapperTable, pToolpathLayerReader, bDiscrete, nSegmentIndex, 0, &nSegmentHatchCount, NULL);
+		if (nResult != LIB3MF_SUCCESS)
+			return nResult;
+
+		if (bFits && (nSegmentHatchCount > 0)) {
+			if (nHatchBufferSize - nHatchCount >= nSegmentHatchCount) {
+				char * pTarget = (char *) pHatchBuffer + nHatchCount * nHatchSize;
+				nResult = toolpathBatchGetSegmentHatches(wrapperTable, pToolpathLayerReader, bDiscrete, nSegmentIndex, nSegmentHatchCount, NULL, pTarget);
+				if (nResult != LIB3MF_SUCCESS)
+					return nResult;
+				if (!bDiscrete)
+					toolpathBatchExpandHatches((sLib3MFBatchHatch2D *) pTarget, nSegmentHatchCount);
+			}
+			else {
+				bFits = 0;
+			}
+		}
+
+		nHatchCount += nSegmentHatchCount;
+	}
+
+	*pSegmentNeededCount = nSegmentCount;
+	*pHatchNeededCount = nHatchCount;
+
+	if (!bFits)
+		return ((pSegmentTypes == NULL) && (pHatchBuffer == NULL)) ? LIB3MF_SUCCESS : LIB3MF_ERROR_BUFFERTOOSMALL;
+
+	pSegmentOffsets[nSegmentCount] = nHatchCount;
+	return LIB3MF_SUCCESS;
+}
+
+Lib3MFResult CCall_toolpathbatch_getlayerhatchdatainmodelunits(Lib3MFHandle libraryHandle, Lib3MF_ToolpathLayerReader pToolpathLayerReader, const Lib3MF_uint32 nSegmentBufferSize, Lib3MF_uint32 * pSegmentNeededCount, Lib3MF_uint64 * pSegmentOffsets, Lib3MF_int32 * pSegmentTypes, const Lib3MF_uint64 nHatchBufferSize, Lib3MF_uint64 * pHatchNeededCount, sLib3MFBatchHatch2D * pHatchBuffer)
+{
+	return toolpathBatchGetLayerHatches(libraryHandle, pToolpathLayerReader, 0, nSegmentBufferSize, pSegmentNeededCount, pSegmentOffsets, pSegmentTypes, nHatchBufferSize, pHatchNeededCount, pHatchBuffer, sizeof(sLib3MFBatchHatch2D));
+}
+
+Lib3MFResult CCall_toolpathbatch_getlayerhatchdatadiscrete(Lib3MFHandle libraryHandle, Lib3MF_ToolpathLayerReader pToolpathLayerReader, const Lib3MF_uint32 nSegmentBufferSize, Lib3MF_uint32 * pSegmentNeededCount, Lib3MF_uint64 * pSegmentOffsets, Lib3MF_int32 * pSegmentTypes, const Lib3MF_uint64 nHatchBufferSize, Lib3MF_uint64 * pHatchNeededCount, sLib3MFDiscreteHatch2D * pHatchBuffer)
+{
+	return toolpathBatchGetLayerHatches(libraryHandle, pToolpathLayerReader, 1, nSegmentBufferSize, pSegmentNeededCount, pSegmentOffsets, pSegmentTypes, nHatchBufferSize, pHatchNeededCount, pHatchBuffer, sizeof(sLib3MFDiscreteHatch2D));
+}
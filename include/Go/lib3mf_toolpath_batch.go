@@ -0,0 +1,167 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract: Batch access to the toolpath layer reader. GetLayerHatchDataInModelUnits
+and GetLayerHatchDataDiscrete retrieve the hatches of all segments of a layer with
+a single cgo call into slices that are reused across layers.
+
+*/
+
+package lib3mf
+
+/*
+#include "lib3mf_toolpath_batch.h"
+*/
+import "C"
+
+import (
+	"unsafe"
+)
+
+// LayerHatchData receives the hatches of all segments of a layer in model units.
+// The slices are reused by subsequent calls and only grow, so reading all layers into the same value stops allocating.
+type LayerHatchData struct {
+	// Hatches of all segments in segment order.
+	Hatches []Hatch2D
+	// SegmentOffsets holds the index of the first hatch of every segment, followed by the hatch count.
+	SegmentOffsets []uint64
+	// SegmentTypes holds the ToolpathSegmentType of every segment.
+	SegmentTypes []int32
+}
+
+// LayerDiscreteHatchData receives the hatches of all segments of a layer in toolpath units.
+type LayerDiscreteHatchData struct {
+	// Hatches of all segments in segment order.
+	Hatches []DiscreteHatch2D
+	// SegmentOffsets holds the index of the first hatch of every segment, followed by the hatch count.
+	SegmentOffsets []uint64
+	// SegmentTypes holds the ToolpathSegmentType of every segment.
+	SegmentTypes []int32
+}
+
+// SegmentCount returns the number of segments of the layer.
+func (data *LayerHatchData) SegmentCount() int {
+	return len(data.SegmentTypes)
+}
+
+// SegmentType returns the type of a segment.
+func (data *LayerHatchData) SegmentType(segmentIndex int) ToolpathSegmentType {
+	return ToolpathSegmentType(data.SegmentTypes[segmentIndex])
+}
+
+// SegmentHatches returns the hatches of a segment as part of Hatches.
+func (data *LayerHatchData) SegmentHatches(segmentIndex int) []Hatch2D {
+	return data.Hatches[data.SegmentOffsets[segmentIndex]:data.SegmentOffsets[segmentIndex+1]]
+}
+
+// SegmentCount returns the number of segments of the layer.
+func (data *LayerDiscreteHatchData) SegmentCount() int {
+	return len(data.SegmentTypes)
+}
+
+// SegmentType returns the type of a segment.
+func (data *LayerDiscreteHatchData) SegmentType(segmentIndex int) ToolpathSegmentType {
+	return ToolpathSegmentType(data.SegmentTypes[segmentIndex])
+}
+
+// SegmentHatches returns the hatches of a segment as part of Hatches.
+func (data *LayerDiscreteHatchData) SegmentHatches(segmentIndex int) []DiscreteHatch2D {
+	return data.Hatches[data.SegmentOffsets[segmentIndex]:data.SegmentOffsets[segmentIndex+1]]
+}
+
+// reserveBatchSegments returns segment buffers for at least segmentCount segments, extended to their capacity.
+// There is always one more offset than types.
+func reserveBatchSegments(segmentTypes []int32, segmentOffsets []uint64, segmentCount int) ([]int32, []uint64) {
+	if cap(segmentTypes) < segmentCount || cap(segmentTypes) == 0 || cap(segmentOffsets) < cap(segmentTypes)+1 {
+		segmentTypes = make([]int32, segmentCount+1)
+		segmentOffsets = make([]uint64, segmentCount+2)
+	}
+	return segmentTypes[:cap(segmentTypes)], segmentOffsets[:cap(segmentTypes)+1]
+}
+
+// GetLayerHatchDataInModelUnits retrieves the hatches of all segments of the layer in model units, as GetSegmentHatchDataInModelUnits does per segment.
+// Unless data has to grow, this takes a single cgo call per layer.
+func (inst ToolpathLayerReader) GetLayerHatchDataInModelUnits(data *LayerHatchData) error {
+	if unsafe.Sizeof(Hatch2D{}) != uintptr(C.sizeof_sLib3MFBatchHatch2D) {
+		return makeError(LIB3MF_ERROR_INVALIDCAST)
+	}
+
+	var neededSegments C.uint32_t
+	var neededHatches C.uint64_t
+	for attempt := 0; attempt < 2; attempt++ {
+		segmentTypes, segmentOffsets := reserveBatchSegments(data.SegmentTypes, data.SegmentOffsets, int(neededSegments))
+		hatches := data.Hatches
+		if cap(hatches) < int(neededHatches) || cap(hatches) == 0 {
+			hatches = make([]Hatch2D, int(neededHatches)+1)
+		}
+		hatches = hatches[:cap(hatches)]
+		data.SegmentTypes, data.SegmentOffsets, data.Hatches = segmentTypes[:0], segmentOffsets[:0], hatches[:0]
+
+		ret := C.CCall_toolpathbatch_getlayerhatchdatainmodelunits(inst.wrapperRef.LibraryHandle, inst.Ref,
+			C.uint32_t(len(segmentTypes)), &neededSegments, (*C.uint64_t)(unsafe.Pointer(&segmentOffsets[0])), (*C.int32_t)(unsafe.Pointer(&segmentTypes[0])),
+			C.uint64_t(len(hatches)), &neededHatches, (*C.sLib3MFBatchHatch2D)(unsafe.Pointer(&hatches[0])))
+		if ret == 0 {
+			data.SegmentTypes = segmentTypes[:int(neededSegments)]
+			data.SegmentOffsets = segmentOffsets[:int(neededSegments)+1]
+			data.Hatches = hatches[:int(neededHatches)]
+			return nil
+		}
+		if ret != LIB3MF_ERROR_BUFFERTOOSMALL {
+			return makeError(uint32(ret))
+		}
+	}
+	return makeError(LIB3MF_ERROR_BUFFERTOOSMALL)
+}
+
+// GetLayerHatchDataDiscrete retrieves the hatches of all segments of the layer in toolpath units, as GetSegmentHatchDataDiscrete does per segment.
+// Unless data has to grow, this takes a single cgo call per layer.
+func (inst ToolpathLayerReader) GetLayerHatchDataDiscrete(data *LayerDiscreteHatchData) error {
+	var neededSegments C.uint32_t
+	var neededHatches C.uint64_t
+	for attempt := 0; attempt < 2; attempt++ {
+		segmentTypes, segmentOffsets := reserveBatchSegments(data.SegmentTypes, data.SegmentOffsets, int(neededSegments))
+		hatches := data.Hatches
+		if cap(hatches) < int(neededHatches) || cap(hatches) == 0 {
+			hatches = make([]DiscreteHatch2D, int(neededHatches)+1)
+		}
+		hatches = hatches[:cap(hatches)]
+		data.SegmentTypes, data.SegmentOffsets, data.Hatches = segmentTypes[:0], segmentOffsets[:0], hatches[:0]
+
+		ret := C.CCall_toolpathbatch_getlayerhatchdatadiscrete(inst.wrapperRef.LibraryHandle, inst.Ref,
+			C.uint32_t(len(segmentTypes)), &neededSegments, (*C.uint64_t)(unsafe.Pointer(&segmentOffsets[0])), (*C.int32_t)(unsafe.Pointer(&segmentTypes[0])),
+			C.uint64_t(len(hatches)), &neededHatches, (*C.sLib3MFDiscreteHatch2D)(unsafe.Pointer(&hatches[0])))
+		if ret == 0 {
+			data.SegmentTypes = segmentTypes[:int(neededSegments)]
+			data.SegmentOffsets = segmentOffsets[:int(neededSegments)+1]
+			data.Hatches = hatches[:int(neededHatches)]
+			return nil
+		}
+		if ret != LIB3MF_ERROR_BUFFERTOOSMALL {
+			return makeError(uint32(ret))
+		}
+	}
+	return makeError(LIB3MF_ERROR_BUFFERTOOSMALL)
+}
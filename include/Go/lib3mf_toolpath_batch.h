@@ -0,0 +1,79 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract: Batch access to the toolpath layer reader for the Go binding. One call
+retrieves the hatches of all segments of a layer, so a layer costs a single cgo
+transition instead of two per segment.
+
+*/
+
+#ifndef __LIB3MF_TOOLPATHBATCH_HEADER
+#define __LIB3MF_TOOLPATHBATCH_HEADER
+
+#include "lib3mf_dynamic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* Hatch in model units with the natural alignment of the Go Hatch2D struct. sLib3MFHatch2D is packed and therefore
+* 4 bytes shorter on 64 bit platforms.
+*/
+typedef struct sLib3MFBatchHatch2D {
+	Lib3MF_double m_Point1Coordinates[2];
+	Lib3MF_double m_Point2Coordinates[2];
+	Lib3MF_int32 m_Tag;
+} sLib3MFBatchHatch2D;
+
+/**
+* Retrieves the hatches of all segments of a layer in model units, as GetSegmentHatchDataInModelUnits does per segment.
+* If a buffer is too small, all needed counts are returned together with LIB3MF_ERROR_BUFFERTOOSMALL.
+*
+* @param[in] libraryHandle - Library handle of the wrapper
+* @param[in] pToolpathLayerReader - Layer reader
+* @param[in] nSegmentBufferSize - Size of pSegmentTypes. pSegmentOffsets must have one more entry.
+* @param[out] pSegmentNeededCount - Segment count of the layer
+* @param[out] pSegmentOffsets - Index of the first hatch of every segment, followed by the hatch count
+* @param[out] pSegmentTypes - Type of every segment
+* @param[in] nHatchBufferSize - Size of pHatchBuffer
+* @param[out] pHatchNeededCount - Hatch count of the layer
+* @param[out] pHatchBuffer - Hatches of all segments
+* @return error code or 0 (success)
+*/
+Lib3MFResult CCall_toolpathbatch_getlayerhatchdatainmodelunits(Lib3MFHandle libraryHandle, Lib3MF_ToolpathLayerReader pToolpathLayerReader, const Lib3MF_uint32 nSegmentBufferSize, Lib3MF_uint32 * pSegmentNeededCount, Lib3MF_uint64 * pSegmentOffsets, Lib3MF_int32 * pSegmentTypes, const Lib3MF_uint64 nHatchBufferSize, Lib3MF_uint64 * pHatchNeededCount, sLib3MFBatchHatch2D * pHatchBuffer);
+
+/**
+* Retrieves the hatches of all segments of a layer in toolpath units, as GetSegmentHatchDataDiscrete does per segment.
+* Parameters are the same as for CCall_toolpathbatch_getlayerhatchdatainmodelunits.
+*/
+Lib3MFResult CCall_toolpathbatch_getlayerhatchdatadiscrete(Lib3MFHandle libraryHandle, Lib3MF_ToolpathLayerReader pToolpathLayerReader, const Lib3MF_uint32 nSegmentBufferSize, Lib3MF_uint32 * pSegmentNeededCount, Lib3MF_uint64 * pSegmentOffsets, Lib3MF_int32 * pSegmentTypes, const Lib3MF_uint64 nHatchBufferSize, Lib3MF_uint64 * pHatchNeededCount, sLib3MFDiscreteHatch2D * pHatchBuffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIB3MF_TOOLPATHBATCH_HEADER
@@ -0,0 +1,192 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract: Benchmarks of the per segment and the batch access to toolpath hatches.
+
+Run with
+  LIB3MF_LIBRARY=<path to lib3mf library> LIB3MF_TOOLPATH_FILE=<toolpath 3mf> go test -bench Layer -run XXX
+
+*/
+
+package lib3mf
+
+import (
+	"os"
+	"testing"
+	"time"
+)
+
+// loadBenchmarkLayers reads all layers of the first toolpath of LIB3MF_TOOLPATH_FILE.
+func loadBenchmarkLayers(b *testing.B) []ToolpathLayerReader {
+	libraryPath := os.Getenv("LIB3MF_LIBRARY")
+	fileName := os.Getenv("LIB3MF_TOOLPATH_FILE")
+	if libraryPath == "" || fileName == "" {
+		b.Skip("set LIB3MF_LIBRARY and LIB3MF_TOOLPATH_FILE")
+	}
+
+	wrapper, err := LoadLibrary(libraryPath)
+	if err != nil {
+		b.Fatal(err)
+	}
+	model, err := wrapper.CreateModel()
+	if err != nil {
+		b.Fatal(err)
+	}
+	reader, err := model.QueryReader("3mf")
+	if err != nil {
+		b.Fatal(err)
+	}
+	if err = reader.ReadFromFile(fileName); err != nil {
+		b.Fatal(err)
+	}
+
+	toolpathIterator, err := model.GetToolpaths()
+	if err != nil {
+		b.Fatal(err)
+	}
+	hasToolpath, err := toolpathIterator.MoveNext()
+	if err != nil {
+		b.Fatal(err)
+	}
+	if !hasToolpath {
+		b.Fatal("file contains no toolpath")
+	}
+	toolpath, err := toolpathIterator.GetCurrentToolpath()
+	if err != nil {
+		b.Fatal(err)
+	}
+
+	layerCount, err := toolpath.GetLayerCount()
+	if err != nil {
+		b.Fatal(err)
+	}
+	layers := make([]ToolpathLayerReader, 0, layerCount)
+	for layerIndex := uint32(0); layerIndex < layerCount; layerIndex++ {
+		layer, err := toolpath.ReadLayerData(layerIndex)
+		if err != nil {
+			b.Fatal(err)
+		}
+		layers = append(layers, layer)
+	}
+	return layers
+}
+
+func reportSegmentRate(b *testing.B, segmentCount int, elapsed time.Duration) {
+	if elapsed > 0 {
+		b.ReportMetric(float64(segmentCount)/elapsed.Seconds(), "segments/s")
+	}
+}
+
+func BenchmarkLayerHatchesPerSegment(b *testing.B) {
+	layers := loadBenchmarkLayers(b)
+	// The generated getters need at least one element, also for segments without hatches
+	hatches := make([]Hatch2D, 1)
+	segmentCount := 0
+
+	b.ResetTimer()
+	start := time.Now()
+	for i := 0; i < b.N; i++ {
+		for _, layer := range layers {
+			layerSegmentCount, err := layer.GetSegmentCount()
+			if err != nil {
+				b.Fatal(err)
+			}
+			for segmentIndex := uint32(0); segmentIndex < layerSegmentCount; segmentIndex++ {
+				if _, _, err = layer.GetSegmentInfo(segmentIndex); err != nil {
+					b.Fatal(err)
+				}
+				if hatches, err = layer.GetSegmentHatchDataInModelUnits(segmentIndex, hatches[:cap(hatches)]); err != nil {
+					b.Fatal(err)
+				}
+			}
+			segmentCount += int(layerSegmentCount)
+		}
+	}
+	reportSegmentRate(b, segmentCount, time.Since(start))
+}
+
+func BenchmarkLayerHatchesBatch(b *testing.B) {
+	layers := loadBenchmarkLayers(b)
+	var data LayerHatchData
+	segmentCount := 0
+
+	b.ResetTimer()
+	start := time.Now()
+	for i := 0; i < b.N; i++ {
+		for _, layer := range layers {
+			if err := layer.GetLayerHatchDataInModelUnits(&data); err != nil {
+				b.Fatal(err)
+			}
+			segmentCount += data.SegmentCount()
+		}
+	}
+	reportSegmentRate(b, segmentCount, time.Since(start))
+}
+
+func BenchmarkLayerDiscreteHatchesPerSegment(b *testing.B) {
+	layers := loadBenchmarkLayers(b)
+	hatches := make([]DiscreteHatch2D, 1)
+	segmentCount := 0
+
+	b.ResetTimer()
+	start := time.Now()
+	for i := 0; i < b.N; i++ {
+		for _, layer := range layers {
+			layerSegmentCount, err := layer.GetSegmentCount()
+			if err != nil {
+				b.Fatal(err)
+			}
+			for segmentIndex := uint32(0); segmentIndex < layerSegmentCount; segmentIndex++ {
+				if _, _, err = layer.GetSegmentInfo(segmentIndex); err != nil {
+					b.Fatal(err)
+				}
+				if hatches, err = layer.GetSegmentHatchDataDiscrete(segmentIndex, hatches[:cap(hatches)]); err != nil {
+					b.Fatal(err)
+				}
+			}
+			segmentCount += int(layerSegmentCount)
+		}
+	}
+	reportSegmentRate(b, segmentCount, time.Since(start))
+}
+
+func BenchmarkLayerDiscreteHatchesBatch(b *testing.B) {
+	layers := loadBenchmarkLayers(b)
+	var data LayerDiscreteHatchData
+	segmentCount := 0
+
+	b.ResetTimer()
+	start := time.Now()
+	for i := 0; i < b.N; i++ {
+		for _, layer := range layers {
+			if err := layer.GetLayerHatchDataDiscrete(&data); err != nil {
+				b.Fatal(err)
+			}
+			segmentCount += data.SegmentCount()
+		}
+	}
+	reportSegmentRate(b, segmentCount, time.Since(start))
+}
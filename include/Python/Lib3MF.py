@@ -1370,6 +1370,158 @@ class Matrix4x4(ctypes.Structure):
 		("Field", (ctypes.c_double * 4) * 4)
 	]
 
+'''NumPy support
+		Structured dtypes with the packed layout of the ctypes structures above, used by the *AsArray and *FromArrays methods.
+		Arrays are passed to lib3mf directly, without building intermediate lists. NumPy is imported on first use.
+'''
+_NumPyTypeCodes = {
+	ctypes.c_uint8: 'u1',
+	ctypes.c_int32: 'i4',
+	ctypes.c_uint32: 'u4',
+	ctypes.c_int64: 'i8',
+	ctypes.c_uint64: 'u8',
+	ctypes.c_float: 'f4',
+	ctypes.c_double: 'f8'
+}
+_NumPyDTypes = {}
+
+def _importNumPy():
+	import numpy
+	return numpy
+
+def NumPyDType(ElementType):
+	if ElementType in _NumPyDTypes:
+		return _NumPyDTypes[ElementType]
+	
+	numpy = _importNumPy()
+	if ElementType in _NumPyTypeCodes:
+		dtype = numpy.dtype('=' + _NumPyTypeCodes[ElementType])
+	else:
+		fields = []
+		for (fieldName, fieldType) in ElementType._fields_:
+			shape = ()
+			while issubclass(fieldType, ctypes.Array):
+				shape = shape + (fieldType._length_,)
+				fieldType = fieldType._type_
+			if shape:
+				fields.append((fieldName, '=' + _NumPyTypeCodes[fieldType], shape))
+			else:
+				fields.append((fieldName, '=' + _NumPyTypeCodes[fieldType]))
+		dtype = numpy.dtype(fields)
+	
+	if dtype.itemsize != ctypes.sizeof(ElementType):
+		raise ELib3MFException(ErrorCodes.INVALIDPARAM, 'no NumPy layout for ' + ElementType.__name__)
+	_NumPyDTypes[ElementType] = dtype
+	return dtype
+
+def _readNumPyArray(instance, function, arguments, ElementType):
+	numpy = _importNumPy()
+	nNeededCount = ctypes.c_uint64(0)
+	instance._wrapper.checkError(instance, function(*(arguments + (ctypes.c_uint64(0), nNeededCount, (ElementType*0)()))))
+	array = numpy.empty(nNeededCount.value, dtype=NumPyDType(ElementType))
+	if len(array) > 0:
+		instance._wrapper.checkError(instance, function(*(arguments + (ctypes.c_uint64(len(array)), nNeededCount, array.ctypes.data_as(ctypes.POINTER(ElementType))))))
+	return array
+
+def _numPyArgument(Data, ElementType):
+	numpy = _importNumPy()
+	array = numpy.ascontiguousarray(Data, dtype=NumPyDType(ElementType))
+	if array.ndim != 1:
+		raise ELib3MFException(ErrorCodes.INVALIDPARAM, 'expected a one dimensional array of ' + ElementType.__name__)
+	return array, ctypes.c_uint64(len(array)), array.ctypes.data_as(ctypes.POINTER(ElementType))
+
+
+'''Whole layer export
+		Loads the ToolpathLayerArrays library built with the toolpath helpers. It reads all segments of a layer with a
+		single call and returns them as contiguous NumPy arrays, see ToolpathLayerReader.ToArrays.
+'''
+class ToolpathLayerArrays:
+	def __init__(self, wrapper, libraryName):
+		ending = ''
+		if platform.system() == 'Windows':
+			ending = 'dll'
+		elif platform.system() == 'Linux':
+			ending = 'so'
+		elif platform.system() == 'Darwin':
+			ending = 'dylib'
+		else:
+			raise ELib3MFException(ErrorCodes.COULDNOTLOADLIBRARY)
+		
+		path = libraryName + '.' + ending
+		try:
+			self.lib = ctypes.CDLL(path)
+		except Exception as e:
+			raise ELib3MFException(ErrorCodes.COULDNOTLOADLIBRARY, str(e) + '| "'+path + '"' )
+		
+		self.lib.toolpathlayerarrays_create.restype = ctypes.c_int32
+		self.lib.toolpathlayerarrays_create.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_void_p)]
+		self.lib.toolpathlayerarrays_release.restype = ctypes.c_int32
+		self.lib.toolpathlayerarrays_release.argtypes = [ctypes.c_void_p]
+		self.lib.toolpathlayerarrays_extract.restype = ctypes.c_int32
+		self.lib.toolpathlayerarrays_extract.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint64), ctypes.POINTER(ctypes.c_uint64)]
+		self.lib.toolpathlayerarrays_copy.restype = ctypes.c_int32
+		self.lib.toolpathlayerarrays_copy.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p]
+		self.lib.toolpathlayerarrays_copyarcpaths.restype = ctypes.c_int32
+		self.lib.toolpathlayerarrays_copyarcpaths.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+		self.lib.toolpathlayerarrays_getlasterror.restype = ctypes.c_int32
+		self.lib.toolpathlayerarrays_getlasterror.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint32), ctypes.c_char_p]
+		
+		self._handle = None
+		self._wrapper = wrapper
+		handle = ctypes.c_void_p()
+		self.checkError(self.lib.toolpathlayerarrays_create(ctypes.c_void_p(wrapper.GetSymbolLookupMethod()), handle))
+		self._handle = handle
+	
+	def __del__(self):
+		if self._handle:
+			self.lib.toolpathlayerarrays_release(self._handle)
+			self._handle = None
+	
+	def checkError(self, errorCode):
+		if errorCode != ErrorCodes.SUCCESS.value:
+			message = ''
+			if self._handle:
+				nNeededChars = ctypes.c_uint32(0)
+				self.lib.toolpathlayerarrays_getlasterror(self._handle, 0, nNeededChars, None)
+				pBuffer = ctypes.create_string_buffer(nNeededChars.value)
+				if self.lib.toolpathlayerarrays_getlasterror(self._handle, nNeededChars, nNeededChars, pBuffer) == ErrorCodes.SUCCESS.value:
+					message = pBuffer.value.decode()
+			raise ELib3MFException(errorCode, message)
+	
+	def Extract(self, LayerReader, Factors = ()):
+		numpy = _importNumPy()
+		nFactorMask = 0
+		for factor in Factors:
+			if factor == ToolpathProfileModificationFactor.Unknown:
+				raise ELib3MFException(ErrorCodes.INVALIDPARAM, 'invalid modification factor')
+			nFactorMask |= 1 << (ToolpathProfileModificationFactor(factor).value - 1)
+		
+		nSegmentCount = ctypes.c_uint64(0)
+		nPointCount = ctypes.c_uint64(0)
+		self.checkError(self.lib.toolpathlayerarrays_extract(self._handle, LayerReader._handle, nFactorMask, nSegmentCount, nPointCount))
+		
+		arrays = {
+			'SegmentTypes': numpy.empty(nSegmentCount.value, dtype=numpy.uint32),
+			'ProfileIDs': numpy.empty(nSegmentCount.value, dtype=numpy.uint32),
+			'PartIDs': numpy.empty(nSegmentCount.value, dtype=numpy.uint32),
+			'ArcPaths': numpy.empty(nSegmentCount.value, dtype=numpy.bool_),
+			'SegmentOffsets': numpy.empty(nSegmentCount.value + 1, dtype=numpy.uint64),
+			'Coordinates': numpy.empty((nPointCount.value, 2), dtype=numpy.int32),
+			'Factors': {}
+		}
+		factorBuffers = []
+		for factor in (ToolpathProfileModificationFactor.FactorF, ToolpathProfileModificationFactor.FactorG, ToolpathProfileModificationFactor.FactorH):
+			if nFactorMask & (1 << (factor.value - 1)):
+				arrays['Factors'][factor] = numpy.empty(nPointCount.value, dtype=numpy.float64)
+				factorBuffers.append(arrays['Factors'][factor].ctypes.data)
+			else:
+				factorBuffers.append(None)
+		
+		self.checkError(self.lib.toolpathlayerarrays_copy(self._handle, arrays['SegmentTypes'].ctypes.data, arrays['ProfileIDs'].ctypes.data,
+			arrays['PartIDs'].ctypes.data, arrays['SegmentOffsets'].ctypes.data, arrays['Coordinates'].ctypes.data, *factorBuffers))
+		self.checkError(self.lib.toolpathlayerarrays_copyarcpaths(self._handle, arrays['ArcPaths'].ctypes.data))
+		return arrays
+
 '''Definition of Function Types
 '''
 '''Definition of ProgressCallback
@@ -15188,7 +15340,58 @@ class ToolpathLayerReader(Base):
 		
 		return [pCountArrayBuffer[i] for i in range(nCountArrayNeededCount.value)], [pFactorValuesBuffer[i] for i in range(nFactorValuesNeededCount.value)]
 	
-
+	
+	'''NumPy variants of the segment getters
+			The returned arrays are filled by lib3mf and use the dtypes returned by NumPyDType. Fields such as
+			hatches['Point1Coordinates'] are views on the same memory.
+	'''
+	def GetSegmentPointDataInModelUnitsAsArray(self, SegmentIndex):
+		return _readNumPyArray(self, self._wrapper.lib.lib3mf_toolpathlayerreader_getsegmentpointdatainmodelunits, (self._handle, ctypes.c_uint32(SegmentIndex)), Position2D)
+	
+	def GetSegmentPointDataDiscreteAsArray(self, SegmentIndex):
+		return _readNumPyArray(self, self._wrapper.lib.lib3mf_toolpathlayerreader_getsegmentpointdatadiscrete, (self._handle, ctypes.c_uint32(SegmentIndex)), DiscretePosition2D)
+	
+	def GetSegmentPointModificationFactorsAsArray(self, SegmentIndex, ModificationFactor):
+		return _readNumPyArray(self, self._wrapper.lib.lib3mf_toolpathlayerreader_getsegmentpointmodificationfactors, (self._handle, ctypes.c_uint32(SegmentIndex), ModificationFactor), ctypes.c_double)
+	
+	def GetSegmentHatchDataInModelUnitsAsArray(self, SegmentIndex):
+		return _readNumPyArray(self, self._wrapper.lib.lib3mf_toolpathlayerreader_getsegmenthatchdatainmodelunits, (self._handle, ctypes.c_uint32(SegmentIndex)), Hatch2D)
+	
+	def GetSegmentHatchDataDiscreteAsArray(self, SegmentIndex):
+		return _readNumPyArray(self, self._wrapper.lib.lib3mf_toolpathlayerreader_getsegmenthatchdatadiscrete, (self._handle, ctypes.c_uint32(SegmentIndex)), DiscreteHatch2D)
+	
+	def GetLinearSegmentHatchModificationFactorsAsArray(self, SegmentIndex, ModificationFactor):
+		return _readNumPyArray(self, self._wrapper.lib.lib3mf_toolpathlayerreader_getlinearsegmenthatchmodificationfactors, (self._handle, ctypes.c_uint32(SegmentIndex), ModificationFactor), Hatch2DFactors)
+	
+	def GetSegmentNonlinearHatchModificationInterpolationAsArray(self, SegmentIndex, HatchIndex, ModificationFactor):
+		return _readNumPyArray(self, self._wrapper.lib.lib3mf_toolpathlayerreader_getsegmentnonlinearhatchmodificationinterpolation, (self._handle, ctypes.c_uint32(SegmentIndex), ctypes.c_uint32(HatchIndex), ModificationFactor), HatchModificationInterpolationData)
+	
+	def GetSegmentAllNonlinearHatchesModificationInterpolationAsArrays(self, SegmentIndex, ModificationFactor):
+		numpy = _importNumPy()
+		nSegmentIndex = ctypes.c_uint32(SegmentIndex)
+		nCountArrayNeededCount = ctypes.c_uint64(0)
+		nFactorValuesNeededCount = ctypes.c_uint64(0)
+		function = self._wrapper.lib.lib3mf_toolpathlayerreader_getsegmentallnonlinearhatchesmodificationinterpolation
+		self._wrapper.checkError(self, function(self._handle, nSegmentIndex, ModificationFactor, ctypes.c_uint64(0), nCountArrayNeededCount, (ctypes.c_uint32*0)(), ctypes.c_uint64(0), nFactorValuesNeededCount, (HatchModificationInterpolationData*0)()))
+		aCountArray = numpy.empty(nCountArrayNeededCount.value, dtype=NumPyDType(ctypes.c_uint32))
+		aFactorValues = numpy.empty(nFactorValuesNeededCount.value, dtype=NumPyDType(HatchModificationInterpolationData))
+		if (len(aCountArray) > 0) or (len(aFactorValues) > 0):
+			self._wrapper.checkError(self, function(self._handle, nSegmentIndex, ModificationFactor, ctypes.c_uint64(len(aCountArray)), nCountArrayNeededCount, aCountArray.ctypes.data_as(ctypes.POINTER(ctypes.c_uint32)), ctypes.c_uint64(len(aFactorValues)), nFactorValuesNeededCount, aFactorValues.ctypes.data_as(ctypes.POINTER(HatchModificationInterpolationData))))
+		
+		return aCountArray, aFactorValues
+
+	
+	'''Whole layer export
+			Returns all segments as a dict of NumPy arrays: SegmentTypes, ProfileIDs, PartIDs, ArcPaths (True for loops and
+			polylines that hold an arc path, whose points alternate between end points and points on the arcs; requires the
+			arcpath segment attribute to be registered before layers are read), SegmentOffsets (index of the first point of
+			every segment and the point count), Coordinates (x and y in toolpath units, hatches contribute both end points)
+			and Factors (one array per requested ToolpathProfileModificationFactor).
+			LayerArrays is a ToolpathLayerArrays instance, which can be reused for all layers.
+	'''
+	def ToArrays(self, LayerArrays, Factors = ()):
+		return LayerArrays.Extract(self, Factors)
+	
 
 ''' Class Implementation for ToolpathLayerData
 '''
@@ -15428,6 +15631,56 @@ class ToolpathLayerData(Base):
 		self._wrapper.checkError(self, self._wrapper.lib.lib3mf_toolpathlayerdata_finish(self._handle))
 		
 	
+	
+	'''NumPy variants of the hatch writers
+			Arrays are converted with numpy.ascontiguousarray and passed to lib3mf without copying if they already
+			have the dtype returned by NumPyDType.
+	'''
+	def WriteHatchDataInModelUnitsFromArrays(self, ProfileID, PartID, HatchData):
+		aHatchData, nHatchDataCount, pHatchDataBuffer = _numPyArgument(HatchData, Hatch2D)
+		self._wrapper.checkError(self, self._wrapper.lib.lib3mf_toolpathlayerdata_writehatchdatainmodelunits(self._handle, ctypes.c_uint32(ProfileID), ctypes.c_uint32(PartID), nHatchDataCount, pHatchDataBuffer))
+	
+	def WriteHatchDataInModelUnitsWithConstantFactorsFromArrays(self, ProfileID, PartID, HatchData, FactorData):
+		aHatchData, nHatchDataCount, pHatchDataBuffer = _numPyArgument(HatchData, Hatch2D)
+		aFactorData, nFactorDataCount, pFactorDataBuffer = _numPyArgument(FactorData, ctypes.c_double)
+		self._wrapper.checkError(self, self._wrapper.lib.lib3mf_toolpathlayerdata_writehatchdatainmodelunitswithconstantfactors(self._handle, ctypes.c_uint32(ProfileID), ctypes.c_uint32(PartID), nHatchDataCount, pHatchDataBuffer, nFactorDataCount, pFactorDataBuffer))
+	
+	def WriteHatchDataInModelUnitsWithLinearFactorsFromArrays(self, ProfileID, PartID, HatchData, FactorData1, FactorData2):
+		aHatchData, nHatchDataCount, pHatchDataBuffer = _numPyArgument(HatchData, Hatch2D)
+		aFactorData1, nFactorData1Count, pFactorData1Buffer = _numPyArgument(FactorData1, ctypes.c_double)
+		aFactorData2, nFactorData2Count, pFactorData2Buffer = _numPyArgument(FactorData2, ctypes.c_double)
+		self._wrapper.checkError(self, self._wrapper.lib.lib3mf_toolpathlayerdata_writehatchdatainmodelunitswithlinearfactors(self._handle, ctypes.c_uint32(ProfileID), ctypes.c_uint32(PartID), nHatchDataCount, pHatchDataBuffer, nFactorData1Count, pFactorData1Buffer, nFactorData2Count, pFactorData2Buffer))
+	
+	def WriteHatchDataInModelUnitsWithNonlinearFactorsFromArrays(self, ProfileID, PartID, HatchData, FactorData1, FactorData2, SubInterpolationCounts, ModificationInterpolationData):
+		aHatchData, nHatchDataCount, pHatchDataBuffer = _numPyArgument(HatchData, Hatch2D)
+		aFactorData1, nFactorData1Count, pFactorData1Buffer = _numPyArgument(FactorData1, ctypes.c_double)
+		aFactorData2, nFactorData2Count, pFactorData2Buffer = _numPyArgument(FactorData2, ctypes.c_double)
+		aSubInterpolationCounts, nSubInterpolationCountsCount, pSubInterpolationCountsBuffer = _numPyArgument(SubInterpolationCounts, ctypes.c_uint32)
+		aModificationInterpolationData, nModificationInterpolationDataCount, pModificationInterpolationDataBuffer = _numPyArgument(ModificationInterpolationData, HatchModificationInterpolationData)
+		self._wrapper.checkError(self, self._wrapper.lib.lib3mf_toolpathlayerdata_writehatchdatainmodelunitswithnonlinearfactors(self._handle, ctypes.c_uint32(ProfileID), ctypes.c_uint32(PartID), nHatchDataCount, pHatchDataBuffer, nFactorData1Count, pFactorData1Buffer, nFactorData2Count, pFactorData2Buffer, nSubInterpolationCountsCount, pSubInterpolationCountsBuffer, nModificationInterpolationDataCount, pModificationInterpolationDataBuffer))
+	
+	def WriteHatchDataDiscreteFromArrays(self, ProfileID, PartID, HatchData):
+		aHatchData, nHatchDataCount, pHatchDataBuffer = _numPyArgument(HatchData, DiscreteHatch2D)
+		self._wrapper.checkError(self, self._wrapper.lib.lib3mf_toolpathlayerdata_writehatchdatadiscrete(self._handle, ctypes.c_uint32(ProfileID), ctypes.c_uint32(PartID), nHatchDataCount, pHatchDataBuffer))
+	
+	def WriteHatchDataDiscreteWithConstantFactorsFromArrays(self, ProfileID, PartID, HatchData, FactorData):
+		aHatchData, nHatchDataCount, pHatchDataBuffer = _numPyArgument(HatchData, DiscreteHatch2D)
+		aFactorData, nFactorDataCount, pFactorDataBuffer = _numPyArgument(FactorData, ctypes.c_double)
+		self._wrapper.checkError(self, self._wrapper.lib.lib3mf_toolpathlayerdata_writehatchdatadiscretewithconstantfactors(self._handle, ctypes.c_uint32(ProfileID), ctypes.c_uint32(PartID), nHatchDataCount, pHatchDataBuffer, nFactorDataCount, pFactorDataBuffer))
+	
+	def WriteHatchDataDiscreteWithLinearFactorsFromArrays(self, ProfileID, PartID, HatchData, FactorData1, FactorData2):
+		aHatchData, nHatchDataCount, pHatchDataBuffer = _numPyArgument(HatchData, DiscreteHatch2D)
+		aFactorData1, nFactorData1Count, pFactorData1Buffer = _numPyArgument(FactorData1, ctypes.c_double)
+		aFactorData2, nFactorData2Count, pFactorData2Buffer = _numPyArgument(FactorData2, ctypes.c_double)
+		self._wrapper.checkError(self, self._wrapper.lib.lib3mf_toolpathlayerdata_writehatchdatadiscretewithlinearfactors(self._handle, ctypes.c_uint32(ProfileID), ctypes.c_uint32(PartID), nHatchDataCount, pHatchDataBuffer, nFactorData1Count, pFactorData1Buffer, nFactorData2Count, pFactorData2Buffer))
+	
+	def WriteHatchDataDiscreteWithNonlinearFactorsFromArrays(self, ProfileID, PartID, HatchData, FactorData1, FactorData2, SubInterpolationCounts, ModificationInterpolationData):
+		aHatchData, nHatchDataCount, pHatchDataBuffer = _numPyArgument(HatchData, DiscreteHatch2D)
+		aFactorData1, nFactorData1Count, pFactorData1Buffer = _numPyArgument(FactorData1, ctypes.c_double)
+		aFactorData2, nFactorData2Count, pFactorData2Buffer = _numPyArgument(FactorData2, ctypes.c_double)
+		aSubInterpolationCounts, nSubInterpolationCountsCount, pSubInterpolationCountsBuffer = _numPyArgument(SubInterpolationCounts, ctypes.c_uint32)
+		aModificationInterpolationData, nModificationInterpolationDataCount, pModificationInterpolationDataBuffer = _numPyArgument(ModificationInterpolationData, HatchModificationInterpolationData)
+		self._wrapper.checkError(self, self._wrapper.lib.lib3mf_toolpathlayerdata_writehatchdatadiscretewithnonlinearfactors(self._handle, ctypes.c_uint32(ProfileID), ctypes.c_uint32(PartID), nHatchDataCount, pHatchDataBuffer, nFactorData1Count, pFactorData1Buffer, nFactorData2Count, pFactorData2Buffer, nSubInterpolationCountsCount, pSubInterpolationCountsBuffer, nModificationInterpolationDataCount, pModificationInterpolationDataBuffer))
 
 
 ''' Class Implementation for Toolpath
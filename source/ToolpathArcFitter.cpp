@@ -0,0 +1,548 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#include "ToolpathArcFitter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+// Arcs are limited to half a circle, so that the through point is well away from the start and end point
+#define ARCFITTER_MAXSWEEP 3.14159265358979323846
+// Through points closer to the chord than this fraction of the chord length are treated as collinear
+#define ARCFITTER_MINSINE 1.0e-9
+// Zero factor tolerances are raised to this, so that rounding errors of linear factors are accepted
+#define ARCFITTER_MINFACTORTOLERANCE 1.0e-9
+
+namespace ToolpathExample {
+
+static const double s_dPi = 3.14159265358979323846;
+
+// Angle in [0, 2 pi)
+static inline double normalizeAngle(double dAngle)
+{
+    dAngle = std::fmod(dAngle, 2.0 * s_dPi);
+    return (dAngle < 0.0) ? dAngle + 2.0 * s_dPi : dAngle;
+}
+
+// Circle through the start, through and end point of an element, with the signed sweep from the start point past
+// the through point to the end point. Returns false if the points are collinear.
+static bool arcThroughPoints(const double * pStart, const double * pThrough, const double * pEnd,
+    double & dCenterX, double & dCenterY, double & dRadius, double & dStartAngle, double & dSweepAngle)
+{
+    double dAX = pThrough[0] - pStart[0];
+    double dAY = pThrough[1] - pStart[1];
+    double dBX = pEnd[0] - pStart[0];
+    double dBY = pEnd[1] - pStart[1];
+    double dALengthSquared = dAX * dAX + dAY * dAY;
+    double dBLengthSquared = dBX * dBX + dBY * dBY;
+    double dDeterminant = 2.0 * (dAX * dBY - dAY * dBX);
+    if (!(std::fabs(dDeterminant) > 2.0 * ARCFITTER_MINSINE * std::sqrt(dALengthSquared * dBLengthSquared)))
+        return false;
+
+    double dUX = (dBY * dALengthSquared - dAY * dBLengthSquared) / dDeterminant;
+    double dUY = (dAX * dBLengthSquared - dBX * dALengthSquared) / dDeterminant;
+    dCenterX = pStart[0] + dUX;
+    dCenterY = pStart[1] + dUY;
+    dRadius = std::sqrt(dUX * dUX + dUY * dUY);
+    dStartAngle = std::atan2(-dUY, -dUX);
+
+    double dEndSweep = normalizeAngle(std::atan2(pEnd[1] - dCenterY, pEnd[0] - dCenterX) - dStartAngle);
+    double dThroughSweep = normalizeAngle(std::atan2(pThrough[1] - dCenterY, pThrough[0] - dCenterX) - dStartAngle);
+    dSweepAngle = (dThroughSweep <= dEndSweep) ? dEndSweep : dEndSweep - 2.0 * s_dPi;
+    return true;
+}
+
+static inline void setCoordinates(Lib3MF::sDiscretePosition2D & point, double dX, double dY)
+{
+    point.m_Coordinates[0] = (int32_t)std::lround(dX);
+    point.m_Coordinates[1] = (int32_t)std::lround(dY);
+}
+
+static inline void setCoordinates(Lib3MF::sPosition2D & point, double dX, double dY)
+{
+    point.m_Coordinates[0] = (float)dX;
+    point.m_Coordinates[1] = (float)dY;
+}
+
+/*************************************************************************************************************************
+ Class CToolpathArcPath
+**************************************************************************************************************************/
+
+CToolpathArcPath::CToolpathArcPath()
+    : m_nElementCount(0), m_bClosed(false)
+{
+}
+
+template <typename T> static size_t loadArcPath(const T * pPoints, const double * pFactors, size_t nPointCount, bool bClosed,
+    std::vector<double> & coordinates, std::vector<double> & factors)
+{
+    if ((pPoints == nullptr) && (nPointCount > 0))
+        throw std::invalid_argument("invalid arc path points");
+    if (bClosed ? ((nPointCount < 2) || (nPointCount % 2 != 0)) : ((nPointCount < 3) || (nPointCount % 2 != 1)))
+        throw std::invalid_argument("invalid arc path point count");
+
+    // Loops repeat their first point at the end
+    size_t nLoadCount = bClosed ? nPointCount + 1 : nPointCount;
+    coordinates.resize(2 * nLoadCount);
+    factors.clear();
+    for (size_t nIndex = 0; nIndex < nLoadCount; nIndex++) {
+        const T & point = pPoints[(nIndex < nPointCount) ? nIndex : 0];
+        coordinates[2 * nIndex] = (double)point.m_Coordinates[0];
+        coordinates[2 * nIndex + 1] = (double)point.m_Coordinates[1];
+        if (pFactors != nullptr)
+            factors.push_back(pFactors[(nIndex < nPointCount) ? nIndex : 0]);
+    }
+
+    return nLoadCount / 2;
+}
+
+void CToolpathArcPath::SetDiscretePoints(const Lib3MF::sDiscretePosition2D * pPoints, const double * pFactors, size_t nPointCount, bool bClosed)
+{
+    m_nElementCount = loadArcPath(pPoints, pFactors, nPointCount, bClosed, m_Coordinates, m_Factors);
+    m_bClosed = bClosed;
+}
+
+void CToolpathArcPath::SetPoints(const Lib3MF::sPosition2D * pPoints, const double * pFactors, size_t nPointCount, bool bClosed)
+{
+    m_nElementCount = loadArcPath(pPoints, pFactors, nPointCount, bClosed, m_Coordinates, m_Factors);
+    m_bClosed = bClosed;
+}
+
+void CToolpathArcPath::GetElement(size_t nElementIndex, sToolpathArcElement & element) const
+{
+    if (nElementIndex >= m_nElementCount)
+        throw std::range_error("invalid arc element index");
+
+    const double * pStart = &m_Coordinates[4 * nElementIndex];
+    const double * pThrough = pStart + 2;
+    const double * pEnd = pStart + 4;
+    element.m_dStartX = pStart[0];
+    element.m_dStartY = pStart[1];
+    element.m_dEndX = pEnd[0];
+    element.m_dEndY = pEnd[1];
+    element.m_dStartFactor = m_Factors.empty() ? 0.0 : m_Factors[2 * nElementIndex];
+    element.m_dEndFactor = m_Factors.empty() ? 0.0 : m_Factors[2 * nElementIndex + 2];
+
+    double dCenterX, dCenterY, dRadius, dStartAngle, dSweepAngle;
+    element.m_bLine = ((pThrough[0] == pStart[0]) && (pThrough[1] == pStart[1]))
+        || !arcThroughPoints(pStart, pThrough, pEnd, dCenterX, dCenterY, dRadius, dStartAngle, dSweepAngle);
+    if (element.m_bLine) {
+        element.m_dCenterX = 0.0;
+        element.m_dCenterY = 0.0;
+        element.m_dRadius = 0.0;
+        element.m_dStartAngle = 0.0;
+        element.m_dSweepAngle = 0.0;
+    }
+    else {
+        element.m_dCenterX = dCenterX;
+        element.m_dCenterY = dCenterY;
+        element.m_dRadius = dRadius;
+        element.m_dStartAngle = dStartAngle * 180.0 / s_dPi;
+        element.m_dSweepAngle = dSweepAngle * 180.0 / s_dPi;
+    }
+}
+
+void CToolpathArcPath::Tessellate(double dTolerance, std::vector<Lib3MF::sPosition2D> & points, std::vector<double> & factors) const
+{
+    if (!(dTolerance > 0.0))
+        throw std::invalid_argument("invalid tessellation tolerance");
+
+    points.clear();
+    factors.clear();
+    sToolpathArcElement element;
+    Lib3MF::sPosition2D point;
+    for (size_t nElementIndex = 0; nElementIndex < m_nElementCount; nElementIndex++) {
+        GetElement(nElementIndex, element);
+        setCoordinates(point, element.m_dStartX, element.m_dStartY);
+        points.push_back(point);
+        factors.push_back(element.m_dStartFactor);
+        if (element.m_bLine)
+            continue;
+
+        // Chords of this angle stay within the tolerance of the arc
+        double dSweep = element.m_dSweepAngle * s_dPi / 180.0;
+        double dMaxStep = (dTolerance < element.m_dRadius) ? 2.0 * std::acos(1.0 - dTolerance / element.m_dRadius) : s_dPi;
+        size_t nStepCount = std::max<size_t>(2, (size_t)std::ceil(std::fabs(dSweep) / dMaxStep));
+        double dStartAngle = element.m_dStartAngle * s_dPi / 180.0;
+        for (size_t nStep = 1; nStep < nStepCount; nStep++) {
+            double dT = (double)nStep / nStepCount;
+            double dAngle = dStartAngle + dT * dSweep;
+            setCoordinates(point, element.m_dCenterX + element.m_dRadius * std::cos(dAngle), element.m_dCenterY + element.m_dRadius * std::sin(dAngle));
+            points.push_back(point);
+            factors.push_back((1.0 - dT) * element.m_dStartFactor + dT * element.m_dEndFactor);
+        }
+    }
+
+    // The end point of a loop is its first point
+    if (!m_bClosed && (m_nElementCount > 0)) {
+        size_t nEnd = 2 * m_nElementCount;
+        setCoordinates(point, m_Coordinates[2 * nEnd], m_Coordinates[2 * nEnd + 1]);
+        points.push_back(point);
+        factors.push_back(m_Factors.empty() ? 0.0 : m_Factors[nEnd]);
+    }
+}
+
+void CToolpathArcPath::RegisterAttribute(Lib3MF::PToolpath pToolpath)
+{
+    if (pToolpath.get() == nullptr)
+        throw std::invalid_argument("invalid toolpath");
+
+    pToolpath->RegisterCustomIntegerSegmentAttribute(TOOLPATHARCS_NAMESPACE, TOOLPATHARCS_ATTRIBUTE);
+}
+
+void CToolpathArcPath::RegisterNamespace(Lib3MF::PWriter pWriter)
+{
+    if (pWriter.get() == nullptr)
+        throw std::invalid_argument("invalid writer");
+
+    pWriter->RegisterCustomNamespace(TOOLPATHARCS_PREFIX, TOOLPATHARCS_NAMESPACE);
+    pWriter->SetCustomNamespaceRequired(TOOLPATHARCS_PREFIX, true);
+}
+
+void CToolpathArcPath::SetSegmentAttribute(Lib3MF::PToolpathLayerData pLayer, bool bArcPath)
+{
+    if (pLayer.get() == nullptr)
+        throw std::invalid_argument("invalid layer data");
+
+    pLayer->SetSegmentAttribute(TOOLPATHARCS_NAMESPACE, TOOLPATHARCS_ATTRIBUTE, bArcPath ? "1" : "0");
+}
+
+bool CToolpathArcPath::IsArcPath(Lib3MF::PToolpathLayerReader pLayerReader, uint32_t nSegmentIndex)
+{
+    if (pLayerReader.get() == nullptr)
+        throw std::invalid_argument("invalid layer reader");
+
+    // Segments that were written without the attribute are plain loops and polylines
+    try {
+        return pLayerReader->GetSegmentIntegerAttributeByName(nSegmentIndex, TOOLPATHARCS_NAMESPACE, TOOLPATHARCS_ATTRIBUTE) != 0;
+    }
+    catch (Lib3MF::ELib3MFException &) {
+        return false;
+    }
+}
+
+/*************************************************************************************************************************
+ Class CToolpathArcFitter
+**************************************************************************************************************************/
+
+CToolpathArcFitter::CToolpathArcFitter()
+    : m_dTolerance(1.0), m_dFactorTolerance(0.0)
+{
+    ResetReport();
+}
+
+void CToolpathArcFitter::SetTolerance(double dTolerance, double dFactorTolerance)
+{
+    if (!(dTolerance > 0.0) || std::isinf(dTolerance))
+        throw std::invalid_argument("invalid arc tolerance");
+    if (!(dFactorTolerance >= 0.0) || std::isinf(dFactorTolerance))
+        throw std::invalid_argument("invalid factor tolerance");
+
+    m_dTolerance = dTolerance;
+    m_dFactorTolerance = dFactorTolerance;
+}
+
+void CToolpathArcFitter::ResetReport()
+{
+    m_Report.m_nCurveCount = 0;
+    m_Report.m_nArcPathCount = 0;
+    m_Report.m_nInputPointCount = 0;
+    m_Report.m_nOutputPointCount = 0;
+    m_Report.m_nArcCount = 0;
+    m_Report.m_nLineCount = 0;
+}
+
+bool CToolpathArcFitter::factorsFit(const double * pFactors, size_t nPointCount, size_t nFirst, size_t nLast) const
+{
+    if (pFactors == nullptr)
+        return true;
+
+    // Factors are interpolated along the curve between the end points of the element
+    double dFirstFactor = pFactors[nFirst % nPointCount];
+    double dLastFactor = pFactors[nLast % nPointCount];
+    double dLength = m_ArcLengths[nLast] - m_ArcLengths[nFirst];
+    double dTolerance = std::max(m_dFactorTolerance, ARCFITTER_MINFACTORTOLERANCE);
+    for (size_t nIndex = nFirst + 1; nIndex < nLast; nIndex++) {
+        double dU = (dLength > 0.0) ? (m_ArcLengths[nIndex] - m_ArcLengths[nFirst]) / dLength : 0.0;
+        if (std::fabs(pFactors[nIndex] - ((1.0 - dU) * dFirstFactor + dU * dLastFactor)) > dTolerance)
+            return false;
+    }
+    return true;
+}
+
+bool CToolpathArcFitter::lineFits(const double * pFactors, size_t nPointCount, size_t nFirst, size_t nLast, double dTolerance) const
+{
+    const double * pFirst = &m_Coordinates[2 * nFirst];
+    double dDX = m_Coordinates[2 * nLast] - pFirst[0];
+    double dDY = m_Coordinates[2 * nLast + 1] - pFirst[1];
+    double dLengthSquared = dDX * dDX + dDY * dDY;
+    for (size_t nIndex = nFirst + 1; nIndex < nLast; nIndex++) {
+        double dPX = m_Coordinates[2 * nIndex] - pFirst[0];
+        double dPY = m_Coordinates[2 * nIndex + 1] - pFirst[1];
+        if (dLengthSquared > 0.0) {
+            double dT = std::min(1.0, std::max(0.0, (dPX * dDX + dPY * dDY) / dLengthSquared));
+            dPX -= dT * dDX;
+            dPY -= dT * dDY;
+        }
+        if (dPX * dPX + dPY * dPY > dTolerance * dTolerance)
+            return false;
+    }
+
+    return factorsFit(pFactors, nPointCount, nFirst, nLast);
+}
+
+bool CToolpathArcFitter::arcFits(const double * pFactors, size_t nPointCount, size_t nFirst, size_t nLast, double dTolerance, bool bDiscrete, sFitElement & element) const
+{
+    const double * pFirst = &m_Coordinates[2 * nFirst];
+    const double * pLast = &m_Coordinates[2 * nLast];
+
+    // The arc through the middle point defines the through point, which is rounded to the units of the path
+    double dCenterX, dCenterY, dRadius, dStartAngle, dSweepAngle;
+    if (!arcThroughPoints(pFirst, &m_Coordinates[2 * ((nFirst + nLast) / 2)], pLast, dCenterX, dCenterY, dRadius, dStartAngle, dSweepAngle))
+        return false;
+    if (std::fabs(dSweepAngle) > ARCFITTER_MAXSWEEP)
+        return false;
+
+    double dThrough[2];
+    dThrough[0] = dCenterX + dRadius * std::cos(dStartAngle + 0.5 * dSweepAngle);
+    dThrough[1] = dCenterY + dRadius * std::sin(dStartAngle + 0.5 * dSweepAngle);
+    if (bDiscrete) {
+        dThrough[0] = (double)std::lround(dThrough[0]);
+        dThrough[1] = (double)std::lround(dThrough[1]);
+    }
+    else {
+        dThrough[0] = (double)(float)dThrough[0];
+        dThrough[1] = (double)(float)dThrough[1];
+    }
+    if (((dThrough[0] == pFirst[0]) && (dThrough[1] == pFirst[1])) || ((dThrough[0] == pLast[0]) && (dThrough[1] == pLast[1])))
+        return false;
+
+    // Points are checked against the arc as a reader reconstructs it
+    if (!arcThroughPoints(pFirst, dThrough, pLast, dCenterX, dCenterY, dRadius, dStartAngle, dSweepAngle))
+        return false;
+
+    double dDirection = (dSweepAngle > 0.0) ? 1.0 : -1.0;
+    double dSweep = std::fabs(dSweepAngle);
+    double dAngleTolerance = dTolerance / dRadius;
+    double dPreviousAngle = 0.0;
+    for (size_t nIndex = nFirst + 1; nIndex <= nLast; nIndex++) {
+        const double * pPoint = &m_Coordinates[2 * nIndex];
+        const double * pPrevious = pPoint - 2;
+
+        // Chords between neighbouring points bulge out by their sagitta
+        double dChordX = pPoint[0] - pPrevious[0];
+        double dChordY = pPoint[1] - pPrevious[1];
+        if ((dChordX * dChordX + dChordY * dChordY) / (8.0 * dRadius) > dTolerance)
+            return false;
+        if (nIndex == nLast)
+            break;
+
+        double dX = pPoint[0] - dCenterX;
+        double dY = pPoint[1] - dCenterY;
+        if (std::fabs(std::sqrt(dX * dX + dY * dY) - dRadius) > dTolerance)
+            return false;
+
+        // Points have to advance along the arc
+        double dAngle = normalizeAngle(dDirection * (std::atan2(dY, dX) - dStartAngle));
+        if (dAngle > s_dPi + 0.5 * dSweep)
+            dAngle -= 2.0 * s_dPi;
+        if ((dAngle < dPreviousAngle - dAngleTolerance) || (dAngle > dSweep + dAngleTolerance))
+            return false;
+        dPreviousAngle = std::max(dPreviousAngle, dAngle);
+    }
+
+    if (!factorsFit(pFactors, nPointCount, nFirst, nLast))
+        return false;
+
+    element.m_nEnd = nLast;
+    element.m_dThroughX = dThrough[0];
+    element.m_dThroughY = dThrough[1];
+    element.m_bLine = false;
+    return true;
+}
+
+size_t CToolpathArcFitter::growElement(const double * pFactors, size_t nPointCount, size_t nFirst, size_t nLast, double dTolerance, bool bDiscrete, bool bLine, sFitElement & element) const
+{
+    size_t nMinLength = bLine ? 1 : 2;
+    if (nLast - nFirst < nMinLength)
+        return nFirst;
+
+    // Short arcs through rounded points may fail where longer ones fit, so the length is doubled up to the end of the
+    // curve before the last fitting end is bisected between the longest fitting and the next failing length
+    sFitElement candidate;
+    size_t nGood = nFirst;
+    size_t nBad = nLast + 1;
+    size_t nLength = nMinLength;
+    while (true) {
+        size_t nEnd = std::min(nFirst + nLength, nLast);
+        bool bFits = bLine ? lineFits(pFactors, nPointCount, nFirst, nEnd, dTolerance) : arcFits(pFactors, nPointCount, nFirst, nEnd, dTolerance, bDiscrete, candidate);
+        if (bFits) {
+            nGood = nEnd;
+            nBad = nLast + 1;
+            if (!bLine)
+                element = candidate;
+        }
+        else if (nBad > nLast) {
+            nBad = nEnd;
+        }
+        if (nEnd == nLast)
+            break;
+        nLength *= 2;
+    }
+    if (nGood == nFirst)
+        return nFirst;
+
+    while (nBad - nGood > 1) {
+        size_t nEnd = nGood + (nBad - nGood) / 2;
+        bool bFits = bLine ? lineFits(pFactors, nPointCount, nFirst, nEnd, dTolerance) : arcFits(pFactors, nPointCount, nFirst, nEnd, dTolerance, bDiscrete, candidate);
+        if (bFits) {
+            nGood = nEnd;
+            if (!bLine)
+                element = candidate;
+        }
+        else {
+            nBad = nEnd;
+        }
+    }
+
+    if (bLine) {
+        element.m_nEnd = nGood;
+        element.m_dThroughX = m_Coordinates[2 * nFirst];
+        element.m_dThroughY = m_Coordinates[2 * nFirst + 1];
+        element.m_bLine = true;
+    }
+    return nGood;
+}
+
+template <typename T> bool CToolpathArcFitter::fit(const T * pPoints, const double * pFactors, size_t nPointCount, bool bClosed, double dScale,
+    std::vector<T> & arcPoints, std::vector<double> & arcFactors)
+{
+    if ((pPoints == nullptr) && (nPointCount > 0))
+        throw std::invalid_argument("invalid curve points");
+
+    arcPoints.clear();
+    arcFactors.clear();
+    m_Report.m_nCurveCount++;
+    m_Report.m_nInputPointCount += nPointCount;
+    if (nPointCount < 3) {
+        m_Report.m_nOutputPointCount += nPointCount;
+        return false;
+    }
+
+    size_t nLast = bClosed ? nPointCount : nPointCount - 1;
+    m_Coordinates.resize(2 * (nLast + 1));
+    for (size_t nIndex = 0; nIndex <= nLast; nIndex++) {
+        const T & point = pPoints[(nIndex < nPointCount) ? nIndex : 0];
+        m_Coordinates[2 * nIndex] = (double)point.m_Coordinates[0];
+        m_Coordinates[2 * nIndex + 1] = (double)point.m_Coordinates[1];
+    }
+
+    if (pFactors != nullptr) {
+        m_ArcLengths.resize(nLast + 1);
+        m_ArcLengths[0] = 0.0;
+        for (size_t nIndex = 1; nIndex <= nLast; nIndex++) {
+            double dDX = m_Coordinates[2 * nIndex] - m_Coordinates[2 * nIndex - 2];
+            double dDY = m_Coordinates[2 * nIndex + 1] - m_Coordinates[2 * nIndex - 1];
+            m_ArcLengths[nIndex] = m_ArcLengths[nIndex - 1] + std::sqrt(dDX * dDX + dDY * dDY);
+        }
+    }
+
+    // Lines always cover at least the next point, so every step advances
+    bool bDiscrete = std::is_same<T, Lib3MF::sDiscretePosition2D>::value;
+    double dTolerance = m_dTolerance * dScale;
+    m_Elements.clear();
+    size_t nStart = 0;
+    while (nStart < nLast) {
+        sFitElement line, arc;
+        size_t nLineEnd = growElement(pFactors, nPointCount, nStart, nLast, dTolerance, bDiscrete, true, line);
+        size_t nArcEnd = growElement(pFactors, nPointCount, nStart, nLast, dTolerance, bDiscrete, false, arc);
+        m_Elements.push_back((nArcEnd > nLineEnd) ? arc : line);
+        nStart = m_Elements.back().m_nEnd;
+    }
+
+    size_t nArcPointCount = bClosed ? 2 * m_Elements.size() : 2 * m_Elements.size() + 1;
+    if (nArcPointCount >= nPointCount) {
+        m_Report.m_nOutputPointCount += nPointCount;
+        return false;
+    }
+
+    arcPoints.reserve(nArcPointCount);
+    if (pFactors != nullptr)
+        arcFactors.reserve(nArcPointCount);
+    nStart = 0;
+    for (auto & element : m_Elements) {
+        T through;
+        setCoordinates(through, element.m_dThroughX, element.m_dThroughY);
+        arcPoints.push_back(pPoints[nStart]);
+        arcPoints.push_back(element.m_bLine ? pPoints[nStart] : through);
+        if (pFactors != nullptr) {
+            double dStartFactor = pFactors[nStart];
+            arcFactors.push_back(dStartFactor);
+            arcFactors.push_back(element.m_bLine ? dStartFactor : 0.5 * (dStartFactor + pFactors[element.m_nEnd % nPointCount]));
+        }
+
+        if (element.m_bLine)
+            m_Report.m_nLineCount++;
+        else
+            m_Report.m_nArcCount++;
+        nStart = element.m_nEnd;
+    }
+    if (!bClosed) {
+        arcPoints.push_back(pPoints[nLast]);
+        if (pFactors != nullptr)
+            arcFactors.push_back(pFactors[nLast]);
+    }
+
+    m_Report.m_nArcPathCount++;
+    m_Report.m_nOutputPointCount += nArcPointCount;
+    return true;
+}
+
+bool CToolpathArcFitter::Fit(const Lib3MF::sDiscretePosition2D * pPoints, const double * pFactors, size_t nPointCount, bool bClosed,
+    std::vector<Lib3MF::sDiscretePosition2D> & arcPoints, std::vector<double> & arcFactors)
+{
+    return fit(pPoints, pFactors, nPointCount, bClosed, 1.0, arcPoints, arcFactors);
+}
+
+bool CToolpathArcFitter::FitInModelUnits(const Lib3MF::sPosition2D * pPoints, const double * pFactors, size_t nPointCount, bool bClosed, double dUnits,
+    std::vector<Lib3MF::sPosition2D> & arcPoints, std::vector<double> & arcFactors)
+{
+    if (!(dUnits > 0.0))
+        throw std::invalid_argument("invalid units");
+
+    return fit(pPoints, pFactors, nPointCount, bClosed, dUnits, arcPoints, arcFactors);
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,270 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#ifndef __TOOLPATHEXAMPLE_ARCFITTER
+#define __TOOLPATHEXAMPLE_ARCFITTER
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+
+// Integer segment attribute that marks loops and polylines holding an arc path
+#define TOOLPATHARCS_NAMESPACE "urn:toolpathexample:arcpath:2025"
+#define TOOLPATHARCS_PREFIX "arcs"
+#define TOOLPATHARCS_ATTRIBUTE "arcpath"
+
+namespace ToolpathExample {
+
+/**
+* Arc or line of an arc path. Coordinates are given in the units of the path points, angles in degrees.
+*/
+typedef struct sToolpathArcElement {
+    double m_dStartX;
+    double m_dStartY;
+    double m_dEndX;
+    double m_dEndY;
+    double m_dCenterX;                  // Center and radius are 0 for lines
+    double m_dCenterY;
+    double m_dRadius;
+    double m_dStartAngle;               // Direction from the center to the start point
+    double m_dSweepAngle;               // Positive counterclockwise, 0 for lines
+    double m_dStartFactor;              // Factors change linearly along the element
+    double m_dEndFactor;
+    bool m_bLine;
+} sToolpathArcElement;
+
+/**
+* Point counts of the curves passed to a CToolpathArcFitter since its report was reset.
+*/
+typedef struct sToolpathArcFitReport {
+    uint64_t m_nCurveCount;
+    uint64_t m_nArcPathCount;           // Curves that are written as arc paths
+    uint64_t m_nInputPointCount;
+    uint64_t m_nOutputPointCount;       // Points of the arc paths and of the curves that are written unchanged
+    uint64_t m_nArcCount;
+    uint64_t m_nLineCount;
+} sToolpathArcFitReport;
+
+/*************************************************************************************************************************
+ Class CToolpathArcPath
+
+ Reads arc paths. lib3mf has no arc segments, so arcs are stored as loop or polyline segments with the integer
+ segment attribute TOOLPATHARCS_ATTRIBUTE set to 1. Their points alternate between end points and through points:
+ element i runs from point 2i through point 2i+1 to point 2i+2, and the last element of a loop ends at point 0. A
+ through point equal to the start point marks a line, any other through point defines the circular arc through the
+ three points. Read as plain points, an arc path is a coarse polygon that cuts into every arc. lib3mf loads packages
+ with arc paths like any other, also if the namespace is marked as required, so readers have to register the attribute
+ and check every loop and polyline with IsArcPath.
+**************************************************************************************************************************/
+class CToolpathArcPath {
+private:
+    std::vector<double> m_Coordinates;
+    std::vector<double> m_Factors;
+    size_t m_nElementCount;
+    bool m_bClosed;
+
+public:
+
+    /**
+    * CToolpathArcPath::CToolpathArcPath - Creates an empty path.
+    */
+    CToolpathArcPath();
+
+    /**
+    * CToolpathArcPath::SetDiscretePoints - Sets the points of an arc path in toolpath units.
+    * @param[in] pPoints - Points as written to the segment
+    * @param[in] pFactors - Factor of every point, nullptr for a path without factors
+    * @param[in] nPointCount - Number of points, even for loops and odd for polylines
+    * @param[in] bClosed - true for a loop, false for a polyline
+    */
+    void SetDiscretePoints(const Lib3MF::sDiscretePosition2D * pPoints, const double * pFactors, size_t nPointCount, bool bClosed);
+
+    /**
+    * CToolpathArcPath::SetPoints - Sets the points of an arc path in model units.
+    * @param[in] pPoints - Points as written to the segment
+    * @param[in] pFactors - Factor of every point, nullptr for a path without factors
+    * @param[in] nPointCount - Number of points, even for loops and odd for polylines
+    * @param[in] bClosed - true for a loop, false for a polyline
+    */
+    void SetPoints(const Lib3MF::sPosition2D * pPoints, const double * pFactors, size_t nPointCount, bool bClosed);
+
+    size_t GetElementCount() const { return m_nElementCount; }
+    bool IsClosed() const { return m_bClosed; }
+
+    /**
+    * CToolpathArcPath::GetElement - Returns an arc or line of the path.
+    * @param[in] nElementIndex - Element index
+    * @param[out] element - Receives the element
+    */
+    void GetElement(size_t nElementIndex, sToolpathArcElement & element) const;
+
+    /**
+    * CToolpathArcPath::Tessellate - Approximates the path by points, for consumers without circular interpolation.
+    * @param[in] dTolerance - Largest distance of the chords from the arcs in the units of the path
+    * @param[out] points - Receives the points, loops do not repeat their first point
+    * @param[out] factors - Receives the factor of every point
+    */
+    void Tessellate(double dTolerance, std::vector<Lib3MF::sPosition2D> & points, std::vector<double> & factors) const;
+
+    /**
+    * CToolpathArcPath::RegisterAttribute - Registers the arc path attribute. Has to be called before layers are added
+    *   to or read from the toolpath.
+    * @param[in] pToolpath - Toolpath
+    */
+    static void RegisterAttribute(Lib3MF::PToolpath pToolpath);
+
+    /**
+    * CToolpathArcPath::RegisterNamespace - Registers the arc path namespace with a writer and marks it as required.
+    *   This lists it among the required extensions of the model, which tells consumers that check that list that the
+    *   segments can not be read as plain points. lib3mf itself does not reject such packages when reading.
+    * @param[in] pWriter - Writer of the package
+    */
+    static void RegisterNamespace(Lib3MF::PWriter pWriter);
+
+    /**
+    * CToolpathArcPath::SetSegmentAttribute - Marks the following segments of a layer as arc paths or plain segments.
+    * @param[in] pLayer - Layer data
+    * @param[in] bArcPath - true for arc paths
+    */
+    static void SetSegmentAttribute(Lib3MF::PToolpathLayerData pLayer, bool bArcPath);
+
+    /**
+    * CToolpathArcPath::IsArcPath - Returns whether a segment holds an arc path.
+    * @param[in] pLayerReader - Layer reader of a toolpath with registered attribute
+    * @param[in] nSegmentIndex - Segment index
+    * @return false for segments without the attribute
+    */
+    static bool IsArcPath(Lib3MF::PToolpathLayerReader pLayerReader, uint32_t nSegmentIndex);
+
+};
+
+/*************************************************************************************************************************
+ Class CToolpathArcFitter
+
+ Replaces runs of loop and polyline points by circular arcs and lines. Every point of a run lies within the tolerance
+ of its element, the chords between neighbouring points stay within the tolerance of an arc, and the factor of every
+ point differs by at most the factor tolerance from the factor interpolated along the element. Elements are grown
+ greedily from the first point; the element that covers more points wins, lines win ties. Through points are rounded
+ to the units of the path before the arc is checked, so the stored arc meets the tolerance.
+ Curves are only written as arc paths if that needs fewer points. One fitter should be used per thread.
+**************************************************************************************************************************/
+class CToolpathArcFitter {
+private:
+    typedef struct sFitElement {
+        size_t m_nEnd;
+        double m_dThroughX;
+        double m_dThroughY;
+        bool m_bLine;
+    } sFitElement;
+
+    double m_dTolerance;
+    double m_dFactorTolerance;
+    sToolpathArcFitReport m_Report;
+
+    // Scratch storage, closed curves repeat their first point at the end
+    std::vector<double> m_Coordinates;
+    std::vector<double> m_ArcLengths;
+    std::vector<sFitElement> m_Elements;
+
+    template <typename T> bool fit(const T * pPoints, const double * pFactors, size_t nPointCount, bool bClosed, double dScale, std::vector<T> & arcPoints, std::vector<double> & arcFactors);
+    bool factorsFit(const double * pFactors, size_t nPointCount, size_t nFirst, size_t nLast) const;
+    bool lineFits(const double * pFactors, size_t nPointCount, size_t nFirst, size_t nLast, double dTolerance) const;
+    bool arcFits(const double * pFactors, size_t nPointCount, size_t nFirst, size_t nLast, double dTolerance, bool bDiscrete, sFitElement & element) const;
+    size_t growElement(const double * pFactors, size_t nPointCount, size_t nFirst, size_t nLast, double dTolerance, bool bDiscrete, bool bLine, sFitElement & element) const;
+
+public:
+
+    /**
+    * CToolpathArcFitter::CToolpathArcFitter - Creates a fitter with a tolerance of one toolpath unit.
+    */
+    CToolpathArcFitter();
+
+    /**
+    * CToolpathArcFitter::SetTolerance - Sets the allowed deviation of the arc path.
+    * @param[in] dTolerance - Largest distance of a point from its element in toolpath units
+    * @param[in] dFactorTolerance - Largest difference of the factor of a point from the interpolated factor
+    */
+    void SetTolerance(double dTolerance, double dFactorTolerance);
+
+    double GetTolerance() const { return m_dTolerance; }
+    double GetFactorTolerance() const { return m_dFactorTolerance; }
+
+    /**
+    * CToolpathArcFitter::Fit - Fits arcs to a curve in toolpath units.
+    * @param[in] pPoints - Points of the curve
+    * @param[in] pFactors - Factor of every point, nullptr for curves without factors
+    * @param[in] nPointCount - Number of points
+    * @param[in] bClosed - true for a loop, false for a polyline
+    * @param[out] arcPoints - Receives the points of the arc path
+    * @param[out] arcFactors - Receives the factors of the arc path, empty without factors
+    * @return true, if the arc path has fewer points than the curve
+    */
+    bool Fit(const Lib3MF::sDiscretePosition2D * pPoints, const double * pFactors, size_t nPointCount, bool bClosed,
+        std::vector<Lib3MF::sDiscretePosition2D> & arcPoints, std::vector<double> & arcFactors);
+
+    /**
+    * CToolpathArcFitter::FitInModelUnits - Fits arcs to a curve in model units.
+    * @param[in] pPoints - Points of the curve
+    * @param[in] pFactors - Factor of every point, nullptr for curves without factors
+    * @param[in] nPointCount - Number of points
+    * @param[in] bClosed - true for a loop, false for a polyline
+    * @param[in] dUnits - Size of a toolpath unit in model units, scales the tolerance
+    * @param[out] arcPoints - Receives the points of the arc path
+    * @param[out] arcFactors - Receives the factors of the arc path, empty without factors
+    * @return true, if the arc path has fewer points than the curve
+    */
+    bool FitInModelUnits(const Lib3MF::sPosition2D * pPoints, const double * pFactors, size_t nPointCount, bool bClosed, double dUnits,
+        std::vector<Lib3MF::sPosition2D> & arcPoints, std::vector<double> & arcFactors);
+
+    /**
+    * CToolpathArcFitter::GetReport - Returns the point counts before and after fitting.
+    * @return Counts accumulated over all curves since the last ResetReport
+    */
+    const sToolpathArcFitReport & GetReport() const { return m_Report; }
+
+    /**
+    * CToolpathArcFitter::ResetReport - Sets all counts of the report to zero.
+    */
+    void ResetReport();
+
+};
+
+typedef std::shared_ptr<CToolpathArcPath> PToolpathArcPath;
+typedef std::shared_ptr<CToolpathArcFitter> PToolpathArcFitter;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_ARCFITTER
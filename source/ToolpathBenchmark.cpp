@@ -0,0 +1,1491 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "lib3mf_dynamic.hpp"
+#include "ToolpathArcFitter.hpp"
+#include "ToolpathCoordinateCodec.hpp"
+#include "ToolpathCurveSimplifier.hpp"
+#include "ToolpathHatchClipper.hpp"
+#include "ToolpathLayerBuilder.hpp"
+#include "ToolpathLayerExtractor.hpp"
+#include "ToolpathMeshSlicer.hpp"
+#include "ToolpathPackage.hpp"
+#include "ToolpathPolygonOffsetter.hpp"
+#include "ToolpathPrefixSum.hpp"
+#include "ToolpathScanStrategy.hpp"
+#include "ToolpathSliceGenerator.hpp"
+
+// All operator new calls of the process are counted. On platforms with symbol interposition this includes
+// allocations of the C++ runtime inside the lib3mf library. Every replaced form allocates with std::malloc and
+// releases with std::free, so that memory from any of them can be passed to any operator delete.
+static std::atomic<uint64_t> s_nAllocationCount(0);
+
+static void * countedAllocate(size_t nSize) noexcept
+{
+    s_nAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc((nSize > 0) ? nSize : 1);
+}
+
+void * operator new(size_t nSize)
+{
+    void * pMemory = countedAllocate(nSize);
+    if (pMemory == nullptr)
+        throw std::bad_alloc();
+    return pMemory;
+}
+
+void * operator new[](size_t nSize)
+{
+    void * pMemory = countedAllocate(nSize);
+    if (pMemory == nullptr)
+        throw std::bad_alloc();
+    return pMemory;
+}
+
+void * operator new(size_t nSize, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(nSize);
+}
+
+void * operator new[](size_t nSize, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(nSize);
+}
+
+// GCC pairs new expressions with the std::free of the inlined replacement operator delete and reports a mismatch,
+// although both sides of the pair are the replacements above.
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 11)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void * pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void * pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete(void * pMemory, size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void * pMemory, size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete(void * pMemory, const std::nothrow_t &) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void * pMemory, const std::nothrow_t &) noexcept
+{
+    std::free(pMemory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 11)
+#pragma GCC diagnostic pop
+#endif
+
+
+typedef struct sBenchmarkResult {
+    uint64_t m_nAllocations;
+    double m_dSeconds;
+} sBenchmarkResult;
+
+sBenchmarkResult measure(const std::function<void()> & fnBenchmark)
+{
+    uint64_t nAllocationsBefore = s_nAllocationCount.load();
+    auto startTime = std::chrono::steady_clock::now();
+
+    fnBenchmark();
+
+    sBenchmarkResult result;
+    result.m_dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    result.m_nAllocations = s_nAllocationCount.load() - nAllocationsBefore;
+    return result;
+}
+
+void printPerLayer(const std::string & sName, const sBenchmarkResult & result, uint32_t nLayerCount)
+{
+    std::cout << std::left << std::setw(24) << sName << std::right << std::setw(12) << std::fixed << std::setprecision(1)
+        << (double)result.m_nAllocations / nLayerCount << " allocations/layer " << std::setw(10) << std::setprecision(3)
+        << result.m_dSeconds * 1000.0 / nLayerCount << " ms/layer" << std::endl;
+}
+
+void addResult(sBenchmarkResult & total, const sBenchmarkResult & result)
+{
+    total.m_nAllocations += result.m_nAllocations;
+    total.m_dSeconds += result.m_dSeconds;
+}
+
+Lib3MF::PToolpath openToolpath(Lib3MF::PWrapper p3MFWrapper, const std::string & sFileName, Lib3MF::PModel & pModel)
+{
+    pModel = p3MFWrapper->CreateModel();
+    auto pReader = pModel->QueryReader("3mf");
+    pReader->ReadFromFile(sFileName);
+
+    auto toolpathIterator = pModel->GetToolpaths();
+    if (!toolpathIterator->MoveNext())
+        throw std::runtime_error("no toolpath in " + sFileName);
+    return toolpathIterator->GetCurrentToolpath();
+}
+
+
+// Extracts all segments like readToolpathDemo, with fresh vectors and a profile lookup per segment
+uint64_t extractLayerNaive(Lib3MF::PToolpathLayerReader pLayerData)
+{
+    uint64_t nChecksum = 0;
+    uint32_t nSegmentCount = pLayerData->GetSegmentCount();
+    for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+        uint32_t nPointCount = 0;
+        Lib3MF::eToolpathSegmentType segmentType;
+        pLayerData->GetSegmentInfo(nSegmentIndex, segmentType, nPointCount);
+
+        std::string sProfileUUID = pLayerData->GetSegmentDefaultProfileUUID(nSegmentIndex);
+        nChecksum += sProfileUUID.size();
+
+        if ((segmentType == Lib3MF::eToolpathSegmentType::Loop) || (segmentType == Lib3MF::eToolpathSegmentType::Polyline)) {
+            std::vector<Lib3MF::sPosition2D> pointData;
+            pLayerData->GetSegmentPointDataInModelUnits(nSegmentIndex, pointData);
+            std::vector<double> factorValues;
+            pLayerData->GetSegmentPointModificationFactors(nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor::FactorF, factorValues);
+            nChecksum += pointData.size() + factorValues.size();
+        }
+        else if (segmentType == Lib3MF::eToolpathSegmentType::Hatch) {
+            std::vector<Lib3MF::sHatch2D> hatchData;
+            pLayerData->GetSegmentHatchDataInModelUnits(nSegmentIndex, hatchData);
+            std::vector<Lib3MF::sHatch2DFactors> factorValues;
+            pLayerData->GetLinearSegmentHatchModificationFactors(nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor::FactorF, factorValues);
+            nChecksum += hatchData.size() + factorValues.size();
+
+            if (pLayerData->SegmentHasNonlinearHatchModificationInterpolation(nSegmentIndex)) {
+                std::vector<Lib3MF_uint32> counts;
+                std::vector<Lib3MF::sHatchModificationInterpolationData> subInterpolationData;
+                pLayerData->GetSegmentAllNonlinearHatchesModificationInterpolation(nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor::FactorF, counts, subInterpolationData);
+                nChecksum += subInterpolationData.size();
+            }
+        }
+    }
+    return nChecksum;
+}
+
+// Extracts the same data through an extractor that is reused for all layers
+uint64_t extractLayerReused(Lib3MF::PToolpathLayerReader pLayerData, ToolpathExample::CToolpathLayerExtractor & extractor)
+{
+    extractor.SetLayer(pLayerData);
+
+    uint64_t nChecksum = 0;
+    uint32_t nSegmentCount = pLayerData->GetSegmentCount();
+    for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+        uint32_t nPointCount = 0;
+        Lib3MF::eToolpathSegmentType segmentType;
+        pLayerData->GetSegmentInfo(nSegmentIndex, segmentType, nPointCount);
+
+        nChecksum += extractor.GetSegmentProfileUUID(nSegmentIndex).size();
+
+        if ((segmentType == Lib3MF::eToolpathSegmentType::Loop) || (segmentType == Lib3MF::eToolpathSegmentType::Polyline)) {
+            nChecksum += extractor.GetPoints(nSegmentIndex).size();
+            nChecksum += extractor.GetPointFactors(nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor::FactorF).size();
+        }
+        else if (segmentType == Lib3MF::eToolpathSegmentType::Hatch) {
+            nChecksum += extractor.GetHatches(nSegmentIndex).size();
+            nChecksum += extractor.GetHatchFactors(nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor::FactorF).size();
+
+            if (pLayerData->SegmentHasNonlinearHatchModificationInterpolation(nSegmentIndex))
+                nChecksum += extractor.GetSubInterpolationData(nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor::FactorF).size();
+        }
+    }
+    return nChecksum;
+}
+
+// Allocations per layer of ReadLayerData and of extracting the segments with and without buffer reuse
+int readAllocationBenchmark(const std::vector<std::string> & arguments)
+{
+    if (arguments.size() != 2) {
+        std::cout << "usage: ToolpathBenchmark readalloc <lib3mf library> <toolpath 3mf>" << std::endl;
+        return 1;
+    }
+
+    auto p3MFWrapper = Lib3MF::CWrapper::loadLibrary(arguments[0]);
+    Lib3MF::PModel pModel;
+    auto pToolpath = openToolpath(p3MFWrapper, arguments[1], pModel);
+    uint32_t nLayerCount = pToolpath->GetLayerCount();
+    if (nLayerCount == 0)
+        throw std::runtime_error("toolpath has no layers");
+
+    ToolpathExample::CToolpathLayerExtractor extractor;
+    uint64_t nChecksumNaive = 0;
+    uint64_t nChecksumReused = 0;
+    sBenchmarkResult readResult = { 0, 0.0 };
+    sBenchmarkResult naiveResult = { 0, 0.0 };
+    sBenchmarkResult reusedResult = { 0, 0.0 };
+
+    for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++) {
+        Lib3MF::PToolpathLayerReader pLayerData;
+        addResult(readResult, measure([&]() { pLayerData = pToolpath->ReadLayerData(nLayerIndex); }));
+        addResult(naiveResult, measure([&]() { nChecksumNaive += extractLayerNaive(pLayerData); }));
+        addResult(reusedResult, measure([&]() { nChecksumReused += extractLayerReused(pLayerData, extractor); }));
+    }
+
+    if (nChecksumNaive != nChecksumReused)
+        throw std::runtime_error("extraction results differ");
+
+    std::cout << nLayerCount << " layers" << std::endl;
+    printPerLayer("ReadLayerData", readResult, nLayerCount);
+    printPerLayer("extract, new buffers", naiveResult, nLayerCount);
+    printPerLayer("extract, reused buffers", reusedResult, nLayerCount);
+    return 0;
+}
+
+
+#define BENCHMARK_UNITS 0.001
+#define BENCHMARK_HATCHDISTANCE 15
+#define BENCHMARK_PARTSIZE 20000
+
+// Writes a package with a contour and a block of hatches per layer, either in model units or in toolpath units
+std::vector<uint8_t> writeSyntheticToolpath(Lib3MF::PWrapper p3MFWrapper, bool bDiscrete, uint32_t nLayerCount, uint32_t nHatchCount, sBenchmarkResult & layerResult)
+{
+    auto pModel = p3MFWrapper->CreateModel();
+    auto pToolpath = pModel->AddToolpathWithBottomZ(BENCHMARK_UNITS, 0);
+    auto pProfile = pToolpath->AddProfile("benchmark_profile");
+    pProfile->SetParameterDoubleValue("", "laserpower", 200.0);
+    pProfile->SetParameterDoubleValue("", "laserspeed", 800.0);
+
+    std::vector<Lib3MF::sPosition> vertices = { { 0.0f, 0.0f, 0.0f }, { 20.0f, 0.0f, 0.0f }, { 0.0f, 20.0f, 0.0f }, { 0.0f, 0.0f, 20.0f } };
+    std::vector<Lib3MF::sTriangle> triangles = { { 2, 1, 0 }, { 0, 1, 3 }, { 1, 2, 3 }, { 2, 0, 3 } };
+    auto pMeshObject = pModel->AddMeshObject();
+    pMeshObject->SetGeometry(vertices, triangles);
+    auto pBuildItem = pModel->AddBuildItem(pMeshObject.get(), p3MFWrapper->GetIdentityTransform());
+
+    auto pWriter = pModel->QueryWriter("3mf");
+    ToolpathExample::CToolpathLayerBuilder layerBuilder;
+
+    for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++) {
+        addResult(layerResult, measure([&]() {
+            auto pLayer = pToolpath->AddLayer((nLayerIndex + 1) * 50, "/Toolpath/layer" + std::to_string(nLayerIndex + 1) + ".xml", pWriter);
+            uint32_t nProfileID = pLayer->RegisterProfile(pProfile);
+            uint32_t nPartID = pLayer->RegisterBuildItem(pBuildItem);
+
+            int32_t nContour[4][2] = { { 0, 0 }, { BENCHMARK_PARTSIZE, 0 }, { BENCHMARK_PARTSIZE, BENCHMARK_PARTSIZE }, { 0, BENCHMARK_PARTSIZE } };
+            layerBuilder.Reset();
+            for (uint32_t nPointIndex = 0; nPointIndex < 4; nPointIndex++) {
+                if (bDiscrete)
+                    layerBuilder.AddDiscretePoint(nContour[nPointIndex][0], nContour[nPointIndex][1], 1.0);
+                else
+                    layerBuilder.AddPoint((float)(nContour[nPointIndex][0] * BENCHMARK_UNITS), (float)(nContour[nPointIndex][1] * BENCHMARK_UNITS), 1.0);
+            }
+            layerBuilder.WriteLoop(pLayer, nProfileID, nPartID);
+
+            for (uint32_t nHatchIndex = 0; nHatchIndex < nHatchCount; nHatchIndex++) {
+                int32_t nY = (int32_t)(nHatchIndex * BENCHMARK_HATCHDISTANCE) % BENCHMARK_PARTSIZE;
+                int32_t nX1 = (nHatchIndex % 2 == 0) ? 100 : BENCHMARK_PARTSIZE - 100;
+                int32_t nX2 = BENCHMARK_PARTSIZE - nX1;
+                if (bDiscrete)
+                    layerBuilder.AddDiscreteHatch(nX1, nY, nX2, nY, 0, 1.0, 1.0);
+                else
+                    layerBuilder.AddHatch(nX1 * BENCHMARK_UNITS, nY * BENCHMARK_UNITS, nX2 * BENCHMARK_UNITS, nY * BENCHMARK_UNITS, 0, 1.0, 1.0);
+            }
+            layerBuilder.WriteHatches(pLayer, nProfileID, nPartID);
+            pLayer->Finish();
+        }));
+    }
+
+    std::vector<uint8_t> buffer;
+    pWriter->WriteToBuffer(buffer);
+    return buffer;
+}
+
+// Reads all layers of a package and sums their coordinates in toolpath units
+uint64_t readSyntheticToolpath(Lib3MF::PWrapper p3MFWrapper, const std::vector<uint8_t> & buffer, bool bDiscrete, sBenchmarkResult & layerResult)
+{
+    auto pModel = p3MFWrapper->CreateModel();
+    pModel->QueryReader("3mf")->ReadFromBuffer(buffer);
+    auto toolpathIterator = pModel->GetToolpaths();
+    if (!toolpathIterator->MoveNext())
+        throw std::runtime_error("no toolpath written");
+    auto pToolpath = toolpathIterator->GetCurrentToolpath();
+    double dUnits = pToolpath->GetUnits();
+
+    ToolpathExample::CToolpathLayerExtractor extractor;
+    uint64_t nChecksum = 0;
+    uint32_t nLayerCount = pToolpath->GetLayerCount();
+    for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++) {
+        auto pLayerData = pToolpath->ReadLayerData(nLayerIndex);
+        extractor.SetLayer(pLayerData);
+
+        uint32_t nSegmentCount = pLayerData->GetSegmentCount();
+        for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+            uint32_t nPointCount = 0;
+            Lib3MF::eToolpathSegmentType segmentType;
+            pLayerData->GetSegmentInfo(nSegmentIndex, segmentType, nPointCount);
+
+            // Only retrieving the data is timed, the checksum just keeps it from being optimized away
+            if (segmentType == Lib3MF::eToolpathSegmentType::Hatch) {
+                if (bDiscrete) {
+                    const std::vector<Lib3MF::sDiscreteHatch2D> * pHatches = nullptr;
+                    addResult(layerResult, measure([&]() { pHatches = &extractor.GetDiscreteHatches(nSegmentIndex); }));
+                    for (auto & hatch : *pHatches)
+                        nChecksum += (uint64_t)(hatch.m_Point1Coordinates[0] + hatch.m_Point1Coordinates[1] + hatch.m_Point2Coordinates[0] + hatch.m_Point2Coordinates[1]);
+                }
+                else {
+                    const std::vector<Lib3MF::sHatch2D> * pHatches = nullptr;
+                    addResult(layerResult, measure([&]() { pHatches = &extractor.GetHatches(nSegmentIndex); }));
+                    for (auto & hatch : *pHatches)
+                        nChecksum += (uint64_t)std::llround((hatch.m_Point1Coordinates[0] + hatch.m_Point1Coordinates[1] + hatch.m_Point2Coordinates[0] + hatch.m_Point2Coordinates[1]) / dUnits);
+                }
+            }
+            else {
+                if (bDiscrete) {
+                    const std::vector<Lib3MF::sDiscretePosition2D> * pPoints = nullptr;
+                    addResult(layerResult, measure([&]() { pPoints = &extractor.GetDiscretePoints(nSegmentIndex); }));
+                    for (auto & point : *pPoints)
+                        nChecksum += (uint64_t)(point.m_Coordinates[0] + point.m_Coordinates[1]);
+                }
+                else {
+                    const std::vector<Lib3MF::sPosition2D> * pPoints = nullptr;
+                    addResult(layerResult, measure([&]() { pPoints = &extractor.GetPoints(nSegmentIndex); }));
+                    for (auto & point : *pPoints)
+                        nChecksum += (uint64_t)std::llround((point.m_Coordinates[0] + point.m_Coordinates[1]) / dUnits);
+                }
+            }
+        }
+    }
+    return nChecksum;
+}
+
+// Time per layer of writing and retrieving toolpath data in model units and in discrete toolpath units
+int discreteUnitsBenchmark(const std::vector<std::string> & arguments)
+{
+    if ((arguments.size() < 1) || (arguments.size() > 3)) {
+        std::cout << "usage: ToolpathBenchmark discrete <lib3mf library> [layer count] [hatches per layer]" << std::endl;
+        return 1;
+    }
+
+    uint32_t nLayerCount = (arguments.size() > 1) ? (uint32_t)std::stoul(arguments[1]) : 20;
+    uint32_t nHatchCount = (arguments.size() > 2) ? (uint32_t)std::stoul(arguments[2]) : 20000;
+    if (nLayerCount == 0)
+        throw std::runtime_error("invalid layer count");
+
+    auto p3MFWrapper = Lib3MF::CWrapper::loadLibrary(arguments[0]);
+
+    sBenchmarkResult writeModelResult = { 0, 0.0 };
+    sBenchmarkResult writeDiscreteResult = { 0, 0.0 };
+    sBenchmarkResult readModelResult = { 0, 0.0 };
+    sBenchmarkResult readDiscreteResult = { 0, 0.0 };
+
+    auto modelBuffer = writeSyntheticToolpath(p3MFWrapper, false, nLayerCount, nHatchCount, writeModelResult);
+    auto discreteBuffer = writeSyntheticToolpath(p3MFWrapper, true, nLayerCount, nHatchCount, writeDiscreteResult);
+    uint64_t nChecksumModel = readSyntheticToolpath(p3MFWrapper, modelBuffer, false, readModelResult);
+    uint64_t nChecksumDiscrete = readSyntheticToolpath(p3MFWrapper, discreteBuffer, true, readDiscreteResult);
+
+    if (nChecksumModel != nChecksumDiscrete)
+        throw std::runtime_error("model unit and toolpath unit results differ");
+
+    std::cout << nLayerCount << " layers, " << nHatchCount << " hatches per layer" << std::endl;
+    printPerLayer("write, model units", writeModelResult, nLayerCount);
+    printPerLayer("write, toolpath units", writeDiscreteResult, nLayerCount);
+    printPerLayer("get, model units", readModelResult, nLayerCount);
+    printPerLayer("get, toolpath units", readDiscreteResult, nLayerCount);
+    return 0;
+}
+
+
+// Unidirectional hatches with constant start and end X and a fixed pitch, tagged like the hatches of writeToolpathDemo
+void generateStripeHatches(size_t nHatchCount, std::vector<Lib3MF::sDiscreteHatch2D> & hatches)
+{
+    hatches.resize(nHatchCount);
+    for (size_t nHatchIndex = 0; nHatchIndex < nHatchCount; nHatchIndex++) {
+        Lib3MF::sDiscreteHatch2D & hatch = hatches[nHatchIndex];
+        int32_t nY = (int32_t)((nHatchIndex % 1000) * BENCHMARK_HATCHDISTANCE);
+        hatch.m_Point1Coordinates[0] = 100;
+        hatch.m_Point1Coordinates[1] = nY;
+        hatch.m_Point2Coordinates[0] = BENCHMARK_PARTSIZE - 100;
+        hatch.m_Point2Coordinates[1] = nY;
+        hatch.m_Tag = (nHatchIndex % 2 == 0) ? (int32_t)(nHatchIndex % 1000) * 2 + 5 : 0;
+    }
+}
+
+// Meander hatches with 0.1mm pitch across a cylinder with a hole, rotated by 67 degrees from layer to layer
+void generateRotatedHatches(size_t nHatchCount, std::vector<Lib3MF::sDiscreteHatch2D> & hatches)
+{
+    const double dOuterRadius = 25000.0;
+    const double dInnerRadius = 8000.0;
+    const double dPitch = 100.0;
+
+    hatches.clear();
+    hatches.reserve(nHatchCount);
+    for (uint32_t nLayerIndex = 0; hatches.size() < nHatchCount; nLayerIndex++) {
+        double dAngle = nLayerIndex * 67.0 * 3.14159265358979 / 180.0;
+        double dDirX = cos(dAngle);
+        double dDirY = sin(dAngle);
+
+        uint32_t nLineIndex = 0;
+        for (double dOffset = -dOuterRadius + dPitch * 0.5; (dOffset < dOuterRadius) && (hatches.size() < nHatchCount); dOffset += dPitch, nLineIndex++) {
+            double dOuter = sqrt(dOuterRadius * dOuterRadius - dOffset * dOffset);
+            double dInner = (fabs(dOffset) < dInnerRadius) ? sqrt(dInnerRadius * dInnerRadius - dOffset * dOffset) : 0.0;
+
+            double intervals[2][2] = { { -dOuter, -dInner }, { dInner, dOuter } };
+            uint32_t nIntervalCount = 2;
+            if (dInner == 0.0) {
+                intervals[0][1] = dOuter;
+                nIntervalCount = 1;
+            }
+
+            bool bReverse = (nLineIndex % 2) == 1;
+            for (uint32_t nInterval = 0; (nInterval < nIntervalCount) && (hatches.size() < nHatchCount); nInterval++) {
+                const double * pInterval = intervals[bReverse ? (nIntervalCount - 1 - nInterval) : nInterval];
+                double dStart = bReverse ? pInterval[1] : pInterval[0];
+                double dEnd = bReverse ? pInterval[0] : pInterval[1];
+
+                Lib3MF::sDiscreteHatch2D hatch;
+                hatch.m_Point1Coordinates[0] = (int32_t)std::lround(dStart * dDirX - dOffset * dDirY);
+                hatch.m_Point1Coordinates[1] = (int32_t)std::lround(dStart * dDirY + dOffset * dDirX);
+                hatch.m_Point2Coordinates[0] = (int32_t)std::lround(dEnd * dDirX - dOffset * dDirY);
+                hatch.m_Point2Coordinates[1] = (int32_t)std::lround(dEnd * dDirY + dOffset * dDirX);
+                hatch.m_Tag = 0;
+                hatches.push_back(hatch);
+            }
+        }
+    }
+}
+
+typedef struct sCodecResult {
+    std::string m_sName;
+    uint64_t m_nSize;
+    double m_dEncodeSeconds;
+    double m_dDecodeSeconds;
+} sCodecResult;
+
+// Encodes and decodes repeatedly and checks that the hatches are restored exactly
+sCodecResult measureCodec(const std::string & sName, const std::vector<Lib3MF::sDiscreteHatch2D> & hatches, uint32_t nRepetitions,
+    const std::function<void(std::vector<uint8_t> & encoded)> & fnEncode, const std::function<void(const std::vector<uint8_t> & encoded, std::vector<Lib3MF::sDiscreteHatch2D> & decoded)> & fnDecode)
+{
+    std::vector<uint8_t> encoded;
+    std::vector<Lib3MF::sDiscreteHatch2D> decoded;
+
+    sCodecResult result;
+    result.m_sName = sName;
+    result.m_dEncodeSeconds = measure([&]() {
+        for (uint32_t nRepetition = 0; nRepetition < nRepetitions; nRepetition++)
+            fnEncode(encoded);
+    }).m_dSeconds;
+    result.m_dDecodeSeconds = measure([&]() {
+        for (uint32_t nRepetition = 0; nRepetition < nRepetitions; nRepetition++)
+            fnDecode(encoded, decoded);
+    }).m_dSeconds;
+    result.m_nSize = encoded.size();
+
+    if ((decoded.size() != hatches.size()) || (memcmp(decoded.data(), hatches.data(), hatches.size() * sizeof(Lib3MF::sDiscreteHatch2D)) != 0))
+        throw std::runtime_error(sName + " does not restore the hatches");
+
+    return result;
+}
+
+// Compressed size and encode and decode throughput of hatch coordinates with the coordinate codec and with deflate
+int coordinateCodecBenchmark(const std::vector<std::string> & arguments)
+{
+    if (arguments.size() > 1) {
+        std::cout << "usage: ToolpathBenchmark coordcodec [hatch count]" << std::endl;
+        return 1;
+    }
+
+    size_t nHatchCount = (arguments.size() > 0) ? (size_t)std::stoul(arguments[0]) : 250000;
+    const uint32_t nRepetitions = 5;
+
+    typedef std::pair<ToolpathExample::eToolpathCoordinatePrediction, std::string> PredictionName;
+    const std::vector<PredictionName> predictions = {
+        { ToolpathExample::eToolpathCoordinatePrediction::None, "none" },
+        { ToolpathExample::eToolpathCoordinatePrediction::Delta, "delta" },
+        { ToolpathExample::eToolpathCoordinatePrediction::SecondOrderDelta, "delta2" },
+        { ToolpathExample::eToolpathCoordinatePrediction::HatchPitch, "hatchpitch" },
+    };
+    typedef std::pair<ToolpathExample::eToolpathCoordinatePacking, std::string> PackingName;
+    const std::vector<PackingName> packings = {
+        { ToolpathExample::eToolpathCoordinatePacking::Varint, "varint" },
+        { ToolpathExample::eToolpathCoordinatePacking::BitPacked, "bitpacked" },
+    };
+
+    for (uint32_t nField = 0; nField < 2; nField++) {
+        std::vector<Lib3MF::sDiscreteHatch2D> hatches;
+        if (nField == 0)
+            generateStripeHatches(nHatchCount, hatches);
+        else
+            generateRotatedHatches(nHatchCount, hatches);
+
+        const uint8_t * pRawData = (const uint8_t *)hatches.data();
+        uint64_t nRawSize = hatches.size() * sizeof(Lib3MF::sDiscreteHatch2D);
+        ToolpathExample::CToolpathCoordinateCodec codec;
+        std::vector<sCodecResult> results;
+
+        for (auto & prediction : predictions) {
+            for (auto & packing : packings) {
+                results.push_back(measureCodec(prediction.second + "/" + packing.second, hatches, nRepetitions,
+                    [&](std::vector<uint8_t> & encoded) { codec.EncodeHatches(hatches.data(), hatches.size(), prediction.first, packing.first, encoded); },
+                    [&](const std::vector<uint8_t> & encoded, std::vector<Lib3MF::sDiscreteHatch2D> & decoded) { codec.DecodeHatches(encoded.data(), encoded.size(), decoded); }));
+            }
+        }
+
+#ifdef TOOLPATHEXAMPLE_USE_ZLIB
+        // Deflate as used for package entries, on the raw hatch array and behind the codec
+        ToolpathExample::sPackageCompressedEntry compressedEntry;
+        std::vector<uint8_t> inflated;
+        results.push_back(measureCodec("deflate", hatches, nRepetitions,
+            [&](std::vector<uint8_t> & encoded) {
+                ToolpathExample::CToolpathPackageWriter::CompressEntry("/hatches.bin", pRawData, nRawSize, ToolpathExample::ePackageCompressionMethod::Deflate, 6, compressedEntry);
+                encoded = compressedEntry.m_Data;
+            },
+            [&](const std::vector<uint8_t> & encoded, std::vector<Lib3MF::sDiscreteHatch2D> & decoded) {
+                ToolpathExample::CToolpathPackageReader::DecompressEntryData(compressedEntry.m_Entry, encoded, inflated);
+                decoded.resize(inflated.size() / sizeof(Lib3MF::sDiscreteHatch2D));
+                memcpy(decoded.data(), inflated.data(), decoded.size() * sizeof(Lib3MF::sDiscreteHatch2D));
+            }));
+
+        for (auto & packing : packings) {
+            std::vector<uint8_t> codecData;
+            results.push_back(measureCodec("hatchpitch/" + packing.second + "+deflate", hatches, nRepetitions,
+                [&](std::vector<uint8_t> & encoded) {
+                    codec.EncodeHatches(hatches.data(), hatches.size(), ToolpathExample::eToolpathCoordinatePrediction::HatchPitch, packing.first, codecData);
+                    ToolpathExample::CToolpathPackageWriter::CompressEntry("/hatches.bin", codecData.data(), codecData.size(), ToolpathExample::ePackageCompressionMethod::Deflate, 6, compressedEntry);
+                    encoded = compressedEntry.m_Data;
+                },
+                [&](const std::vector<uint8_t> & encoded, std::vector<Lib3MF::sDiscreteHatch2D> & decoded) {
+                    ToolpathExample::CToolpathPackageReader::DecompressEntryData(compressedEntry.m_Entry, encoded, inflated);
+                    codec.DecodeHatches(inflated.data(), inflated.size(), decoded);
+                }));
+        }
+#endif // TOOLPATHEXAMPLE_USE_ZLIB
+
+        std::cout << ((nField == 0) ? "stripe" : "rotated meander") << " hatches: " << hatches.size() << ", " << nRawSize << " bytes" << std::endl;
+        for (auto & result : results) {
+            double dMegabytes = (double)nRawSize * nRepetitions / 1.0e6;
+            std::cout << "  " << std::left << std::setw(28) << result.m_sName << std::right << std::setw(12) << result.m_nSize << " bytes"
+                << std::fixed << std::setprecision(2) << std::setw(8) << (double)nRawSize / result.m_nSize << "x"
+                << std::setprecision(0) << std::setw(8) << dMegabytes / result.m_dEncodeSeconds << " MB/s encode"
+                << std::setw(8) << dMegabytes / result.m_dDecodeSeconds << " MB/s decode" << std::endl;
+        }
+    }
+    return 0;
+}
+
+
+// Throughput of the reconstruction steps of the coordinate decoder, scalar and vectorized, and of complete decoding
+int prefixSumBenchmark(const std::vector<std::string> & arguments)
+{
+    if (arguments.size() > 1) {
+        std::cout << "usage: ToolpathBenchmark prefixsum [value count]" << std::endl;
+        return 1;
+    }
+
+    size_t nValueCount = (arguments.size() > 0) ? (size_t)std::stoul(arguments[0]) : 4000000;
+    const uint32_t nRepetitions = 20;
+
+    std::vector<uint32_t> residuals(nValueCount);
+    uint32_t nRandom = 12345;
+    for (auto & nResidual : residuals) {
+        nRandom = nRandom * 1664525 + 1013904223;
+        nResidual = nRandom >> 24;
+    }
+
+    std::vector<uint32_t> scalarValues;
+    std::vector<uint32_t> vectorValues;
+    auto printThroughput = [&](const std::string & sName, double dBytes, double dSeconds) {
+        std::cout << "  " << std::left << std::setw(28) << sName << std::right << std::fixed << std::setprecision(2)
+            << std::setw(8) << dBytes / dSeconds / 1.0e9 << " GB/s" << std::endl;
+    };
+
+    std::cout << nValueCount << " values, vector implementation: " << ToolpathExample::toolpathPrefixSumImplementation() << std::endl;
+    double dBytes = (double)nValueCount * sizeof(uint32_t) * nRepetitions;
+    for (size_t nStride = 1; nStride <= 2; nStride++) {
+        double dScalarSeconds = 0.0;
+        double dVectorSeconds = 0.0;
+        for (uint32_t nRepetition = 0; nRepetition < nRepetitions; nRepetition++) {
+            scalarValues = residuals;
+            vectorValues = residuals;
+            dScalarSeconds += measure([&]() { ToolpathExample::toolpathPrefixSumScalar(scalarValues.data(), scalarValues.size(), nStride); }).m_dSeconds;
+            dVectorSeconds += measure([&]() { ToolpathExample::toolpathPrefixSum(vectorValues.data(), vectorValues.size(), nStride); }).m_dSeconds;
+        }
+        if (scalarValues != vectorValues)
+            throw std::runtime_error("vectorized prefix sum differs from scalar prefix sum");
+
+        printThroughput("prefix sum, stride " + std::to_string(nStride) + ", scalar", dBytes, dScalarSeconds);
+        printThroughput("prefix sum, stride " + std::to_string(nStride) + ", vector", dBytes, dVectorSeconds);
+    }
+
+    double dUnzigzagSeconds = 0.0;
+    for (uint32_t nRepetition = 0; nRepetition < nRepetitions; nRepetition++) {
+        vectorValues = residuals;
+        dUnzigzagSeconds += measure([&]() { ToolpathExample::toolpathUnzigzag(vectorValues.data(), vectorValues.size()); }).m_dSeconds;
+    }
+    printThroughput("unzigzag, vector", dBytes, dUnzigzagSeconds);
+
+    // Complete decoding of hatches, measured in bytes of decoded hatch arrays
+    std::vector<Lib3MF::sDiscreteHatch2D> hatches;
+    generateRotatedHatches(nValueCount / 5, hatches);
+    ToolpathExample::CToolpathCoordinateCodec codec;
+    std::vector<uint8_t> encoded;
+    std::vector<Lib3MF::sDiscreteHatch2D> decoded;
+    double dHatchBytes = (double)hatches.size() * sizeof(Lib3MF::sDiscreteHatch2D) * nRepetitions;
+    const std::vector<std::pair<ToolpathExample::eToolpathCoordinatePacking, std::string>> packings = {
+        { ToolpathExample::eToolpathCoordinatePacking::Varint, "varint" },
+        { ToolpathExample::eToolpathCoordinatePacking::BitPacked, "bitpacked" },
+    };
+    for (auto & packing : packings) {
+        codec.EncodeHatches(hatches.data(), hatches.size(), ToolpathExample::eToolpathCoordinatePrediction::HatchPitch, packing.first, encoded);
+        double dSeconds = measure([&]() {
+            for (uint32_t nRepetition = 0; nRepetition < nRepetitions; nRepetition++)
+                codec.DecodeHatches(encoded.data(), encoded.size(), decoded);
+        }).m_dSeconds;
+        if ((decoded.size() != hatches.size()) || (memcmp(decoded.data(), hatches.data(), hatches.size() * sizeof(Lib3MF::sDiscreteHatch2D)) != 0))
+            throw std::runtime_error("decoded hatches differ");
+        printThroughput("decode hatches, " + packing.second, dHatchBytes, dSeconds);
+    }
+    return 0;
+}
+
+
+// Slice of a 40 mm square plate with an 8 x 8 grid of round holes whose radius changes with the layer, in micron
+void generatePerforatedSlice(uint32_t nLayerIndex, ToolpathExample::CToolpathSlicePolygons & slice)
+{
+    const int32_t nSize = 40000;
+    const int32_t nHoleCount = 8;
+    const uint32_t nHoleVertexCount = 48;
+    const double dPi = 3.14159265358979323846;
+
+    slice.Clear();
+    slice.BeginPolygon();
+    slice.AddVertex(0, 0);
+    slice.AddVertex(nSize, 0);
+    slice.AddVertex(nSize, nSize);
+    slice.AddVertex(0, nSize);
+    slice.EndPolygon();
+
+    double dRadius = 1500.0 + 800.0 * std::sin(nLayerIndex * 0.01);
+    double dSpacing = (double)nSize / nHoleCount;
+    for (int32_t nRow = 0; nRow < nHoleCount; nRow++) {
+        for (int32_t nColumn = 0; nColumn < nHoleCount; nColumn++) {
+            double dCenterX = (nColumn + 0.5) * dSpacing;
+            double dCenterY = (nRow + 0.5) * dSpacing;
+            slice.BeginPolygon();
+            for (uint32_t nVertex = 0; nVertex < nHoleVertexCount; nVertex++) {
+                double dAngle = -2.0 * dPi * nVertex / nHoleVertexCount;
+                slice.AddVertex((int32_t)std::lround(dCenterX + dRadius * std::cos(dAngle)), (int32_t)std::lround(dCenterY + dRadius * std::sin(dAngle)));
+            }
+            slice.EndPolygon();
+        }
+    }
+}
+
+double hatchLength(const std::vector<Lib3MF::sDiscreteHatch2D> & hatches)
+{
+    double dLength = 0.0;
+    for (auto & hatch : hatches) {
+        double dX = (double)hatch.m_Point2Coordinates[0] - hatch.m_Point1Coordinates[0];
+        double dY = (double)hatch.m_Point2Coordinates[1] - hatch.m_Point1Coordinates[1];
+        dLength += std::sqrt(dX * dX + dY * dY);
+    }
+    return dLength;
+}
+
+// Contour and hatch generation from slice polygons, single threaded and on all hardware threads
+int sliceGeneratorBenchmark(const std::vector<std::string> & arguments)
+{
+    if (arguments.size() > 1) {
+        std::cout << "usage: ToolpathBenchmark slicegen [layer count]" << std::endl;
+        return 1;
+    }
+
+    uint32_t nLayerCount = (arguments.size() > 0) ? (uint32_t)std::stoul(arguments[0]) : 1000;
+
+    ToolpathExample::sToolpathSliceGeneratorParameters parameters;
+    parameters.m_nHatchDistance = 100;
+    parameters.m_dHatchAngle = 0.0;
+    parameters.m_dHatchAngleIncrement = 67.0;
+    parameters.m_nHatchOffset = 0;
+    parameters.m_nMinHatchLength = 0;
+    parameters.m_nContourTolerance = 0;
+
+    std::vector<ToolpathExample::CToolpathSlicePolygons> slices(nLayerCount);
+    for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++)
+        generatePerforatedSlice(nLayerIndex, slices[nLayerIndex]);
+
+    // Without offsets, the hatches cover the slice area up to the rounding at the polygon boundaries
+    ToolpathExample::CToolpathSliceGenerator checkGenerator(parameters);
+    ToolpathExample::CToolpathGeneratedLayer checkLayer;
+    for (uint32_t nLayerIndex = 0; nLayerIndex < std::min<uint32_t>(nLayerCount, 10); nLayerIndex++) {
+        checkGenerator.GenerateLayer(slices[nLayerIndex], nLayerIndex, checkLayer);
+        double dRatio = hatchLength(checkLayer.GetHatches()) * parameters.m_nHatchDistance / slices[nLayerIndex].GetArea();
+        if (std::fabs(dRatio - 1.0) > 0.01)
+            throw std::runtime_error("hatches do not cover the slice area, ratio " + std::to_string(dRatio));
+    }
+
+    parameters.m_nHatchOffset = 250;
+    parameters.m_nMinHatchLength = 50;
+    parameters.m_ContourOffsets = { 50, 150 };
+    ToolpathExample::CToolpathSliceGenerator generator(parameters);
+
+    std::vector<uint32_t> threadCounts = { 1 };
+    if (std::thread::hardware_concurrency() > 1)
+        threadCounts.push_back(std::thread::hardware_concurrency());
+
+    std::cout << nLayerCount << " layers, " << slices[0].GetPolygonCount() << " polygons per slice" << std::endl;
+    std::vector<ToolpathExample::CToolpathGeneratedLayer> layers;
+    for (uint32_t nThreadCount : threadCounts) {
+        generator.SetThreadPool((nThreadCount > 1) ? std::make_shared<ToolpathExample::CToolpathThreadPool>(nThreadCount) : nullptr);
+        generator.GenerateLayers(slices, slices.size(), 0, layers);
+
+        auto result = measure([&]() { generator.GenerateLayers(slices, slices.size(), 0, layers); });
+        uint64_t nHatchCount = 0;
+        uint64_t nLoopCount = 0;
+        for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++) {
+            nHatchCount += layers[nLayerIndex].GetHatchCount();
+            nLoopCount += layers[nLayerIndex].GetLoopCount();
+        }
+
+        std::cout << "  " << std::setw(3) << nThreadCount << " threads: " << std::fixed << std::setprecision(1)
+            << std::setw(10) << nLayerCount / result.m_dSeconds << " layers/s " << std::setw(12) << nHatchCount / result.m_dSeconds << " hatches/s, "
+            << nLoopCount / nLayerCount << " loops and " << nHatchCount / nLayerCount << " hatches per layer, "
+            << (double)result.m_nAllocations / nLayerCount << " allocations/layer" << std::endl;
+    }
+    return 0;
+}
+
+
+// Slice of a lattice plate, alternately round and diamond shaped holes on a grid of 2 mm cells, in micron
+void generateLatticeSlice(uint32_t nCellCount, ToolpathExample::CToolpathSlicePolygons & slice)
+{
+    const int32_t nCellSize = 2000;
+    const uint32_t nCircleVertexCount = 32;
+    const double dPi = 3.14159265358979323846;
+    int32_t nSize = nCellSize * (int32_t)nCellCount;
+
+    slice.Clear();
+    slice.BeginPolygon();
+    slice.AddVertex(0, 0);
+    slice.AddVertex(nSize, 0);
+    slice.AddVertex(nSize, nSize);
+    slice.AddVertex(0, nSize);
+    slice.EndPolygon();
+
+    for (uint32_t nRow = 0; nRow < nCellCount; nRow++) {
+        for (uint32_t nColumn = 0; nColumn < nCellCount; nColumn++) {
+            double dCenterX = (nColumn + 0.5) * nCellSize;
+            double dCenterY = (nRow + 0.5) * nCellSize;
+            bool bCircle = ((nRow + nColumn) % 2) == 0;
+            uint32_t nVertexCount = bCircle ? nCircleVertexCount : 4;
+            double dRadius = bCircle ? 700.0 : 850.0;
+            double dPhase = bCircle ? 0.0 : 0.1 * (nRow + nColumn);
+            slice.BeginPolygon();
+            for (uint32_t nVertex = 0; nVertex < nVertexCount; nVertex++) {
+                double dAngle = dPhase - 2.0 * dPi * nVertex / nVertexCount;
+                slice.AddVertex((int32_t)std::lround(dCenterX + dRadius * std::cos(dAngle)), (int32_t)std::lround(dCenterY + dRadius * std::sin(dAngle)));
+            }
+            slice.EndPolygon();
+        }
+    }
+}
+
+// Hatch clipping of a lattice cross section at changing angles, with and without vector instructions
+int hatchClipperBenchmark(const std::vector<std::string> & arguments)
+{
+    if (arguments.size() > 2) {
+        std::cout << "usage: ToolpathBenchmark hatchclip [cells per side] [repetitions]" << std::endl;
+        return 1;
+    }
+
+    uint32_t nCellCount = (arguments.size() > 0) ? (uint32_t)std::stoul(arguments[0]) : 24;
+    uint32_t nRepetitionCount = (arguments.size() > 1) ? (uint32_t)std::stoul(arguments[1]) : 50;
+    if ((nCellCount == 0) || (nCellCount > 500) || (nRepetitionCount == 0))
+        throw std::invalid_argument("invalid benchmark arguments");
+
+    ToolpathExample::CToolpathSlicePolygons slice;
+    generateLatticeSlice(nCellCount, slice);
+    const int32_t nDistance = 50;
+
+    std::cout << slice.GetPolygonCount() << " polygons, " << slice.GetVertexCount() << " vertices, implementation "
+        << ToolpathExample::CToolpathHatchClipper::GetImplementation() << std::endl;
+
+    ToolpathExample::CToolpathHatchClipper clipper;
+    std::vector<Lib3MF::sDiscreteHatch2D> hatches;
+    std::vector<Lib3MF::sDiscreteHatch2D> referenceHatches;
+    for (bool bVectorized : { false, true }) {
+        clipper.SetVectorized(bVectorized);
+
+        // Hatches cover the slice area up to the rounding at the polygon boundaries
+        for (uint32_t nAngleIndex = 0; nAngleIndex < 8; nAngleIndex++) {
+            hatches.clear();
+            clipper.SetHatching(nAngleIndex * 67.0, nDistance);
+            clipper.Clip(slice, hatches);
+            double dRatio = hatchLength(hatches) * nDistance / slice.GetArea();
+            if (std::fabs(dRatio - 1.0) > 0.01)
+                throw std::runtime_error("hatches do not cover the slice area, ratio " + std::to_string(dRatio));
+        }
+
+        // Both paths interpolate in double precision, results may only differ by rounding
+        if (bVectorized) {
+            if (hatches.size() != referenceHatches.size())
+                throw std::runtime_error("vectorized and scalar hatch counts differ");
+            for (size_t nIndex = 0; nIndex < hatches.size(); nIndex++) {
+                for (int nCoordinate = 0; nCoordinate < 2; nCoordinate++) {
+                    if ((std::abs(hatches[nIndex].m_Point1Coordinates[nCoordinate] - referenceHatches[nIndex].m_Point1Coordinates[nCoordinate]) > 1)
+                        || (std::abs(hatches[nIndex].m_Point2Coordinates[nCoordinate] - referenceHatches[nIndex].m_Point2Coordinates[nCoordinate]) > 1))
+                        throw std::runtime_error("vectorized and scalar hatches differ");
+                }
+            }
+        }
+        else {
+            referenceHatches = hatches;
+        }
+
+        uint64_t nHatchCount = 0;
+        auto result = measure([&]() {
+            for (uint32_t nRepetition = 0; nRepetition < nRepetitionCount; nRepetition++) {
+                hatches.clear();
+                clipper.SetHatching(nRepetition * 67.0, nDistance);
+                clipper.Clip(slice, hatches);
+                nHatchCount += hatches.size();
+            }
+        });
+
+        std::cout << "  " << std::setw(10) << (bVectorized ? "vectorized" : "scalar") << ": " << std::fixed << std::setprecision(1)
+            << std::setw(10) << nRepetitionCount / result.m_dSeconds << " slices/s " << std::setw(12) << nHatchCount / result.m_dSeconds << " hatches/s, "
+            << nHatchCount / nRepetitionCount << " hatches per slice, " << (double)result.m_nAllocations / nRepetitionCount << " allocations/slice" << std::endl;
+    }
+    return 0;
+}
+
+// Stripe and chessboard hatching of a perforated plate, single threaded and on all hardware threads
+int scanStrategyBenchmark(const std::vector<std::string> & arguments)
+{
+    if (arguments.size() > 1) {
+        std::cout << "usage: ToolpathBenchmark scanstrategy [layer count]" << std::endl;
+        return 1;
+    }
+
+    uint32_t nLayerCount = (arguments.size() > 0) ? (uint32_t)std::stoul(arguments[0]) : 200;
+
+    std::vector<ToolpathExample::CToolpathSlicePolygons> slices(nLayerCount);
+    for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++)
+        generatePerforatedSlice(nLayerIndex, slices[nLayerIndex]);
+
+    std::vector<uint32_t> threadCounts = { 1 };
+    if (std::thread::hardware_concurrency() > 1)
+        threadCounts.push_back(std::thread::hardware_concurrency());
+
+    ToolpathExample::sToolpathScanStrategyParameters parameters;
+    parameters.m_nCellSize = 5000;
+    parameters.m_nHatchDistance = 100;
+    parameters.m_dAngle = 0.0;
+    parameters.m_dAngleIncrement = 67.0;
+    parameters.m_nMinHatchLength = 0;
+
+    std::cout << nLayerCount << " layers, " << slices[0].GetPolygonCount() << " polygons per slice" << std::endl;
+    for (auto pattern : { ToolpathExample::eToolpathScanPattern::Stripes, ToolpathExample::eToolpathScanPattern::Chessboard }) {
+        parameters.m_Pattern = pattern;
+
+        // Without overlap, the cells share the slice area up to the rounding at the polygon and cell boundaries
+        parameters.m_nCellOverlap = 0;
+        ToolpathExample::CToolpathScanStrategy checkStrategy(parameters);
+        ToolpathExample::CToolpathScanLayer checkLayer;
+        for (uint32_t nLayerIndex = 0; nLayerIndex < std::min<uint32_t>(nLayerCount, 10); nLayerIndex++) {
+            checkStrategy.GenerateLayer(slices[nLayerIndex], nLayerIndex, checkLayer);
+            double dRatio = hatchLength(checkLayer.GetHatches()) * parameters.m_nHatchDistance / slices[nLayerIndex].GetArea();
+            if (std::fabs(dRatio - 1.0) > 0.01)
+                throw std::runtime_error("scan cells do not cover the slice area, ratio " + std::to_string(dRatio));
+        }
+
+        parameters.m_nCellOverlap = 100;
+        parameters.m_nMinHatchLength = 50;
+        ToolpathExample::CToolpathScanStrategy strategy(parameters);
+        std::vector<ToolpathExample::CToolpathScanLayer> layers(nLayerCount);
+        std::vector<std::vector<Lib3MF::sDiscreteHatch2D>> referenceHatches(nLayerCount);
+        for (uint32_t nThreadCount : threadCounts) {
+            strategy.SetThreadPool((nThreadCount > 1) ? std::make_shared<ToolpathExample::CToolpathThreadPool>(nThreadCount) : nullptr);
+
+            auto result = measure([&]() {
+                for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++)
+                    strategy.GenerateLayer(slices[nLayerIndex], nLayerIndex, layers[nLayerIndex]);
+            });
+
+            uint64_t nHatchCount = 0;
+            uint64_t nCellCount = 0;
+            for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++) {
+                const std::vector<Lib3MF::sDiscreteHatch2D> & hatches = layers[nLayerIndex].GetHatches();
+                nHatchCount += hatches.size();
+                nCellCount += layers[nLayerIndex].GetCellCount();
+
+                if (nThreadCount == threadCounts.front())
+                    referenceHatches[nLayerIndex] = hatches;
+                else if ((referenceHatches[nLayerIndex].size() != hatches.size())
+                    || (memcmp(referenceHatches[nLayerIndex].data(), hatches.data(), hatches.size() * sizeof(Lib3MF::sDiscreteHatch2D)) != 0))
+                    throw std::runtime_error("scan cells differ between thread counts");
+            }
+
+            std::cout << "  " << std::setw(10) << ((pattern == ToolpathExample::eToolpathScanPattern::Stripes) ? "stripes" : "chessboard") << ", "
+                << std::setw(3) << nThreadCount << " threads: " << std::fixed << std::setprecision(1)
+                << std::setw(10) << nLayerCount / result.m_dSeconds << " layers/s " << std::setw(12) << nHatchCount / result.m_dSeconds << " hatches/s, "
+                << nCellCount / nLayerCount << " cells and " << nHatchCount / nLayerCount << " hatches per layer" << std::endl;
+        }
+    }
+    return 0;
+}
+
+// Outline with a wave on a circle of 25 mm radius and a ring of round holes, in micron
+void generateWavySlice(uint32_t nVertexCount, ToolpathExample::CToolpathSlicePolygons & slice)
+{
+    const double dPi = 3.14159265358979323846;
+    const uint32_t nHoleCount = 24;
+    const uint32_t nHoleVertexCount = 64;
+
+    slice.Clear();
+    slice.BeginPolygon();
+    for (uint32_t nVertex = 0; nVertex < nVertexCount; nVertex++) {
+        double dAngle = 2.0 * dPi * nVertex / nVertexCount;
+        double dRadius = 25000.0 + 800.0 * std::sin(dAngle * 180.0);
+        slice.AddVertex((int32_t)std::lround(dRadius * std::cos(dAngle)), (int32_t)std::lround(dRadius * std::sin(dAngle)));
+    }
+    slice.EndPolygon();
+
+    for (uint32_t nHole = 0; nHole < nHoleCount; nHole++) {
+        double dCenterAngle = 2.0 * dPi * nHole / nHoleCount;
+        double dCenterX = 16000.0 * std::cos(dCenterAngle);
+        double dCenterY = 16000.0 * std::sin(dCenterAngle);
+        slice.BeginPolygon();
+        for (uint32_t nVertex = 0; nVertex < nHoleVertexCount; nVertex++) {
+            double dAngle = -2.0 * dPi * nVertex / nHoleVertexCount;
+            slice.AddVertex((int32_t)std::lround(dCenterX + 1800.0 * std::cos(dAngle)), (int32_t)std::lround(dCenterY + 1800.0 * std::sin(dAngle)));
+        }
+        slice.EndPolygon();
+    }
+}
+
+// Several insets of a slice with many vertices, single threaded and on all hardware threads
+int polygonOffsetterBenchmark(const std::vector<std::string> & arguments)
+{
+    if (arguments.size() > 2) {
+        std::cout << "usage: ToolpathBenchmark offset [vertex count] [inset count]" << std::endl;
+        return 1;
+    }
+
+    uint32_t nVertexCount = (arguments.size() > 0) ? (uint32_t)std::stoul(arguments[0]) : 100000;
+    uint32_t nInsetCount = (arguments.size() > 1) ? (uint32_t)std::stoul(arguments[1]) : 3;
+    if ((nVertexCount < 3) || (nInsetCount == 0) || (nInsetCount > 100))
+        throw std::invalid_argument("invalid benchmark arguments");
+    const double dPi = 3.14159265358979323846;
+
+    // Insets of a circle with round joins shrink its radius
+    ToolpathExample::CToolpathSlicePolygons circle;
+    circle.BeginPolygon();
+    for (uint32_t nVertex = 0; nVertex < nVertexCount; nVertex++) {
+        double dAngle = 2.0 * dPi * nVertex / nVertexCount;
+        circle.AddVertex((int32_t)std::lround(25000.0 * std::cos(dAngle)), (int32_t)std::lround(25000.0 * std::sin(dAngle)));
+    }
+    circle.EndPolygon();
+
+    ToolpathExample::CToolpathPolygonOffsetter checkOffsetter;
+    checkOffsetter.SetJoin(ToolpathExample::eToolpathOffsetJoin::Round);
+    ToolpathExample::CToolpathSlicePolygons offsetCircle;
+    for (int32_t nInset : { 1000, -1000 }) {
+        checkOffsetter.Offset(circle, nInset, offsetCircle);
+        double dExpectedArea = dPi * (25000.0 - nInset) * (25000.0 - nInset);
+        if ((offsetCircle.GetPolygonCount() != 1) || (std::fabs(offsetCircle.GetArea() / dExpectedArea - 1.0) > 0.001))
+            throw std::runtime_error("offset circle has the wrong area");
+    }
+
+    // Self-intersecting input keeps both of its lobes under the even-odd rule: a symmetric bowtie and a figure-eight
+    // whose lobes differ in size
+    std::vector<std::vector<Lib3MF::sDiscretePosition2D>> crossingPolygons = {
+        { { { 0, 0 } }, { { 1000, 1000 } }, { { 1000, 0 } }, { { 0, 1000 } } },
+        { { { 0, 0 } }, { { 3000, 2000 } }, { { 3000, 0 } }, { { 0, 1000 } } }
+    };
+    std::vector<double> crossingAreas = { 500000.0, 2500000.0 };
+    for (size_t nPolygon = 0; nPolygon < crossingPolygons.size(); nPolygon++) {
+        ToolpathExample::CToolpathSlicePolygons crossing;
+        crossing.BeginPolygon();
+        for (const Lib3MF::sDiscretePosition2D & vertex : crossingPolygons[nPolygon])
+            crossing.AddVertex(vertex.m_Coordinates[0], vertex.m_Coordinates[1]);
+        crossing.EndPolygon();
+
+        double dArea = crossingAreas[nPolygon];
+        checkOffsetter.Offset(crossing, 0, offsetCircle);
+        if ((offsetCircle.GetPolygonCount() != 2) || (std::fabs(offsetCircle.GetArea() / dArea - 1.0) > 0.001))
+            throw std::runtime_error("resolved self-intersecting polygon has the wrong area");
+        checkOffsetter.Offset(crossing, 20, offsetCircle);
+        if ((offsetCircle.GetPolygonCount() != 2) || (offsetCircle.GetArea() < 0.7 * dArea) || (offsetCircle.GetArea() >= dArea))
+            throw std::runtime_error("inset of a self-intersecting polygon has the wrong area");
+        checkOffsetter.Offset(crossing, -20, offsetCircle);
+        if ((offsetCircle.GetPolygonCount() == 0) || (offsetCircle.GetArea() <= dArea) || (offsetCircle.GetArea() > 1.3 * dArea))
+            throw std::runtime_error("outset of a self-intersecting polygon has the wrong area");
+    }
+
+    ToolpathExample::CToolpathSlicePolygons slice;
+    generateWavySlice(nVertexCount, slice);
+    std::vector<int32_t> insets;
+    for (uint32_t nInset = 0; nInset < nInsetCount; nInset++)
+        insets.push_back(50 + 100 * (int32_t)nInset);
+
+    std::vector<uint32_t> threadCounts = { 1 };
+    if (std::thread::hardware_concurrency() > 1)
+        threadCounts.push_back(std::thread::hardware_concurrency());
+
+    std::cout << slice.GetVertexCount() << " vertices, " << slice.GetPolygonCount() << " polygons, " << nInsetCount << " insets" << std::endl;
+    ToolpathExample::CToolpathPolygonOffsetter offsetter;
+    ToolpathExample::CToolpathContours contours;
+    std::vector<Lib3MF::sDiscretePosition2D> referencePoints;
+    for (uint32_t nThreadCount : threadCounts) {
+        offsetter.SetThreadPool((nThreadCount > 1) ? std::make_shared<ToolpathExample::CToolpathThreadPool>(nThreadCount) : nullptr);
+        offsetter.GenerateContours(slice, insets, contours);
+
+        auto result = measure([&]() { offsetter.GenerateContours(slice, insets, contours); });
+        if (nThreadCount == threadCounts.front())
+            referencePoints = contours.GetPoints();
+        else if ((referencePoints.size() != contours.GetPointCount())
+            || (memcmp(referencePoints.data(), contours.GetPoints().data(), referencePoints.size() * sizeof(Lib3MF::sDiscretePosition2D)) != 0))
+            throw std::runtime_error("contours differ between thread counts");
+
+        std::cout << "  " << std::setw(3) << nThreadCount << " threads: " << std::fixed << std::setprecision(3) << std::setw(8) << result.m_dSeconds * 1000.0 / nInsetCount << " ms per inset, "
+            << std::setprecision(1) << std::setw(8) << slice.GetVertexCount() * nInsetCount / result.m_dSeconds / 1.0e6 << " M vertices/s, "
+            << contours.GetLoopCount() << " loops, " << contours.GetPointCount() << " points" << std::endl;
+    }
+    return 0;
+}
+
+// Largest distance of a removed point from the simplified loop and largest factor error, with the factors
+// interpolated along the original curve between the remaining points
+void simplificationError(const Lib3MF::sDiscretePosition2D * pPoints, const double * pFactors, size_t nPointCount,
+    const Lib3MF::sDiscretePosition2D * pKept, const double * pKeptFactors, size_t nKeptCount, double & dMaxDistance, double & dMaxFactorError)
+{
+    // The remaining points are a subsequence of the loop that starts with its first point
+    std::vector<size_t> keptIndices;
+    for (size_t nIndex = 0; (nIndex < nPointCount) && (keptIndices.size() < nKeptCount); nIndex++) {
+        const Lib3MF::sDiscretePosition2D & kept = pKept[keptIndices.size()];
+        if ((pPoints[nIndex].m_Coordinates[0] == kept.m_Coordinates[0]) && (pPoints[nIndex].m_Coordinates[1] == kept.m_Coordinates[1]))
+            keptIndices.push_back(nIndex);
+    }
+    if ((keptIndices.size() != nKeptCount) || (nKeptCount < 3))
+        throw std::runtime_error("simplified loop is not a subsequence of the loop");
+    keptIndices.push_back(nPointCount);
+
+    for (size_t nKept = 0; nKept < nKeptCount; nKept++) {
+        size_t nFirst = keptIndices[nKept];
+        size_t nLast = keptIndices[nKept + 1];
+        const Lib3MF::sDiscretePosition2D & first = pPoints[nFirst];
+        const Lib3MF::sDiscretePosition2D & last = pPoints[nLast % nPointCount];
+        double dFirstFactor = pKeptFactors[nKept];
+        double dLastFactor = pKeptFactors[(nKept + 1) % nKeptCount];
+
+        std::vector<double> arcLengths(1, 0.0);
+        for (size_t nIndex = nFirst + 1; nIndex <= nLast; nIndex++)
+            arcLengths.push_back(arcLengths.back() + std::hypot((double)pPoints[nIndex % nPointCount].m_Coordinates[0] - pPoints[nIndex - 1].m_Coordinates[0],
+                (double)pPoints[nIndex % nPointCount].m_Coordinates[1] - pPoints[nIndex - 1].m_Coordinates[1]));
+
+        double dDX = (double)last.m_Coordinates[0] - first.m_Coordinates[0];
+        double dDY = (double)last.m_Coordinates[1] - first.m_Coordinates[1];
+        double dLengthSquared = std::max(dDX * dDX + dDY * dDY, 1e-300);
+        for (size_t nIndex = nFirst + 1; nIndex < nLast; nIndex++) {
+            double dPX = (double)pPoints[nIndex].m_Coordinates[0] - first.m_Coordinates[0];
+            double dPY = (double)pPoints[nIndex].m_Coordinates[1] - first.m_Coordinates[1];
+            double dT = std::min(1.0, std::max(0.0, (dPX * dDX + dPY * dDY) / dLengthSquared));
+            dMaxDistance = std::max(dMaxDistance, std::hypot(dPX - dT * dDX, dPY - dT * dDY));
+
+            double dU = arcLengths[nIndex - nFirst] / arcLengths.back();
+            dMaxFactorError = std::max(dMaxFactorError, std::fabs(pFactors[nIndex] - ((1.0 - dU) * dFirstFactor + dU * dLastFactor)));
+        }
+    }
+}
+
+// Simplification of dense loops with rounding noise and a smooth factor profile
+int curveSimplifierBenchmark(const std::vector<std::string> & arguments)
+{
+    if (arguments.size() > 2) {
+        std::cout << "usage: ToolpathBenchmark simplify [points per loop] [loop count]" << std::endl;
+        return 1;
+    }
+
+    uint32_t nPointCount = (arguments.size() > 0) ? (uint32_t)std::stoul(arguments[0]) : 20000;
+    uint32_t nLoopCount = (arguments.size() > 1) ? (uint32_t)std::stoul(arguments[1]) : 100;
+    if ((nPointCount < 4) || (nLoopCount == 0))
+        throw std::invalid_argument("invalid benchmark arguments");
+    const double dPi = 3.14159265358979323846;
+    const double dFactorTolerance = 0.001;
+
+    // Wavy outlines like the contours of a fine mesh, rounded to toolpath units
+    std::vector<Lib3MF::sDiscretePosition2D> points((size_t)nPointCount * nLoopCount);
+    std::vector<double> factors(points.size());
+    for (uint32_t nLoop = 0; nLoop < nLoopCount; nLoop++) {
+        double dRadius = 5000.0 + 200.0 * nLoop;
+        for (uint32_t nPoint = 0; nPoint < nPointCount; nPoint++) {
+            double dAngle = 2.0 * dPi * nPoint / nPointCount;
+            double dWave = dRadius + 300.0 * std::sin(7.0 * dAngle + nLoop);
+            size_t nIndex = (size_t)nLoop * nPointCount + nPoint;
+            points[nIndex].m_Coordinates[0] = (int32_t)std::lround(dWave * std::cos(dAngle));
+            points[nIndex].m_Coordinates[1] = (int32_t)std::lround(dWave * std::sin(dAngle));
+            factors[nIndex] = 0.6 + 0.3 * std::sin(3.0 * dAngle);
+        }
+    }
+
+    std::cout << nLoopCount << " loops, " << points.size() << " points" << std::endl;
+    ToolpathExample::CToolpathCurveSimplifier simplifier;
+    std::vector<Lib3MF::sDiscretePosition2D> simplifiedPoints;
+    std::vector<double> simplifiedFactors;
+    std::vector<uint32_t> loopSizes(nLoopCount);
+    for (double dTolerance : { 0.5, 1.0, 2.0, 5.0 }) {
+        simplifier.SetTolerance(dTolerance, dFactorTolerance);
+        simplifier.ResetReport();
+        simplifiedPoints = points;
+        simplifiedFactors = factors;
+
+        auto result = measure([&]() {
+            for (uint32_t nLoop = 0; nLoop < nLoopCount; nLoop++) {
+                size_t nStart = (size_t)nLoop * nPointCount;
+                loopSizes[nLoop] = (uint32_t)simplifier.Simplify(simplifiedPoints.data() + nStart, simplifiedFactors.data() + nStart, nPointCount, true);
+            }
+        });
+
+        double dMaxDistance = 0.0;
+        double dMaxFactorError = 0.0;
+        for (uint32_t nLoop = 0; nLoop < nLoopCount; nLoop++) {
+            size_t nStart = (size_t)nLoop * nPointCount;
+            simplificationError(points.data() + nStart, factors.data() + nStart, nPointCount, simplifiedPoints.data() + nStart, simplifiedFactors.data() + nStart,
+                loopSizes[nLoop], dMaxDistance, dMaxFactorError);
+        }
+        if ((dMaxDistance > dTolerance * (1.0 + 1e-9)) || (dMaxFactorError > dFactorTolerance * (1.0 + 1e-9)))
+            throw std::runtime_error("simplified loops exceed the tolerance");
+
+        const ToolpathExample::sToolpathSimplificationReport & report = simplifier.GetReport();
+        std::cout << "  tolerance " << std::fixed << std::setprecision(1) << std::setw(4) << dTolerance << ": " << std::setw(8) << report.m_nOutputPointCount << " points, "
+            << std::setw(5) << 100.0 * (1.0 - (double)report.m_nOutputPointCount / report.m_nInputPointCount) << "% removed, max error " << std::setprecision(3) << dMaxDistance
+            << ", max factor error " << std::setprecision(5) << dMaxFactorError << ", " << std::setprecision(1) << std::setw(6)
+            << report.m_nInputPointCount / result.m_dSeconds / 1.0e6 << " M points/s" << std::endl;
+    }
+    return 0;
+}
+
+// Largest distance of a loop point from the arc path and largest factor error, with the factors
+// interpolated along the original curve between the end points of each element
+void arcPathError(const Lib3MF::sDiscretePosition2D * pPoints, const double * pFactors, size_t nPointCount,
+    const ToolpathExample::CToolpathArcPath & arcPath, double & dMaxDistance, double & dMaxFactorError)
+{
+    ToolpathExample::sToolpathArcElement element;
+    size_t nFirst = 0;
+    for (size_t nElementIndex = 0; nElementIndex < arcPath.GetElementCount(); nElementIndex++) {
+        arcPath.GetElement(nElementIndex, element);
+        if ((element.m_dStartX != pPoints[nFirst].m_Coordinates[0]) || (element.m_dStartY != pPoints[nFirst].m_Coordinates[1]))
+            throw std::runtime_error("arc path does not follow the loop");
+
+        // Element end points are loop points, the last element closes the loop
+        size_t nLast = nFirst + 1;
+        while ((nLast < nPointCount) && ((element.m_dEndX != pPoints[nLast].m_Coordinates[0]) || (element.m_dEndY != pPoints[nLast].m_Coordinates[1])))
+            nLast++;
+        if ((nLast == nPointCount) && (nElementIndex + 1 != arcPath.GetElementCount()))
+            throw std::runtime_error("arc path does not follow the loop");
+
+        std::vector<double> arcLengths(1, 0.0);
+        for (size_t nIndex = nFirst + 1; nIndex <= nLast; nIndex++)
+            arcLengths.push_back(arcLengths.back() + std::hypot((double)pPoints[nIndex % nPointCount].m_Coordinates[0] - pPoints[nIndex - 1].m_Coordinates[0],
+                (double)pPoints[nIndex % nPointCount].m_Coordinates[1] - pPoints[nIndex - 1].m_Coordinates[1]));
+
+        double dDX = element.m_dEndX - element.m_dStartX;
+        double dDY = element.m_dEndY - element.m_dStartY;
+        double dLengthSquared = std::max(dDX * dDX + dDY * dDY, 1e-300);
+        for (size_t nIndex = nFirst + 1; nIndex < nLast; nIndex++) {
+            double dPX = (double)pPoints[nIndex].m_Coordinates[0];
+            double dPY = (double)pPoints[nIndex].m_Coordinates[1];
+            if (element.m_bLine) {
+                double dT = std::min(1.0, std::max(0.0, ((dPX - element.m_dStartX) * dDX + (dPY - element.m_dStartY) * dDY) / dLengthSquared));
+                dMaxDistance = std::max(dMaxDistance, std::hypot(dPX - element.m_dStartX - dT * dDX, dPY - element.m_dStartY - dT * dDY));
+            }
+            else {
+                dMaxDistance = std::max(dMaxDistance, std::fabs(std::hypot(dPX - element.m_dCenterX, dPY - element.m_dCenterY) - element.m_dRadius));
+            }
+
+            double dU = arcLengths[nIndex - nFirst] / arcLengths.back();
+            dMaxFactorError = std::max(dMaxFactorError, std::fabs(pFactors[nIndex] - ((1.0 - dU) * element.m_dStartFactor + dU * element.m_dEndFactor)));
+        }
+        nFirst = nLast;
+    }
+    if (nFirst != nPointCount)
+        throw std::runtime_error("arc path does not close the loop");
+}
+
+// Arc fitting of dense loops with rounding noise and a smooth factor profile, compared with point simplification
+int arcFitterBenchmark(const std::vector<std::string> & arguments)
+{
+    if (arguments.size() > 2) {
+        std::cout << "usage: ToolpathBenchmark arcfit [points per loop] [loop count]" << std::endl;
+        return 1;
+    }
+
+    uint32_t nPointCount = (arguments.size() > 0) ? (uint32_t)std::stoul(arguments[0]) : 20000;
+    uint32_t nLoopCount = (arguments.size() > 1) ? (uint32_t)std::stoul(arguments[1]) : 20;
+    if ((nPointCount < 4) || (nLoopCount == 0))
+        throw std::invalid_argument("invalid benchmark arguments");
+    const double dPi = 3.14159265358979323846;
+    const double dFactorTolerance = 0.01;
+
+    // Wavy outlines like the contours of a fine mesh, rounded to toolpath units
+    std::vector<Lib3MF::sDiscretePosition2D> points((size_t)nPointCount * nLoopCount);
+    std::vector<double> factors(points.size());
+    for (uint32_t nLoop = 0; nLoop < nLoopCount; nLoop++) {
+        double dRadius = 5000.0 + 200.0 * nLoop;
+        for (uint32_t nPoint = 0; nPoint < nPointCount; nPoint++) {
+            double dAngle = 2.0 * dPi * nPoint / nPointCount;
+            double dWave = dRadius + 300.0 * std::sin(7.0 * dAngle + nLoop);
+            size_t nIndex = (size_t)nLoop * nPointCount + nPoint;
+            points[nIndex].m_Coordinates[0] = (int32_t)std::lround(dWave * std::cos(dAngle));
+            points[nIndex].m_Coordinates[1] = (int32_t)std::lround(dWave * std::sin(dAngle));
+            factors[nIndex] = 0.6 + 0.3 * std::sin(3.0 * dAngle);
+        }
+    }
+
+    std::cout << nLoopCount << " loops, " << points.size() << " points" << std::endl;
+    ToolpathExample::CToolpathArcFitter arcFitter;
+    ToolpathExample::CToolpathCurveSimplifier simplifier;
+    ToolpathExample::CToolpathArcPath arcPath;
+    std::vector<std::vector<Lib3MF::sDiscretePosition2D>> arcPoints(nLoopCount);
+    std::vector<std::vector<double>> arcFactors(nLoopCount);
+    std::vector<Lib3MF::sDiscretePosition2D> simplifiedPoints;
+    std::vector<double> simplifiedFactors;
+    for (double dTolerance : { 0.5, 1.0, 2.0, 5.0 }) {
+        arcFitter.SetTolerance(dTolerance, dFactorTolerance);
+        arcFitter.ResetReport();
+
+        uint32_t nUnfittedCount = 0;
+        auto result = measure([&]() {
+            for (uint32_t nLoop = 0; nLoop < nLoopCount; nLoop++) {
+                size_t nStart = (size_t)nLoop * nPointCount;
+                if (!arcFitter.Fit(points.data() + nStart, factors.data() + nStart, nPointCount, true, arcPoints[nLoop], arcFactors[nLoop]))
+                    nUnfittedCount++;
+            }
+        });
+
+        double dMaxDistance = 0.0;
+        double dMaxFactorError = 0.0;
+        for (uint32_t nLoop = 0; nLoop < nLoopCount; nLoop++) {
+            if (arcPoints[nLoop].empty())
+                continue;
+            size_t nStart = (size_t)nLoop * nPointCount;
+            arcPath.SetDiscretePoints(arcPoints[nLoop].data(), arcFactors[nLoop].data(), arcPoints[nLoop].size(), true);
+            arcPathError(points.data() + nStart, factors.data() + nStart, nPointCount, arcPath, dMaxDistance, dMaxFactorError);
+        }
+        if ((dMaxDistance > dTolerance * (1.0 + 1e-9)) || (dMaxFactorError > dFactorTolerance * (1.0 + 1e-9)))
+            throw std::runtime_error("arc paths exceed the tolerance");
+
+        // Point count of the same loops after simplification, for comparison
+        simplifier.SetTolerance(dTolerance, dFactorTolerance);
+        simplifier.ResetReport();
+        simplifiedPoints = points;
+        simplifiedFactors = factors;
+        for (uint32_t nLoop = 0; nLoop < nLoopCount; nLoop++) {
+            size_t nStart = (size_t)nLoop * nPointCount;
+            simplifier.Simplify(simplifiedPoints.data() + nStart, simplifiedFactors.data() + nStart, nPointCount, true);
+        }
+
+        const ToolpathExample::sToolpathArcFitReport & report = arcFitter.GetReport();
+        std::cout << "  tolerance " << std::fixed << std::setprecision(1) << std::setw(4) << dTolerance << ": " << std::setw(8) << report.m_nOutputPointCount << " points ("
+            << report.m_nArcCount << " arcs, " << report.m_nLineCount << " lines, " << nUnfittedCount << " loops unchanged), " << std::setw(8) << simplifier.GetReport().m_nOutputPointCount
+            << " points simplified, max error " << std::setprecision(3) << dMaxDistance << ", max factor error " << std::setprecision(5) << dMaxFactorError << ", "
+            << std::setprecision(1) << std::setw(6) << report.m_nInputPointCount / result.m_dSeconds / 1.0e6 << " M points/s" << std::endl;
+    }
+    return 0;
+}
+
+// Torus around the Z axis with outward oriented triangles, in mm
+void generateTorusMesh(uint32_t nRingCount, uint32_t nSegmentCount, double dMajorRadius, double dMinorRadius, std::vector<Lib3MF::sPosition> & vertices, std::vector<Lib3MF::sTriangle> & triangles)
+{
+    const double dPi = 3.14159265358979323846;
+    vertices.resize((size_t)nRingCount * nSegmentCount);
+    triangles.clear();
+    triangles.reserve((size_t)nRingCount * nSegmentCount * 2);
+
+    for (uint32_t nRing = 0; nRing < nRingCount; nRing++) {
+        double dU = 2.0 * dPi * nRing / nRingCount;
+        for (uint32_t nSegment = 0; nSegment < nSegmentCount; nSegment++) {
+            double dV = 2.0 * dPi * nSegment / nSegmentCount;
+            double dDistance = dMajorRadius + dMinorRadius * std::cos(dV);
+            Lib3MF::sPosition & vertex = vertices[(size_t)nRing * nSegmentCount + nSegment];
+            vertex.m_Coordinates[0] = (float)(dDistance * std::cos(dU));
+            vertex.m_Coordinates[1] = (float)(dDistance * std::sin(dU));
+            vertex.m_Coordinates[2] = (float)(dMinorRadius * std::sin(dV));
+        }
+    }
+
+    for (uint32_t nRing = 0; nRing < nRingCount; nRing++) {
+        uint32_t nNextRing = (nRing + 1) % nRingCount;
+        for (uint32_t nSegment = 0; nSegment < nSegmentCount; nSegment++) {
+            uint32_t nNextSegment = (nSegment + 1) % nSegmentCount;
+            uint32_t n00 = nRing * nSegmentCount + nSegment;
+            uint32_t n10 = nNextRing * nSegmentCount + nSegment;
+            uint32_t n11 = nNextRing * nSegmentCount + nNextSegment;
+            uint32_t n01 = nRing * nSegmentCount + nNextSegment;
+            triangles.push_back({ { n00, n10, n11 } });
+            triangles.push_back({ { n11, n01, n00 } });
+        }
+    }
+}
+
+// Slicing a torus mesh at uniform layers, single threaded and on all hardware threads
+int meshSlicerBenchmark(const std::vector<std::string> & arguments)
+{
+    if (arguments.size() > 2) {
+        std::cout << "usage: ToolpathBenchmark meshslice [triangle count] [layer count]" << std::endl;
+        return 1;
+    }
+
+    uint64_t nTriangleCount = (arguments.size() > 0) ? std::stoull(arguments[0]) : 4000000;
+    uint32_t nLayerCount = (arguments.size() > 1) ? (uint32_t)std::stoul(arguments[1]) : 1000;
+    const double dMajorRadius = 20.0;
+    const double dMinorRadius = 8.0;
+    const double dPi = 3.14159265358979323846;
+
+    uint32_t nSegmentCount = std::max<uint32_t>(8, (uint32_t)std::sqrt((double)nTriangleCount / 10.0));
+    uint32_t nRingCount = std::max<uint32_t>(8, (uint32_t)(nTriangleCount / 2 / nSegmentCount));
+    std::vector<Lib3MF::sPosition> vertices;
+    std::vector<Lib3MF::sTriangle> triangles;
+    generateTorusMesh(nRingCount, nSegmentCount, dMajorRadius, dMinorRadius, vertices, triangles);
+
+    std::vector<double> layerZTops(nLayerCount);
+    double dLayerThickness = 2.0 * dMinorRadius / nLayerCount;
+    for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++)
+        layerZTops[nLayerIndex] = -dMinorRadius + (nLayerIndex + 1) * dLayerThickness;
+
+    ToolpathExample::CToolpathMeshSlicer slicer;
+    slicer.SetLayerHeights(-dMinorRadius, layerZTops);
+    slicer.SetMesh(vertices.data(), vertices.size(), triangles.data(), triangles.size());
+
+    std::vector<uint32_t> threadCounts = { 1 };
+    if (std::thread::hardware_concurrency() > 1)
+        threadCounts.push_back(std::thread::hardware_concurrency());
+
+    std::cout << triangles.size() << " triangles, " << nLayerCount << " layers" << std::endl;
+    std::vector<std::vector<Lib3MF::sPosition2D>> referenceVertices(nLayerCount);
+    for (uint32_t nThreadCount : threadCounts) {
+        slicer.SetThreadPool((nThreadCount > 1) ? std::make_shared<ToolpathExample::CToolpathThreadPool>(nThreadCount) : nullptr);
+        auto result = measure([&]() { slicer.Slice(); });
+
+        // Every layer cuts the torus in two circles; compare with the area of the exact annulus
+        uint64_t nPolygonCount = 0;
+        uint64_t nVertexCount = 0;
+        double dMaxAreaError = 0.0;
+        for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++) {
+            const ToolpathExample::CToolpathMeshSlice & slice = slicer.GetSlice(nLayerIndex);
+            const std::vector<Lib3MF::sPosition2D> & sliceVertices = slice.GetVertices();
+            double dArea = 0.0;
+            for (size_t nPolygonIndex = 0; nPolygonIndex < slice.GetPolygonCount(); nPolygonIndex++) {
+                if (!slice.IsPolygonClosed(nPolygonIndex))
+                    throw std::runtime_error("open polygon in the slice of a closed mesh");
+                uint32_t nStart = slice.GetPolygonStart(nPolygonIndex);
+                uint32_t nSize = slice.GetPolygonSize(nPolygonIndex);
+                for (uint32_t nIndex = 0; nIndex < nSize; nIndex++) {
+                    const Lib3MF::sPosition2D & a = sliceVertices[nStart + nIndex];
+                    const Lib3MF::sPosition2D & b = sliceVertices[nStart + (nIndex + 1) % nSize];
+                    dArea += 0.5 * (a.m_Coordinates[0] * b.m_Coordinates[1] - b.m_Coordinates[0] * a.m_Coordinates[1]);
+                }
+            }
+            double dZ = slicer.GetPlaneZ(nLayerIndex);
+            double dExpectedArea = 4.0 * dPi * dMajorRadius * std::sqrt(dMinorRadius * dMinorRadius - dZ * dZ);
+            dMaxAreaError = std::max(dMaxAreaError, std::fabs(dArea - dExpectedArea) / dExpectedArea);
+            nPolygonCount += slice.GetPolygonCount();
+            nVertexCount += sliceVertices.size();
+
+            if (nThreadCount == threadCounts.front())
+                referenceVertices[nLayerIndex] = sliceVertices;
+            else if ((referenceVertices[nLayerIndex].size() != sliceVertices.size())
+                || (memcmp(referenceVertices[nLayerIndex].data(), sliceVertices.data(), sliceVertices.size() * sizeof(Lib3MF::sPosition2D)) != 0))
+                throw std::runtime_error("slices differ between thread counts");
+        }
+
+        std::cout << "  " << std::setw(3) << nThreadCount << " threads: " << std::fixed << std::setprecision(3) << std::setw(8) << result.m_dSeconds << " s, "
+            << std::setprecision(1) << std::setw(8) << triangles.size() / result.m_dSeconds / 1.0e6 << " M triangles/s, "
+            << std::setw(8) << nLayerCount / result.m_dSeconds << " layers/s, " << nPolygonCount << " polygons, " << nVertexCount << " vertices, "
+            << std::setprecision(4) << "max area error " << dMaxAreaError * 100.0 << "%" << std::endl;
+    }
+    return 0;
+}
+
+
+int main(int argc, char ** argv)
+{
+    typedef std::function<int(const std::vector<std::string> & arguments)> BenchmarkFunction;
+    const std::vector<std::pair<std::string, BenchmarkFunction>> benchmarks = {
+        { "readalloc", readAllocationBenchmark },
+        { "discrete", discreteUnitsBenchmark },
+        { "coordcodec", coordinateCodecBenchmark },
+        { "prefixsum", prefixSumBenchmark },
+        { "slicegen", sliceGeneratorBenchmark },
+        { "meshslice", meshSlicerBenchmark },
+        { "hatchclip", hatchClipperBenchmark },
+        { "scanstrategy", scanStrategyBenchmark },
+        { "offset", polygonOffsetterBenchmark },
+        { "simplify", curveSimplifierBenchmark },
+        { "arcfit", arcFitterBenchmark },
+    };
+
+    std::vector<std::string> arguments;
+    for (int nArgument = 2; nArgument < argc; nArgument++)
+        arguments.push_back(argv[nArgument]);
+
+    try {
+        for (auto & benchmark : benchmarks) {
+            if ((argc >= 2) && (benchmark.first == argv[1]))
+                return benchmark.second(arguments);
+        }
+
+        std::cout << "usage: ToolpathBenchmark <benchmark> [arguments]" << std::endl << "benchmarks:";
+        for (auto & benchmark : benchmarks)
+            std::cout << " " << benchmark.first;
+        std::cout << std::endl;
+        return 1;
+    }
+    catch (std::exception & E) {
+        std::cout << "fatal error: " << E.what() << std::endl;
+        return 1;
+    }
+}
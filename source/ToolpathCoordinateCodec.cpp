@@ -0,0 +1,402 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathCoordinateCodec.hpp"
+#include "ToolpathPrefixSum.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#define COORDINATECODEC_KIND_POINTS 1
+#define COORDINATECODEC_KIND_HATCHES 2
+#define COORDINATECODEC_POINT_CHANNELS 2
+#define COORDINATECODEC_HATCH_CHANNELS 5
+#define COORDINATECODEC_BLOCKSIZE 128
+
+// Bit unpacking reads whole words where the byte order allows it
+#if !(defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__))
+#define COORDINATECODEC_WORDREAD
+#endif
+
+namespace ToolpathExample {
+
+static void codecWriteVarint(uint64_t nValue, std::vector<uint8_t> & output)
+{
+    while (nValue >= 0x80) {
+        output.push_back((uint8_t)(nValue | 0x80));
+        nValue >>= 7;
+    }
+    output.push_back((uint8_t)nValue);
+}
+
+static const uint8_t * codecReadVarint(const uint8_t * pData, const uint8_t * pDataEnd, uint64_t & nValue)
+{
+    nValue = 0;
+    for (uint32_t nShift = 0; nShift < 64; nShift += 7) {
+        if (pData >= pDataEnd)
+            throw std::runtime_error("truncated coordinate data");
+        uint8_t nByte = *pData++;
+        nValue |= (uint64_t)(nByte & 0x7f) << nShift;
+        if ((nByte & 0x80) == 0)
+            return pData;
+    }
+    throw std::runtime_error("invalid varint in coordinate data");
+}
+
+static inline uint32_t codecZigzag(uint32_t nValue)
+{
+    return (nValue << 1) ^ (uint32_t)((int32_t)nValue >> 31);
+}
+
+// Channels are predicted by applying a difference of the given stride once per order. Values are treated as
+// unsigned 32 bit integers, so all residuals wrap around and decoding restores every int32 exactly.
+static void codecGetPredictionOrder(eToolpathCoordinatePrediction prediction, bool bTagChannel, uint32_t & nOrder, size_t & nStride)
+{
+    nStride = 1;
+    switch (prediction) {
+    case eToolpathCoordinatePrediction::None:
+        nOrder = 0;
+        break;
+    case eToolpathCoordinatePrediction::Delta:
+        nOrder = 1;
+        break;
+    case eToolpathCoordinatePrediction::SecondOrderDelta:
+        nOrder = bTagChannel ? 1 : 2;
+        break;
+    case eToolpathCoordinatePrediction::HatchPitch:
+        // Meander hatching alternates the direction, so the same direction repeats every second hatch
+        nOrder = bTagChannel ? 1 : 2;
+        nStride = bTagChannel ? 1 : 2;
+        break;
+    default:
+        throw std::invalid_argument("invalid coordinate prediction");
+    }
+}
+
+static void codecDifference(uint32_t * pValues, size_t nCount, size_t nStride)
+{
+    for (size_t nIndex = nCount; nIndex-- > nStride;)
+        pValues[nIndex] -= pValues[nIndex - nStride];
+}
+
+static void codecPackVarint(const uint32_t * pValues, size_t nCount, std::vector<uint8_t> & output)
+{
+    for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+        codecWriteVarint(pValues[nIndex], output);
+}
+
+static void codecUnpackVarint(const uint8_t * pData, const uint8_t * pDataEnd, uint32_t * pValues, size_t nCount)
+{
+    for (size_t nIndex = 0; nIndex < nCount; nIndex++) {
+        uint32_t nValue = 0;
+        uint32_t nShift = 0;
+        while (true) {
+            if ((pData >= pDataEnd) || (nShift > 28))
+                throw std::runtime_error("invalid varint in coordinate data");
+            uint8_t nByte = *pData++;
+            nValue |= (uint32_t)(nByte & 0x7f) << nShift;
+            if ((nByte & 0x80) == 0)
+                break;
+            nShift += 7;
+        }
+        pValues[nIndex] = nValue;
+    }
+}
+
+static void codecPackBits(const uint32_t * pValues, size_t nCount, std::vector<uint8_t> & output)
+{
+    for (size_t nBlockStart = 0; nBlockStart < nCount; nBlockStart += COORDINATECODEC_BLOCKSIZE) {
+        size_t nBlockCount = std::min<size_t>(COORDINATECODEC_BLOCKSIZE, nCount - nBlockStart);
+        const uint32_t * pBlock = pValues + nBlockStart;
+
+        uint32_t nMask = 0;
+        for (size_t nIndex = 0; nIndex < nBlockCount; nIndex++)
+            nMask |= pBlock[nIndex];
+        uint32_t nBitWidth = 0;
+        while ((nBitWidth < 32) && ((nMask >> nBitWidth) != 0))
+            nBitWidth++;
+        output.push_back((uint8_t)nBitWidth);
+        if (nBitWidth == 0)
+            continue;
+
+        uint64_t nAccumulator = 0;
+        uint32_t nBitCount = 0;
+        for (size_t nIndex = 0; nIndex < nBlockCount; nIndex++) {
+            nAccumulator |= (uint64_t)pBlock[nIndex] << nBitCount;
+            nBitCount += nBitWidth;
+            while (nBitCount >= 8) {
+                output.push_back((uint8_t)nAccumulator);
+                nAccumulator >>= 8;
+                nBitCount -= 8;
+            }
+        }
+        if (nBitCount > 0)
+            output.push_back((uint8_t)nAccumulator);
+    }
+}
+
+static void codecUnpackBits(const uint8_t * pData, const uint8_t * pDataEnd, uint32_t * pValues, size_t nCount)
+{
+    for (size_t nBlockStart = 0; nBlockStart < nCount; nBlockStart += COORDINATECODEC_BLOCKSIZE) {
+        size_t nBlockCount = std::min<size_t>(COORDINATECODEC_BLOCKSIZE, nCount - nBlockStart);
+        uint32_t * pBlock = pValues + nBlockStart;
+
+        if (pData >= pDataEnd)
+            throw std::runtime_error("truncated coordinate data");
+        uint32_t nBitWidth = *pData++;
+        if (nBitWidth > 32)
+            throw std::runtime_error("invalid bit width in coordinate data");
+
+        size_t nBlockBytes = (nBlockCount * nBitWidth + 7) / 8;
+        if ((size_t)(pDataEnd - pData) < nBlockBytes)
+            throw std::runtime_error("truncated coordinate data");
+
+        uint64_t nMask = (nBitWidth == 32) ? 0xffffffffULL : ((1ULL << nBitWidth) - 1);
+#ifdef COORDINATECODEC_WORDREAD
+        if ((size_t)(pDataEnd - pData) >= nBlockBytes + sizeof(uint64_t)) {
+            // Enough data behind the block to read every value with one unaligned little endian word
+            for (size_t nIndex = 0; nIndex < nBlockCount; nIndex++) {
+                size_t nBitOffset = nIndex * nBitWidth;
+                uint64_t nWord;
+                memcpy(&nWord, pData + (nBitOffset >> 3), sizeof(nWord));
+                pBlock[nIndex] = (uint32_t)((nWord >> (nBitOffset & 7)) & nMask);
+            }
+            pData += nBlockBytes;
+            continue;
+        }
+#endif // COORDINATECODEC_WORDREAD
+
+        uint64_t nAccumulator = 0;
+        uint32_t nBitCount = 0;
+        for (size_t nIndex = 0; nIndex < nBlockCount; nIndex++) {
+            while (nBitCount < nBitWidth) {
+                nAccumulator |= (uint64_t)(*pData++) << nBitCount;
+                nBitCount += 8;
+            }
+            pBlock[nIndex] = (uint32_t)(nAccumulator & nMask);
+            nAccumulator >>= nBitWidth;
+            nBitCount -= nBitWidth;
+        }
+    }
+}
+
+static const uint8_t * codecReadHeader(const uint8_t * pData, size_t nSize, uint8_t nExpectedKind, eToolpathCoordinatePrediction & prediction, eToolpathCoordinatePacking & packing, size_t & nCount)
+{
+    if ((pData == nullptr) || (nSize < 4))
+        throw std::runtime_error("truncated coordinate data");
+    if (pData[0] != nExpectedKind)
+        throw std::runtime_error("coordinate data contains a different kind of elements");
+    if (pData[1] > (uint8_t)eToolpathCoordinatePrediction::HatchPitch)
+        throw std::runtime_error("invalid coordinate prediction");
+    if (pData[2] > (uint8_t)eToolpathCoordinatePacking::BitPacked)
+        throw std::runtime_error("invalid coordinate packing");
+
+    prediction = (eToolpathCoordinatePrediction)pData[1];
+    packing = (eToolpathCoordinatePacking)pData[2];
+
+    uint64_t nValue = 0;
+    const uint8_t * pCurrent = codecReadVarint(pData + 3, pData + nSize, nValue);
+    // Every block of values takes at least one byte per channel
+    if (nValue > (uint64_t)nSize * COORDINATECODEC_BLOCKSIZE)
+        throw std::runtime_error("invalid element count in coordinate data");
+    nCount = (size_t)nValue;
+    return pCurrent;
+}
+
+static void codecWriteHeader(uint8_t nKind, eToolpathCoordinatePrediction prediction, eToolpathCoordinatePacking packing, size_t nCount, std::vector<uint8_t> & output)
+{
+    output.clear();
+    output.push_back(nKind);
+    output.push_back((uint8_t)prediction);
+    output.push_back((uint8_t)packing);
+    codecWriteVarint(nCount, output);
+}
+
+
+/*************************************************************************************************************************
+ Class CToolpathCoordinateCodec
+**************************************************************************************************************************/
+
+CToolpathCoordinateCodec::CToolpathCoordinateCodec()
+{
+}
+
+void CToolpathCoordinateCodec::encodeChannel(eToolpathCoordinatePrediction prediction, eToolpathCoordinatePacking packing, bool bTagChannel, std::vector<uint8_t> & output)
+{
+    uint32_t nOrder;
+    size_t nStride;
+    codecGetPredictionOrder(prediction, bTagChannel, nOrder, nStride);
+
+    uint32_t * pValues = m_Channel.data();
+    size_t nCount = m_Channel.size();
+    for (uint32_t nPass = 0; nPass < nOrder; nPass++)
+        codecDifference(pValues, nCount, nStride);
+    for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+        pValues[nIndex] = codecZigzag(pValues[nIndex]);
+
+    m_PackedChannel.clear();
+    if (packing == eToolpathCoordinatePacking::Varint)
+        codecPackVarint(pValues, nCount, m_PackedChannel);
+    else if (packing == eToolpathCoordinatePacking::BitPacked)
+        codecPackBits(pValues, nCount, m_PackedChannel);
+    else
+        throw std::invalid_argument("invalid coordinate packing");
+
+    // The size prefix allows to skip channels
+    codecWriteVarint(m_PackedChannel.size(), output);
+    output.insert(output.end(), m_PackedChannel.begin(), m_PackedChannel.end());
+}
+
+const uint8_t * CToolpathCoordinateCodec::decodeChannel(const uint8_t * pData, const uint8_t * pDataEnd, size_t nCount, eToolpathCoordinatePrediction prediction, eToolpathCoordinatePacking packing, bool bTagChannel)
+{
+    uint64_t nChannelSize = 0;
+    pData = codecReadVarint(pData, pDataEnd, nChannelSize);
+    if ((uint64_t)(pDataEnd - pData) < nChannelSize)
+        throw std::runtime_error("truncated coordinate data");
+    const uint8_t * pChannelEnd = pData + nChannelSize;
+
+    m_Channel.resize(nCount);
+    uint32_t * pValues = m_Channel.data();
+    if (packing == eToolpathCoordinatePacking::Varint)
+        codecUnpackVarint(pData, pChannelEnd, pValues, nCount);
+    else
+        codecUnpackBits(pData, pChannelEnd, pValues, nCount);
+
+    uint32_t nOrder;
+    size_t nStride;
+    codecGetPredictionOrder(prediction, bTagChannel, nOrder, nStride);
+
+    // Reconstruction is vectorized, see toolpathPrefixSum
+    toolpathUnzigzag(pValues, nCount);
+    for (uint32_t nPass = 0; nPass < nOrder; nPass++)
+        toolpathPrefixSum(pValues, nCount, nStride);
+
+    return pChannelEnd;
+}
+
+void CToolpathCoordinateCodec::EncodePoints(const Lib3MF::sDiscretePosition2D * pPoints, size_t nCount, eToolpathCoordinatePrediction prediction, eToolpathCoordinatePacking packing, std::vector<uint8_t> & output)
+{
+    if ((pPoints == nullptr) && (nCount > 0))
+        throw std::invalid_argument("invalid point data");
+    if (prediction == eToolpathCoordinatePrediction::HatchPitch)
+        throw std::invalid_argument("hatch pitch prediction requires hatches");
+
+    codecWriteHeader(COORDINATECODEC_KIND_POINTS, prediction, packing, nCount, output);
+
+    m_Channel.resize(nCount);
+    for (uint32_t nChannel = 0; nChannel < COORDINATECODEC_POINT_CHANNELS; nChannel++) {
+        for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+            m_Channel[nIndex] = (uint32_t)pPoints[nIndex].m_Coordinates[nChannel];
+        encodeChannel(prediction, packing, false, output);
+    }
+}
+
+void CToolpathCoordinateCodec::EncodeHatches(const Lib3MF::sDiscreteHatch2D * pHatches, size_t nCount, eToolpathCoordinatePrediction prediction, eToolpathCoordinatePacking packing, std::vector<uint8_t> & output)
+{
+    if ((pHatches == nullptr) && (nCount > 0))
+        throw std::invalid_argument("invalid hatch data");
+
+    codecWriteHeader(COORDINATECODEC_KIND_HATCHES, prediction, packing, nCount, output);
+
+    m_Channel.resize(nCount);
+    for (uint32_t nChannel = 0; nChannel < COORDINATECODEC_HATCH_CHANNELS; nChannel++) {
+        for (size_t nIndex = 0; nIndex < nCount; nIndex++) {
+            const Lib3MF::sDiscreteHatch2D & hatch = pHatches[nIndex];
+            int32_t nValue;
+            switch (nChannel) {
+            case 0: nValue = hatch.m_Point1Coordinates[0]; break;
+            case 1: nValue = hatch.m_Point1Coordinates[1]; break;
+            case 2: nValue = hatch.m_Point2Coordinates[0]; break;
+            case 3: nValue = hatch.m_Point2Coordinates[1]; break;
+            default: nValue = hatch.m_Tag; break;
+            }
+            m_Channel[nIndex] = (uint32_t)nValue;
+        }
+        encodeChannel(prediction, packing, nChannel == 4, output);
+    }
+}
+
+void CToolpathCoordinateCodec::DecodePoints(const uint8_t * pData, size_t nSize, std::vector<Lib3MF::sDiscretePosition2D> & points)
+{
+    eToolpathCoordinatePrediction prediction;
+    eToolpathCoordinatePacking packing;
+    size_t nCount = 0;
+    const uint8_t * pDataEnd = pData + nSize;
+    pData = codecReadHeader(pData, nSize, COORDINATECODEC_KIND_POINTS, prediction, packing, nCount);
+
+    points.resize(nCount);
+    for (uint32_t nChannel = 0; nChannel < COORDINATECODEC_POINT_CHANNELS; nChannel++) {
+        pData = decodeChannel(pData, pDataEnd, nCount, prediction, packing, false);
+        for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+            points[nIndex].m_Coordinates[nChannel] = (int32_t)m_Channel[nIndex];
+    }
+}
+
+void CToolpathCoordinateCodec::DecodeHatches(const uint8_t * pData, size_t nSize, std::vector<Lib3MF::sDiscreteHatch2D> & hatches)
+{
+    eToolpathCoordinatePrediction prediction;
+    eToolpathCoordinatePacking packing;
+    size_t nCount = 0;
+    const uint8_t * pDataEnd = pData + nSize;
+    pData = codecReadHeader(pData, nSize, COORDINATECODEC_KIND_HATCHES, prediction, packing, nCount);
+
+    hatches.resize(nCount);
+    for (uint32_t nChannel = 0; nChannel < COORDINATECODEC_HATCH_CHANNELS; nChannel++) {
+        pData = decodeChannel(pData, pDataEnd, nCount, prediction, packing, nChannel == 4);
+        const uint32_t * pValues = m_Channel.data();
+        Lib3MF::sDiscreteHatch2D * pHatches = hatches.data();
+        switch (nChannel) {
+        case 0:
+            for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+                pHatches[nIndex].m_Point1Coordinates[0] = (int32_t)pValues[nIndex];
+            break;
+        case 1:
+            for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+                pHatches[nIndex].m_Point1Coordinates[1] = (int32_t)pValues[nIndex];
+            break;
+        case 2:
+            for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+                pHatches[nIndex].m_Point2Coordinates[0] = (int32_t)pValues[nIndex];
+            break;
+        case 3:
+            for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+                pHatches[nIndex].m_Point2Coordinates[1] = (int32_t)pValues[nIndex];
+            break;
+        default:
+            for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+                pHatches[nIndex].m_Tag = (int32_t)pValues[nIndex];
+            break;
+        }
+    }
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,124 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+#ifndef __TOOLPATHEXAMPLE_COORDINATECODEC
+#define __TOOLPATHEXAMPLE_COORDINATECODEC
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+
+namespace ToolpathExample {
+
+/* Prediction applied to every coordinate channel before packing. */
+enum class eToolpathCoordinatePrediction : uint8_t {
+    None = 0, /** Values are stored as they are */
+    Delta = 1, /** Difference to the previous value */
+    SecondOrderDelta = 2, /** Difference to the linear extrapolation of the two previous values */
+    HatchPitch = 3 /** Hatches only: linear extrapolation of the two previous hatches of the same direction, tags as delta */
+};
+
+/* Packing of the prediction residuals. */
+enum class eToolpathCoordinatePacking : uint8_t {
+    Varint = 0, /** Zigzag encoded, 7 bits per byte */
+    BitPacked = 1 /** Zigzag encoded, blocks of 128 values with the bit width of their largest value */
+};
+
+/*************************************************************************************************************************
+ Class CToolpathCoordinateCodec
+
+ Encodes arrays of discrete points and hatches into a compact byte stream. Every coordinate (and the hatch tag) is
+ stored as a separate channel: a prediction turns regular sequences such as hatch fields with constant pitch into
+ residuals close to zero, which are zigzag encoded and packed. The result can be passed to an entropy coder such as
+ deflate. Scratch buffers are kept between calls.
+**************************************************************************************************************************/
+class CToolpathCoordinateCodec {
+private:
+    std::vector<uint32_t> m_Channel;
+    std::vector<uint8_t> m_PackedChannel;
+
+    void encodeChannel(eToolpathCoordinatePrediction prediction, eToolpathCoordinatePacking packing, bool bTagChannel, std::vector<uint8_t> & output);
+    const uint8_t * decodeChannel(const uint8_t * pData, const uint8_t * pDataEnd, size_t nCount, eToolpathCoordinatePrediction prediction, eToolpathCoordinatePacking packing, bool bTagChannel);
+
+public:
+
+    /**
+    * CToolpathCoordinateCodec::CToolpathCoordinateCodec - Creates a codec.
+    */
+    CToolpathCoordinateCodec();
+
+    /**
+    * CToolpathCoordinateCodec::EncodePoints - Encodes loop or polyline points.
+    * @param[in] pPoints - Points in toolpath units
+    * @param[in] nCount - Number of points
+    * @param[in] prediction - Prediction, HatchPitch is not supported for points
+    * @param[in] packing - Packing of the residuals
+    * @param[out] output - Encoded data, replaces the previous content
+    */
+    void EncodePoints(const Lib3MF::sDiscretePosition2D * pPoints, size_t nCount, eToolpathCoordinatePrediction prediction, eToolpathCoordinatePacking packing, std::vector<uint8_t> & output);
+
+    /**
+    * CToolpathCoordinateCodec::EncodeHatches - Encodes hatches including their tags.
+    * @param[in] pHatches - Hatches in toolpath units
+    * @param[in] nCount - Number of hatches
+    * @param[in] prediction - Prediction
+    * @param[in] packing - Packing of the residuals
+    * @param[out] output - Encoded data, replaces the previous content
+    */
+    void EncodeHatches(const Lib3MF::sDiscreteHatch2D * pHatches, size_t nCount, eToolpathCoordinatePrediction prediction, eToolpathCoordinatePacking packing, std::vector<uint8_t> & output);
+
+    /**
+    * CToolpathCoordinateCodec::DecodePoints - Decodes points encoded with EncodePoints.
+    * @param[in] pData - Encoded data
+    * @param[in] nSize - Size of the encoded data
+    * @param[out] points - Decoded points, resized to the point count
+    */
+    void DecodePoints(const uint8_t * pData, size_t nSize, std::vector<Lib3MF::sDiscretePosition2D> & points);
+
+    /**
+    * CToolpathCoordinateCodec::DecodeHatches - Decodes hatches encoded with EncodeHatches.
+    * @param[in] pData - Encoded data
+    * @param[in] nSize - Size of the encoded data
+    * @param[out] hatches - Decoded hatches, resized to the hatch count
+    */
+    void DecodeHatches(const uint8_t * pData, size_t nSize, std::vector<Lib3MF::sDiscreteHatch2D> & hatches);
+
+};
+
+typedef std::shared_ptr<CToolpathCoordinateCodec> PToolpathCoordinateCodec;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_COORDINATECODEC
@@ -0,0 +1,239 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#include "ToolpathCurveSimplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Zero tolerances are raised to this, so that rounding errors of collinear points and linear factors are accepted and
+// the worst point of a span can still be told apart
+#define CURVESIMPLIFIER_MINTOLERANCE 1.0e-9
+
+namespace ToolpathExample {
+
+// Error relative to the tolerance, a point has to be kept if it exceeds 1
+static inline double relativeError(double dError, double dTolerance)
+{
+    return dError / std::max(dTolerance, CURVESIMPLIFIER_MINTOLERANCE);
+}
+
+CToolpathCurveSimplifier::CToolpathCurveSimplifier()
+    : m_dTolerance(0.0), m_dFactorTolerance(0.0)
+{
+    ResetReport();
+}
+
+void CToolpathCurveSimplifier::SetTolerance(double dTolerance, double dFactorTolerance)
+{
+    if (!(dTolerance >= 0.0) || std::isinf(dTolerance))
+        throw std::invalid_argument("invalid simplification tolerance");
+    if (!(dFactorTolerance >= 0.0) || std::isinf(dFactorTolerance))
+        throw std::invalid_argument("invalid factor tolerance");
+
+    m_dTolerance = dTolerance;
+    m_dFactorTolerance = dFactorTolerance;
+}
+
+void CToolpathCurveSimplifier::ResetReport()
+{
+    m_Report.m_nCurveCount = 0;
+    m_Report.m_nInputPointCount = 0;
+    m_Report.m_nOutputPointCount = 0;
+}
+
+double CToolpathCurveSimplifier::spanError(const double * pFactors, size_t nPointCount, size_t nFirst, size_t nLast, size_t nPoint, double dTolerance) const
+{
+    const double * pFirst = &m_Coordinates[2 * nFirst];
+    const double * pLast = &m_Coordinates[2 * nLast];
+    const double * pPoint = &m_Coordinates[2 * nPoint];
+
+    // Distance from the segment, not from the line, so that reversals of the curve are kept
+    double dDX = pLast[0] - pFirst[0];
+    double dDY = pLast[1] - pFirst[1];
+    double dPX = pPoint[0] - pFirst[0];
+    double dPY = pPoint[1] - pFirst[1];
+    double dLengthSquared = dDX * dDX + dDY * dDY;
+    if (dLengthSquared > 0.0) {
+        double dT = std::min(1.0, std::max(0.0, (dPX * dDX + dPY * dDY) / dLengthSquared));
+        dPX -= dT * dDX;
+        dPY -= dT * dDY;
+    }
+    double dError = relativeError(std::sqrt(dPX * dPX + dPY * dPY), dTolerance);
+
+    if (pFactors != nullptr) {
+        double dLength = m_ArcLengths[nLast] - m_ArcLengths[nFirst];
+        double dU = (dLength > 0.0) ? (m_ArcLengths[nPoint] - m_ArcLengths[nFirst]) / dLength : 0.0;
+        double dFirstFactor = pFactors[nFirst % nPointCount];
+        double dLastFactor = pFactors[nLast % nPointCount];
+        double dFactor = (1.0 - dU) * dFirstFactor + dU * dLastFactor;
+        dError = std::max(dError, relativeError(std::fabs(pFactors[nPoint] - dFactor), m_dFactorTolerance));
+    }
+
+    return dError;
+}
+
+void CToolpathCurveSimplifier::markPoints(const double * pFactors, size_t nPointCount, bool bClosed, double dTolerance)
+{
+    size_t nLast = bClosed ? nPointCount : nPointCount - 1;
+    m_Keep.assign(nLast + 1, 0);
+    m_Keep[0] = 1;
+    m_Keep[nLast] = 1;
+
+    if (pFactors != nullptr) {
+        m_ArcLengths.resize(nLast + 1);
+        m_ArcLengths[0] = 0.0;
+        for (size_t nIndex = 1; nIndex <= nLast; nIndex++) {
+            double dDX = m_Coordinates[2 * nIndex] - m_Coordinates[2 * nIndex - 2];
+            double dDY = m_Coordinates[2 * nIndex + 1] - m_Coordinates[2 * nIndex - 1];
+            m_ArcLengths[nIndex] = m_ArcLengths[nIndex - 1] + std::sqrt(dDX * dDX + dDY * dDY);
+        }
+    }
+
+    // A loop is split at its first point and the point farthest from it
+    m_Spans.clear();
+    size_t nFarthest = 0;
+    if (bClosed) {
+        double dMaxDistance = -1.0;
+        for (size_t nIndex = 1; nIndex < nPointCount; nIndex++) {
+            double dDX = m_Coordinates[2 * nIndex] - m_Coordinates[0];
+            double dDY = m_Coordinates[2 * nIndex + 1] - m_Coordinates[1];
+            if (dDX * dDX + dDY * dDY > dMaxDistance) {
+                dMaxDistance = dDX * dDX + dDY * dDY;
+                nFarthest = nIndex;
+            }
+        }
+        m_Keep[nFarthest] = 1;
+        m_Spans.push_back(std::make_pair((size_t)0, nFarthest));
+        m_Spans.push_back(std::make_pair(nFarthest, nLast));
+    }
+    else {
+        m_Spans.push_back(std::make_pair((size_t)0, nLast));
+    }
+
+    // Spans are split at their worst point until every point between kept points is within the tolerances
+    while (!m_Spans.empty()) {
+        std::pair<size_t, size_t> span = m_Spans.back();
+        m_Spans.pop_back();
+
+        double dMaxError = 1.0;
+        size_t nSplit = span.first;
+        for (size_t nIndex = span.first + 1; nIndex < span.second; nIndex++) {
+            double dError = spanError(pFactors, nPointCount, span.first, span.second, nIndex, dTolerance);
+            if (dError > dMaxError) {
+                dMaxError = dError;
+                nSplit = nIndex;
+            }
+        }
+
+        if (nSplit != span.first) {
+            m_Keep[nSplit] = 1;
+            m_Spans.push_back(std::make_pair(span.first, nSplit));
+            m_Spans.push_back(std::make_pair(nSplit, span.second));
+        }
+    }
+
+    // A loop that collapsed to a line keeps the point farthest from it
+    if (bClosed) {
+        size_t nKeptCount = 0;
+        for (size_t nIndex = 0; nIndex < nPointCount; nIndex++)
+            nKeptCount += m_Keep[nIndex];
+
+        if (nKeptCount < 3) {
+            double dMaxError = -1.0;
+            size_t nThird = 0;
+            for (size_t nIndex = 1; nIndex < nPointCount; nIndex++) {
+                if (nIndex == nFarthest)
+                    continue;
+                double dError = spanError(nullptr, nPointCount, 0, nFarthest, nIndex, 1.0);
+                if (dError > dMaxError) {
+                    dMaxError = dError;
+                    nThird = nIndex;
+                }
+            }
+            m_Keep[nThird] = 1;
+        }
+    }
+}
+
+template <typename T> size_t CToolpathCurveSimplifier::simplify(T * pPoints, double * pFactors, size_t nPointCount, bool bClosed, double dScale)
+{
+    if ((pPoints == nullptr) && (nPointCount > 0))
+        throw std::invalid_argument("invalid curve points");
+
+    m_Report.m_nCurveCount++;
+    m_Report.m_nInputPointCount += nPointCount;
+    if (nPointCount <= (bClosed ? (size_t)3 : (size_t)2)) {
+        m_Report.m_nOutputPointCount += nPointCount;
+        return nPointCount;
+    }
+
+    size_t nLoadCount = bClosed ? nPointCount + 1 : nPointCount;
+    m_Coordinates.resize(2 * nLoadCount);
+    for (size_t nIndex = 0; nIndex < nLoadCount; nIndex++) {
+        const T & point = pPoints[(nIndex < nPointCount) ? nIndex : 0];
+        m_Coordinates[2 * nIndex] = (double)point.m_Coordinates[0];
+        m_Coordinates[2 * nIndex + 1] = (double)point.m_Coordinates[1];
+    }
+
+    markPoints(pFactors, nPointCount, bClosed, m_dTolerance * dScale);
+
+    size_t nKeptCount = 0;
+    for (size_t nIndex = 0; nIndex < nPointCount; nIndex++) {
+        if (m_Keep[nIndex]) {
+            pPoints[nKeptCount] = pPoints[nIndex];
+            if (pFactors != nullptr)
+                pFactors[nKeptCount] = pFactors[nIndex];
+            nKeptCount++;
+        }
+    }
+
+    m_Report.m_nOutputPointCount += nKeptCount;
+    return nKeptCount;
+}
+
+size_t CToolpathCurveSimplifier::Simplify(Lib3MF::sDiscretePosition2D * pPoints, double * pFactors, size_t nPointCount, bool bClosed)
+{
+    return simplify(pPoints, pFactors, nPointCount, bClosed, 1.0);
+}
+
+size_t CToolpathCurveSimplifier::SimplifyInModelUnits(Lib3MF::sPosition2D * pPoints, double * pFactors, size_t nPointCount, bool bClosed, double dUnits)
+{
+    if (!(dUnits > 0.0))
+        throw std::invalid_argument("invalid units");
+
+    return simplify(pPoints, pFactors, nPointCount, bClosed, dUnits);
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,137 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#ifndef __TOOLPATHEXAMPLE_CURVESIMPLIFIER
+#define __TOOLPATHEXAMPLE_CURVESIMPLIFIER
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+
+namespace ToolpathExample {
+
+/**
+* Point counts of the curves passed to a CToolpathCurveSimplifier since its report was reset.
+*/
+typedef struct sToolpathSimplificationReport {
+    uint64_t m_nCurveCount;
+    uint64_t m_nInputPointCount;
+    uint64_t m_nOutputPointCount;
+} sToolpathSimplificationReport;
+
+/*************************************************************************************************************************
+ Class CToolpathCurveSimplifier
+
+ Removes points from loops and polylines with the Douglas-Peucker algorithm. Every removed point lies within the
+ tolerance of the segment that replaces it, and its factor differs by at most the factor tolerance from the factor
+ linearly interpolated along the curve between the remaining points, so scanners that interpolate factors along a
+ segment see the same profile. Polylines keep their end points, loops keep at least three points.
+ Curves are simplified in place; the scratch storage keeps its capacity, so one simplifier should be used per thread.
+**************************************************************************************************************************/
+class CToolpathCurveSimplifier {
+private:
+    double m_dTolerance;
+    double m_dFactorTolerance;
+    sToolpathSimplificationReport m_Report;
+
+    // Scratch storage, closed curves repeat their first point at the end
+    std::vector<double> m_Coordinates;
+    std::vector<double> m_ArcLengths;
+    std::vector<uint8_t> m_Keep;
+    std::vector<std::pair<size_t, size_t>> m_Spans;
+
+    template <typename T> size_t simplify(T * pPoints, double * pFactors, size_t nPointCount, bool bClosed, double dScale);
+    double spanError(const double * pFactors, size_t nPointCount, size_t nFirst, size_t nLast, size_t nPoint, double dTolerance) const;
+    void markPoints(const double * pFactors, size_t nPointCount, bool bClosed, double dTolerance);
+
+public:
+
+    /**
+    * CToolpathCurveSimplifier::CToolpathCurveSimplifier - Creates a simplifier that only removes collinear points
+    *   with linearly interpolated factors.
+    */
+    CToolpathCurveSimplifier();
+
+    /**
+    * CToolpathCurveSimplifier::SetTolerance - Sets the allowed deviation of the simplified curve.
+    * @param[in] dTolerance - Largest distance of a removed point from the remaining curve in toolpath units
+    * @param[in] dFactorTolerance - Largest difference of the factor of a removed point from the interpolated factor
+    */
+    void SetTolerance(double dTolerance, double dFactorTolerance);
+
+    double GetTolerance() const { return m_dTolerance; }
+    double GetFactorTolerance() const { return m_dFactorTolerance; }
+
+    /**
+    * CToolpathCurveSimplifier::Simplify - Simplifies a curve in toolpath units in place.
+    * @param[in,out] pPoints - Points of the curve, the remaining points are moved to the front
+    * @param[in,out] pFactors - Factor of every point, moved along with the points, nullptr for curves without factors
+    * @param[in] nPointCount - Number of points
+    * @param[in] bClosed - true for a loop, false for a polyline
+    * @return Number of remaining points
+    */
+    size_t Simplify(Lib3MF::sDiscretePosition2D * pPoints, double * pFactors, size_t nPointCount, bool bClosed);
+
+    /**
+    * CToolpathCurveSimplifier::SimplifyInModelUnits - Simplifies a curve in model units in place.
+    * @param[in,out] pPoints - Points of the curve, the remaining points are moved to the front
+    * @param[in,out] pFactors - Factor of every point, moved along with the points, nullptr for curves without factors
+    * @param[in] nPointCount - Number of points
+    * @param[in] bClosed - true for a loop, false for a polyline
+    * @param[in] dUnits - Size of a toolpath unit in model units, scales the tolerance
+    * @return Number of remaining points
+    */
+    size_t SimplifyInModelUnits(Lib3MF::sPosition2D * pPoints, double * pFactors, size_t nPointCount, bool bClosed, double dUnits);
+
+    /**
+    * CToolpathCurveSimplifier::GetReport - Returns the point counts before and after simplification.
+    * @return Counts accumulated over all curves since the last ResetReport
+    */
+    const sToolpathSimplificationReport & GetReport() const { return m_Report; }
+
+    /**
+    * CToolpathCurveSimplifier::ResetReport - Sets all counts of the report to zero.
+    */
+    void ResetReport();
+
+};
+
+typedef std::shared_ptr<CToolpathCurveSimplifier> PToolpathCurveSimplifier;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_CURVESIMPLIFIER
@@ -0,0 +1,516 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathEnergyDensity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define __TOOLPATHEXAMPLE_ENERGYDENSITY_SSE2
+#include <emmintrin.h>
+#endif
+
+// Upper bound for the sample count of a single vector, keeps the sample loops far away from the uint32_t range
+#define ENERGYDENSITY_MAXSAMPLECOUNT 1073741824.0
+
+// Largest distance of tessellated arc paths from their arcs, as a fraction of the cell size
+#define ENERGYDENSITY_ARCTOLERANCE 0.01
+
+namespace ToolpathExample {
+
+static sEnergyDensityParameter readProfileParameter(Lib3MF::PToolpathProfile pProfile, const std::string & sValueName)
+{
+    sEnergyDensityParameter parameter;
+    parameter.m_dBaseValue = pProfile->GetParameterDoubleValueDef("", sValueName, 0.0);
+    parameter.m_ModificationType = Lib3MF::eToolpathProfileModificationType::NoModification;
+    parameter.m_ModificationFactor = Lib3MF::eToolpathProfileModificationFactor::Unknown;
+    parameter.m_dMinValue = parameter.m_dBaseValue;
+    parameter.m_dMaxValue = parameter.m_dBaseValue;
+
+    if (pProfile->HasModifier("", sValueName))
+        pProfile->GetModifierInformationByName("", sValueName, parameter.m_ModificationType, parameter.m_ModificationFactor, parameter.m_dMinValue, parameter.m_dMaxValue);
+
+    return parameter;
+}
+
+static bool parameterUsesFactors(Lib3MF::PToolpathLayerReader pLayerReader, uint32_t nSegmentIndex, const sEnergyDensityParameter & parameter)
+{
+    if (parameter.m_ModificationType == Lib3MF::eToolpathProfileModificationType::NoModification)
+        return false;
+
+    return pLayerReader->SegmentHasModificationFactors(nSegmentIndex, parameter.m_ModificationFactor);
+}
+
+static inline double evaluateParameter(const sEnergyDensityParameter & parameter, bool bHasFactor, double dFactor)
+{
+    if (!bHasFactor)
+        return parameter.m_dBaseValue;
+
+    return parameter.m_dMinValue + dFactor * (parameter.m_dMaxValue - parameter.m_dMinValue);
+}
+
+static inline double lineEnergy(double dLaserPower, double dLaserSpeed)
+{
+    if (dLaserSpeed <= 0.0)
+        return 0.0;
+
+    return dLaserPower / dLaserSpeed;
+}
+
+// Evaluates the piecewise linear factor curve (0, f1), (t_0, f_0), ..., (1, f2) at dT.
+// nCursor is advanced monotonically, so the knots must be queried in ascending order.
+static double interpolateFactor(double dFactor1, double dFactor2, const Lib3MF::sHatchModificationInterpolationData * pData, uint32_t nCount, double dT, uint32_t & nCursor)
+{
+    while ((nCursor < nCount) && (pData[nCursor].m_Parameter <= dT))
+        nCursor++;
+
+    double dT0 = 0.0;
+    double dF0 = dFactor1;
+    if (nCursor > 0) {
+        dT0 = pData[nCursor - 1].m_Parameter;
+        dF0 = pData[nCursor - 1].m_Factor;
+    }
+
+    double dT1 = 1.0;
+    double dF1 = dFactor2;
+    if (nCursor < nCount) {
+        dT1 = pData[nCursor].m_Parameter;
+        dF1 = pData[nCursor].m_Factor;
+    }
+
+    if (dT1 <= dT0)
+        return dF0;
+
+    return dF0 + (dF1 - dF0) * (dT - dT0) / (dT1 - dT0);
+}
+
+CEnergyDensityRasterizer::CEnergyDensityRasterizer(const sEnergyDensityGrid & grid, PToolpathThreadPool pThreadPool)
+    : m_Grid(grid), m_pThreadPool(pThreadPool), m_nSamplesPerCell(4)
+{
+    if ((m_Grid.m_dCellSize <= 0.0) || (m_Grid.m_nCellCountX == 0) || (m_Grid.m_nCellCountY == 0))
+        throw std::invalid_argument("invalid energy density grid");
+}
+
+const sEnergyDensityGrid & CEnergyDensityRasterizer::GetGrid() const
+{
+    return m_Grid;
+}
+
+void CEnergyDensityRasterizer::SetSamplesPerCell(uint32_t nSamplesPerCell)
+{
+    if (nSamplesPerCell == 0)
+        throw std::invalid_argument("samples per cell must be at least 1");
+
+    m_nSamplesPerCell = nSamplesPerCell;
+}
+
+const sEnergyDensityProfile & CEnergyDensityRasterizer::getSegmentProfile(Lib3MF::PToolpathLayerReader pLayerReader, uint32_t nSegmentIndex, std::map<uint32_t, const sEnergyDensityProfile *> & localProfiles)
+{
+    // Profile IDs are local to the layer, UUIDs are not.
+    uint32_t nProfileID = pLayerReader->GetSegmentDefaultProfileID(nSegmentIndex);
+    auto iLocal = localProfiles.find(nProfileID);
+    if (iLocal != localProfiles.end())
+        return *iLocal->second;
+
+    auto pProfile = pLayerReader->GetSegmentDefaultProfile(nSegmentIndex);
+    std::string sUUID = pProfile->GetUUID();
+
+    auto iCached = m_ProfileCache.find(sUUID);
+    if (iCached == m_ProfileCache.end()) {
+        sEnergyDensityProfile profile;
+        profile.m_LaserPower = readProfileParameter(pProfile, "laserpower");
+        profile.m_LaserSpeed = readProfileParameter(pProfile, "laserspeed");
+        iCached = m_ProfileCache.insert(std::make_pair(sUUID, profile)).first;
+    }
+
+    localProfiles.insert(std::make_pair(nProfileID, &iCached->second));
+    return iCached->second;
+}
+
+void CEnergyDensityRasterizer::collectPointSegment(Lib3MF::PToolpathLayerReader pLayerReader, uint32_t nSegmentIndex, const sEnergyDensityProfile & profile, bool bClosed, std::vector<sEnergyDensityVector> & vectors)
+{
+    pLayerReader->GetSegmentPointDataInModelUnits(nSegmentIndex, m_PointBuffer);
+    size_t nPointCount = m_PointBuffer.size();
+    if (nPointCount < 2)
+        return;
+
+    bool bPowerFactors = parameterUsesFactors(pLayerReader, nSegmentIndex, profile.m_LaserPower);
+    if (bPowerFactors)
+        pLayerReader->GetSegmentPointModificationFactors(nSegmentIndex, profile.m_LaserPower.m_ModificationFactor, m_PowerFactorBuffer);
+
+    bool bSpeedFactors = parameterUsesFactors(pLayerReader, nSegmentIndex, profile.m_LaserSpeed);
+    if (bSpeedFactors)
+        pLayerReader->GetSegmentPointModificationFactors(nSegmentIndex, profile.m_LaserSpeed.m_ModificationFactor, m_SpeedFactorBuffer);
+
+    // Arc paths deposit their energy along the arcs, not along the chords between their points
+    if (CToolpathArcPath::IsArcPath(pLayerReader, nSegmentIndex)) {
+        tessellateArcPath(bClosed, bPowerFactors, bSpeedFactors);
+        nPointCount = m_PointBuffer.size();
+        if (nPointCount < 2)
+            return;
+    }
+
+    auto pointEnergy = [&](size_t nPointIndex) {
+        double dPower = evaluateParameter(profile.m_LaserPower, bPowerFactors, bPowerFactors ? m_PowerFactorBuffer.at(nPointIndex) : 0.0);
+        double dSpeed = evaluateParameter(profile.m_LaserSpeed, bSpeedFactors, bSpeedFactors ? m_SpeedFactorBuffer.at(nPointIndex) : 0.0);
+        return (float)lineEnergy(dPower, dSpeed);
+    };
+
+    size_t nVectorCount = bClosed ? nPointCount : nPointCount - 1;
+    float fEnergy1 = pointEnergy(0);
+    for (size_t nVectorIndex = 0; nVectorIndex < nVectorCount; nVectorIndex++) {
+        size_t nNextIndex = (nVectorIndex + 1) % nPointCount;
+        float fEnergy2 = pointEnergy(nNextIndex);
+
+        sEnergyDensityVector vector;
+        vector.m_fX1 = m_PointBuffer[nVectorIndex].m_Coordinates[0];
+        vector.m_fY1 = m_PointBuffer[nVectorIndex].m_Coordinates[1];
+        vector.m_fX2 = m_PointBuffer[nNextIndex].m_Coordinates[0];
+        vector.m_fY2 = m_PointBuffer[nNextIndex].m_Coordinates[1];
+        vector.m_fLineEnergy1 = fEnergy1;
+        vector.m_fLineEnergy2 = fEnergy2;
+        vectors.push_back(vector);
+
+        fEnergy1 = fEnergy2;
+    }
+}
+
+void CEnergyDensityRasterizer::tessellateArcPath(bool bClosed, bool bPowerFactors, bool bSpeedFactors)
+{
+    double dTolerance = m_Grid.m_dCellSize * ENERGYDENSITY_ARCTOLERANCE;
+
+    // Each factor is tessellated on its own, the tessellated points are the same every time
+    m_ArcPath.SetPoints(m_PointBuffer.data(), bPowerFactors ? m_PowerFactorBuffer.data() : nullptr, m_PointBuffer.size(), bClosed);
+    m_ArcPath.Tessellate(dTolerance, m_TessellatedPoints, m_TessellatedFactors);
+    if (bPowerFactors)
+        m_PowerFactorBuffer.swap(m_TessellatedFactors);
+
+    if (bSpeedFactors) {
+        m_ArcPath.SetPoints(m_PointBuffer.data(), m_SpeedFactorBuffer.data(), m_PointBuffer.size(), bClosed);
+        m_ArcPath.Tessellate(dTolerance, m_TessellatedPoints, m_TessellatedFactors);
+        m_SpeedFactorBuffer.swap(m_TessellatedFactors);
+    }
+
+    m_PointBuffer.swap(m_TessellatedPoints);
+}
+
+void CEnergyDensityRasterizer::collectHatchSegment(Lib3MF::PToolpathLayerReader pLayerReader, uint32_t nSegmentIndex, const sEnergyDensityProfile & profile, std::vector<sEnergyDensityVector> & vectors)
+{
+    pLayerReader->GetSegmentHatchDataInModelUnits(nSegmentIndex, m_HatchBuffer);
+    size_t nHatchCount = m_HatchBuffer.size();
+    if (nHatchCount == 0)
+        return;
+
+    bool bHasNonlinearInterpolation = pLayerReader->SegmentHasNonlinearHatchModificationInterpolation(nSegmentIndex);
+
+    bool bPowerFactors = parameterUsesFactors(pLayerReader, nSegmentIndex, profile.m_LaserPower);
+    bool bPowerNonlinear = bPowerFactors && bHasNonlinearInterpolation && (profile.m_LaserPower.m_ModificationType == Lib3MF::eToolpathProfileModificationType::NonlinearModification);
+    if (bPowerFactors)
+        pLayerReader->GetLinearSegmentHatchModificationFactors(nSegmentIndex, profile.m_LaserPower.m_ModificationFactor, m_PowerHatchFactorBuffer);
+    if (bPowerNonlinear)
+        pLayerReader->GetSegmentAllNonlinearHatchesModificationInterpolation(nSegmentIndex, profile.m_LaserPower.m_ModificationFactor, m_PowerCountBuffer, m_PowerInterpolationBuffer);
+
+    bool bSpeedFactors = parameterUsesFactors(pLayerReader, nSegmentIndex, profile.m_LaserSpeed);
+    bool bSpeedNonlinear = bSpeedFactors && bHasNonlinearInterpolation && (profile.m_LaserSpeed.m_ModificationType == Lib3MF::eToolpathProfileModificationType::NonlinearModification);
+    if (bSpeedFactors)
+        pLayerReader->GetLinearSegmentHatchModificationFactors(nSegmentIndex, profile.m_LaserSpeed.m_ModificationFactor, m_SpeedHatchFactorBuffer);
+    if (bSpeedNonlinear)
+        pLayerReader->GetSegmentAllNonlinearHatchesModificationInterpolation(nSegmentIndex, profile.m_LaserSpeed.m_ModificationFactor, m_SpeedCountBuffer, m_SpeedInterpolationBuffer);
+
+    size_t nPowerOffset = 0;
+    size_t nSpeedOffset = 0;
+
+    for (size_t nHatchIndex = 0; nHatchIndex < nHatchCount; nHatchIndex++) {
+        auto & hatch = m_HatchBuffer[nHatchIndex];
+
+        double dPowerFactor1 = 0.0, dPowerFactor2 = 0.0;
+        if (bPowerFactors) {
+            dPowerFactor1 = m_PowerHatchFactorBuffer.at(nHatchIndex).m_Point1Factor;
+            dPowerFactor2 = m_PowerHatchFactorBuffer.at(nHatchIndex).m_Point2Factor;
+        }
+        double dSpeedFactor1 = 0.0, dSpeedFactor2 = 0.0;
+        if (bSpeedFactors) {
+            dSpeedFactor1 = m_SpeedHatchFactorBuffer.at(nHatchIndex).m_Point1Factor;
+            dSpeedFactor2 = m_SpeedHatchFactorBuffer.at(nHatchIndex).m_Point2Factor;
+        }
+
+        const Lib3MF::sHatchModificationInterpolationData * pPowerData = nullptr;
+        uint32_t nPowerCount = 0;
+        if (bPowerNonlinear) {
+            nPowerCount = m_PowerCountBuffer.at(nHatchIndex);
+            if (nPowerOffset + nPowerCount > m_PowerInterpolationBuffer.size())
+                throw std::runtime_error("inconsistent hatch interpolation data");
+            pPowerData = m_PowerInterpolationBuffer.data() + nPowerOffset;
+            nPowerOffset += nPowerCount;
+        }
+
+        const Lib3MF::sHatchModificationInterpolationData * pSpeedData = nullptr;
+        uint32_t nSpeedCount = 0;
+        if (bSpeedNonlinear) {
+            nSpeedCount = m_SpeedCountBuffer.at(nHatchIndex);
+            if (nSpeedOffset + nSpeedCount > m_SpeedInterpolationBuffer.size())
+                throw std::runtime_error("inconsistent hatch interpolation data");
+            pSpeedData = m_SpeedInterpolationBuffer.data() + nSpeedOffset;
+            nSpeedOffset += nSpeedCount;
+        }
+
+        // Split the hatch at every interpolation knot of either parameter.
+        m_KnotBuffer.clear();
+        m_KnotBuffer.push_back(0.0);
+        for (uint32_t nKnotIndex = 0; nKnotIndex < nPowerCount; nKnotIndex++)
+            m_KnotBuffer.push_back(pPowerData[nKnotIndex].m_Parameter);
+        for (uint32_t nKnotIndex = 0; nKnotIndex < nSpeedCount; nKnotIndex++)
+            m_KnotBuffer.push_back(pSpeedData[nKnotIndex].m_Parameter);
+        m_KnotBuffer.push_back(1.0);
+        if (nPowerCount + nSpeedCount > 0) {
+            std::sort(m_KnotBuffer.begin(), m_KnotBuffer.end());
+            m_KnotBuffer.erase(std::unique(m_KnotBuffer.begin(), m_KnotBuffer.end()), m_KnotBuffer.end());
+        }
+
+        uint32_t nPowerCursor = 0;
+        uint32_t nSpeedCursor = 0;
+        auto knotEnergy = [&](double dT) {
+            double dPower = evaluateParameter(profile.m_LaserPower, bPowerFactors, interpolateFactor(dPowerFactor1, dPowerFactor2, pPowerData, nPowerCount, dT, nPowerCursor));
+            double dSpeed = evaluateParameter(profile.m_LaserSpeed, bSpeedFactors, interpolateFactor(dSpeedFactor1, dSpeedFactor2, pSpeedData, nSpeedCount, dT, nSpeedCursor));
+            return (float)lineEnergy(dPower, dSpeed);
+        };
+
+        double dDeltaX = hatch.m_Point2Coordinates[0] - hatch.m_Point1Coordinates[0];
+        double dDeltaY = hatch.m_Point2Coordinates[1] - hatch.m_Point1Coordinates[1];
+
+        double dT1 = m_KnotBuffer[0];
+        float fEnergy1 = knotEnergy(dT1);
+        for (size_t nKnotIndex = 1; nKnotIndex < m_KnotBuffer.size(); nKnotIndex++) {
+            double dT2 = m_KnotBuffer[nKnotIndex];
+            float fEnergy2 = knotEnergy(dT2);
+
+            sEnergyDensityVector vector;
+            vector.m_fX1 = (float)(hatch.m_Point1Coordinates[0] + dDeltaX * dT1);
+            vector.m_fY1 = (float)(hatch.m_Point1Coordinates[1] + dDeltaY * dT1);
+            vector.m_fX2 = (float)(hatch.m_Point1Coordinates[0] + dDeltaX * dT2);
+            vector.m_fY2 = (float)(hatch.m_Point1Coordinates[1] + dDeltaY * dT2);
+            vector.m_fLineEnergy1 = fEnergy1;
+            vector.m_fLineEnergy2 = fEnergy2;
+            vectors.push_back(vector);
+
+            dT1 = dT2;
+            fEnergy1 = fEnergy2;
+        }
+    }
+}
+
+void CEnergyDensityRasterizer::CollectVectors(Lib3MF::PToolpathLayerReader pLayerReader, std::vector<sEnergyDensityVector> & vectors)
+{
+    CToolpathTraceSpan span(m_pTracer.get(), "CollectVectors", "rasterize");
+    if (pLayerReader.get() == nullptr)
+        throw std::invalid_argument("invalid layer reader");
+
+    vectors.clear();
+    std::map<uint32_t, const sEnergyDensityProfile *> localProfiles;
+
+    uint32_t nSegmentCount = pLayerReader->GetSegmentCount();
+    for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+        Lib3MF::eToolpathSegmentType segmentType;
+        uint32_t nPointCount = 0;
+        pLayerReader->GetSegmentInfo(nSegmentIndex, segmentType, nPointCount);
+
+        switch (segmentType) {
+        case Lib3MF::eToolpathSegmentType::Loop:
+            collectPointSegment(pLayerReader, nSegmentIndex, getSegmentProfile(pLayerReader, nSegmentIndex, localProfiles), true, vectors);
+            break;
+        case Lib3MF::eToolpathSegmentType::Polyline:
+            collectPointSegment(pLayerReader, nSegmentIndex, getSegmentProfile(pLayerReader, nSegmentIndex, localProfiles), false, vectors);
+            break;
+        case Lib3MF::eToolpathSegmentType::Hatch:
+            collectHatchSegment(pLayerReader, nSegmentIndex, getSegmentProfile(pLayerReader, nSegmentIndex, localProfiles), vectors);
+            break;
+        default:
+            // Point sequences, delays and syncs do not deposit energy along a path.
+            break;
+        }
+    }
+}
+
+void CEnergyDensityRasterizer::rasterizeVector(const sEnergyDensityVector & vector, float * pImage)
+{
+    const double dInvCellSize = 1.0 / m_Grid.m_dCellSize;
+    const double dDeltaX = (double)vector.m_fX2 - (double)vector.m_fX1;
+    const double dDeltaY = (double)vector.m_fY2 - (double)vector.m_fY1;
+    const double dLength = sqrt(dDeltaX * dDeltaX + dDeltaY * dDeltaY);
+    if (dLength <= 0.0)
+        return;
+
+    const uint32_t nCellCountX = m_Grid.m_nCellCountX;
+    const uint32_t nCellCountY = m_Grid.m_nCellCountY;
+
+    // Every sample represents an equal share of the vector length and is deposited into the cell it falls into.
+    double dSampleCount = ceil(dLength * dInvCellSize * m_nSamplesPerCell);
+    if (!(dSampleCount <= ENERGYDENSITY_MAXSAMPLECOUNT))
+        throw std::range_error("vector has too many samples for the grid cell size");
+    uint32_t nSampleCount = (dSampleCount < 1.0) ? 1 : (uint32_t)dSampleCount;
+
+    const float fStartX = (float)(((double)vector.m_fX1 - m_Grid.m_dOriginX) * dInvCellSize);
+    const float fStartY = (float)(((double)vector.m_fY1 - m_Grid.m_dOriginY) * dInvCellSize);
+    const float fStepX = (float)(dDeltaX * dInvCellSize);
+    const float fStepY = (float)(dDeltaY * dInvCellSize);
+    const float fScale = (float)((dLength / nSampleCount) * dInvCellSize * dInvCellSize);
+    const float fEnergy1 = vector.m_fLineEnergy1 * fScale;
+    const float fEnergyStep = (vector.m_fLineEnergy2 - vector.m_fLineEnergy1) * fScale;
+    const float fInvSampleCount = 1.0f / (float)nSampleCount;
+
+#ifdef __TOOLPATHEXAMPLE_ENERGYDENSITY_SSE2
+    const __m128 vStartX = _mm_set1_ps(fStartX);
+    const __m128 vStartY = _mm_set1_ps(fStartY);
+    const __m128 vStepX = _mm_set1_ps(fStepX);
+    const __m128 vStepY = _mm_set1_ps(fStepY);
+    const __m128 vEnergy1 = _mm_set1_ps(fEnergy1);
+    const __m128 vEnergyStep = _mm_set1_ps(fEnergyStep);
+    const __m128 vInvSampleCount = _mm_set1_ps(fInvSampleCount);
+    const __m128 vSampleCount = _mm_set1_ps((float)nSampleCount);
+    const __m128 vCellCountX = _mm_set1_ps((float)nCellCountX);
+    const __m128 vCellCountY = _mm_set1_ps((float)nCellCountY);
+    const __m128 vZero = _mm_setzero_ps();
+    __m128 vSampleIndex = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 vFour = _mm_set1_ps(4.0f);
+
+    alignas(16) int32_t cellX[4];
+    alignas(16) int32_t cellY[4];
+    alignas(16) float energy[4];
+
+    for (uint32_t nSampleIndex = 0; nSampleIndex < nSampleCount; nSampleIndex += 4) {
+        __m128 vT = _mm_mul_ps(vSampleIndex, vInvSampleCount);
+        __m128 vX = _mm_add_ps(vStartX, _mm_mul_ps(vStepX, vT));
+        __m128 vY = _mm_add_ps(vStartY, _mm_mul_ps(vStepY, vT));
+        __m128 vEnergy = _mm_add_ps(vEnergy1, _mm_mul_ps(vEnergyStep, vT));
+
+        // Samples outside the grid and beyond the last sample contribute nothing.
+        __m128 vMask = _mm_and_ps(_mm_cmpge_ps(vX, vZero), _mm_cmplt_ps(vX, vCellCountX));
+        vMask = _mm_and_ps(vMask, _mm_and_ps(_mm_cmpge_ps(vY, vZero), _mm_cmplt_ps(vY, vCellCountY)));
+        vMask = _mm_and_ps(vMask, _mm_cmplt_ps(vSampleIndex, vSampleCount));
+
+        // Coordinates are non-negative where the mask is set, so truncation equals floor.
+        _mm_store_si128((__m128i *)cellX, _mm_cvttps_epi32(_mm_and_ps(vX, vMask)));
+        _mm_store_si128((__m128i *)cellY, _mm_cvttps_epi32(_mm_and_ps(vY, vMask)));
+        _mm_store_ps(energy, _mm_and_ps(vEnergy, vMask));
+
+        for (uint32_t nLane = 0; nLane < 4; nLane++)
+            pImage[(size_t)cellY[nLane] * nCellCountX + (size_t)cellX[nLane]] += energy[nLane];
+
+        vSampleIndex = _mm_add_ps(vSampleIndex, vFour);
+    }
+#else
+    for (uint32_t nSampleIndex = 0; nSampleIndex < nSampleCount; nSampleIndex++) {
+        float fT = ((float)nSampleIndex + 0.5f) * fInvSampleCount;
+        float fX = fStartX + fStepX * fT;
+        float fY = fStartY + fStepY * fT;
+        if ((fX >= 0.0f) && (fX < (float)nCellCountX) && (fY >= 0.0f) && (fY < (float)nCellCountY))
+            pImage[(size_t)fY * nCellCountX + (size_t)fX] += fEnergy1 + fEnergyStep * fT;
+    }
+#endif
+}
+
+void CEnergyDensityRasterizer::RasterizeVectors(const std::vector<sEnergyDensityVector> & vectors, std::vector<float> & image)
+{
+    size_t nCellCount = (size_t)m_Grid.m_nCellCountX * (size_t)m_Grid.m_nCellCountY;
+
+    // One task per thread with a fixed vector range, so that the summation order only depends on the thread count.
+    uint32_t nTaskCount = (m_pThreadPool.get() != nullptr) ? m_pThreadPool->GetThreadCount() : 1;
+    if ((size_t)nTaskCount > vectors.size())
+        nTaskCount = std::max<uint32_t>((uint32_t)vectors.size(), 1);
+
+    if (m_TaskImages.size() < nTaskCount)
+        m_TaskImages.resize(nTaskCount);
+
+    auto rasterizeTask = [&](uint64_t nTaskIndex, uint32_t) {
+        CToolpathTraceSpan span(m_pTracer.get(), "RasterizeTask", "rasterize", "task", nTaskIndex);
+        auto & taskImage = m_TaskImages[nTaskIndex];
+        taskImage.assign(nCellCount, 0.0f);
+
+        size_t nBegin = (size_t)(vectors.size() * nTaskIndex / nTaskCount);
+        size_t nEnd = (size_t)(vectors.size() * (nTaskIndex + 1) / nTaskCount);
+        for (size_t nVectorIndex = nBegin; nVectorIndex < nEnd; nVectorIndex++)
+            rasterizeVector(vectors[nVectorIndex], taskImage.data());
+    };
+
+    if (nTaskCount > 1)
+        m_pThreadPool->ParallelFor(nTaskCount, rasterizeTask);
+    else
+        rasterizeTask(0, 0);
+
+    if (nTaskCount == 1) {
+        image.swap(m_TaskImages[0]);
+        return;
+    }
+
+    image.resize(nCellCount);
+
+    // Reduce the task images in row blocks
+    const size_t nBlockSize = 16384;
+    size_t nBlockCount = (nCellCount + nBlockSize - 1) / nBlockSize;
+    m_pThreadPool->ParallelFor(nBlockCount, [&](uint64_t nBlockIndex, uint32_t) {
+        CToolpathTraceSpan span(m_pTracer.get(), "ReduceBlock", "rasterize", "block", nBlockIndex);
+        size_t nBegin = (size_t)nBlockIndex * nBlockSize;
+        size_t nEnd = std::min(nBegin + nBlockSize, nCellCount);
+        float * pTarget = image.data();
+
+        const float * pSource = m_TaskImages[0].data();
+        for (size_t nCellIndex = nBegin; nCellIndex < nEnd; nCellIndex++)
+            pTarget[nCellIndex] = pSource[nCellIndex];
+
+        for (uint32_t nTaskIndex = 1; nTaskIndex < nTaskCount; nTaskIndex++) {
+            pSource = m_TaskImages[nTaskIndex].data();
+            for (size_t nCellIndex = nBegin; nCellIndex < nEnd; nCellIndex++)
+                pTarget[nCellIndex] += pSource[nCellIndex];
+        }
+    });
+}
+
+void CEnergyDensityRasterizer::SetStatistics(PToolpathStatistics pStatistics)
+{
+    m_pStatistics = pStatistics;
+}
+
+void CEnergyDensityRasterizer::SetTracer(PToolpathTracer pTracer)
+{
+    m_pTracer = pTracer;
+}
+
+void CEnergyDensityRasterizer::RasterizeLayer(Lib3MF::PToolpathLayerReader pLayerReader, std::vector<float> & image)
+{
+    CToolpathScopedTimer timer(m_pStatistics.get(), eToolpathTimer::Rasterize);
+    CToolpathTraceSpan span(m_pTracer.get(), "RasterizeLayer", "rasterize");
+    CollectVectors(pLayerReader, m_Vectors);
+    RasterizeVectors(m_Vectors, image);
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,185 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef __TOOLPATHEXAMPLE_ENERGYDENSITY
+#define __TOOLPATHEXAMPLE_ENERGYDENSITY
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+#include "ToolpathArcFitter.hpp"
+#include "ToolpathStatistics.hpp"
+#include "ToolpathThreadPool.hpp"
+#include "ToolpathTrace.hpp"
+
+namespace ToolpathExample {
+
+/* Raster definition in model units. Cell (0, 0) has its lower left corner at the origin, images are stored row by row. */
+typedef struct sEnergyDensityGrid {
+    double m_dOriginX;
+    double m_dOriginY;
+    double m_dCellSize;
+    uint32_t m_nCellCountX;
+    uint32_t m_nCellCountY;
+} sEnergyDensityGrid;
+
+/* Straight exposure vector in model units with a line energy (laser power / laser speed) that varies linearly from start to end. */
+typedef struct sEnergyDensityVector {
+    float m_fX1;
+    float m_fY1;
+    float m_fX2;
+    float m_fY2;
+    float m_fLineEnergy1;
+    float m_fLineEnergy2;
+} sEnergyDensityVector;
+
+/* Profile parameter together with the modifier that maps a segment factor onto it. */
+typedef struct sEnergyDensityParameter {
+    double m_dBaseValue;
+    Lib3MF::eToolpathProfileModificationType m_ModificationType;
+    Lib3MF::eToolpathProfileModificationFactor m_ModificationFactor;
+    double m_dMinValue;
+    double m_dMaxValue;
+} sEnergyDensityParameter;
+
+typedef struct sEnergyDensityProfile {
+    sEnergyDensityParameter m_LaserPower;
+    sEnergyDensityParameter m_LaserSpeed;
+} sEnergyDensityProfile;
+
+/*************************************************************************************************************************
+ Class CEnergyDensityRasterizer
+
+ Accumulates the energy that the exposure vectors of a layer deposit into a grid. Every cell holds
+ laserpower / laserspeed * exposed length / cell area, i.e. J/mm^2 for a model in millimeters, W and mm/s.
+ Modified parameters are evaluated as minvalue + factor * (maxvalue - minvalue) along each vector, nonlinear
+ hatch interpolation is resolved into piecewise linear sub vectors. Arc paths (see CToolpathArcPath) are tessellated
+ along their arcs if the arc path attribute has been registered with the toolpath before its layers are read.
+**************************************************************************************************************************/
+class CEnergyDensityRasterizer {
+private:
+    sEnergyDensityGrid m_Grid;
+    PToolpathThreadPool m_pThreadPool;
+    uint32_t m_nSamplesPerCell;
+    PToolpathStatistics m_pStatistics;
+    PToolpathTracer m_pTracer;
+
+    /* Profiles are cached by UUID over the lifetime of the rasterizer. */
+    std::map<std::string, sEnergyDensityProfile> m_ProfileCache;
+
+    /* Per task accumulation images and collection buffers, kept to avoid reallocation between layers. */
+    std::vector<std::vector<float>> m_TaskImages;
+    std::vector<sEnergyDensityVector> m_Vectors;
+    std::vector<Lib3MF::sPosition2D> m_PointBuffer;
+    std::vector<Lib3MF::sHatch2D> m_HatchBuffer;
+    std::vector<double> m_PowerFactorBuffer;
+    std::vector<double> m_SpeedFactorBuffer;
+    std::vector<Lib3MF::sHatch2DFactors> m_PowerHatchFactorBuffer;
+    std::vector<Lib3MF::sHatch2DFactors> m_SpeedHatchFactorBuffer;
+    std::vector<Lib3MF_uint32> m_PowerCountBuffer;
+    std::vector<Lib3MF_uint32> m_SpeedCountBuffer;
+    std::vector<Lib3MF::sHatchModificationInterpolationData> m_PowerInterpolationBuffer;
+    std::vector<Lib3MF::sHatchModificationInterpolationData> m_SpeedInterpolationBuffer;
+    std::vector<double> m_KnotBuffer;
+    CToolpathArcPath m_ArcPath;
+    std::vector<Lib3MF::sPosition2D> m_TessellatedPoints;
+    std::vector<double> m_TessellatedFactors;
+
+    const sEnergyDensityProfile & getSegmentProfile(Lib3MF::PToolpathLayerReader pLayerReader, uint32_t nSegmentIndex, std::map<uint32_t, const sEnergyDensityProfile *> & localProfiles);
+
+    void collectPointSegment(Lib3MF::PToolpathLayerReader pLayerReader, uint32_t nSegmentIndex, const sEnergyDensityProfile & profile, bool bClosed, std::vector<sEnergyDensityVector> & vectors);
+    void tessellateArcPath(bool bClosed, bool bPowerFactors, bool bSpeedFactors);
+    void collectHatchSegment(Lib3MF::PToolpathLayerReader pLayerReader, uint32_t nSegmentIndex, const sEnergyDensityProfile & profile, std::vector<sEnergyDensityVector> & vectors);
+
+    void rasterizeVector(const sEnergyDensityVector & vector, float * pImage);
+
+public:
+
+    /**
+    * CEnergyDensityRasterizer::CEnergyDensityRasterizer - Creates a rasterizer for a fixed grid.
+    * @param[in] grid - Grid in model units
+    * @param[in] pThreadPool - Thread pool to rasterize on. May be null for single threaded operation.
+    */
+    CEnergyDensityRasterizer(const sEnergyDensityGrid & grid, PToolpathThreadPool pThreadPool);
+
+    /**
+    * CEnergyDensityRasterizer::GetGrid - Returns the grid definition.
+    * @return Grid in model units
+    */
+    const sEnergyDensityGrid & GetGrid() const;
+
+    /**
+    * CEnergyDensityRasterizer::SetSamplesPerCell - Sets how many samples are taken along a vector per cell size. Default is 4.
+    * @param[in] nSamplesPerCell - Samples per cell size, at least 1
+    */
+    void SetSamplesPerCell(uint32_t nSamplesPerCell);
+
+    /**
+    * CEnergyDensityRasterizer::SetStatistics - Sets the statistics that RasterizeLayer is recorded in.
+    * @param[in] pStatistics - Statistics, null to disable
+    */
+    void SetStatistics(PToolpathStatistics pStatistics);
+
+    /**
+    * CEnergyDensityRasterizer::SetTracer - Sets the tracer that collection and rasterization spans are recorded in.
+    * @param[in] pTracer - Tracer, null to disable
+    */
+    void SetTracer(PToolpathTracer pTracer);
+
+    /**
+    * CEnergyDensityRasterizer::CollectVectors - Converts all loops, polylines and hatches of a layer into exposure vectors.
+    * @param[in] pLayerReader - Layer to convert
+    * @param[out] vectors - Exposure vectors, previous content is discarded
+    */
+    void CollectVectors(Lib3MF::PToolpathLayerReader pLayerReader, std::vector<sEnergyDensityVector> & vectors);
+
+    /**
+    * CEnergyDensityRasterizer::RasterizeVectors - Accumulates exposure vectors into an energy density image. Throws
+    *   std::range_error if a vector would need more than 2^30 samples at the current cell size.
+    * @param[in] vectors - Exposure vectors
+    * @param[out] image - Energy density per cell, resized to the grid
+    */
+    void RasterizeVectors(const std::vector<sEnergyDensityVector> & vectors, std::vector<float> & image);
+
+    /**
+    * CEnergyDensityRasterizer::RasterizeLayer - Computes the energy density image of a layer.
+    * @param[in] pLayerReader - Layer to rasterize
+    * @param[out] image - Energy density per cell, resized to the grid
+    */
+    void RasterizeLayer(Lib3MF::PToolpathLayerReader pLayerReader, std::vector<float> & image);
+
+};
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_ENERGYDENSITY
@@ -28,9 +28,24 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 #include "lib3mf_dynamic.hpp"
+#include "ToolpathArcFitter.hpp"
+#include "ToolpathEnergyDensity.hpp"
+#include "ToolpathLayerBuilder.hpp"
+#include "ToolpathMeshSlicer.hpp"
+#include "ToolpathPackage.hpp"
+#include "ToolpathParallelReader.hpp"
+#include "ToolpathProgress.hpp"
+#include "ToolpathScanStrategy.hpp"
+#include "ToolpathSegmentIterator.hpp"
+#include "ToolpathSliceGenerator.hpp"
+#include "ToolpathStatistics.hpp"
+#include "ToolpathTrace.hpp"
 
 // Convenience function to create a box geometry
 void createBoxMesh(Lib3MF::PMeshObject pMeshObject, float sizex, float sizey, float sizez)
@@ -158,6 +173,24 @@ void writeToolpathDemo (Lib3MF::PWrapper p3MFWrapper, const std::string sOutputF
     pWriter->RegisterCustomNamespace("skywriting", "http://schemas.scanlab.com/skywriting/2023/01");
     pWriter->SetCustomNamespaceRequired("mycompany", true);
 
+    // Report progress of writing layers and the package, returning false from the callback would abort writing
+    auto pWriteProgress = std::make_shared<ToolpathExample::CToolpathProgress>([](const ToolpathExample::sToolpathProgressEvent & event) {
+        if (event.m_Stage == ToolpathExample::eToolpathProgressStage::WriteLayer)
+            std::cout << "Layer " << event.m_nIndex + 1 << " of " << event.m_nCount << " written: " << event.m_nSegmentCount << " segments, " << event.m_nBytes << " bytes" << std::endl;
+        else if (event.m_dProgress >= 0.0)
+            std::cout << "Writing package: " << (int)(event.m_dProgress * 100.0) << "%" << std::endl;
+        return true;
+    });
+    pWriter->SetProgressCallback(ToolpathExample::CToolpathProgress::Lib3MFProgressCallback, pWriteProgress.get());
+
+    // Record how long passing layers to lib3mf and writing the package take
+    auto pWriteStatistics = std::make_shared<ToolpathExample::CToolpathStatistics>();
+
+    // Layer buffers are reused for all layers, so only the first layer allocates them
+    ToolpathExample::CToolpathLayerBuilder layerBuilder;
+    layerBuilder.SetProgress(pWriteProgress, 5);
+    layerBuilder.SetStatistics(pWriteStatistics);
+
     // Write Layers
     for (uint32_t nLayerIndex = 1; nLayerIndex <= 5; nLayerIndex++) {
 
@@ -174,6 +207,8 @@ void writeToolpathDemo (Lib3MF::PWrapper p3MFWrapper, const std::string sOutputF
         //auto pBinaryStream = pWriter->CreateBinaryStream(sLayerIndexPath, sLayerBinaryPath);
         //pBinaryStream->EnableLZ4(12);
            
+        ToolpathExample::CToolpathScopedTimer layerTimer(pWriteStatistics.get(), ToolpathExample::eToolpathTimer::LayerWrite);
+
         // Create Layer Object
         auto pLayer = pToolpath->AddLayer(nZHeightInMicron, sLayerPath, pWriter);
 
@@ -191,58 +226,35 @@ void writeToolpathDemo (Lib3MF::PWrapper p3MFWrapper, const std::string sOutputF
         uint32_t nAdditionalProfileID = pLayer->RegisterProfile(pAdditionalProfile);
         uint32_t nPartID = pLayer->RegisterBuildItem(pBuildItem);
 
-        // Write a dummy contour
-        std::vector<Lib3MF::sPosition2D> contourPoints;
-        std::vector<double> scaleFactorsF;
-        std::vector<uint32_t> subInterpolationCounts;
-        std::vector<Lib3MF::sHatchModificationInterpolationData> subInterpolationData;
+        // Write a dummy contour. Coordinates are given in toolpath units (micron), which lib3mf stores without conversion
+        layerBuilder.Reset();
+        layerBuilder.AddDiscretePoint(0, 0, 0.32);
+        layerBuilder.AddDiscretePoint(20000, 0, 0.425);
+        layerBuilder.AddDiscretePoint(20000, 30000, 0.525);
+        layerBuilder.AddDiscretePoint(0, 30000, 0.617);
 
-        contourPoints.push_back({ 0.0f, 0.0f });
-        scaleFactorsF.push_back(0.32);
-        
-        contourPoints.push_back({ 20.0f, 0.0f });
-        scaleFactorsF.push_back(0.425);
-
-        contourPoints.push_back({ 20.0f, 30.0f });
-        scaleFactorsF.push_back(0.525);
-
-        contourPoints.push_back({ 0.0f, 30.0f });
-        scaleFactorsF.push_back(0.617);
-
-        pLayer->WriteLoopInModelUnitsWithFactors(nContourProfileID, nPartID, contourPoints, scaleFactorsF);
+        layerBuilder.WriteLoop(pLayer, nContourProfileID, nPartID);
 
         // Write a dummy hatches
-        std::vector<Lib3MF::sHatch2D> hatchList;
-        std::vector<double> scaleParameterList1;
-        std::vector<double> scaleParameterList2;
         for (uint32_t nHatchIndex = 1; nHatchIndex < 1000; nHatchIndex++) {
-            float y = nHatchIndex * 0.015f;
-            Lib3MF::sHatch2D hatch;
-            
-            hatch.m_Point1Coordinates[0] = 0.1f;
-            hatch.m_Point1Coordinates[1] = y;            
-            hatch.m_Point2Coordinates[0] = 19.9f;
-            hatch.m_Point2Coordinates[1] = y;
-
+            int32_t nY = nHatchIndex * 15;
             double f1, f2;
+            uint32_t nTag;
                
             // Set a custom tag on each second hatch
             if (nHatchIndex % 2 == 0) {
-                hatch.m_Tag = nHatchIndex * 2 + 5;
+                nTag = nHatchIndex * 2 + 5;
                 f1 = 0.3;
                 f2 = 0.7;
             }
             else {
                 f2 = 0.3;
                 f1 = 0.7;
-                hatch.m_Tag = 0;
+                nTag = 0;
             }
 
-            scaleParameterList1.push_back(f1);
-            scaleParameterList2.push_back(f2);
-
             // Add hatch
-            hatchList.push_back(hatch);
+            layerBuilder.AddDiscreteHatch(100, nY, 19900, nY, nTag, f1, f2);
 
             uint32_t nCount = 40;
 
@@ -256,22 +268,38 @@ void writeToolpathDemo (Lib3MF::PWrapper p3MFWrapper, const std::string sOutputF
                 nCount = 18;
 
             for (uint32_t nSubIndex = 1; nSubIndex <= nCount; nSubIndex++) {
-                Lib3MF::sHatchModificationInterpolationData interpolationData;
                 double t = (double)nSubIndex / (double)(nCount + 1);
-
-                interpolationData.m_Parameter = t;
-                interpolationData.m_Factor = (1.0 - t) * f1 + t * f2 + sin(nSubIndex * 3.14159 / nCount) * 0.3;
-                subInterpolationData.push_back(interpolationData);
+                layerBuilder.AddSubInterpolation(t, (1.0 - t) * f1 + t * f2 + sin(nSubIndex * 3.14159 / nCount) * 0.3);
             }
-
-            subInterpolationCounts.push_back(nCount);
         };
-           
-        pLayer->WriteHatchDataInModelUnitsWithNonlinearFactors(nHatchProfileID, nPartID, hatchList, scaleParameterList1, scaleParameterList2, subInterpolationCounts, subInterpolationData);
 
+        layerBuilder.WriteHatches(pLayer, nHatchProfileID, nPartID);
+        layerBuilder.FinishLayer(pLayer, nLayerIndex - 1);
     }
 
-    pWriter->WriteToFile(sOutputFileName);
+    {
+        ToolpathExample::CToolpathScopedTimer writeTimer(pWriteStatistics.get(), ToolpathExample::eToolpathTimer::ModelWrite);
+        pWriter->WriteToFile(sOutputFileName);
+    }
+
+    pWriteStatistics->WriteReport(std::cout);
+}
+
+
+void outputArcPath(ToolpathExample::CToolpathArcPath & arcPath, const Lib3MF::sPosition2D * pPoints, const double * pFactors, uint32_t nPointCount, bool bClosed) {
+    arcPath.SetPoints(pPoints, pFactors, nPointCount, bClosed);
+
+    ToolpathExample::sToolpathArcElement element;
+    for (size_t nElementIndex = 0; nElementIndex < arcPath.GetElementCount(); nElementIndex++) {
+        arcPath.GetElement(nElementIndex, element);
+        if (element.m_bLine) {
+            std::cout << "  Line: " << element.m_dStartX << "/" << element.m_dStartY << " to " << element.m_dEndX << "/" << element.m_dEndY << ": " << element.m_dStartFactor << std::endl;
+        }
+        else {
+            std::cout << "  Arc: " << element.m_dStartX << "/" << element.m_dStartY << " around " << element.m_dCenterX << "/" << element.m_dCenterY
+                << ", radius " << element.m_dRadius << ", sweep " << element.m_dSweepAngle << ": " << element.m_dStartFactor << " to " << element.m_dEndFactor << std::endl;
+        }
+    }
 }
 
 
@@ -339,6 +367,13 @@ void readToolpathDemo(Lib3MF::PWrapper p3MFWrapper, const std::string sInputFile
             outputCustomData(pCustomData->GetRootNode (), "", "  ");
         }
 
+        // Arc paths can only be recognized if the attribute is registered before layers are read
+        ToolpathExample::CToolpathArcPath::RegisterAttribute(pToolpath);
+        ToolpathExample::CToolpathArcPath arcPath;
+
+        // Point and hatch buffers of the iterator are reused for all layers
+        ToolpathExample::CToolpathSegmentIterator segmentIterator;
+
         // Iterate through all layers
         for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++) {
 
@@ -349,7 +384,6 @@ void readToolpathDemo(Lib3MF::PWrapper p3MFWrapper, const std::string sInputFile
             // Output layer info
             uint32_t nZMin = pToolpath->GetLayerZMin(nLayerIndex);
             uint32_t nZMax = pToolpath->GetLayerZMax(nLayerIndex);
-            uint32_t nSegmentCount = pLayerData->GetSegmentCount();
             std::cout << "- layer " << nLayerIndex << " ranging from " << nZMin << " to " << nZMax << std::endl;
 
             // Read layer custom data...
@@ -360,12 +394,13 @@ void readToolpathDemo(Lib3MF::PWrapper p3MFWrapper, const std::string sInputFile
             }
 
             // iterate through all segments
-            for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+            segmentIterator.SetLayer(pLayerData);
+            while (segmentIterator.Next()) {
 
                 // Get Segment Information
-                uint32_t nPointCount = 0;
-                Lib3MF::eToolpathSegmentType segmentType;
-                pLayerData->GetSegmentInfo(nSegmentIndex, segmentType, nPointCount);
+                uint32_t nSegmentIndex = segmentIterator.GetSegmentIndex();
+                uint32_t nPointCount = segmentIterator.GetPointCount();
+                Lib3MF::eToolpathSegmentType segmentType = segmentIterator.GetType();
 
                 // Get Profile Information
                 auto pProfile = pLayerData->GetSegmentDefaultProfile(nSegmentIndex);
@@ -392,16 +427,17 @@ void readToolpathDemo(Lib3MF::PWrapper p3MFWrapper, const std::string sInputFile
                 // Write segment information and retrieve point data
                 switch (segmentType) {
                 case Lib3MF::eToolpathSegmentType::Loop: {
-                    std::vector <Lib3MF::sPosition2D> pointData;
-                    pLayerData->GetSegmentPointDataInModelUnits(nSegmentIndex, pointData);
+                    auto pointData = segmentIterator.GetPoints();
+                    auto factorValues = segmentIterator.GetPointFactors(Lib3MF::eToolpathProfileModificationFactor::FactorF);
+                    std::cout << "    o Loop: " << nPointCount << " points, Profile: " + sProfileName << " " << dLaserPower << "W, " << dLaserSpeed << "mm/s" << std::endl;
 
-                    std::vector<double> factorValues;
+                    if (segmentIterator.IsArcPath()) {
+                        outputArcPath(arcPath, pointData.data(), factorValues.data(), nPointCount, true);
+                        break;
+                    }
 
-                    pLayerData->GetSegmentPointModificationFactors (nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor::FactorF, factorValues);
-                    std::cout << "    o Loop: " << nPointCount << " points, Profile: " + sProfileName << " " << dLaserPower << "W, " << dLaserSpeed << "mm/s" << std::endl;
-                        
                     for (uint32_t nPointIndex = 0; nPointIndex < nPointCount; nPointIndex++) {
-                        auto& point = pointData.at(nPointIndex);
+                        auto& point = pointData[nPointIndex];
                         std::cout << "  Point: " << point.m_Coordinates[0] << "/" << point.m_Coordinates[1] << ": " << factorValues[nPointIndex] << std::endl;
                     }
 
@@ -409,15 +445,18 @@ void readToolpathDemo(Lib3MF::PWrapper p3MFWrapper, const std::string sInputFile
                 }
 
                 case Lib3MF::eToolpathSegmentType::Polyline: {
-                    std::vector <Lib3MF::sPosition2D> pointData;
-                    pLayerData->GetSegmentPointDataInModelUnits(nSegmentIndex, pointData);
-
-                    std::vector<double> factorValues;
-                    pLayerData->GetSegmentPointModificationFactors(nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor::FactorF, factorValues);
+                    auto pointData = segmentIterator.GetPoints();
+                    auto factorValues = segmentIterator.GetPointFactors(Lib3MF::eToolpathProfileModificationFactor::FactorF);
 
                     std::cout << "    o Polyline: " << nPointCount << " points, Profile: " + sProfileName << " " << dLaserPower << "W, " << dLaserSpeed << "mm/s" << std::endl;
+
+                    if (segmentIterator.IsArcPath()) {
+                        outputArcPath(arcPath, pointData.data(), factorValues.data(), nPointCount, false);
+                        break;
+                    }
+
                     for (uint32_t nPointIndex = 0; nPointIndex < nPointCount; nPointIndex++) {
-                        auto& point = pointData.at(nPointIndex);
+                        auto& point = pointData[nPointIndex];
                         std::cout << "  Point: " << point.m_Coordinates[0] << "/" << point.m_Coordinates[1] << ": " << factorValues[nPointIndex] << std::endl;
                     }
                     break;
@@ -426,29 +465,31 @@ void readToolpathDemo(Lib3MF::PWrapper p3MFWrapper, const std::string sInputFile
                 case Lib3MF::eToolpathSegmentType::Hatch: {
                     std::cout << "    o Hatches: " << nPointCount << " points, Profile: " + sProfileName << " " << dLaserPower << "W, " << dLaserSpeed << "mm/s" << std::endl;
 
-                    std::vector <Lib3MF::sHatch2D> hatchData;
-                    pLayerData->GetSegmentHatchDataInModelUnits(nSegmentIndex, hatchData);
-
-
-                    std::vector<Lib3MF::sHatch2DFactors> factorValues;
-                    pLayerData->GetLinearSegmentHatchModificationFactors(nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor::FactorF, factorValues);
-                    uint32_t nHatchCount = nPointCount / 2;
-
-					bool bHasNonlinearOverrides = pLayerData->SegmentHasNonlinearHatchModificationInterpolation(nSegmentIndex);
-
-/*                    for (uint32_t nHatchIndex = 0; nHatchIndex < nHatchCount; nHatchIndex++) {
-                        auto& hatch = hatchData.at(nHatchIndex);
-                        std::cout << "  hatch: " << hatch.m_Point1Coordinates[0] << "/" << hatch.m_Point1Coordinates[1] << " - " << hatch.m_Point2Coordinates[0] << "/" << hatch.m_Point2Coordinates[1]  << ": " << factorValues[nHatchIndex].m_Point1Override << " - " << factorValues[nHatchIndex].m_Point2Override << std::endl;
-
-                        if (bHasNonlinearOverrides) {
-							std::vector<Lib3MF::sHatchOverrideInterpolationData> subInterpolationData;
-							pLayerData->GetSegmentNonlinearHatchOverrideInterpolation(nSegmentIndex, nHatchIndex, Lib3MF::eToolpathProfileOverrideFactor::FactorF, subInterpolationData);
-							for (uint32_t nSubIndex = 0; nSubIndex < subInterpolationData.size (); nSubIndex++) {
-								auto& subData = subInterpolationData.at(nSubIndex);
-								std::cout << "    sub " << nSubIndex << ": " << subData.m_Parameter << " - " << subData.m_Override << std::endl;
-							}
+                    auto hatchData = segmentIterator.GetHatches();
+                    auto factorValues = segmentIterator.GetHatchFactors(Lib3MF::eToolpathProfileModificationFactor::FactorF);
+
+                    // Nonlinear factors are stored per hatch, one run of samples after the other
+                    ToolpathExample::CToolpathArrayView<Lib3MF_uint32> subInterpolationCounts;
+                    ToolpathExample::CToolpathArrayView<Lib3MF::sHatchModificationInterpolationData> subInterpolationData;
+                    if (pLayerData->SegmentHasNonlinearHatchModificationInterpolation(nSegmentIndex))
+                        segmentIterator.GetSubInterpolation(Lib3MF::eToolpathProfileModificationFactor::FactorF, subInterpolationCounts, subInterpolationData);
+
+                    size_t nSubInterpolationStart = 0;
+                    for (size_t nHatchIndex = 0; nHatchIndex < hatchData.size(); nHatchIndex++) {
+                        auto& hatch = hatchData[nHatchIndex];
+                        std::cout << "  hatch: " << hatch.m_Point1Coordinates[0] << "/" << hatch.m_Point1Coordinates[1] << " - " << hatch.m_Point2Coordinates[0] << "/" << hatch.m_Point2Coordinates[1]
+                            << ": " << factorValues[nHatchIndex].m_Point1Factor << " - " << factorValues[nHatchIndex].m_Point2Factor;
+
+                        if (!subInterpolationCounts.empty()) {
+                            uint32_t nSubInterpolationCount = subInterpolationCounts[nHatchIndex];
+                            for (uint32_t nSubIndex = 0; nSubIndex < nSubInterpolationCount; nSubIndex++) {
+                                auto& subData = subInterpolationData[nSubInterpolationStart + nSubIndex];
+                                std::cout << " | " << subData.m_Parameter << ": " << subData.m_Factor;
+                            }
+                            nSubInterpolationStart += nSubInterpolationCount;
                         }
-                    } */
+                        std::cout << std::endl;
+                    }
                     break;
                 }
                 }
@@ -460,6 +501,285 @@ void readToolpathDemo(Lib3MF::PWrapper p3MFWrapper, const std::string sInputFile
 
 }
 
+// Demo that computes the energy density of every layer and reports hot spots
+void energyDensityDemo(Lib3MF::PWrapper p3MFWrapper, const std::string sInputFileName)
+{
+    auto pModel = p3MFWrapper->CreateModel();
+    auto pSource = pModel->CreatePersistentSourceFromFile(sInputFileName);
+    auto pReader = pModel->QueryReader("3mf");
+    pReader->ReadFromPersistentSource(pSource);
+
+    // 0.1mm cells covering the build area of the dummy part
+    ToolpathExample::sEnergyDensityGrid grid;
+    grid.m_dOriginX = -1.0;
+    grid.m_dOriginY = -1.0;
+    grid.m_dCellSize = 0.1;
+    grid.m_nCellCountX = 220;
+    grid.m_nCellCountY = 320;
+
+    auto pThreadPool = std::make_shared<ToolpathExample::CToolpathThreadPool>();
+    ToolpathExample::CEnergyDensityRasterizer rasterizer(grid, pThreadPool);
+
+    auto toolpathIterator = pModel->GetToolpaths();
+    while (toolpathIterator->MoveNext()) {
+        auto pToolpath = toolpathIterator->GetCurrentToolpath();
+
+        std::vector<float> energyDensity;
+        uint32_t nLayerCount = pToolpath->GetLayerCount();
+        for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++) {
+            auto pLayerData = pToolpath->ReadLayerData(nLayerIndex);
+            rasterizer.RasterizeLayer(pLayerData, energyDensity);
+
+            double dSum = 0.0;
+            float fMaximum = 0.0f;
+            uint32_t nExposedCells = 0;
+            for (float fValue : energyDensity) {
+                if (fValue > 0.0f) {
+                    dSum += fValue;
+                    nExposedCells++;
+                }
+                fMaximum = std::max(fMaximum, fValue);
+            }
+
+            // Flag cells that receive more than twice the mean energy density of the exposed area
+            double dMean = (nExposedCells > 0) ? dSum / nExposedCells : 0.0;
+            uint32_t nHotspotCells = 0;
+            for (float fValue : energyDensity)
+                if (fValue > 2.0 * dMean)
+                    nHotspotCells++;
+
+            std::cout << "- layer " << nLayerIndex << ": mean energy density " << dMean << " J/mm^2, max " << fMaximum << " J/mm^2, " << nHotspotCells << " hot spot cells" << std::endl;
+        }
+    }
+}
+
+// Demo that reads all layers of a toolpath concurrently
+void parallelReadDemo(Lib3MF::PWrapper p3MFWrapper, const std::string sInputFileName)
+{
+    auto pThreadPool = std::make_shared<ToolpathExample::CToolpathThreadPool>();
+    ToolpathExample::CToolpathParallelLayerReader parallelReader(p3MFWrapper, sInputFileName, 0, pThreadPool);
+
+    uint32_t nLayerCount = parallelReader.GetLayerCount();
+    std::vector<uint32_t> segmentCounts(nLayerCount);
+    std::vector<uint64_t> pointCounts(nLayerCount);
+
+    // Progress callbacks are serialized, so the total needs no synchronization
+    uint64_t nTotalBytes = 0;
+    parallelReader.SetProgress(std::make_shared<ToolpathExample::CToolpathProgress>([&](const ToolpathExample::sToolpathProgressEvent & event) {
+        nTotalBytes += event.m_nBytes;
+        return true;
+    }));
+
+    auto pStatistics = std::make_shared<ToolpathExample::CToolpathStatistics>();
+    parallelReader.SetStatistics(pStatistics);
+
+    auto pTracer = std::make_shared<ToolpathExample::CToolpathTracer>();
+    parallelReader.SetTracer(pTracer);
+
+    parallelReader.ProcessLayers(0, nLayerCount, [&](uint32_t nLayerIndex, Lib3MF::PToolpathLayerReader pLayerData, uint32_t) {
+        uint32_t nSegmentCount = pLayerData->GetSegmentCount();
+        uint64_t nPointCount = 0;
+        for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+            Lib3MF::eToolpathSegmentType segmentType;
+            uint32_t nSegmentPointCount = 0;
+            pLayerData->GetSegmentInfo(nSegmentIndex, segmentType, nSegmentPointCount);
+            nPointCount += nSegmentPointCount;
+        }
+        pStatistics->AddCount(ToolpathExample::eToolpathCounter::PointsRead, nPointCount);
+
+        segmentCounts[nLayerIndex] = nSegmentCount;
+        pointCounts[nLayerIndex] = nPointCount;
+    });
+
+    for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++)
+        std::cout << "- layer " << nLayerIndex << ": " << segmentCounts[nLayerIndex] << " segments, " << pointCounts[nLayerIndex] << " points" << std::endl;
+    std::cout << "- " << nTotalBytes << " bytes of layer data" << std::endl;
+    pStatistics->WriteReport(std::cout);
+
+    pTracer->WriteChromeTraceToFile(sInputFileName + ".read.trace.json");
+}
+
+
+// Demo that updates single parts of an existing package. All other parts are copied without recompression.
+void updateToolpathDemo(Lib3MF::PWrapper p3MFWrapper, const std::string sInputFileName, const std::string sOutputFileName)
+{
+    // Find the part of the layer to replace
+    auto pModel = p3MFWrapper->CreateModel();
+    auto pSource = pModel->CreatePersistentSourceFromFile(sInputFileName);
+    auto pReader = pModel->QueryReader("3mf");
+    pReader->ReadFromPersistentSource(pSource);
+
+    auto toolpathIterator = pModel->GetToolpaths();
+    if (!toolpathIterator->MoveNext())
+        return;
+    auto pToolpath = toolpathIterator->GetCurrentToolpath();
+    if (pToolpath->GetLayerCount() < 3)
+        return;
+
+    ToolpathExample::CToolpathPackageUpdater updater(sInputFileName);
+
+    // Replaced parts are compressed in parallel
+    updater.SetThreadPool(std::make_shared<ToolpathExample::CToolpathThreadPool>());
+
+    // Replace layer 3 with the content of layer 1. Both reference the same profiles and parts.
+    uint32_t nEntryIndex = 0;
+    std::vector<uint8_t> layerBuffer;
+    if (!updater.GetReader().FindEntry(pToolpath->GetLayerPath(0), nEntryIndex))
+        throw std::runtime_error("layer part not found");
+    updater.GetReader().ReadEntryData(nEntryIndex, layerBuffer);
+    updater.ReplacePart(pToolpath->GetLayerPath(2), layerBuffer);
+
+    // Update the custom attachment
+    std::string sAttachmentData = "{ \"test\": 5678 }";
+    updater.ReplacePart("/mycompanydata/attachment.json", std::vector<uint8_t>(sAttachmentData.begin(), sAttachmentData.end()));
+
+    updater.WriteToFile(sOutputFileName);
+}
+
+// Demo that re-encodes a package with maximum compression for archiving
+void archiveToolpathDemo(const std::string sInputFileName, const std::string sOutputFileName)
+{
+    ToolpathExample::CToolpathPackageUpdater updater(sInputFileName);
+    updater.SetThreadPool(std::make_shared<ToolpathExample::CToolpathThreadPool>());
+    updater.SetCompressionPolicy(ToolpathExample::CToolpathPackageCompressionPolicy::CreateArchive());
+    updater.SetRecompressAll(true);
+
+    // Record inflate and deflate spans of all workers, the trace can be opened in Perfetto
+    auto pTracer = std::make_shared<ToolpathExample::CToolpathTracer>();
+    updater.SetTracer(pTracer);
+
+    updater.WriteToFile(sOutputFileName);
+    pTracer->WriteChromeTraceToFile(sOutputFileName + ".trace.json");
+}
+
+
+// Demo that slices a mesh and generates contours and hatches for every slice
+void sliceToolpathDemo(Lib3MF::PWrapper p3MFWrapper, const std::string sOutputFileName)
+{
+    auto pModel = p3MFWrapper->CreateModel();
+
+    // Units are micron, layers are 0.05mm thick
+    auto pToolpath = pModel->AddToolpathWithBottomZ(0.001, 0);
+    const uint32_t nLayerCount = 200;
+    const double dLayerThickness = 0.05;
+
+    auto pMeshObject = pModel->AddMeshObject();
+    createBoxMesh(pMeshObject, 20, 30, (float)(nLayerCount * dLayerThickness));
+    auto pBuildItem = pModel->AddBuildItem(pMeshObject.get(), p3MFWrapper->GetIdentityTransform());
+
+    auto pContourProfile = pToolpath->AddProfile("contour_profile");
+    pContourProfile->SetParameterDoubleValue("", "laserpower", 125.0);
+    pContourProfile->SetParameterDoubleValue("", "laserspeed", 500.0);
+
+    auto pHatchProfile = pToolpath->AddProfile("hatch_profile");
+    pHatchProfile->SetParameterDoubleValue("", "laserpower", 400.0);
+    pHatchProfile->SetParameterDoubleValue("", "laserspeed", 600.0);
+
+    auto pThreadPool = std::make_shared<ToolpathExample::CToolpathThreadPool>();
+
+    // Cut the mesh in the middle of every layer
+    std::vector<double> layerZTops(nLayerCount);
+    for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++)
+        layerZTops[nLayerIndex] = (nLayerIndex + 1) * dLayerThickness;
+
+    ToolpathExample::CToolpathMeshSlicer meshSlicer;
+    meshSlicer.SetThreadPool(pThreadPool);
+    meshSlicer.SetLayerHeights(0.0, layerZTops);
+    meshSlicer.ReadMesh(pMeshObject);
+    meshSlicer.Slice();
+
+    auto pSliceStack = pModel->AddSliceStack(0.0);
+    meshSlicer.WriteSliceStack(pSliceStack);
+
+    // Two contours 50 and 150 micron inside the outline, simplified within 1 micron, hatches with 100 micron distance
+    // rotated by 67 degrees per layer
+    ToolpathExample::sToolpathSliceGeneratorParameters parameters;
+    parameters.m_nHatchDistance = 100;
+    parameters.m_dHatchAngle = 0.0;
+    parameters.m_dHatchAngleIncrement = 67.0;
+    parameters.m_nHatchOffset = 200;
+    parameters.m_nMinHatchLength = 50;
+    parameters.m_ContourOffsets = { 50, 150 };
+    parameters.m_nContourTolerance = 1;
+
+    ToolpathExample::sToolpathSliceTargets targets;
+    targets.m_ContourProfiles.push_back(pContourProfile);
+    targets.m_pHatchProfile = pHatchProfile;
+    targets.m_pBuildItem = pBuildItem;
+
+    auto pWriter = pModel->QueryWriter("3mf");
+
+    ToolpathExample::CToolpathSliceGenerator sliceGenerator(parameters);
+    sliceGenerator.SetThreadPool(pThreadPool);
+    sliceGenerator.WriteSliceStack(pSliceStack, pToolpath, pWriter, targets, "/Toolpath/layer");
+
+    std::cout << "Generated " << pToolpath->GetLayerCount() << " layers from " << pMeshObject->GetTriangleCount() << " triangles" << std::endl;
+    pWriter->WriteToFile(sOutputFileName);
+}
+
+
+void scanStrategyDemo(Lib3MF::PWrapper p3MFWrapper, const std::string sOutputFileName)
+{
+    auto pModel = p3MFWrapper->CreateModel();
+
+    // Units are micron, layers are 0.05mm thick
+    auto pToolpath = pModel->AddToolpathWithBottomZ(0.001, 0);
+    const uint32_t nLayerCount = 40;
+    const uint32_t nLayerThickness = 50;
+
+    auto pMeshObject = pModel->AddMeshObject();
+    createBoxMesh(pMeshObject, 20, 30, (float)(nLayerCount * nLayerThickness * 0.001));
+    auto pBuildItem = pModel->AddBuildItem(pMeshObject.get(), p3MFWrapper->GetIdentityTransform());
+
+    // Neighbouring islands are exposed with different speeds
+    auto pBlackProfile = pToolpath->AddProfile("black_island_profile");
+    pBlackProfile->SetParameterDoubleValue("", "laserpower", 400.0);
+    pBlackProfile->SetParameterDoubleValue("", "laserspeed", 600.0);
+
+    auto pWhiteProfile = pToolpath->AddProfile("white_island_profile");
+    pWhiteProfile->SetParameterDoubleValue("", "laserpower", 400.0);
+    pWhiteProfile->SetParameterDoubleValue("", "laserspeed", 700.0);
+
+    // Every layer of the box is the same rectangle
+    ToolpathExample::CToolpathSlicePolygons region;
+    region.BeginPolygon();
+    region.AddVertex(0, 0);
+    region.AddVertex(20000, 0);
+    region.AddVertex(20000, 30000);
+    region.AddVertex(0, 30000);
+    region.EndPolygon();
+
+    // 5mm islands overlapping by 0.1mm, hatches with 100 micron distance, the grid rotates by 67 degrees per layer
+    ToolpathExample::sToolpathScanStrategyParameters parameters;
+    parameters.m_Pattern = ToolpathExample::eToolpathScanPattern::Chessboard;
+    parameters.m_nCellSize = 5000;
+    parameters.m_nCellOverlap = 100;
+    parameters.m_nHatchDistance = 100;
+    parameters.m_dAngle = 0.0;
+    parameters.m_dAngleIncrement = 67.0;
+    parameters.m_nMinHatchLength = 50;
+
+    ToolpathExample::CToolpathScanStrategy scanStrategy(parameters);
+    scanStrategy.SetThreadPool(std::make_shared<ToolpathExample::CToolpathThreadPool>());
+
+    auto pWriter = pModel->QueryWriter("3mf");
+    ToolpathExample::CToolpathScanLayer scanLayer;
+    uint64_t nCellCount = 0;
+    for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++) {
+        scanStrategy.GenerateLayer(region, nLayerIndex, scanLayer);
+        nCellCount += scanLayer.GetCellCount();
+
+        auto pLayer = pToolpath->AddLayer((nLayerIndex + 1) * nLayerThickness, "/Toolpath/layer" + std::to_string(nLayerIndex + 1) + ".xml", pWriter);
+        std::vector<uint32_t> cellProfileIDs = { pLayer->RegisterProfile(pBlackProfile), pLayer->RegisterProfile(pWhiteProfile) };
+        uint32_t nPartID = pLayer->RegisterBuildItem(pBuildItem);
+        scanLayer.Write(pLayer, cellProfileIDs, nPartID);
+        pLayer->Finish();
+    }
+
+    std::cout << "Generated " << nCellCount << " islands in " << pToolpath->GetLayerCount() << " layers" << std::endl;
+    pWriter->WriteToFile(sOutputFileName);
+}
+
 
 int main()
 {
@@ -472,6 +792,24 @@ int main()
         std::cout << "Reading dummy.toolpath.3mf" << std::endl;
         readToolpathDemo(p3MFWrapper, "dummy.toolpath.3mf");
 
+        std::cout << "Reading dummy.toolpath.3mf in parallel" << std::endl;
+        parallelReadDemo(p3MFWrapper, "dummy.toolpath.3mf");
+
+        std::cout << "Computing energy density of dummy.toolpath.3mf" << std::endl;
+        energyDensityDemo(p3MFWrapper, "dummy.toolpath.3mf");
+
+        std::cout << "Updating dummy.toolpath.3mf to dummy.toolpath.updated.3mf" << std::endl;
+        updateToolpathDemo(p3MFWrapper, "dummy.toolpath.3mf", "dummy.toolpath.updated.3mf");
+
+        std::cout << "Recompressing dummy.toolpath.3mf to dummy.toolpath.archive.3mf" << std::endl;
+        archiveToolpathDemo("dummy.toolpath.3mf", "dummy.toolpath.archive.3mf");
+
+        std::cout << "Slicing a box to dummy.sliced.toolpath.3mf" << std::endl;
+        sliceToolpathDemo(p3MFWrapper, "dummy.sliced.toolpath.3mf");
+
+        std::cout << "Writing chessboard islands to dummy.chessboard.toolpath.3mf" << std::endl;
+        scanStrategyDemo(p3MFWrapper, "dummy.chessboard.toolpath.3mf");
+
     }
     catch (std::exception& E) {
         std::cout << "fatal error: " << E.what() << std::endl;
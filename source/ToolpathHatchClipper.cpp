@@ -0,0 +1,399 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#include "ToolpathHatchClipper.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HATCHCLIPPER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define HATCHCLIPPER_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define HATCHCLIPPER_NEON
+#endif
+
+// Scale of the integer line normal
+#define HATCHCLIPPER_NORMALSCALE 16384.0
+
+// Lines whose crossings are computed together
+#define HATCHCLIPPER_BATCHLINES 4
+
+namespace ToolpathExample {
+
+// Index of the first line at or above v, rounding the division towards +infinity for both signs
+static int64_t hatchClipperFirstLine(int64_t nV, int64_t nLineOffset, int64_t nLinePitch)
+{
+    int64_t nDistance = nV - nLineOffset;
+    int64_t nLine = nDistance / nLinePitch;
+    if (nLine * nLinePitch < nDistance)
+        nLine++;
+    return nLine;
+}
+
+static int32_t hatchClipperRound(double dValue)
+{
+    double dRounded = std::round(dValue);
+    if ((dRounded < (double)std::numeric_limits<int32_t>::min()) || (dRounded > (double)std::numeric_limits<int32_t>::max()))
+        throw std::range_error("hatch coordinate exceeds the range of toolpath units");
+    return (int32_t)dRounded;
+}
+
+// Nearly sorted input, as crossings keep their order from line to line
+static void hatchClipperInsertionSort(double * pValues, size_t nCount)
+{
+    for (size_t nIndex = 1; nIndex < nCount; nIndex++) {
+        double dValue = pValues[nIndex];
+        size_t nTarget = nIndex;
+        while ((nTarget > 0) && (pValues[nTarget - 1] > dValue)) {
+            pValues[nTarget] = pValues[nTarget - 1];
+            nTarget--;
+        }
+        pValues[nTarget] = dValue;
+    }
+}
+
+CToolpathHatchClipper::CToolpathHatchClipper()
+    : m_dAngle(0.0), m_nDistance(0), m_nMinHatchLength(0), m_bAlternate(true), m_bVectorized(true),
+    m_nNormalX(0), m_nNormalY(0), m_nLinePitch(1), m_nLineOffset(0), m_dNormalLength(1.0)
+{
+    SetHatching(0.0, 100);
+}
+
+void CToolpathHatchClipper::SetHatching(double dAngle, int32_t nDistance)
+{
+    if (nDistance <= 0)
+        throw std::invalid_argument("invalid hatch distance");
+
+    double dRadians = dAngle * 3.14159265358979323846 / 180.0;
+    m_nNormalX = (int64_t)std::llround(-std::sin(dRadians) * HATCHCLIPPER_NORMALSCALE);
+    m_nNormalY = (int64_t)std::llround(std::cos(dRadians) * HATCHCLIPPER_NORMALSCALE);
+    m_dNormalLength = std::sqrt((double)(m_nNormalX * m_nNormalX + m_nNormalY * m_nNormalY));
+    m_nLinePitch = std::max<int64_t>(1, std::llround(nDistance * m_dNormalLength));
+    m_nLineOffset = m_nLinePitch / 2;
+    m_dAngle = dAngle;
+    m_nDistance = nDistance;
+}
+
+void CToolpathHatchClipper::SetMinHatchLength(int32_t nMinHatchLength)
+{
+    if (nMinHatchLength < 0)
+        throw std::invalid_argument("invalid minimum hatch length");
+    m_nMinHatchLength = nMinHatchLength;
+}
+
+void CToolpathHatchClipper::SetAlternate(bool bAlternate)
+{
+    m_bAlternate = bAlternate;
+}
+
+void CToolpathHatchClipper::SetVectorized(bool bVectorized)
+{
+    m_bVectorized = bVectorized;
+}
+
+// Fills HATCHCLIPPER_BATCHLINES crossings per active edge, +infinity for lines the edge does not reach
+void CToolpathHatchClipper::computeLanes(size_t nEdgeCount, int64_t nBatchLine)
+{
+    const sActiveEdge * pEdges = m_ActiveEdges.data();
+    double * pLanes = m_LaneCrossings.data();
+    const double dInfinity = std::numeric_limits<double>::infinity();
+
+    if (m_bVectorized) {
+#if defined(HATCHCLIPPER_AVX2)
+        const __m256d laneOffsets = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d infinity = _mm256_set1_pd(dInfinity);
+        for (size_t nEdge = 0; nEdge < nEdgeCount; nEdge++) {
+            const sActiveEdge & edge = pEdges[nEdge];
+            __m256d steps = _mm256_add_pd(_mm256_set1_pd((double)(nBatchLine - edge.m_nFirstLine)), laneOffsets);
+            __m256d valid = _mm256_and_pd(_mm256_cmp_pd(steps, zero, _CMP_GE_OQ), _mm256_cmp_pd(steps, _mm256_set1_pd((double)(edge.m_nEndLine - edge.m_nFirstLine)), _CMP_LT_OQ));
+            __m256d crossings = _mm256_add_pd(_mm256_set1_pd(edge.m_dU), _mm256_mul_pd(steps, _mm256_set1_pd(edge.m_dSlope)));
+            _mm256_storeu_pd(pLanes + nEdge * HATCHCLIPPER_BATCHLINES, _mm256_blendv_pd(infinity, crossings, valid));
+        }
+        return;
+#elif defined(HATCHCLIPPER_SSE2)
+        const __m128d laneOffsets0 = _mm_setr_pd(0.0, 1.0);
+        const __m128d laneOffsets1 = _mm_setr_pd(2.0, 3.0);
+        const __m128d zero = _mm_setzero_pd();
+        const __m128d infinity = _mm_set1_pd(dInfinity);
+        for (size_t nEdge = 0; nEdge < nEdgeCount; nEdge++) {
+            const sActiveEdge & edge = pEdges[nEdge];
+            __m128d base = _mm_set1_pd((double)(nBatchLine - edge.m_nFirstLine));
+            __m128d limit = _mm_set1_pd((double)(edge.m_nEndLine - edge.m_nFirstLine));
+            __m128d u = _mm_set1_pd(edge.m_dU);
+            __m128d slope = _mm_set1_pd(edge.m_dSlope);
+            for (int nHalf = 0; nHalf < 2; nHalf++) {
+                __m128d steps = _mm_add_pd(base, (nHalf == 0) ? laneOffsets0 : laneOffsets1);
+                __m128d valid = _mm_and_pd(_mm_cmpge_pd(steps, zero), _mm_cmplt_pd(steps, limit));
+                __m128d crossings = _mm_add_pd(u, _mm_mul_pd(steps, slope));
+                _mm_storeu_pd(pLanes + nEdge * HATCHCLIPPER_BATCHLINES + nHalf * 2, _mm_or_pd(_mm_and_pd(valid, crossings), _mm_andnot_pd(valid, infinity)));
+            }
+        }
+        return;
+#elif defined(HATCHCLIPPER_NEON)
+        const float64x2_t laneOffsets0 = { 0.0, 1.0 };
+        const float64x2_t laneOffsets1 = { 2.0, 3.0 };
+        const float64x2_t zero = vdupq_n_f64(0.0);
+        const float64x2_t infinity = vdupq_n_f64(dInfinity);
+        for (size_t nEdge = 0; nEdge < nEdgeCount; nEdge++) {
+            const sActiveEdge & edge = pEdges[nEdge];
+            float64x2_t base = vdupq_n_f64((double)(nBatchLine - edge.m_nFirstLine));
+            float64x2_t limit = vdupq_n_f64((double)(edge.m_nEndLine - edge.m_nFirstLine));
+            float64x2_t u = vdupq_n_f64(edge.m_dU);
+            float64x2_t slope = vdupq_n_f64(edge.m_dSlope);
+            for (int nHalf = 0; nHalf < 2; nHalf++) {
+                float64x2_t steps = vaddq_f64(base, (nHalf == 0) ? laneOffsets0 : laneOffsets1);
+                uint64x2_t valid = vandq_u64(vcgeq_f64(steps, zero), vcltq_f64(steps, limit));
+                float64x2_t crossings = vaddq_f64(u, vmulq_f64(steps, slope));
+                vst1q_f64(pLanes + nEdge * HATCHCLIPPER_BATCHLINES + nHalf * 2, vbslq_f64(valid, crossings, infinity));
+            }
+        }
+        return;
+#endif
+    }
+
+    for (size_t nEdge = 0; nEdge < nEdgeCount; nEdge++) {
+        const sActiveEdge & edge = pEdges[nEdge];
+        for (int64_t nLane = 0; nLane < HATCHCLIPPER_BATCHLINES; nLane++) {
+            int64_t nLine = nBatchLine + nLane;
+            double dStep = (double)(nLine - edge.m_nFirstLine);
+            bool bValid = (nLine >= edge.m_nFirstLine) && (nLine < edge.m_nEndLine);
+            pLanes[nEdge * HATCHCLIPPER_BATCHLINES + nLane] = bValid ? (edge.m_dU + dStep * edge.m_dSlope) : dInfinity;
+        }
+    }
+}
+
+void CToolpathHatchClipper::clipLines(const CToolpathSlicePolygons & polygons, int64_t nWindowFirstLine, int64_t nWindowEndLine, std::vector<Lib3MF::sDiscreteHatch2D> & hatches)
+{
+    const std::vector<Lib3MF::sDiscretePosition2D> & vertices = polygons.GetVertices();
+    if (vertices.empty())
+        return;
+
+    // u runs along the lines and v across them, both scaled by the length of the integer normal
+    int64_t nNormalX = m_nNormalX;
+    int64_t nNormalY = m_nNormalY;
+    int64_t nMinV = std::numeric_limits<int64_t>::max();
+    int64_t nMaxV = std::numeric_limits<int64_t>::min();
+    for (const Lib3MF::sDiscretePosition2D & vertex : vertices) {
+        int64_t nV = nNormalX * vertex.m_Coordinates[0] + nNormalY * vertex.m_Coordinates[1];
+        nMinV = std::min(nMinV, nV);
+        nMaxV = std::max(nMaxV, nV);
+    }
+    int64_t nFirstLine = std::max(nWindowFirstLine, hatchClipperFirstLine(nMinV, m_nLineOffset, m_nLinePitch));
+    int64_t nLineCount = std::min(nWindowEndLine, hatchClipperFirstLine(nMaxV, m_nLineOffset, m_nLinePitch)) - nFirstLine;
+    if (nLineCount <= 0)
+        return;
+    if (nLineCount >= (int64_t)std::numeric_limits<uint32_t>::max())
+        throw std::range_error("too many hatch lines");
+
+    // An edge crosses the lines in [v_min, v_max), relative to the first line of the slice
+    m_Edges.clear();
+    for (size_t nPolygonIndex = 0; nPolygonIndex < polygons.GetPolygonCount(); nPolygonIndex++) {
+        uint32_t nStart = polygons.GetPolygonStart(nPolygonIndex);
+        uint32_t nSize = polygons.GetPolygonSize(nPolygonIndex);
+        for (uint32_t nIndex = 0; nIndex < nSize; nIndex++) {
+            const Lib3MF::sDiscretePosition2D & a = vertices[nStart + nIndex];
+            const Lib3MF::sDiscretePosition2D & b = vertices[nStart + (nIndex + 1) % nSize];
+            int64_t nVA = nNormalX * a.m_Coordinates[0] + nNormalY * a.m_Coordinates[1];
+            int64_t nVB = nNormalX * b.m_Coordinates[0] + nNormalY * b.m_Coordinates[1];
+            if (nVA == nVB)
+                continue;
+
+            int64_t nEdgeFirstLine = std::max(nFirstLine, hatchClipperFirstLine(std::min(nVA, nVB), m_nLineOffset, m_nLinePitch));
+            int64_t nEdgeEndLine = std::min(nFirstLine + nLineCount, hatchClipperFirstLine(std::max(nVA, nVB), m_nLineOffset, m_nLinePitch));
+            if (nEdgeFirstLine >= nEdgeEndLine)
+                continue;
+
+            int64_t nUA = nNormalY * a.m_Coordinates[0] - nNormalX * a.m_Coordinates[1];
+            int64_t nUB = nNormalY * b.m_Coordinates[0] - nNormalX * b.m_Coordinates[1];
+            double dSlope = (double)(nUB - nUA) / (double)(nVB - nVA);
+            int64_t nFirstLineV = nEdgeFirstLine * m_nLinePitch + m_nLineOffset;
+
+            sActiveEdge edge;
+            edge.m_dU = (double)nUA + (double)(nFirstLineV - nVA) * dSlope;
+            edge.m_dSlope = dSlope * (double)m_nLinePitch;
+            edge.m_nFirstLine = nEdgeFirstLine - nFirstLine;
+            edge.m_nEndLine = nEdgeEndLine - nFirstLine;
+            m_Edges.push_back(edge);
+        }
+    }
+
+    // Counting sort of the edges by first line
+    m_LineEdgeOffsets.assign((size_t)nLineCount + 1, 0);
+    for (const sActiveEdge & edge : m_Edges)
+        m_LineEdgeOffsets[(size_t)edge.m_nFirstLine + 1]++;
+    for (size_t nLine = 0; nLine < (size_t)nLineCount; nLine++)
+        m_LineEdgeOffsets[nLine + 1] += m_LineEdgeOffsets[nLine];
+    m_SortedEdges.resize(m_Edges.size());
+    for (const sActiveEdge & edge : m_Edges)
+        m_SortedEdges[m_LineEdgeOffsets[(size_t)edge.m_nFirstLine]++] = edge;
+    for (size_t nLine = (size_t)nLineCount; nLine > 0; nLine--)
+        m_LineEdgeOffsets[nLine] = m_LineEdgeOffsets[nLine - 1];
+    m_LineEdgeOffsets[0] = 0;
+
+    double dNormalLengthSquared = (double)(nNormalX * nNormalX + nNormalY * nNormalY);
+    double dMinLength = (double)m_nMinHatchLength * m_dNormalLength;
+    const double dInfinity = std::numeric_limits<double>::infinity();
+
+    m_ActiveEdges.clear();
+    for (int64_t nBatchLine = 0; nBatchLine < nLineCount; nBatchLine += HATCHCLIPPER_BATCHLINES) {
+        int64_t nBatchEnd = std::min<int64_t>(nBatchLine + HATCHCLIPPER_BATCHLINES, nLineCount);
+
+        size_t nKept = 0;
+        for (size_t nEdge = 0; nEdge < m_ActiveEdges.size(); nEdge++) {
+            if (m_ActiveEdges[nEdge].m_nEndLine > nBatchLine)
+                m_ActiveEdges[nKept++] = m_ActiveEdges[nEdge];
+        }
+        m_ActiveEdges.resize(nKept);
+        m_ActiveEdges.insert(m_ActiveEdges.end(), m_SortedEdges.begin() + m_LineEdgeOffsets[(size_t)nBatchLine], m_SortedEdges.begin() + m_LineEdgeOffsets[(size_t)nBatchEnd]);
+
+        size_t nEdgeCount = m_ActiveEdges.size();
+        m_LaneCrossings.resize(nEdgeCount * HATCHCLIPPER_BATCHLINES);
+        computeLanes(nEdgeCount, nBatchLine);
+
+        for (int64_t nLane = 0; nLane < nBatchEnd - nBatchLine; nLane++) {
+            m_LineCrossings.clear();
+            for (size_t nEdge = 0; nEdge < nEdgeCount; nEdge++) {
+                double dCrossing = m_LaneCrossings[nEdge * HATCHCLIPPER_BATCHLINES + (size_t)nLane];
+                if (dCrossing != dInfinity)
+                    m_LineCrossings.push_back(dCrossing);
+            }
+            hatchClipperInsertionSort(m_LineCrossings.data(), m_LineCrossings.size());
+
+            int64_t nLine = nFirstLine + nBatchLine + nLane;
+            double dV = (double)(nLine * m_nLinePitch + m_nLineOffset);
+            bool bReverse = m_bAlternate && ((nLine & 1) != 0);
+            size_t nPairCount = m_LineCrossings.size() / 2;
+            for (size_t nPair = 0; nPair < nPairCount; nPair++) {
+                size_t nPairIndex = bReverse ? (nPairCount - 1 - nPair) : nPair;
+                double dU0 = m_LineCrossings[2 * nPairIndex];
+                double dU1 = m_LineCrossings[2 * nPairIndex + 1];
+                if ((dU1 <= dU0) || (dU1 - dU0 < dMinLength))
+                    continue;
+                if (bReverse)
+                    std::swap(dU0, dU1);
+
+                Lib3MF::sDiscreteHatch2D hatch;
+                hatch.m_Point1Coordinates[0] = hatchClipperRound((dU0 * nNormalY + dV * nNormalX) / dNormalLengthSquared);
+                hatch.m_Point1Coordinates[1] = hatchClipperRound((dV * nNormalY - dU0 * nNormalX) / dNormalLengthSquared);
+                hatch.m_Point2Coordinates[0] = hatchClipperRound((dU1 * nNormalY + dV * nNormalX) / dNormalLengthSquared);
+                hatch.m_Point2Coordinates[1] = hatchClipperRound((dV * nNormalY - dU1 * nNormalX) / dNormalLengthSquared);
+                hatch.m_Tag = 0;
+                hatches.push_back(hatch);
+            }
+        }
+
+        // Order the table by the crossings of the last line of the batch, edges that ended move to the back
+        double * pKeys = m_LaneCrossings.data() + (HATCHCLIPPER_BATCHLINES - 1);
+        for (size_t nEdge = 1; nEdge < nEdgeCount; nEdge++) {
+            double dKey = pKeys[nEdge * HATCHCLIPPER_BATCHLINES];
+            if (!(pKeys[(nEdge - 1) * HATCHCLIPPER_BATCHLINES] > dKey))
+                continue;
+
+            sActiveEdge edge = m_ActiveEdges[nEdge];
+            size_t nTarget = nEdge;
+            while ((nTarget > 0) && (pKeys[(nTarget - 1) * HATCHCLIPPER_BATCHLINES] > dKey)) {
+                m_ActiveEdges[nTarget] = m_ActiveEdges[nTarget - 1];
+                pKeys[nTarget * HATCHCLIPPER_BATCHLINES] = pKeys[(nTarget - 1) * HATCHCLIPPER_BATCHLINES];
+                nTarget--;
+            }
+            m_ActiveEdges[nTarget] = edge;
+            pKeys[nTarget * HATCHCLIPPER_BATCHLINES] = dKey;
+        }
+    }
+}
+
+void CToolpathHatchClipper::Clip(const CToolpathSlicePolygons & polygons, std::vector<Lib3MF::sDiscreteHatch2D> & hatches)
+{
+    clipLines(polygons, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), hatches);
+}
+
+void CToolpathHatchClipper::ClipWindow(const CToolpathSlicePolygons & polygons, double dMinDistance, double dMaxDistance, std::vector<Lib3MF::sDiscreteHatch2D> & hatches)
+{
+    // Line positions are integers in units of the normal length, a line lies at or above a distance if it lies at or
+    // above the next integer
+    double dMinV = std::ceil(dMinDistance * m_dNormalLength);
+    double dMaxV = std::ceil(dMaxDistance * m_dNormalLength);
+    const double dLimit = 4.0e18;
+    if (!(dMinV > -dLimit) || !(dMaxV < dLimit))
+        throw std::range_error("invalid hatch line window");
+    if (dMinV >= dMaxV)
+        return;
+
+    clipLines(polygons, hatchClipperFirstLine((int64_t)dMinV, m_nLineOffset, m_nLinePitch), hatchClipperFirstLine((int64_t)dMaxV, m_nLineOffset, m_nLinePitch), hatches);
+}
+
+void CToolpathHatchClipper::ClipSlice(Lib3MF::PSlice pSlice, double dUnits, std::vector<Lib3MF::sDiscreteHatch2D> & hatches)
+{
+    m_SlicePolygons.ReadSlice(pSlice, dUnits);
+    hatches.clear();
+    Clip(m_SlicePolygons, hatches);
+}
+
+void CToolpathHatchClipper::ClipSliceInModelUnits(Lib3MF::PSlice pSlice, double dUnits, std::vector<Lib3MF::sHatch2D> & hatches)
+{
+    ClipSlice(pSlice, dUnits, m_DiscreteHatches);
+
+    hatches.resize(m_DiscreteHatches.size());
+    for (size_t nIndex = 0; nIndex < m_DiscreteHatches.size(); nIndex++) {
+        const Lib3MF::sDiscreteHatch2D & discrete = m_DiscreteHatches[nIndex];
+        Lib3MF::sHatch2D & hatch = hatches[nIndex];
+        hatch.m_Point1Coordinates[0] = discrete.m_Point1Coordinates[0] * dUnits;
+        hatch.m_Point1Coordinates[1] = discrete.m_Point1Coordinates[1] * dUnits;
+        hatch.m_Point2Coordinates[0] = discrete.m_Point2Coordinates[0] * dUnits;
+        hatch.m_Point2Coordinates[1] = discrete.m_Point2Coordinates[1] * dUnits;
+        hatch.m_Tag = discrete.m_Tag;
+    }
+}
+
+const char * CToolpathHatchClipper::GetImplementation()
+{
+#if defined(HATCHCLIPPER_AVX2)
+    return "AVX2";
+#elif defined(HATCHCLIPPER_SSE2)
+    return "SSE2";
+#elif defined(HATCHCLIPPER_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace ToolpathExample
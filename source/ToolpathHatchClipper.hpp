@@ -0,0 +1,179 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#ifndef __TOOLPATHEXAMPLE_HATCHCLIPPER
+#define __TOOLPATHEXAMPLE_HATCHCLIPPER
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+#include "ToolpathSlicePolygons.hpp"
+
+namespace ToolpathExample {
+
+/*************************************************************************************************************************
+ Class CToolpathHatchClipper
+
+ Clips parallel hatch lines against slice polygons under the even-odd rule. Hatch lines run in the hatch direction
+ at (k + 0.5) times the hatch distance from the origin, so hatches of neighbouring parts line up.
+
+ Vertices are projected onto an integer approximation of the line normal (2^14 steps per unit, the direction is
+ off by less than 0.005 degrees), so which lines an edge crosses is decided exactly in 64 bit integers and every
+ line has an even number of crossings. Edges enter an active edge table at their first line and leave it after
+ their last; the crossings of all active edges are computed for four lines at once with AVX2, SSE2 or NEON,
+ sorted per line (edges keep their order between lines, so the sort is nearly linear) and paired into hatches.
+ Storage is kept across calls.
+**************************************************************************************************************************/
+class CToolpathHatchClipper {
+private:
+    typedef struct sActiveEdge {
+        double m_dU;            // Position along the line at the first line of the edge, scaled by the normal length
+        double m_dSlope;        // Change of m_dU from line to line
+        int64_t m_nFirstLine;
+        int64_t m_nEndLine;
+    } sActiveEdge;
+
+    double m_dAngle;
+    int32_t m_nDistance;
+    int32_t m_nMinHatchLength;
+    bool m_bAlternate;
+    bool m_bVectorized;
+
+    // Integer line normal, line k lies at normal . p = k * m_nLinePitch + m_nLineOffset
+    int64_t m_nNormalX;
+    int64_t m_nNormalY;
+    int64_t m_nLinePitch;
+    int64_t m_nLineOffset;
+    double m_dNormalLength;
+
+    std::vector<sActiveEdge> m_Edges;
+    std::vector<sActiveEdge> m_SortedEdges;
+    std::vector<uint32_t> m_LineEdgeOffsets;
+    std::vector<sActiveEdge> m_ActiveEdges;
+    std::vector<double> m_LaneCrossings;
+    std::vector<double> m_LineCrossings;
+    CToolpathSlicePolygons m_SlicePolygons;
+    std::vector<Lib3MF::sDiscreteHatch2D> m_DiscreteHatches;
+
+    void computeLanes(size_t nEdgeCount, int64_t nBatchLine);
+    void clipLines(const CToolpathSlicePolygons & polygons, int64_t nWindowFirstLine, int64_t nWindowEndLine, std::vector<Lib3MF::sDiscreteHatch2D> & hatches);
+
+public:
+
+    /**
+    * CToolpathHatchClipper::CToolpathHatchClipper - Creates a clipper for hatches along the X axis, 100 units apart.
+    */
+    CToolpathHatchClipper();
+
+    /**
+    * CToolpathHatchClipper::SetHatching - Sets direction and distance of the hatch lines.
+    * @param[in] dAngle - Hatch direction in degrees, measured from the X axis
+    * @param[in] nDistance - Distance between hatch lines in toolpath units
+    */
+    void SetHatching(double dAngle, int32_t nDistance);
+
+    /**
+    * CToolpathHatchClipper::SetMinHatchLength - Drops shorter hatches.
+    * @param[in] nMinHatchLength - Minimum hatch length in toolpath units
+    */
+    void SetMinHatchLength(int32_t nMinHatchLength);
+
+    /**
+    * CToolpathHatchClipper::SetAlternate - Sets whether hatches of every other line run backwards, so consecutive
+    *   lines are connected in a meander. Enabled by default.
+    * @param[in] bAlternate - Alternate directions
+    */
+    void SetAlternate(bool bAlternate);
+
+    /**
+    * CToolpathHatchClipper::SetVectorized - Switches between vector instructions and the scalar computation of
+    *   crossings, mainly for comparisons.
+    * @param[in] bVectorized - Use vector instructions, enabled by default
+    */
+    void SetVectorized(bool bVectorized);
+
+    double GetAngle() const { return m_dAngle; }
+    int32_t GetDistance() const { return m_nDistance; }
+
+    /**
+    * CToolpathHatchClipper::Clip - Appends the hatches inside the polygons, line by line.
+    * @param[in] polygons - Slice polygons in toolpath units
+    * @param[out] hatches - Hatches are appended with tag 0
+    */
+    void Clip(const CToolpathSlicePolygons & polygons, std::vector<Lib3MF::sDiscreteHatch2D> & hatches);
+
+    /**
+    * CToolpathHatchClipper::ClipWindow - Appends the hatches inside the polygons on the lines whose distance from the
+    *   origin along the line normal (the hatch direction turned by 90 degrees) lies in [dMinDistance, dMaxDistance).
+    *   Adjacent windows split the lines of a Clip call without gaps or duplicates.
+    * @param[in] polygons - Slice polygons in toolpath units
+    * @param[in] dMinDistance - Start of the window in toolpath units
+    * @param[in] dMaxDistance - End of the window in toolpath units
+    * @param[out] hatches - Hatches are appended with tag 0
+    */
+    void ClipWindow(const CToolpathSlicePolygons & polygons, double dMinDistance, double dMaxDistance, std::vector<Lib3MF::sDiscreteHatch2D> & hatches);
+
+    /**
+    * CToolpathHatchClipper::ClipSlice - Clears hatches and fills them with the hatches inside the closed polygons
+    *   of a slice.
+    * @param[in] pSlice - Slice in model units
+    * @param[in] dUnits - Size of a toolpath unit in model units
+    * @param[out] hatches - Hatches in toolpath units
+    */
+    void ClipSlice(Lib3MF::PSlice pSlice, double dUnits, std::vector<Lib3MF::sDiscreteHatch2D> & hatches);
+
+    /**
+    * CToolpathHatchClipper::ClipSliceInModelUnits - Clears hatches and fills them with the hatches inside the
+    *   closed polygons of a slice, as ClipSlice, converted to model units.
+    * @param[in] pSlice - Slice in model units
+    * @param[in] dUnits - Size of a toolpath unit in model units
+    * @param[out] hatches - Hatches in model units
+    */
+    void ClipSliceInModelUnits(Lib3MF::PSlice pSlice, double dUnits, std::vector<Lib3MF::sHatch2D> & hatches);
+
+    /**
+    * CToolpathHatchClipper::GetImplementation - Returns the instruction set crossings are computed with.
+    * @return "AVX2", "SSE2", "NEON" or "scalar"
+    */
+    static const char * GetImplementation();
+
+};
+
+typedef std::shared_ptr<CToolpathHatchClipper> PToolpathHatchClipper;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_HATCHCLIPPER
@@ -0,0 +1,154 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+#include "ToolpathLayerArrays.hpp"
+
+#include <stdexcept>
+
+namespace ToolpathExample {
+
+static const Lib3MF::eToolpathProfileModificationFactor layerArraysFactors[3] = {
+    Lib3MF::eToolpathProfileModificationFactor::FactorF,
+    Lib3MF::eToolpathProfileModificationFactor::FactorG,
+    Lib3MF::eToolpathProfileModificationFactor::FactorH
+};
+
+CToolpathLayerArrays::CToolpathLayerArrays()
+    : m_nFactorMask(0)
+{
+    m_SegmentOffsets.push_back(0);
+}
+
+void CToolpathLayerArrays::Extract(Lib3MF::PToolpathLayerReader pLayerReader, uint32_t nFactorMask)
+{
+    if (pLayerReader.get() == nullptr)
+        throw std::invalid_argument("invalid layer reader");
+
+    m_Types.clear();
+    m_ProfileIDs.clear();
+    m_PartIDs.clear();
+    m_ArcPaths.clear();
+    m_SegmentOffsets.clear();
+    m_Coordinates.clear();
+    for (auto & factors : m_Factors)
+        factors.clear();
+    m_nFactorMask = nFactorMask & (TOOLPATHLAYERARRAYS_FACTOR_F | TOOLPATHLAYERARRAYS_FACTOR_G | TOOLPATHLAYERARRAYS_FACTOR_H);
+
+    m_Iterator.SetLayer(pLayerReader);
+    uint32_t nSegmentCount = m_Iterator.GetSegmentCount();
+    m_Types.reserve(nSegmentCount);
+    m_ProfileIDs.reserve(nSegmentCount);
+    m_PartIDs.reserve(nSegmentCount);
+    m_ArcPaths.reserve(nSegmentCount);
+    m_SegmentOffsets.reserve((size_t)nSegmentCount + 1);
+
+    m_SegmentOffsets.push_back(0);
+    while (m_Iterator.Next()) {
+        Lib3MF::eToolpathSegmentType segmentType = m_Iterator.GetType();
+        m_Types.push_back((uint32_t)segmentType);
+        m_ProfileIDs.push_back(m_Iterator.GetProfileID());
+        m_PartIDs.push_back(m_Iterator.GetPartID());
+        m_ArcPaths.push_back(m_Iterator.IsArcPath() ? 1 : 0);
+
+        switch (segmentType) {
+        case Lib3MF::eToolpathSegmentType::Hatch:
+            appendHatches(m_nFactorMask);
+            break;
+        case Lib3MF::eToolpathSegmentType::Loop:
+        case Lib3MF::eToolpathSegmentType::Polyline:
+            appendPoints(m_nFactorMask);
+            break;
+        default:
+            break;
+        }
+
+        m_SegmentOffsets.push_back(GetPointCount());
+    }
+}
+
+void CToolpathLayerArrays::appendPoints(uint32_t nFactorMask)
+{
+    auto points = m_Iterator.GetDiscretePoints();
+    for (const auto & point : points) {
+        m_Coordinates.push_back(point.m_Coordinates[0]);
+        m_Coordinates.push_back(point.m_Coordinates[1]);
+    }
+
+    for (uint32_t nFactorIndex = 0; nFactorIndex < 3; nFactorIndex++) {
+        if (nFactorMask & (1u << nFactorIndex)) {
+            auto factors = m_Iterator.GetPointFactors(layerArraysFactors[nFactorIndex]);
+            if (factors.size() != points.size())
+                throw std::runtime_error("point factor count does not match point count");
+            m_Factors[nFactorIndex].insert(m_Factors[nFactorIndex].end(), factors.begin(), factors.end());
+        }
+    }
+}
+
+void CToolpathLayerArrays::appendHatches(uint32_t nFactorMask)
+{
+    auto hatches = m_Iterator.GetDiscreteHatches();
+    for (const auto & hatch : hatches) {
+        m_Coordinates.push_back(hatch.m_Point1Coordinates[0]);
+        m_Coordinates.push_back(hatch.m_Point1Coordinates[1]);
+        m_Coordinates.push_back(hatch.m_Point2Coordinates[0]);
+        m_Coordinates.push_back(hatch.m_Point2Coordinates[1]);
+    }
+
+    for (uint32_t nFactorIndex = 0; nFactorIndex < 3; nFactorIndex++) {
+        if (nFactorMask & (1u << nFactorIndex)) {
+            auto factors = m_Iterator.GetHatchFactors(layerArraysFactors[nFactorIndex]);
+            if (factors.size() != hatches.size())
+                throw std::runtime_error("hatch factor count does not match hatch count");
+            auto & target = m_Factors[nFactorIndex];
+            for (const auto & factor : factors) {
+                target.push_back(factor.m_Point1Factor);
+                target.push_back(factor.m_Point2Factor);
+            }
+        }
+    }
+}
+
+const std::vector<double> & CToolpathLayerArrays::GetFactors(Lib3MF::eToolpathProfileModificationFactor factor) const
+{
+    switch (factor) {
+    case Lib3MF::eToolpathProfileModificationFactor::FactorF:
+        return m_Factors[0];
+    case Lib3MF::eToolpathProfileModificationFactor::FactorG:
+        return m_Factors[1];
+    case Lib3MF::eToolpathProfileModificationFactor::FactorH:
+        return m_Factors[2];
+    default:
+        throw std::invalid_argument("invalid modification factor");
+    }
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,135 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#ifndef __TOOLPATHEXAMPLE_LAYERARRAYS
+#define __TOOLPATHEXAMPLE_LAYERARRAYS
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+#include "ToolpathSegmentIterator.hpp"
+
+// Modification factors exported by CToolpathLayerArrays::Extract
+#define TOOLPATHLAYERARRAYS_FACTOR_F 0x01
+#define TOOLPATHLAYERARRAYS_FACTOR_G 0x02
+#define TOOLPATHLAYERARRAYS_FACTOR_H 0x04
+
+namespace ToolpathExample {
+
+/*************************************************************************************************************************
+ Class CToolpathLayerArrays
+
+ Flattens all segments of a layer into contiguous arrays: one entry per segment for type, profile ID, part ID, arc path
+ flag and the offset of its first point, and one entry per point for coordinates in toolpath units and the selected modification
+ factors. Hatches contribute both end points, so hatch i of a segment is made of points 2i and 2i+1. Segments without
+ geometry, such as delays, have no points. The points of arc paths are exported as written, see CToolpathArcPath for
+ their decoding. Arrays keep their capacity across layers.
+**************************************************************************************************************************/
+class CToolpathLayerArrays {
+private:
+    CToolpathSegmentIterator m_Iterator;
+
+    std::vector<uint32_t> m_Types;
+    std::vector<uint32_t> m_ProfileIDs;
+    std::vector<uint32_t> m_PartIDs;
+    std::vector<uint8_t> m_ArcPaths;
+    std::vector<uint64_t> m_SegmentOffsets;
+    std::vector<int32_t> m_Coordinates;
+    std::vector<double> m_Factors[3];
+    uint32_t m_nFactorMask;
+
+    void appendPoints(uint32_t nFactorMask);
+    void appendHatches(uint32_t nFactorMask);
+
+public:
+
+    /**
+    * CToolpathLayerArrays::CToolpathLayerArrays - Creates empty arrays.
+    */
+    CToolpathLayerArrays();
+
+    /**
+    * CToolpathLayerArrays::Extract - Replaces the arrays with the segments of a layer.
+    * @param[in] pLayerReader - Layer reader
+    * @param[in] nFactorMask - Combination of TOOLPATHLAYERARRAYS_FACTOR_* flags for the factors to export
+    */
+    void Extract(Lib3MF::PToolpathLayerReader pLayerReader, uint32_t nFactorMask);
+
+    uint64_t GetSegmentCount() const { return m_Types.size(); }
+    uint64_t GetPointCount() const { return m_Coordinates.size() / 2; }
+    uint32_t GetFactorMask() const { return m_nFactorMask; }
+
+    /**
+    * CToolpathLayerArrays::GetTypes - Returns the eToolpathSegmentType of every segment.
+    * @return Segment types
+    */
+    const std::vector<uint32_t> & GetTypes() const { return m_Types; }
+    const std::vector<uint32_t> & GetProfileIDs() const { return m_ProfileIDs; }
+    const std::vector<uint32_t> & GetPartIDs() const { return m_PartIDs; }
+
+    /**
+    * CToolpathLayerArrays::GetArcPaths - Returns whether every segment holds an arc path. Arc paths are only recognized
+    *   if the arc path attribute has been registered with the toolpath before its layers are read.
+    * @return 1 for arc paths, 0 for all other segments
+    */
+    const std::vector<uint8_t> & GetArcPaths() const { return m_ArcPaths; }
+
+    /**
+    * CToolpathLayerArrays::GetSegmentOffsets - Returns the index of the first point of every segment.
+    * @return Segment count + 1 offsets, the last one is the point count
+    */
+    const std::vector<uint64_t> & GetSegmentOffsets() const { return m_SegmentOffsets; }
+
+    /**
+    * CToolpathLayerArrays::GetCoordinates - Returns the coordinates of all points in toolpath units.
+    * @return x and y of every point
+    */
+    const std::vector<int32_t> & GetCoordinates() const { return m_Coordinates; }
+
+    /**
+    * CToolpathLayerArrays::GetFactors - Returns a modification factor for all points.
+    * @param[in] factor - Modification factor
+    * @return Factors, empty if the factor has not been exported
+    */
+    const std::vector<double> & GetFactors(Lib3MF::eToolpathProfileModificationFactor factor) const;
+
+};
+
+typedef std::shared_ptr<CToolpathLayerArrays> PToolpathLayerArrays;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_LAYERARRAYS
@@ -0,0 +1,174 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+#include "ToolpathLayerArraysABI.h"
+#include "ToolpathLayerArrays.hpp"
+
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+
+/*************************************************************************************************************************
+ Class CToolpathLayerArraysInstance
+
+ Object behind a ToolpathLayerArraysHandle.
+**************************************************************************************************************************/
+class CToolpathLayerArraysInstance {
+public:
+    Lib3MF::PWrapper m_pWrapper;
+    ToolpathExample::CToolpathLayerArrays m_Arrays;
+    std::string m_sLastError;
+};
+
+static int32_t layerArraysFail(CToolpathLayerArraysInstance * pInstance, int32_t nErrorCode, const char * pMessage)
+{
+    if (pInstance != nullptr)
+        pInstance->m_sLastError = pMessage;
+    return nErrorCode;
+}
+
+template <typename T> static void layerArraysCopy(T * pTarget, const std::vector<T> & source)
+{
+    if ((pTarget != nullptr) && !source.empty())
+        memcpy(pTarget, source.data(), source.size() * sizeof(T));
+}
+
+#define LAYERARRAYS_CATCH(pInstance) \
+    catch (Lib3MF::ELib3MFException & e) { \
+        return layerArraysFail(pInstance, e.getErrorCode(), e.what()); \
+    } \
+    catch (std::exception & e) { \
+        return layerArraysFail(pInstance, LIB3MF_ERROR_GENERICEXCEPTION, e.what()); \
+    } \
+    catch (...) { \
+        return layerArraysFail(pInstance, LIB3MF_ERROR_GENERICEXCEPTION, "unknown exception"); \
+    }
+
+int32_t toolpathlayerarrays_create(void * pSymbolLookupMethod, ToolpathLayerArraysHandle * pArrays)
+{
+    if ((pSymbolLookupMethod == nullptr) || (pArrays == nullptr))
+        return LIB3MF_ERROR_INVALIDPARAM;
+
+    try {
+        std::unique_ptr<CToolpathLayerArraysInstance> pInstance(new CToolpathLayerArraysInstance());
+        pInstance->m_pWrapper = Lib3MF::CWrapper::loadLibraryFromSymbolLookupMethod(pSymbolLookupMethod);
+        *pArrays = pInstance.release();
+        return LIB3MF_SUCCESS;
+    }
+    LAYERARRAYS_CATCH(nullptr)
+}
+
+int32_t toolpathlayerarrays_release(ToolpathLayerArraysHandle pArrays)
+{
+    if (pArrays == nullptr)
+        return LIB3MF_ERROR_INVALIDPARAM;
+
+    try {
+        delete (CToolpathLayerArraysInstance *)pArrays;
+        return LIB3MF_SUCCESS;
+    }
+    LAYERARRAYS_CATCH(nullptr)
+}
+
+int32_t toolpathlayerarrays_extract(ToolpathLayerArraysHandle pArrays, void * pLayerReader, uint32_t nFactorMask, uint64_t * pSegmentCount, uint64_t * pPointCount)
+{
+    CToolpathLayerArraysInstance * pInstance = (CToolpathLayerArraysInstance *)pArrays;
+    if (pInstance == nullptr)
+        return LIB3MF_ERROR_INVALIDPARAM;
+    if ((pLayerReader == nullptr) || (pSegmentCount == nullptr) || (pPointCount == nullptr))
+        return layerArraysFail(pInstance, LIB3MF_ERROR_INVALIDPARAM, "invalid parameter");
+
+    try {
+        // The handle stays owned by the caller: take an additional reference for the C++ object, which releases
+        // it again. The temporary without wrapper does not release anything on destruction.
+        Lib3MF::CBase borrowedHandle(nullptr, pLayerReader);
+        pInstance->m_pWrapper->Acquire(&borrowedHandle);
+        auto pReader = std::make_shared<Lib3MF::CToolpathLayerReader>(pInstance->m_pWrapper.get(), pLayerReader);
+
+        pInstance->m_Arrays.Extract(pReader, nFactorMask);
+        *pSegmentCount = pInstance->m_Arrays.GetSegmentCount();
+        *pPointCount = pInstance->m_Arrays.GetPointCount();
+        return LIB3MF_SUCCESS;
+    }
+    LAYERARRAYS_CATCH(pInstance)
+}
+
+int32_t toolpathlayerarrays_copy(ToolpathLayerArraysHandle pArrays, uint32_t * pTypes, uint32_t * pProfileIDs, uint32_t * pPartIDs, uint64_t * pSegmentOffsets, int32_t * pCoordinates, double * pFactorsF, double * pFactorsG, double * pFactorsH)
+{
+    CToolpathLayerArraysInstance * pInstance = (CToolpathLayerArraysInstance *)pArrays;
+    if (pInstance == nullptr)
+        return LIB3MF_ERROR_INVALIDPARAM;
+
+    try {
+        auto & arrays = pInstance->m_Arrays;
+        layerArraysCopy(pTypes, arrays.GetTypes());
+        layerArraysCopy(pProfileIDs, arrays.GetProfileIDs());
+        layerArraysCopy(pPartIDs, arrays.GetPartIDs());
+        layerArraysCopy(pSegmentOffsets, arrays.GetSegmentOffsets());
+        layerArraysCopy(pCoordinates, arrays.GetCoordinates());
+        layerArraysCopy(pFactorsF, arrays.GetFactors(Lib3MF::eToolpathProfileModificationFactor::FactorF));
+        layerArraysCopy(pFactorsG, arrays.GetFactors(Lib3MF::eToolpathProfileModificationFactor::FactorG));
+        layerArraysCopy(pFactorsH, arrays.GetFactors(Lib3MF::eToolpathProfileModificationFactor::FactorH));
+        return LIB3MF_SUCCESS;
+    }
+    LAYERARRAYS_CATCH(pInstance)
+}
+
+int32_t toolpathlayerarrays_copyarcpaths(ToolpathLayerArraysHandle pArrays, uint8_t * pArcPaths)
+{
+    CToolpathLayerArraysInstance * pInstance = (CToolpathLayerArraysInstance *)pArrays;
+    if (pInstance == nullptr)
+        return LIB3MF_ERROR_INVALIDPARAM;
+
+    try {
+        layerArraysCopy(pArcPaths, pInstance->m_Arrays.GetArcPaths());
+        return LIB3MF_SUCCESS;
+    }
+    LAYERARRAYS_CATCH(pInstance)
+}
+
+int32_t toolpathlayerarrays_getlasterror(ToolpathLayerArraysHandle pArrays, uint32_t nBufferSize, uint32_t * pNeededChars, char * pBuffer)
+{
+    CToolpathLayerArraysInstance * pInstance = (CToolpathLayerArraysInstance *)pArrays;
+    if ((pInstance == nullptr) || (pNeededChars == nullptr))
+        return LIB3MF_ERROR_INVALIDPARAM;
+
+    const std::string & sMessage = pInstance->m_sLastError;
+    *pNeededChars = (uint32_t)sMessage.size() + 1;
+    if (pBuffer != nullptr) {
+        if (nBufferSize < *pNeededChars)
+            return LIB3MF_ERROR_BUFFERTOOSMALL;
+        memcpy(pBuffer, sMessage.c_str(), sMessage.size() + 1);
+    }
+    return LIB3MF_SUCCESS;
+}
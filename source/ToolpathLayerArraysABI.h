@@ -0,0 +1,116 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract: C interface of CToolpathLayerArrays for bindings that pass lib3mf handles, such as the Python binding. A layer is
+exported with one call into lib3mf's layer reader and one copy into caller buffers.
+
+*/
+
+
+
+#ifndef __TOOLPATHEXAMPLE_LAYERARRAYSABI
+#define __TOOLPATHEXAMPLE_LAYERARRAYSABI
+
+#include <stdint.h>
+
+#ifdef _WIN32
+#define TOOLPATHLAYERARRAYS_DECLSPEC __declspec(dllexport)
+#else
+#define TOOLPATHLAYERARRAYS_DECLSPEC __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void * ToolpathLayerArraysHandle;
+
+/**
+* toolpathlayerarrays_create - Creates layer arrays that call lib3mf through its symbol lookup method.
+* @param[in] pSymbolLookupMethod - Result of lib3mf_getsymbollookupmethod of the library that owns the layer readers
+* @param[out] pArrays - New layer arrays
+* @return lib3mf error code
+*/
+TOOLPATHLAYERARRAYS_DECLSPEC int32_t toolpathlayerarrays_create(void * pSymbolLookupMethod, ToolpathLayerArraysHandle * pArrays);
+
+/**
+* toolpathlayerarrays_release - Frees layer arrays.
+* @param[in] pArrays - Layer arrays
+* @return lib3mf error code
+*/
+TOOLPATHLAYERARRAYS_DECLSPEC int32_t toolpathlayerarrays_release(ToolpathLayerArraysHandle pArrays);
+
+/**
+* toolpathlayerarrays_extract - Flattens all segments of a layer.
+* @param[in] pArrays - Layer arrays
+* @param[in] pLayerReader - Lib3MF_ToolpathLayerReader handle, it is not released
+* @param[in] nFactorMask - Combination of TOOLPATHLAYERARRAYS_FACTOR_* flags
+* @param[out] pSegmentCount - Segment count
+* @param[out] pPointCount - Point count
+* @return lib3mf error code
+*/
+TOOLPATHLAYERARRAYS_DECLSPEC int32_t toolpathlayerarrays_extract(ToolpathLayerArraysHandle pArrays, void * pLayerReader, uint32_t nFactorMask, uint64_t * pSegmentCount, uint64_t * pPointCount);
+
+/**
+* toolpathlayerarrays_copy - Copies the extracted layer into caller buffers. Null buffers are skipped.
+* @param[in] pArrays - Layer arrays
+* @param[out] pTypes - Segment count segment types
+* @param[out] pProfileIDs - Segment count local profile IDs
+* @param[out] pPartIDs - Segment count local part IDs
+* @param[out] pSegmentOffsets - Segment count + 1 point offsets
+* @param[out] pCoordinates - 2 * point count coordinates in toolpath units
+* @param[out] pFactorsF - Point count factors F, if exported
+* @param[out] pFactorsG - Point count factors G, if exported
+* @param[out] pFactorsH - Point count factors H, if exported
+* @return lib3mf error code
+*/
+TOOLPATHLAYERARRAYS_DECLSPEC int32_t toolpathlayerarrays_copy(ToolpathLayerArraysHandle pArrays, uint32_t * pTypes, uint32_t * pProfileIDs, uint32_t * pPartIDs, uint64_t * pSegmentOffsets, int32_t * pCoordinates, double * pFactorsF, double * pFactorsG, double * pFactorsH);
+
+/**
+* toolpathlayerarrays_copyarcpaths - Copies the arc path flags of the extracted layer into a caller buffer.
+* @param[in] pArrays - Layer arrays
+* @param[out] pArcPaths - Segment count flags, 1 for arc paths and 0 for all other segments
+* @return lib3mf error code
+*/
+TOOLPATHLAYERARRAYS_DECLSPEC int32_t toolpathlayerarrays_copyarcpaths(ToolpathLayerArraysHandle pArrays, uint8_t * pArcPaths);
+
+/**
+* toolpathlayerarrays_getlasterror - Returns the message of the last failed call.
+* @param[in] pArrays - Layer arrays
+* @param[in] nBufferSize - Size of pBuffer including the terminating zero
+* @param[out] pNeededChars - Needed buffer size
+* @param[out] pBuffer - Message, may be null to query the size
+* @return lib3mf error code
+*/
+TOOLPATHLAYERARRAYS_DECLSPEC int32_t toolpathlayerarrays_getlasterror(ToolpathLayerArraysHandle pArrays, uint32_t nBufferSize, uint32_t * pNeededChars, char * pBuffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TOOLPATHEXAMPLE_LAYERARRAYSABI
@@ -0,0 +1,375 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathLayerBuilder.hpp"
+
+#include <stdexcept>
+
+namespace ToolpathExample {
+
+template <typename T> static size_t capacityInBytes(const std::vector<T> & buffer)
+{
+    return buffer.capacity() * sizeof(T);
+}
+
+template <typename T> static uint64_t sizeInBytes(const std::vector<T> & buffer)
+{
+    return (uint64_t)buffer.size() * sizeof(T);
+}
+
+// The input vectors only reference the builder storage, lib3mf copies the data during the call.
+template <typename T> static Lib3MF::CInputVector<T> inputView(const std::vector<T> & buffer)
+{
+    return Lib3MF::CInputVector<T>(buffer.data(), buffer.size());
+}
+
+// Clears the arc path attribute unless the arc path has been written, so that a failed write does not mark the
+// following segments of the layer
+class CToolpathArcPathAttributeGuard {
+private:
+    Lib3MF::PToolpathLayerData m_pLayer;
+    bool & m_bArcPathAttribute;
+    bool m_bWritten;
+
+public:
+    CToolpathArcPathAttributeGuard(Lib3MF::PToolpathLayerData pLayer, bool & bArcPathAttribute)
+        : m_pLayer(pLayer), m_bArcPathAttribute(bArcPathAttribute), m_bWritten(false)
+    {
+    }
+
+    ~CToolpathArcPathAttributeGuard()
+    {
+        if (m_bWritten || !m_bArcPathAttribute)
+            return;
+
+        // If clearing fails as well, the attribute is still recorded as set and cleared before the next segment
+        try {
+            CToolpathArcPath::SetSegmentAttribute(m_pLayer, false);
+            m_bArcPathAttribute = false;
+        }
+        catch (...) {
+        }
+    }
+
+    void SetWritten() { m_bWritten = true; }
+};
+
+CToolpathLayerBuilder::CToolpathLayerBuilder()
+    : m_dSimplifierUnits(1.0), m_dArcFitterUnits(1.0), m_bArcPathAttribute(false), m_nLayerCount(0), m_nLayerSegmentCount(0), m_nLayerBytes(0)
+{
+}
+
+void CToolpathLayerBuilder::SetStatistics(PToolpathStatistics pStatistics)
+{
+    m_pStatistics = pStatistics;
+}
+
+void CToolpathLayerBuilder::SetProgress(PToolpathProgress pProgress, uint32_t nLayerCount)
+{
+    m_pProgress = pProgress;
+    m_nLayerCount = nLayerCount;
+}
+
+void CToolpathLayerBuilder::FinishLayer(Lib3MF::PToolpathLayerData pLayer, uint32_t nLayerIndex)
+{
+    if (pLayer.get() == nullptr)
+        throw std::invalid_argument("invalid layer data");
+
+    pLayer->Finish();
+    m_pAttributeLayer.reset();
+    m_bArcPathAttribute = false;
+    if (m_pStatistics.get() != nullptr)
+        m_pStatistics->AddCount(eToolpathCounter::LayersWritten, 1);
+
+    uint64_t nSegmentCount = m_nLayerSegmentCount;
+    uint64_t nBytes = m_nLayerBytes;
+    m_nLayerSegmentCount = 0;
+    m_nLayerBytes = 0;
+
+    if (m_pProgress.get() != nullptr) {
+        m_pProgress->ReportLayer(eToolpathProgressStage::WriteLayer, nLayerIndex, m_nLayerCount, nBytes, nSegmentCount);
+        m_pProgress->CheckCancelled();
+    }
+}
+
+void CToolpathLayerBuilder::SetSimplifier(PToolpathCurveSimplifier pSimplifier, double dUnits)
+{
+    if (!(dUnits > 0.0))
+        throw std::invalid_argument("invalid units");
+
+    m_pSimplifier = pSimplifier;
+    m_dSimplifierUnits = dUnits;
+}
+
+void CToolpathLayerBuilder::SetArcFitter(PToolpathArcFitter pArcFitter, double dUnits)
+{
+    if (!(dUnits > 0.0))
+        throw std::invalid_argument("invalid units");
+
+    m_pArcFitter = pArcFitter;
+    m_dArcFitterUnits = dUnits;
+}
+
+void CToolpathLayerBuilder::Reserve(size_t nHatchCount, size_t nSubInterpolationCount, size_t nPointCount)
+{
+    m_Hatches.reserve(nHatchCount);
+    m_DiscreteHatches.reserve(nHatchCount);
+    m_HatchFactors1.reserve(nHatchCount);
+    m_HatchFactors2.reserve(nHatchCount);
+    m_SubInterpolationCounts.reserve(nHatchCount);
+    m_SubInterpolationData.reserve(nSubInterpolationCount);
+    m_Points.reserve(nPointCount);
+    m_DiscretePoints.reserve(nPointCount);
+    m_PointFactors.reserve(nPointCount);
+    if (m_pArcFitter.get() != nullptr) {
+        m_ArcPoints.reserve(nPointCount);
+        m_ArcDiscretePoints.reserve(nPointCount);
+        m_ArcFactors.reserve(nPointCount);
+    }
+}
+
+void CToolpathLayerBuilder::clearHatches()
+{
+    // clear() keeps the capacity of the vectors
+    m_Hatches.clear();
+    m_DiscreteHatches.clear();
+    m_HatchFactors1.clear();
+    m_HatchFactors2.clear();
+    m_SubInterpolationCounts.clear();
+    m_SubInterpolationData.clear();
+}
+
+void CToolpathLayerBuilder::clearPoints()
+{
+    m_Points.clear();
+    m_DiscretePoints.clear();
+    m_PointFactors.clear();
+}
+
+void CToolpathLayerBuilder::countSegment(uint64_t nPointCount, uint64_t nBytes)
+{
+    m_nLayerSegmentCount++;
+    m_nLayerBytes += nBytes;
+
+    if (m_pStatistics.get() != nullptr) {
+        m_pStatistics->AddCount(eToolpathCounter::SegmentsWritten, 1);
+        m_pStatistics->AddCount(eToolpathCounter::PointsWritten, nPointCount);
+    }
+}
+
+void CToolpathLayerBuilder::checkHatchUnits() const
+{
+    if (!m_Hatches.empty() && !m_DiscreteHatches.empty())
+        throw std::logic_error("hatches in model units and toolpath units can not be mixed in one segment");
+}
+
+void CToolpathLayerBuilder::checkPointUnits() const
+{
+    if (!m_Points.empty() && !m_DiscretePoints.empty())
+        throw std::logic_error("points in model units and toolpath units can not be mixed in one segment");
+}
+
+void CToolpathLayerBuilder::simplifyPoints(bool bClosed)
+{
+    if (m_pSimplifier.get() == nullptr)
+        return;
+
+    // The simplifier moves the remaining points and their factors to the front of the buffers
+    size_t nPointCount;
+    if (!m_DiscretePoints.empty()) {
+        nPointCount = m_pSimplifier->Simplify(m_DiscretePoints.data(), m_PointFactors.data(), m_DiscretePoints.size(), bClosed);
+        m_DiscretePoints.resize(nPointCount);
+    }
+    else {
+        nPointCount = m_pSimplifier->SimplifyInModelUnits(m_Points.data(), m_PointFactors.data(), m_Points.size(), bClosed, m_dSimplifierUnits);
+        m_Points.resize(nPointCount);
+    }
+    m_PointFactors.resize(nPointCount);
+}
+
+bool CToolpathLayerBuilder::fitArcs(bool bClosed)
+{
+    if (m_pArcFitter.get() == nullptr)
+        return false;
+
+    if (!m_DiscretePoints.empty())
+        return m_pArcFitter->Fit(m_DiscretePoints.data(), m_PointFactors.data(), m_DiscretePoints.size(), bClosed, m_ArcDiscretePoints, m_ArcFactors);
+    return m_pArcFitter->FitInModelUnits(m_Points.data(), m_PointFactors.data(), m_Points.size(), bClosed, m_dArcFitterUnits, m_ArcPoints, m_ArcFactors);
+}
+
+void CToolpathLayerBuilder::Reset()
+{
+    clearHatches();
+    clearPoints();
+}
+
+size_t CToolpathLayerBuilder::GetHatchCount() const
+{
+    return m_Hatches.size() + m_DiscreteHatches.size();
+}
+
+size_t CToolpathLayerBuilder::GetSubInterpolationCount() const
+{
+    return m_SubInterpolationData.size();
+}
+
+size_t CToolpathLayerBuilder::GetPointCount() const
+{
+    return m_Points.size() + m_DiscretePoints.size();
+}
+
+size_t CToolpathLayerBuilder::GetCapacityInBytes() const
+{
+    return capacityInBytes(m_Hatches) + capacityInBytes(m_DiscreteHatches) + capacityInBytes(m_HatchFactors1) + capacityInBytes(m_HatchFactors2)
+        + capacityInBytes(m_SubInterpolationCounts) + capacityInBytes(m_SubInterpolationData)
+        + capacityInBytes(m_Points) + capacityInBytes(m_DiscretePoints) + capacityInBytes(m_PointFactors)
+        + capacityInBytes(m_ArcPoints) + capacityInBytes(m_ArcDiscretePoints) + capacityInBytes(m_ArcFactors);
+}
+
+void CToolpathLayerBuilder::setArcPathAttribute(Lib3MF::PToolpathLayerData pLayer, bool bArcPath)
+{
+    // Layers start without the attribute
+    if (m_pAttributeLayer.lock() != pLayer) {
+        m_pAttributeLayer = pLayer;
+        m_bArcPathAttribute = false;
+    }
+
+    if (m_bArcPathAttribute != bArcPath) {
+        CToolpathArcPath::SetSegmentAttribute(pLayer, bArcPath);
+        m_bArcPathAttribute = bArcPath;
+    }
+}
+
+void CToolpathLayerBuilder::WriteHatches(Lib3MF::PToolpathLayerData pLayer, uint32_t nProfileID, uint32_t nPartID)
+{
+    if (pLayer.get() == nullptr)
+        throw std::invalid_argument("invalid layer data");
+
+    checkHatchUnits();
+    if (!m_DiscreteHatches.empty() || !m_Hatches.empty())
+        setArcPathAttribute(pLayer, false);
+    if (!m_DiscreteHatches.empty()) {
+        // Discrete hatches are passed on as they are, lib3mf does not convert them
+        if (m_SubInterpolationData.empty()) {
+            pLayer->WriteHatchDataDiscreteWithLinearFactors(nProfileID, nPartID, inputView(m_DiscreteHatches), inputView(m_HatchFactors1), inputView(m_HatchFactors2));
+        }
+        else {
+            pLayer->WriteHatchDataDiscreteWithNonlinearFactors(nProfileID, nPartID, inputView(m_DiscreteHatches), inputView(m_HatchFactors1), inputView(m_HatchFactors2),
+                inputView(m_SubInterpolationCounts), inputView(m_SubInterpolationData));
+        }
+    }
+    else if (!m_Hatches.empty()) {
+        if (m_SubInterpolationData.empty()) {
+            pLayer->WriteHatchDataInModelUnitsWithLinearFactors(nProfileID, nPartID, inputView(m_Hatches), inputView(m_HatchFactors1), inputView(m_HatchFactors2));
+        }
+        else {
+            pLayer->WriteHatchDataInModelUnitsWithNonlinearFactors(nProfileID, nPartID, inputView(m_Hatches), inputView(m_HatchFactors1), inputView(m_HatchFactors2),
+                inputView(m_SubInterpolationCounts), inputView(m_SubInterpolationData));
+        }
+    }
+    else {
+        return;
+    }
+
+    uint64_t nBytes = sizeInBytes(m_Hatches) + sizeInBytes(m_DiscreteHatches) + sizeInBytes(m_HatchFactors1) + sizeInBytes(m_HatchFactors2);
+    if (!m_SubInterpolationData.empty())
+        nBytes += sizeInBytes(m_SubInterpolationCounts) + sizeInBytes(m_SubInterpolationData);
+    countSegment(2 * (uint64_t)GetHatchCount(), nBytes);
+    clearHatches();
+}
+
+void CToolpathLayerBuilder::WriteLoop(Lib3MF::PToolpathLayerData pLayer, uint32_t nProfileID, uint32_t nPartID)
+{
+    if (pLayer.get() == nullptr)
+        throw std::invalid_argument("invalid layer data");
+
+    checkPointUnits();
+    if (GetPointCount() == 0)
+        return;
+
+    if (fitArcs(true)) {
+        setArcPathAttribute(pLayer, true);
+        CToolpathArcPathAttributeGuard attributeGuard(pLayer, m_bArcPathAttribute);
+        if (!m_DiscretePoints.empty())
+            pLayer->WriteLoopDiscreteWithFactors(nProfileID, nPartID, inputView(m_ArcDiscretePoints), inputView(m_ArcFactors));
+        else
+            pLayer->WriteLoopInModelUnitsWithFactors(nProfileID, nPartID, inputView(m_ArcPoints), inputView(m_ArcFactors));
+        attributeGuard.SetWritten();
+        countSegment(m_DiscretePoints.empty() ? m_ArcPoints.size() : m_ArcDiscretePoints.size(), (m_DiscretePoints.empty() ? sizeInBytes(m_ArcPoints) : sizeInBytes(m_ArcDiscretePoints)) + sizeInBytes(m_ArcFactors));
+        clearPoints();
+        return;
+    }
+
+    simplifyPoints(true);
+    setArcPathAttribute(pLayer, false);
+    if (!m_DiscretePoints.empty())
+        pLayer->WriteLoopDiscreteWithFactors(nProfileID, nPartID, inputView(m_DiscretePoints), inputView(m_PointFactors));
+    else
+        pLayer->WriteLoopInModelUnitsWithFactors(nProfileID, nPartID, inputView(m_Points), inputView(m_PointFactors));
+
+    countSegment(GetPointCount(), sizeInBytes(m_Points) + sizeInBytes(m_DiscretePoints) + sizeInBytes(m_PointFactors));
+    clearPoints();
+}
+
+void CToolpathLayerBuilder::WritePolyline(Lib3MF::PToolpathLayerData pLayer, uint32_t nProfileID, uint32_t nPartID)
+{
+    if (pLayer.get() == nullptr)
+        throw std::invalid_argument("invalid layer data");
+
+    checkPointUnits();
+    if (GetPointCount() == 0)
+        return;
+
+    if (fitArcs(false)) {
+        setArcPathAttribute(pLayer, true);
+        CToolpathArcPathAttributeGuard attributeGuard(pLayer, m_bArcPathAttribute);
+        if (!m_DiscretePoints.empty())
+            pLayer->WritePolylineDiscreteWithFactors(nProfileID, nPartID, inputView(m_ArcDiscretePoints), inputView(m_ArcFactors));
+        else
+            pLayer->WritePolylineInModelUnitsWithFactors(nProfileID, nPartID, inputView(m_ArcPoints), inputView(m_ArcFactors));
+        attributeGuard.SetWritten();
+        countSegment(m_DiscretePoints.empty() ? m_ArcPoints.size() : m_ArcDiscretePoints.size(), (m_DiscretePoints.empty() ? sizeInBytes(m_ArcPoints) : sizeInBytes(m_ArcDiscretePoints)) + sizeInBytes(m_ArcFactors));
+        clearPoints();
+        return;
+    }
+
+    simplifyPoints(false);
+    setArcPathAttribute(pLayer, false);
+    if (!m_DiscretePoints.empty())
+        pLayer->WritePolylineDiscreteWithFactors(nProfileID, nPartID, inputView(m_DiscretePoints), inputView(m_PointFactors));
+    else
+        pLayer->WritePolylineInModelUnitsWithFactors(nProfileID, nPartID, inputView(m_Points), inputView(m_PointFactors));
+
+    countSegment(GetPointCount(), sizeInBytes(m_Points) + sizeInBytes(m_DiscretePoints) + sizeInBytes(m_PointFactors));
+    clearPoints();
+}
+
+} // namespace ToolpathExample
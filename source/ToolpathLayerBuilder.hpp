@@ -0,0 +1,320 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef __TOOLPATHEXAMPLE_LAYERBUILDER
+#define __TOOLPATHEXAMPLE_LAYERBUILDER
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+#include "ToolpathArcFitter.hpp"
+#include "ToolpathCurveSimplifier.hpp"
+#include "ToolpathProgress.hpp"
+#include "ToolpathStatistics.hpp"
+
+namespace ToolpathExample {
+
+/*************************************************************************************************************************
+ Class CToolpathLayerBuilder
+
+ Collects the segments of a layer in buffers that keep their capacity when the builder is reset, and passes them to
+ the layer data as views on that storage. Reusing one builder for all layers of a build allocates only while the
+ buffers grow to the size of the largest layer.
+ Segments can be collected in model units or, without any floating point conversion, in discrete toolpath units.
+ Both kinds can not be mixed within one segment. Loops and polylines are written as arc paths if a CToolpathArcFitter
+ is set and finds a shorter path, and are simplified before they are written otherwise if a CToolpathCurveSimplifier
+ is set.
+**************************************************************************************************************************/
+class CToolpathLayerBuilder {
+private:
+    std::vector<Lib3MF::sHatch2D> m_Hatches;
+    std::vector<Lib3MF::sDiscreteHatch2D> m_DiscreteHatches;
+    std::vector<double> m_HatchFactors1;
+    std::vector<double> m_HatchFactors2;
+    std::vector<Lib3MF_uint32> m_SubInterpolationCounts;
+    std::vector<Lib3MF::sHatchModificationInterpolationData> m_SubInterpolationData;
+
+    std::vector<Lib3MF::sPosition2D> m_Points;
+    std::vector<Lib3MF::sDiscretePosition2D> m_DiscretePoints;
+    std::vector<double> m_PointFactors;
+
+    // Each pass keeps the units it was set with
+    PToolpathCurveSimplifier m_pSimplifier;
+    double m_dSimplifierUnits;
+    PToolpathArcFitter m_pArcFitter;
+    double m_dArcFitterUnits;
+
+    // Arc path of the collected points
+    std::vector<Lib3MF::sPosition2D> m_ArcPoints;
+    std::vector<Lib3MF::sDiscretePosition2D> m_ArcDiscretePoints;
+    std::vector<double> m_ArcFactors;
+
+    // Arc path attribute as last set on the layer. It is only cleared when a following segment is no arc path.
+    std::weak_ptr<Lib3MF::CToolpathLayerData> m_pAttributeLayer;
+    bool m_bArcPathAttribute;
+
+    // Progress of the current layer
+    PToolpathStatistics m_pStatistics;
+    PToolpathProgress m_pProgress;
+    uint32_t m_nLayerCount;
+    uint64_t m_nLayerSegmentCount;
+    uint64_t m_nLayerBytes;
+
+    void countSegment(uint64_t nPointCount, uint64_t nBytes);
+    void clearHatches();
+    void clearPoints();
+    void simplifyPoints(bool bClosed);
+    bool fitArcs(bool bClosed);
+    void setArcPathAttribute(Lib3MF::PToolpathLayerData pLayer, bool bArcPath);
+    void checkHatchUnits() const;
+    void checkPointUnits() const;
+
+public:
+
+    /**
+    * CToolpathLayerBuilder::CToolpathLayerBuilder - Creates an empty builder.
+    */
+    CToolpathLayerBuilder();
+
+    /**
+    * CToolpathLayerBuilder::SetSimplifier - Sets the simplifier loops and polylines are passed through before writing.
+    * @param[in] pSimplifier - Simplifier with its tolerance in toolpath units, nullptr writes all points
+    * @param[in] dUnits - Size of a toolpath unit in model units, applies to points in model units of the simplifier only
+    */
+    void SetSimplifier(PToolpathCurveSimplifier pSimplifier, double dUnits);
+
+    PToolpathCurveSimplifier GetSimplifier() const { return m_pSimplifier; }
+
+    /**
+    * CToolpathLayerBuilder::SetArcFitter - Sets the arc fitter loops and polylines are passed through before writing.
+    *   Arc paths are marked with the segment attribute of CToolpathArcPath, which has to be registered with the toolpath
+    *   before its layers are added. As lib3mf keeps segment attributes for all following segments of a layer, the
+    *   builder sets the attribute to 0 before the next segment it writes that is no arc path, and leaves it set in
+    *   between; segments written to the layer directly have to clear it with CToolpathArcPath::SetSegmentAttribute.
+    *   Once cleared, every following segment of the layer carries arcpath="0", about 20 bytes of XML per segment, as
+    *   ClearSegmentAttributes would remove other attributes of the caller as well. The namespace is registered with
+    *   the writer by CToolpathArcPath::RegisterNamespace.
+    * @param[in] pArcFitter - Arc fitter with its tolerance in toolpath units, nullptr writes all points
+    * @param[in] dUnits - Size of a toolpath unit in model units, applies to points in model units of the arc fitter only
+    */
+    void SetArcFitter(PToolpathArcFitter pArcFitter, double dUnits);
+
+    PToolpathArcFitter GetArcFitter() const { return m_pArcFitter; }
+
+    /**
+    * CToolpathLayerBuilder::SetStatistics - Sets the statistics that written segments and points, and layers finished
+    *   with FinishLayer are counted in. Hatches count as two points, loops and polylines with the points that remain
+    *   after arc fitting or simplification.
+    * @param[in] pStatistics - Statistics, null to disable
+    */
+    void SetStatistics(PToolpathStatistics pStatistics);
+
+    /**
+    * CToolpathLayerBuilder::SetProgress - Sets the progress instance that FinishLayer reports WriteLayer events to.
+    * @param[in] pProgress - Progress instance, null to disable
+    * @param[in] nLayerCount - Total number of layers, 0 if unknown
+    */
+    void SetProgress(PToolpathProgress pProgress, uint32_t nLayerCount);
+
+    /**
+    * CToolpathLayerBuilder::Reserve - Reserves storage upfront, e.g. for the expected size of the largest layer.
+    * @param[in] nHatchCount - Number of hatches
+    * @param[in] nSubInterpolationCount - Total number of hatch sub interpolation samples
+    * @param[in] nPointCount - Number of loop or polyline points
+    */
+    void Reserve(size_t nHatchCount, size_t nSubInterpolationCount, size_t nPointCount);
+
+    /**
+    * CToolpathLayerBuilder::Reset - Discards all collected data and keeps the storage for the next layer.
+    */
+    void Reset();
+
+    /**
+    * CToolpathLayerBuilder::AddHatch - Appends a hatch with factors at its start and end point.
+    * @param[in] dX1 - Start point X in model units
+    * @param[in] dY1 - Start point Y in model units
+    * @param[in] dX2 - End point X in model units
+    * @param[in] dY2 - End point Y in model units
+    * @param[in] nTag - Hatch tag
+    * @param[in] dFactor1 - Factor at the start point
+    * @param[in] dFactor2 - Factor at the end point
+    */
+    inline void AddHatch(double dX1, double dY1, double dX2, double dY2, uint32_t nTag, double dFactor1, double dFactor2)
+    {
+        m_Hatches.emplace_back();
+        Lib3MF::sHatch2D & hatch = m_Hatches.back();
+        hatch.m_Point1Coordinates[0] = dX1;
+        hatch.m_Point1Coordinates[1] = dY1;
+        hatch.m_Point2Coordinates[0] = dX2;
+        hatch.m_Point2Coordinates[1] = dY2;
+        hatch.m_Tag = nTag;
+
+        m_HatchFactors1.push_back(dFactor1);
+        m_HatchFactors2.push_back(dFactor2);
+        m_SubInterpolationCounts.push_back(0);
+    }
+
+    /**
+    * CToolpathLayerBuilder::AddDiscreteHatch - Appends a hatch in toolpath units with factors at its start and end point.
+    * @param[in] nX1 - Start point X in toolpath units
+    * @param[in] nY1 - Start point Y in toolpath units
+    * @param[in] nX2 - End point X in toolpath units
+    * @param[in] nY2 - End point Y in toolpath units
+    * @param[in] nTag - Hatch tag
+    * @param[in] dFactor1 - Factor at the start point
+    * @param[in] dFactor2 - Factor at the end point
+    */
+    inline void AddDiscreteHatch(int32_t nX1, int32_t nY1, int32_t nX2, int32_t nY2, uint32_t nTag, double dFactor1, double dFactor2)
+    {
+        m_DiscreteHatches.emplace_back();
+        Lib3MF::sDiscreteHatch2D & hatch = m_DiscreteHatches.back();
+        hatch.m_Point1Coordinates[0] = nX1;
+        hatch.m_Point1Coordinates[1] = nY1;
+        hatch.m_Point2Coordinates[0] = nX2;
+        hatch.m_Point2Coordinates[1] = nY2;
+        hatch.m_Tag = nTag;
+
+        m_HatchFactors1.push_back(dFactor1);
+        m_HatchFactors2.push_back(dFactor2);
+        m_SubInterpolationCounts.push_back(0);
+    }
+
+    /**
+    * CToolpathLayerBuilder::AddSubInterpolation - Appends a nonlinear factor sample to the last hatch.
+    * @param[in] dParameter - Position along the hatch, between 0 and 1 exclusive, increasing per hatch
+    * @param[in] dFactor - Factor at the position
+    */
+    inline void AddSubInterpolation(double dParameter, double dFactor)
+    {
+        if (m_SubInterpolationCounts.empty())
+            throw std::logic_error("no hatch to add sub interpolation data to");
+
+        Lib3MF::sHatchModificationInterpolationData data;
+        data.m_Parameter = dParameter;
+        data.m_Factor = dFactor;
+        m_SubInterpolationData.push_back(data);
+        m_SubInterpolationCounts.back()++;
+    }
+
+    /**
+    * CToolpathLayerBuilder::AddPoint - Appends a loop or polyline point.
+    * @param[in] fX - X in model units
+    * @param[in] fY - Y in model units
+    * @param[in] dFactor - Factor at the point
+    */
+    inline void AddPoint(float fX, float fY, double dFactor)
+    {
+        m_Points.push_back({ fX, fY });
+        m_PointFactors.push_back(dFactor);
+    }
+
+    /**
+    * CToolpathLayerBuilder::AddDiscretePoint - Appends a loop or polyline point in toolpath units.
+    * @param[in] nX - X in toolpath units
+    * @param[in] nY - Y in toolpath units
+    * @param[in] dFactor - Factor at the point
+    */
+    inline void AddDiscretePoint(int32_t nX, int32_t nY, double dFactor)
+    {
+        m_DiscretePoints.push_back({ { nX, nY } });
+        m_PointFactors.push_back(dFactor);
+    }
+
+    /**
+    * CToolpathLayerBuilder::GetHatchCount - Returns the number of collected hatches.
+    * @return Hatch count
+    */
+    size_t GetHatchCount() const;
+
+    /**
+    * CToolpathLayerBuilder::GetSubInterpolationCount - Returns the number of collected sub interpolation samples.
+    * @return Sample count
+    */
+    size_t GetSubInterpolationCount() const;
+
+    /**
+    * CToolpathLayerBuilder::GetPointCount - Returns the number of collected loop or polyline points.
+    * @return Point count
+    */
+    size_t GetPointCount() const;
+
+    /**
+    * CToolpathLayerBuilder::GetCapacityInBytes - Returns the size of the retained storage.
+    * @return Capacity of all buffers in bytes
+    */
+    size_t GetCapacityInBytes() const;
+
+    /**
+    * CToolpathLayerBuilder::WriteHatches - Writes the collected hatches as one segment and clears them. Hatches are
+    *   written with nonlinear factors if any sub interpolation data has been added, with linear factors otherwise.
+    * @param[in] pLayer - Layer data to write to
+    * @param[in] nProfileID - Profile ID as registered in the layer
+    * @param[in] nPartID - Part ID as registered in the layer
+    */
+    void WriteHatches(Lib3MF::PToolpathLayerData pLayer, uint32_t nProfileID, uint32_t nPartID);
+
+    /**
+    * CToolpathLayerBuilder::WriteLoop - Writes the collected points as loop segment with factors and clears them.
+    *   The loop is written as arc path or simplified first if an arc fitter or a simplifier is set.
+    * @param[in] pLayer - Layer data to write to
+    * @param[in] nProfileID - Profile ID as registered in the layer
+    * @param[in] nPartID - Part ID as registered in the layer
+    */
+    void WriteLoop(Lib3MF::PToolpathLayerData pLayer, uint32_t nProfileID, uint32_t nPartID);
+
+    /**
+    * CToolpathLayerBuilder::WritePolyline - Writes the collected points as polyline segment with factors and clears them.
+    *   The polyline is written as arc path or simplified first if an arc fitter or a simplifier is set.
+    * @param[in] pLayer - Layer data to write to
+    * @param[in] nProfileID - Profile ID as registered in the layer
+    * @param[in] nPartID - Part ID as registered in the layer
+    */
+    void WritePolyline(Lib3MF::PToolpathLayerData pLayer, uint32_t nProfileID, uint32_t nPartID);
+
+    /**
+    * CToolpathLayerBuilder::FinishLayer - Finishes the layer data and reports a WriteLayer event with the number of
+    *   segments and the size of the segment data written since the last call. Throws EToolpathCancelled if
+    *   cancellation has been requested.
+    * @param[in] pLayer - Layer data to finish
+    * @param[in] nLayerIndex - Layer index
+    */
+    void FinishLayer(Lib3MF::PToolpathLayerData pLayer, uint32_t nLayerIndex);
+
+};
+
+typedef std::shared_ptr<CToolpathLayerBuilder> PToolpathLayerBuilder;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_LAYERBUILDER
@@ -0,0 +1,133 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathLayerExtractor.hpp"
+
+#include <stdexcept>
+
+namespace ToolpathExample {
+
+template <typename T> static size_t capacityInBytes(const std::vector<T> & buffer)
+{
+    return buffer.capacity() * sizeof(T);
+}
+
+CToolpathLayerExtractor::CToolpathLayerExtractor()
+{
+}
+
+Lib3MF::CToolpathLayerReader & CToolpathLayerExtractor::getReader()
+{
+    if (m_pLayerReader.get() == nullptr)
+        throw std::runtime_error("no layer has been set");
+
+    return *m_pLayerReader;
+}
+
+void CToolpathLayerExtractor::SetLayer(Lib3MF::PToolpathLayerReader pLayerReader)
+{
+    if (pLayerReader.get() == nullptr)
+        throw std::invalid_argument("invalid layer reader");
+
+    // Local profile IDs are only unique within a layer.
+    m_pLayerReader = pLayerReader;
+    m_ProfileUUIDs.clear();
+}
+
+const std::string & CToolpathLayerExtractor::GetSegmentProfileUUID(uint32_t nSegmentIndex)
+{
+    Lib3MF::CToolpathLayerReader & reader = getReader();
+
+    uint32_t nProfileID = reader.GetSegmentDefaultProfileID(nSegmentIndex);
+    auto iProfile = m_ProfileUUIDs.find(nProfileID);
+    if (iProfile == m_ProfileUUIDs.end())
+        iProfile = m_ProfileUUIDs.insert(std::make_pair(nProfileID, reader.GetProfileUUIDByLocalProfileID(nProfileID))).first;
+
+    return iProfile->second;
+}
+
+// The generated getters resize the target vector, which keeps its capacity when the data does not grow.
+
+const std::vector<Lib3MF::sPosition2D> & CToolpathLayerExtractor::GetPoints(uint32_t nSegmentIndex)
+{
+    getReader().GetSegmentPointDataInModelUnits(nSegmentIndex, m_Points);
+    return m_Points;
+}
+
+const std::vector<Lib3MF::sDiscretePosition2D> & CToolpathLayerExtractor::GetDiscretePoints(uint32_t nSegmentIndex)
+{
+    getReader().GetSegmentPointDataDiscrete(nSegmentIndex, m_DiscretePoints);
+    return m_DiscretePoints;
+}
+
+const std::vector<double> & CToolpathLayerExtractor::GetPointFactors(uint32_t nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor factor)
+{
+    getReader().GetSegmentPointModificationFactors(nSegmentIndex, factor, m_PointFactors);
+    return m_PointFactors;
+}
+
+const std::vector<Lib3MF::sHatch2D> & CToolpathLayerExtractor::GetHatches(uint32_t nSegmentIndex)
+{
+    getReader().GetSegmentHatchDataInModelUnits(nSegmentIndex, m_Hatches);
+    return m_Hatches;
+}
+
+const std::vector<Lib3MF::sDiscreteHatch2D> & CToolpathLayerExtractor::GetDiscreteHatches(uint32_t nSegmentIndex)
+{
+    getReader().GetSegmentHatchDataDiscrete(nSegmentIndex, m_DiscreteHatches);
+    return m_DiscreteHatches;
+}
+
+const std::vector<Lib3MF::sHatch2DFactors> & CToolpathLayerExtractor::GetHatchFactors(uint32_t nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor factor)
+{
+    getReader().GetLinearSegmentHatchModificationFactors(nSegmentIndex, factor, m_HatchFactors);
+    return m_HatchFactors;
+}
+
+const std::vector<Lib3MF::sHatchModificationInterpolationData> & CToolpathLayerExtractor::GetSubInterpolationData(uint32_t nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor factor)
+{
+    getReader().GetSegmentAllNonlinearHatchesModificationInterpolation(nSegmentIndex, factor, m_SubInterpolationCounts, m_SubInterpolationData);
+    return m_SubInterpolationData;
+}
+
+const std::vector<Lib3MF_uint32> & CToolpathLayerExtractor::GetSubInterpolationCounts() const
+{
+    return m_SubInterpolationCounts;
+}
+
+size_t CToolpathLayerExtractor::GetCapacityInBytes() const
+{
+    return capacityInBytes(m_Points) + capacityInBytes(m_DiscretePoints) + capacityInBytes(m_PointFactors)
+        + capacityInBytes(m_Hatches) + capacityInBytes(m_DiscreteHatches) + capacityInBytes(m_HatchFactors)
+        + capacityInBytes(m_SubInterpolationCounts) + capacityInBytes(m_SubInterpolationData);
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,159 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef __TOOLPATHEXAMPLE_LAYEREXTRACTOR
+#define __TOOLPATHEXAMPLE_LAYEREXTRACTOR
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+
+namespace ToolpathExample {
+
+/*************************************************************************************************************************
+ Class CToolpathLayerExtractor
+
+ Retrieves segment data of layer readers into buffers that are kept between segments and layers. The returned
+ references stay valid until the next call that fills the same buffer. Profile UUIDs are resolved once per local
+ profile ID and layer instead of once per segment. Reading many layers through one extractor therefore does not
+ allocate on the application side once the buffers have grown to the largest segment.
+**************************************************************************************************************************/
+class CToolpathLayerExtractor {
+private:
+    Lib3MF::PToolpathLayerReader m_pLayerReader;
+    std::map<uint32_t, std::string> m_ProfileUUIDs;
+
+    std::vector<Lib3MF::sPosition2D> m_Points;
+    std::vector<Lib3MF::sDiscretePosition2D> m_DiscretePoints;
+    std::vector<double> m_PointFactors;
+    std::vector<Lib3MF::sHatch2D> m_Hatches;
+    std::vector<Lib3MF::sDiscreteHatch2D> m_DiscreteHatches;
+    std::vector<Lib3MF::sHatch2DFactors> m_HatchFactors;
+    std::vector<Lib3MF_uint32> m_SubInterpolationCounts;
+    std::vector<Lib3MF::sHatchModificationInterpolationData> m_SubInterpolationData;
+
+    Lib3MF::CToolpathLayerReader & getReader();
+
+public:
+
+    /**
+    * CToolpathLayerExtractor::CToolpathLayerExtractor - Creates an extractor without a layer.
+    */
+    CToolpathLayerExtractor();
+
+    /**
+    * CToolpathLayerExtractor::SetLayer - Starts extracting from a layer. Keeps the buffers and drops the profile cache.
+    * @param[in] pLayerReader - Layer reader, released when the next layer is set
+    */
+    void SetLayer(Lib3MF::PToolpathLayerReader pLayerReader);
+
+    /**
+    * CToolpathLayerExtractor::GetSegmentProfileUUID - Returns the UUID of the default profile of a segment.
+    * @param[in] nSegmentIndex - Segment index
+    * @return Profile UUID, cached per local profile ID
+    */
+    const std::string & GetSegmentProfileUUID(uint32_t nSegmentIndex);
+
+    /**
+    * CToolpathLayerExtractor::GetPoints - Retrieves the points of a loop or polyline segment in model units.
+    * @param[in] nSegmentIndex - Segment index
+    * @return Points, valid until the next call of GetPoints
+    */
+    const std::vector<Lib3MF::sPosition2D> & GetPoints(uint32_t nSegmentIndex);
+
+    /**
+    * CToolpathLayerExtractor::GetDiscretePoints - Retrieves the points of a loop or polyline segment in toolpath units.
+    * @param[in] nSegmentIndex - Segment index
+    * @return Points, valid until the next call of GetDiscretePoints
+    */
+    const std::vector<Lib3MF::sDiscretePosition2D> & GetDiscretePoints(uint32_t nSegmentIndex);
+
+    /**
+    * CToolpathLayerExtractor::GetPointFactors - Retrieves the modification factors of the points of a segment.
+    * @param[in] nSegmentIndex - Segment index
+    * @param[in] factor - Modification factor
+    * @return Factors, valid until the next call of GetPointFactors
+    */
+    const std::vector<double> & GetPointFactors(uint32_t nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor factor);
+
+    /**
+    * CToolpathLayerExtractor::GetHatches - Retrieves the hatches of a hatch segment in model units.
+    * @param[in] nSegmentIndex - Segment index
+    * @return Hatches, valid until the next call of GetHatches
+    */
+    const std::vector<Lib3MF::sHatch2D> & GetHatches(uint32_t nSegmentIndex);
+
+    /**
+    * CToolpathLayerExtractor::GetDiscreteHatches - Retrieves the hatches of a hatch segment in toolpath units.
+    * @param[in] nSegmentIndex - Segment index
+    * @return Hatches, valid until the next call of GetDiscreteHatches
+    */
+    const std::vector<Lib3MF::sDiscreteHatch2D> & GetDiscreteHatches(uint32_t nSegmentIndex);
+
+    /**
+    * CToolpathLayerExtractor::GetHatchFactors - Retrieves the linear modification factors of the hatches of a segment.
+    * @param[in] nSegmentIndex - Segment index
+    * @param[in] factor - Modification factor
+    * @return Factors at both hatch ends, valid until the next call of GetHatchFactors
+    */
+    const std::vector<Lib3MF::sHatch2DFactors> & GetHatchFactors(uint32_t nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor factor);
+
+    /**
+    * CToolpathLayerExtractor::GetSubInterpolationData - Retrieves the nonlinear modification factors of all hatches of a segment.
+    * @param[in] nSegmentIndex - Segment index
+    * @param[in] factor - Modification factor
+    * @return Samples of all hatches in hatch order, valid until the next call of GetSubInterpolationData
+    */
+    const std::vector<Lib3MF::sHatchModificationInterpolationData> & GetSubInterpolationData(uint32_t nSegmentIndex, Lib3MF::eToolpathProfileModificationFactor factor);
+
+    /**
+    * CToolpathLayerExtractor::GetSubInterpolationCounts - Returns the sample count per hatch of the last GetSubInterpolationData call.
+    * @return Sample counts
+    */
+    const std::vector<Lib3MF_uint32> & GetSubInterpolationCounts() const;
+
+    /**
+    * CToolpathLayerExtractor::GetCapacityInBytes - Returns the size of the retained buffers.
+    * @return Capacity of all buffers in bytes
+    */
+    size_t GetCapacityInBytes() const;
+
+};
+
+typedef std::shared_ptr<CToolpathLayerExtractor> PToolpathLayerExtractor;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_LAYEREXTRACTOR
@@ -0,0 +1,647 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathLayerVisitor.hpp"
+#include "ToolpathArcFitter.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#define LAYERVISITOR_TOOLPATH_NAMESPACE "http://schemas.microsoft.com/3dmanufacturing/toolpath/2019/05"
+#define LAYERVISITOR_BINARY_NAMESPACE "http://schemas.microsoft.com/3dmanufacturing/binary/2023/05"
+#define LAYERVISITOR_DEFAULT_CHUNKSIZE 65536
+#define LAYERVISITOR_MIN_CHUNKSIZE 4096
+
+namespace ToolpathExample {
+
+/* Attribute of the current tag, pointing into the parse buffer. */
+typedef struct sLayerXMLAttribute {
+    const char * m_pName;
+    size_t m_nNameLength;
+    const char * m_pValue;
+    size_t m_nValueLength;
+} sLayerXMLAttribute;
+
+static bool layerXMLEquals(const char * pString, size_t nLength, const char * pLiteral)
+{
+    return (strlen(pLiteral) == nLength) && (memcmp(pString, pLiteral, nLength) == 0);
+}
+
+static bool layerXMLIsSpace(char cChar)
+{
+    return (cChar == ' ') || (cChar == '\t') || (cChar == '\r') || (cChar == '\n');
+}
+
+// Values are always followed by their closing quote, which terminates the conversion.
+static int64_t layerXMLParseInteger(const sLayerXMLAttribute & attribute)
+{
+    char * pEnd = nullptr;
+    int64_t nValue = strtoll(attribute.m_pValue, &pEnd, 10);
+    if ((pEnd == attribute.m_pValue) || (pEnd != attribute.m_pValue + attribute.m_nValueLength))
+        throw std::runtime_error("invalid integer in layer: " + std::string(attribute.m_pValue, attribute.m_nValueLength));
+    return nValue;
+}
+
+static double layerXMLParseDouble(const sLayerXMLAttribute & attribute)
+{
+    char * pEnd = nullptr;
+    double dValue = strtod(attribute.m_pValue, &pEnd);
+    if ((pEnd == attribute.m_pValue) || (pEnd != attribute.m_pValue + attribute.m_nValueLength))
+        throw std::runtime_error("invalid number in layer: " + std::string(attribute.m_pValue, attribute.m_nValueLength));
+    return dValue;
+}
+
+static Lib3MF::eToolpathSegmentType layerXMLParseSegmentType(const sLayerXMLAttribute & attribute)
+{
+    const char * pValue = attribute.m_pValue;
+    size_t nLength = attribute.m_nValueLength;
+    if (layerXMLEquals(pValue, nLength, "hatch"))
+        return Lib3MF::eToolpathSegmentType::Hatch;
+    if (layerXMLEquals(pValue, nLength, "loop"))
+        return Lib3MF::eToolpathSegmentType::Loop;
+    if (layerXMLEquals(pValue, nLength, "polyline"))
+        return Lib3MF::eToolpathSegmentType::Polyline;
+    if (layerXMLEquals(pValue, nLength, "pointsequence"))
+        return Lib3MF::eToolpathSegmentType::PointSequence;
+    if (layerXMLEquals(pValue, nLength, "arc"))
+        return Lib3MF::eToolpathSegmentType::Arc;
+    if (layerXMLEquals(pValue, nLength, "delay"))
+        return Lib3MF::eToolpathSegmentType::Delay;
+    if (layerXMLEquals(pValue, nLength, "sync"))
+        return Lib3MF::eToolpathSegmentType::Sync;
+    return Lib3MF::eToolpathSegmentType::Unknown;
+}
+
+/*************************************************************************************************************************
+ Class CToolpathLayerXMLParser
+
+ Incremental parser for toolpath layer XML. Data is fed in arbitrary chunks; only an incomplete tag at the end of a
+ chunk is kept for the next one. Namespace declarations are taken from the root element.
+**************************************************************************************************************************/
+class CToolpathLayerXMLParser {
+private:
+    enum class eParserState { Document, Layer, Parts, Profiles, Segments, Segment, Hatch, Finished };
+
+    CToolpathLayerVisitor & m_Visitor;
+    sToolpathVisitorLayer & m_Layer;
+    eParserState m_State;
+    uint32_t m_nSkipDepth;
+    bool m_bLayerBegun;
+    std::string m_sToolpathPrefix;
+    std::string m_sBinaryPrefix;
+    std::string m_sArcPrefix;
+
+    std::vector<char> m_Pending;
+    std::vector<sLayerXMLAttribute> m_Attributes;
+
+    sToolpathVisitorSegment m_Segment;
+    uint32_t m_nSegmentCount;
+    sToolpathVisitorHatch m_Hatch;
+    std::vector<sToolpathVisitorSubInterpolation> m_SubInterpolations;
+
+    bool matchPrefix(const char * pName, size_t nNameLength, const std::string & sPrefix, const char * & pLocalName, size_t & nLocalNameLength)
+    {
+        const char * pColon = (const char *)memchr(pName, ':', nNameLength);
+        if (pColon == nullptr) {
+            pLocalName = pName;
+            nLocalNameLength = nNameLength;
+            return sPrefix.empty();
+        }
+
+        pLocalName = pColon + 1;
+        nLocalNameLength = nNameLength - (pColon - pName) - 1;
+        return ((size_t)(pColon - pName) == sPrefix.size()) && (memcmp(pName, sPrefix.data(), sPrefix.size()) == 0);
+    }
+
+    void parseAttributes(const char * pCurrent, const char * pEnd)
+    {
+        m_Attributes.clear();
+        while (true) {
+            while ((pCurrent < pEnd) && layerXMLIsSpace(*pCurrent))
+                pCurrent++;
+            if (pCurrent >= pEnd)
+                return;
+
+            sLayerXMLAttribute attribute;
+            attribute.m_pName = pCurrent;
+            while ((pCurrent < pEnd) && (*pCurrent != '=') && !layerXMLIsSpace(*pCurrent))
+                pCurrent++;
+            attribute.m_nNameLength = pCurrent - attribute.m_pName;
+
+            while ((pCurrent < pEnd) && layerXMLIsSpace(*pCurrent))
+                pCurrent++;
+            if ((pCurrent >= pEnd) || (*pCurrent != '='))
+                throw std::runtime_error("invalid attribute in layer " + m_Layer.m_sPartPath);
+            pCurrent++;
+            while ((pCurrent < pEnd) && layerXMLIsSpace(*pCurrent))
+                pCurrent++;
+            if ((pCurrent >= pEnd) || ((*pCurrent != '"') && (*pCurrent != '\'')))
+                throw std::runtime_error("invalid attribute in layer " + m_Layer.m_sPartPath);
+
+            char cQuote = *pCurrent++;
+            attribute.m_pValue = pCurrent;
+            while ((pCurrent < pEnd) && (*pCurrent != cQuote))
+                pCurrent++;
+            if (pCurrent >= pEnd)
+                throw std::runtime_error("invalid attribute in layer " + m_Layer.m_sPartPath);
+            attribute.m_nValueLength = pCurrent - attribute.m_pValue;
+            pCurrent++;
+
+            m_Attributes.push_back(attribute);
+        }
+    }
+
+    bool isBinaryAttribute(const sLayerXMLAttribute & attribute)
+    {
+        const char * pLocalName;
+        size_t nLocalNameLength;
+        return !m_sBinaryPrefix.empty() && (memchr(attribute.m_pName, ':', attribute.m_nNameLength) != nullptr)
+            && matchPrefix(attribute.m_pName, attribute.m_nNameLength, m_sBinaryPrefix, pLocalName, nLocalNameLength);
+    }
+
+    void readNamespaces()
+    {
+        for (auto & attribute : m_Attributes) {
+            std::string sPrefix;
+            if (layerXMLEquals(attribute.m_pName, attribute.m_nNameLength, "xmlns"))
+                sPrefix = "";
+            else if ((attribute.m_nNameLength > 6) && (memcmp(attribute.m_pName, "xmlns:", 6) == 0))
+                sPrefix.assign(attribute.m_pName + 6, attribute.m_nNameLength - 6);
+            else
+                continue;
+
+            if (layerXMLEquals(attribute.m_pValue, attribute.m_nValueLength, LAYERVISITOR_TOOLPATH_NAMESPACE))
+                m_sToolpathPrefix = sPrefix;
+            else if (layerXMLEquals(attribute.m_pValue, attribute.m_nValueLength, LAYERVISITOR_BINARY_NAMESPACE))
+                m_sBinaryPrefix = sPrefix;
+            else if (layerXMLEquals(attribute.m_pValue, attribute.m_nValueLength, TOOLPATHARCS_NAMESPACE))
+                m_sArcPrefix = sPrefix;
+        }
+    }
+
+    void readResourceID(std::map<uint32_t, std::string> & uuids)
+    {
+        uint32_t nID = 0;
+        std::string sUUID;
+        for (auto & attribute : m_Attributes) {
+            if (layerXMLEquals(attribute.m_pName, attribute.m_nNameLength, "id"))
+                nID = (uint32_t)layerXMLParseInteger(attribute);
+            else if (layerXMLEquals(attribute.m_pName, attribute.m_nNameLength, "uuid"))
+                sUUID.assign(attribute.m_pValue, attribute.m_nValueLength);
+        }
+        uuids[nID] = sUUID;
+    }
+
+    void readSegment()
+    {
+        m_Segment.m_Type = Lib3MF::eToolpathSegmentType::Unknown;
+        m_Segment.m_nSegmentIndex = m_nSegmentCount++;
+        m_Segment.m_nProfileID = 0;
+        m_Segment.m_nPartID = 0;
+        m_Segment.m_nLaserIndex = 0;
+        m_Segment.m_bArcPath = false;
+
+        for (auto & attribute : m_Attributes) {
+            if (isBinaryAttribute(attribute))
+                throw std::runtime_error("binary layer data is not supported by the streaming reader: " + m_Layer.m_sPartPath);
+
+            const char * pName = attribute.m_pName;
+            size_t nNameLength = attribute.m_nNameLength;
+            if (layerXMLEquals(pName, nNameLength, "type"))
+                m_Segment.m_Type = layerXMLParseSegmentType(attribute);
+            else if (layerXMLEquals(pName, nNameLength, "profileid"))
+                m_Segment.m_nProfileID = (uint32_t)layerXMLParseInteger(attribute);
+            else if (layerXMLEquals(pName, nNameLength, "partid"))
+                m_Segment.m_nPartID = (uint32_t)layerXMLParseInteger(attribute);
+            else if (layerXMLEquals(pName, nNameLength, "laserindex"))
+                m_Segment.m_nLaserIndex = (uint32_t)layerXMLParseInteger(attribute);
+            else if (!m_sArcPrefix.empty() && (memchr(pName, ':', nNameLength) != nullptr)) {
+                const char * pLocalName;
+                size_t nLocalNameLength;
+                if (matchPrefix(pName, nNameLength, m_sArcPrefix, pLocalName, nLocalNameLength) && layerXMLEquals(pLocalName, nLocalNameLength, TOOLPATHARCS_ATTRIBUTE))
+                    m_Segment.m_bArcPath = (layerXMLParseInteger(attribute) != 0);
+            }
+        }
+    }
+
+    void readPoint(sToolpathVisitorPoint & point)
+    {
+        memset(&point, 0, sizeof(point));
+        for (auto & attribute : m_Attributes) {
+            const char * pName = attribute.m_pName;
+            size_t nNameLength = attribute.m_nNameLength;
+            if (nNameLength != 1)
+                continue;
+
+            switch (pName[0]) {
+            case 'x': point.m_nX = (int32_t)layerXMLParseInteger(attribute); break;
+            case 'y': point.m_nY = (int32_t)layerXMLParseInteger(attribute); break;
+            case 'f': point.m_dFactorF = layerXMLParseDouble(attribute); break;
+            case 'g': point.m_dFactorG = layerXMLParseDouble(attribute); break;
+            case 'h': point.m_dFactorH = layerXMLParseDouble(attribute); break;
+            }
+        }
+        point.m_dX = point.m_nX * m_Layer.m_dUnitFactor;
+        point.m_dY = point.m_nY * m_Layer.m_dUnitFactor;
+    }
+
+    void readHatch()
+    {
+        memset(&m_Hatch, 0, sizeof(m_Hatch));
+        for (auto & attribute : m_Attributes) {
+            const char * pName = attribute.m_pName;
+            size_t nNameLength = attribute.m_nNameLength;
+            if (layerXMLEquals(pName, nNameLength, "tag")) {
+                m_Hatch.m_nTag = (uint32_t)layerXMLParseInteger(attribute);
+                continue;
+            }
+            if (nNameLength != 2)
+                continue;
+
+            bool bFirst = (pName[1] == '1');
+            if (!bFirst && (pName[1] != '2'))
+                continue;
+
+            switch (pName[0]) {
+            case 'x': (bFirst ? m_Hatch.m_nX1 : m_Hatch.m_nX2) = (int32_t)layerXMLParseInteger(attribute); break;
+            case 'y': (bFirst ? m_Hatch.m_nY1 : m_Hatch.m_nY2) = (int32_t)layerXMLParseInteger(attribute); break;
+            case 'f': (bFirst ? m_Hatch.m_dFactorF1 : m_Hatch.m_dFactorF2) = layerXMLParseDouble(attribute); break;
+            case 'g': (bFirst ? m_Hatch.m_dFactorG1 : m_Hatch.m_dFactorG2) = layerXMLParseDouble(attribute); break;
+            case 'h': (bFirst ? m_Hatch.m_dFactorH1 : m_Hatch.m_dFactorH2) = layerXMLParseDouble(attribute); break;
+            }
+        }
+        m_Hatch.m_dX1 = m_Hatch.m_nX1 * m_Layer.m_dUnitFactor;
+        m_Hatch.m_dY1 = m_Hatch.m_nY1 * m_Layer.m_dUnitFactor;
+        m_Hatch.m_dX2 = m_Hatch.m_nX2 * m_Layer.m_dUnitFactor;
+        m_Hatch.m_dY2 = m_Hatch.m_nY2 * m_Layer.m_dUnitFactor;
+    }
+
+    void readSubInterpolation()
+    {
+        sToolpathVisitorSubInterpolation subInterpolation;
+        memset(&subInterpolation, 0, sizeof(subInterpolation));
+        for (auto & attribute : m_Attributes) {
+            if (attribute.m_nNameLength != 1)
+                continue;
+
+            switch (attribute.m_pName[0]) {
+            case 't': subInterpolation.m_dParameter = layerXMLParseDouble(attribute); break;
+            case 'f': subInterpolation.m_dFactorF = layerXMLParseDouble(attribute); break;
+            case 'g': subInterpolation.m_dFactorG = layerXMLParseDouble(attribute); break;
+            case 'h': subInterpolation.m_dFactorH = layerXMLParseDouble(attribute); break;
+            }
+        }
+        m_SubInterpolations.push_back(subInterpolation);
+    }
+
+    void beginLayer()
+    {
+        if (!m_bLayerBegun) {
+            m_bLayerBegun = true;
+            m_Visitor.OnLayerBegin(m_Layer);
+        }
+    }
+
+    void startElement(const char * pName, size_t nNameLength, bool bEmptyElement)
+    {
+        if (m_nSkipDepth > 0) {
+            if (!bEmptyElement)
+                m_nSkipDepth++;
+            return;
+        }
+
+        if (m_State == eParserState::Document) {
+            readNamespaces();
+            const char * pLocalName;
+            size_t nLocalNameLength;
+            if (!matchPrefix(pName, nNameLength, m_sToolpathPrefix, pLocalName, nLocalNameLength) || !layerXMLEquals(pLocalName, nLocalNameLength, "layer"))
+                throw std::runtime_error("invalid root element in layer " + m_Layer.m_sPartPath);
+
+            m_State = eParserState::Layer;
+            if (bEmptyElement)
+                endElement();
+            return;
+        }
+
+        const char * pLocalName;
+        size_t nLocalNameLength;
+        if (!matchPrefix(pName, nNameLength, m_sToolpathPrefix, pLocalName, nLocalNameLength)) {
+            if (!m_sBinaryPrefix.empty() && matchPrefix(pName, nNameLength, m_sBinaryPrefix, pLocalName, nLocalNameLength))
+                throw std::runtime_error("binary layer data is not supported by the streaming reader: " + m_Layer.m_sPartPath);
+
+            // Custom data and other extensions
+            m_nSkipDepth = bEmptyElement ? 0 : 1;
+            return;
+        }
+
+        bool bHandled = false;
+        switch (m_State) {
+        case eParserState::Layer:
+            if (layerXMLEquals(pLocalName, nLocalNameLength, "parts")) {
+                m_State = eParserState::Parts;
+                bHandled = true;
+            }
+            else if (layerXMLEquals(pLocalName, nLocalNameLength, "profiles")) {
+                m_State = eParserState::Profiles;
+                bHandled = true;
+            }
+            else if (layerXMLEquals(pLocalName, nLocalNameLength, "segments")) {
+                beginLayer();
+                m_State = eParserState::Segments;
+                bHandled = true;
+            }
+            if (bHandled && bEmptyElement)
+                endElement();
+            break;
+
+        case eParserState::Parts:
+            if (layerXMLEquals(pLocalName, nLocalNameLength, "part"))
+                readResourceID(m_Layer.m_PartUUIDs);
+            break;
+
+        case eParserState::Profiles:
+            if (layerXMLEquals(pLocalName, nLocalNameLength, "profile"))
+                readResourceID(m_Layer.m_ProfileUUIDs);
+            break;
+
+        case eParserState::Segments:
+            if (layerXMLEquals(pLocalName, nLocalNameLength, "segment")) {
+                readSegment();
+                m_Visitor.OnSegmentBegin(m_Segment);
+                if (bEmptyElement)
+                    m_Visitor.OnSegmentEnd(m_Segment);
+                else
+                    m_State = eParserState::Segment;
+                bHandled = true;
+            }
+            break;
+
+        case eParserState::Segment:
+            if (layerXMLEquals(pLocalName, nLocalNameLength, "point")) {
+                sToolpathVisitorPoint point;
+                readPoint(point);
+                m_Visitor.OnPoint(m_Segment, point);
+            }
+            else if (layerXMLEquals(pLocalName, nLocalNameLength, "hatch")) {
+                readHatch();
+                m_SubInterpolations.clear();
+                if (bEmptyElement)
+                    m_Visitor.OnHatch(m_Segment, m_Hatch, nullptr, 0);
+                else
+                    m_State = eParserState::Hatch;
+                bHandled = true;
+            }
+            break;
+
+        case eParserState::Hatch:
+            if (layerXMLEquals(pLocalName, nLocalNameLength, "sub"))
+                readSubInterpolation();
+            break;
+
+        default:
+            throw std::runtime_error("unexpected element in layer " + m_Layer.m_sPartPath);
+        }
+
+        // Children of elements that carry no further layer content are skipped.
+        if (!bHandled && !bEmptyElement)
+            m_nSkipDepth = 1;
+    }
+
+    void endElement()
+    {
+        if (m_nSkipDepth > 0) {
+            m_nSkipDepth--;
+            return;
+        }
+
+        switch (m_State) {
+        case eParserState::Layer:
+            beginLayer();
+            m_Visitor.OnLayerEnd(m_Layer);
+            m_State = eParserState::Finished;
+            break;
+
+        case eParserState::Parts:
+        case eParserState::Profiles:
+        case eParserState::Segments:
+            m_State = eParserState::Layer;
+            break;
+
+        case eParserState::Segment:
+            m_Visitor.OnSegmentEnd(m_Segment);
+            m_State = eParserState::Segments;
+            break;
+
+        case eParserState::Hatch:
+            m_Visitor.OnHatch(m_Segment, m_Hatch, m_SubInterpolations.data(), m_SubInterpolations.size());
+            m_State = eParserState::Segment;
+            break;
+
+        default:
+            throw std::runtime_error("unexpected end of element in layer " + m_Layer.m_sPartPath);
+        }
+    }
+
+    void processTag(const char * pStart, const char * pEnd)
+    {
+        // pStart points behind '<', pEnd at '>'
+        if (*pStart == '/') {
+            // End tags are matched by nesting, their name is not needed
+            endElement();
+            return;
+        }
+
+        bool bEmptyElement = (pEnd > pStart) && (*(pEnd - 1) == '/');
+        if (bEmptyElement)
+            pEnd--;
+
+        const char * pNameEnd = pStart;
+        while ((pNameEnd < pEnd) && !layerXMLIsSpace(*pNameEnd))
+            pNameEnd++;
+        if (pNameEnd == pStart)
+            throw std::runtime_error("invalid element in layer " + m_Layer.m_sPartPath);
+
+        // Attributes are only needed for elements that are not skipped.
+        if (m_nSkipDepth == 0)
+            parseAttributes(pNameEnd, pEnd);
+        startElement(pStart, pNameEnd - pStart, bEmptyElement);
+    }
+
+    // Returns the end of the markup starting at pStart, or nullptr if it is incomplete.
+    const char * findMarkupEnd(const char * pStart, const char * pEnd, size_t & nTerminatorLength)
+    {
+        auto findString = [&](const char * pTerminator) -> const char * {
+            size_t nLength = strlen(pTerminator);
+            for (const char * pCurrent = pStart; pCurrent + nLength <= pEnd; pCurrent++) {
+                if (memcmp(pCurrent, pTerminator, nLength) == 0) {
+                    nTerminatorLength = nLength;
+                    return pCurrent;
+                }
+            }
+            return nullptr;
+        };
+
+        size_t nAvailable = pEnd - pStart;
+        if ((nAvailable >= 4) && (memcmp(pStart, "<!--", 4) == 0))
+            return findString("-->");
+        if ((nAvailable >= 9) && (memcmp(pStart, "<![CDATA[", 9) == 0))
+            return findString("]]>");
+        if ((nAvailable >= 2) && (memcmp(pStart, "<?", 2) == 0))
+            return findString("?>");
+        if (nAvailable < 9)
+            // Not enough data to tell comments and CDATA sections apart from tags
+            return (memchr(pStart, '>', nAvailable) == nullptr) ? nullptr : findTagEnd(pStart, pEnd, nTerminatorLength);
+
+        return findTagEnd(pStart, pEnd, nTerminatorLength);
+    }
+
+    const char * findTagEnd(const char * pStart, const char * pEnd, size_t & nTerminatorLength)
+    {
+        char cQuote = 0;
+        for (const char * pCurrent = pStart + 1; pCurrent < pEnd; pCurrent++) {
+            char cChar = *pCurrent;
+            if (cQuote != 0) {
+                if (cChar == cQuote)
+                    cQuote = 0;
+            }
+            else if ((cChar == '"') || (cChar == '\'')) {
+                cQuote = cChar;
+            }
+            else if (cChar == '>') {
+                nTerminatorLength = 1;
+                return pCurrent;
+            }
+        }
+        return nullptr;
+    }
+
+public:
+
+    CToolpathLayerXMLParser(CToolpathLayerVisitor & visitor, sToolpathVisitorLayer & layer)
+        : m_Visitor(visitor), m_Layer(layer), m_State(eParserState::Document), m_nSkipDepth(0), m_bLayerBegun(false), m_nSegmentCount(0)
+    {
+        memset(&m_Segment, 0, sizeof(m_Segment));
+        memset(&m_Hatch, 0, sizeof(m_Hatch));
+    }
+
+    void Feed(const uint8_t * pData, uint64_t nSize)
+    {
+        m_Pending.insert(m_Pending.end(), (const char *)pData, (const char *)pData + nSize);
+
+        const char * pBuffer = m_Pending.data();
+        const char * pBufferEnd = pBuffer + m_Pending.size();
+        const char * pCurrent = pBuffer;
+
+        while (pCurrent < pBufferEnd) {
+            const char * pTagStart = (const char *)memchr(pCurrent, '<', pBufferEnd - pCurrent);
+            if (pTagStart == nullptr) {
+                // Character data is not part of the layer content
+                pCurrent = pBufferEnd;
+                break;
+            }
+
+            size_t nTerminatorLength = 0;
+            const char * pTagEnd = findMarkupEnd(pTagStart, pBufferEnd, nTerminatorLength);
+            if (pTagEnd == nullptr) {
+                pCurrent = pTagStart;
+                break;
+            }
+
+            char cFirst = pTagStart[1];
+            if ((cFirst != '?') && (cFirst != '!')) {
+                if (m_State == eParserState::Finished)
+                    throw std::runtime_error("content after the end of layer " + m_Layer.m_sPartPath);
+                processTag(pTagStart + 1, pTagEnd);
+            }
+
+            pCurrent = pTagEnd + nTerminatorLength;
+        }
+
+        m_Pending.erase(m_Pending.begin(), m_Pending.begin() + (pCurrent - pBuffer));
+    }
+
+    void Finish()
+    {
+        for (char cChar : m_Pending) {
+            if (!layerXMLIsSpace(cChar))
+                throw std::runtime_error("unexpected end of layer " + m_Layer.m_sPartPath);
+        }
+        if (m_State != eParserState::Finished)
+            throw std::runtime_error("unexpected end of layer " + m_Layer.m_sPartPath);
+    }
+
+};
+
+
+/*************************************************************************************************************************
+ Class CToolpathLayerStreamReader
+**************************************************************************************************************************/
+
+CToolpathLayerStreamReader::CToolpathLayerStreamReader(const std::string & sFileName)
+    : m_PackageReader(sFileName), m_nChunkSize(LAYERVISITOR_DEFAULT_CHUNKSIZE)
+{
+}
+
+void CToolpathLayerStreamReader::SetChunkSize(uint64_t nChunkSize)
+{
+    if (nChunkSize < LAYERVISITOR_MIN_CHUNKSIZE)
+        throw std::invalid_argument("layer chunk size is too small");
+
+    m_nChunkSize = nChunkSize;
+}
+
+void CToolpathLayerStreamReader::VisitLayer(Lib3MF::PToolpath pToolpath, uint32_t nLayerIndex, CToolpathLayerVisitor & visitor)
+{
+    if (pToolpath.get() == nullptr)
+        throw std::invalid_argument("invalid toolpath");
+
+    VisitLayerPart(pToolpath->GetLayerPath(nLayerIndex), pToolpath->GetUnits(), visitor);
+}
+
+void CToolpathLayerStreamReader::VisitLayerPart(const std::string & sPartPath, double dUnitFactor, CToolpathLayerVisitor & visitor)
+{
+    uint32_t nEntryIndex = 0;
+    if (!m_PackageReader.FindEntry(sPartPath, nEntryIndex))
+        throw std::runtime_error("layer part not found: " + sPartPath);
+
+    sToolpathVisitorLayer layer;
+    layer.m_sPartPath = sPartPath;
+    layer.m_dUnitFactor = dUnitFactor;
+
+    CToolpathLayerXMLParser parser(visitor, layer);
+    m_PackageReader.StreamEntryData(nEntryIndex, m_nChunkSize, [&](const uint8_t * pData, uint64_t nSize) {
+        parser.Feed(pData, nSize);
+    });
+    parser.Finish();
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,165 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef __TOOLPATHEXAMPLE_LAYERVISITOR
+#define __TOOLPATHEXAMPLE_LAYERVISITOR
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+#include "ToolpathPackage.hpp"
+
+namespace ToolpathExample {
+
+/* Layer information that is known before the first segment. */
+typedef struct sToolpathVisitorLayer {
+    std::string m_sPartPath;
+    double m_dUnitFactor;
+    std::map<uint32_t, std::string> m_ProfileUUIDs; /** Local profile ID to profile UUID */
+    std::map<uint32_t, std::string> m_PartUUIDs; /** Local part ID to build item UUID */
+} sToolpathVisitorLayer;
+
+typedef struct sToolpathVisitorSegment {
+    Lib3MF::eToolpathSegmentType m_Type;
+    uint32_t m_nSegmentIndex;
+    uint32_t m_nProfileID; /** Local profile ID, 0 for delay and sync segments */
+    uint32_t m_nPartID; /** Local part ID, 0 for delay and sync segments */
+    uint32_t m_nLaserIndex;
+    bool m_bArcPath; /** Loop or polyline holding an arc path, see CToolpathArcPath */
+} sToolpathVisitorSegment;
+
+/* Loop, polyline or point sequence point. Factors that are not given in the layer are 0. */
+typedef struct sToolpathVisitorPoint {
+    int32_t m_nX;
+    int32_t m_nY;
+    double m_dX; /** X in model units */
+    double m_dY; /** Y in model units */
+    double m_dFactorF;
+    double m_dFactorG;
+    double m_dFactorH;
+} sToolpathVisitorPoint;
+
+typedef struct sToolpathVisitorHatch {
+    int32_t m_nX1;
+    int32_t m_nY1;
+    int32_t m_nX2;
+    int32_t m_nY2;
+    double m_dX1; /** Start point X in model units */
+    double m_dY1;
+    double m_dX2;
+    double m_dY2;
+    uint32_t m_nTag;
+    double m_dFactorF1;
+    double m_dFactorF2;
+    double m_dFactorG1;
+    double m_dFactorG2;
+    double m_dFactorH1;
+    double m_dFactorH2;
+} sToolpathVisitorHatch;
+
+typedef struct sToolpathVisitorSubInterpolation {
+    double m_dParameter;
+    double m_dFactorF;
+    double m_dFactorG;
+    double m_dFactorH;
+} sToolpathVisitorSubInterpolation;
+
+/*************************************************************************************************************************
+ Class CToolpathLayerVisitor
+
+ Receives the content of a layer in document order. All arguments are only valid during the call.
+**************************************************************************************************************************/
+class CToolpathLayerVisitor {
+public:
+    virtual ~CToolpathLayerVisitor() {}
+
+    virtual void OnLayerBegin(const sToolpathVisitorLayer &) {}
+    virtual void OnSegmentBegin(const sToolpathVisitorSegment &) {}
+    virtual void OnPoint(const sToolpathVisitorSegment &, const sToolpathVisitorPoint &) {}
+    virtual void OnHatch(const sToolpathVisitorSegment &, const sToolpathVisitorHatch &, const sToolpathVisitorSubInterpolation *, size_t) {}
+    virtual void OnSegmentEnd(const sToolpathVisitorSegment &) {}
+    virtual void OnLayerEnd(const sToolpathVisitorLayer &) {}
+};
+
+/*************************************************************************************************************************
+ Class CToolpathLayerStreamReader
+
+ Streams toolpath layer parts from a package into a visitor while they are inflated and parsed, instead of building
+ a complete layer reader first. Memory is bounded by one inflate chunk and one hatch with its sub interpolation
+ data, and the first segments reach the visitor before the rest of the layer has been read. Only XML layer data is
+ supported; layers that reference binary streams are rejected.
+**************************************************************************************************************************/
+class CToolpathLayerStreamReader {
+private:
+    CToolpathPackageReader m_PackageReader;
+    uint64_t m_nChunkSize;
+
+public:
+
+    /**
+    * CToolpathLayerStreamReader::CToolpathLayerStreamReader - Opens a package for streaming layer reads.
+    * @param[in] sFileName - Package file
+    */
+    explicit CToolpathLayerStreamReader(const std::string & sFileName);
+
+    /**
+    * CToolpathLayerStreamReader::SetChunkSize - Sets the size of the chunks that layer parts are inflated in. Default is 64k.
+    * @param[in] nChunkSize - Chunk size in bytes, at least 4k
+    */
+    void SetChunkSize(uint64_t nChunkSize);
+
+    /**
+    * CToolpathLayerStreamReader::VisitLayer - Streams a layer of a toolpath into a visitor.
+    * @param[in] pToolpath - Toolpath of the package, used for the layer path and unit factor
+    * @param[in] nLayerIndex - Layer index
+    * @param[in] visitor - Visitor
+    */
+    void VisitLayer(Lib3MF::PToolpath pToolpath, uint32_t nLayerIndex, CToolpathLayerVisitor & visitor);
+
+    /**
+    * CToolpathLayerStreamReader::VisitLayerPart - Streams a layer part into a visitor.
+    * @param[in] sPartPath - Layer part path, e.g. "/Toolpath/layer1.xml"
+    * @param[in] dUnitFactor - Size of one toolpath unit in model units
+    * @param[in] visitor - Visitor
+    */
+    void VisitLayerPart(const std::string & sPartPath, double dUnitFactor, CToolpathLayerVisitor & visitor);
+
+};
+
+typedef std::shared_ptr<CToolpathLayerStreamReader> PToolpathLayerStreamReader;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_LAYERVISITOR
@@ -0,0 +1,540 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#include "ToolpathMeshSlicer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+// Number of Z bands per thread, more bands even out differences in the work per band
+#define MESHSLICER_BANDSPERTHREAD 8
+
+// Triangles per task when the planes crossed by every triangle are determined
+#define MESHSLICER_TRIANGLECHUNKSIZE 65536
+
+// Cells of the plane lookup table per plane
+#define MESHSLICER_LOOKUPCELLSPERPLANE 4
+
+#define MESHSLICER_NOSEGMENT 0xffffffffu
+
+// Edge keys join two different vertex indices, so this key never occurs
+#define MESHSLICER_EMPTYKEY 0xffffffffffffffffull
+
+namespace ToolpathExample {
+
+typedef struct sMeshSlicerSegment {
+    Lib3MF::sPosition2D m_Start;
+    Lib3MF::sPosition2D m_End;
+    uint64_t m_nStartEdge;
+    uint64_t m_nEndEdge;
+} sMeshSlicerSegment;
+
+// Storage of one worker, reused for all planes the worker cuts
+typedef struct sMeshSlicerScratch {
+    std::vector<sToolpathMeshSlicerTriangle> m_ActiveTriangles;
+    std::vector<sMeshSlicerSegment> m_Segments;
+    std::vector<uint64_t> m_HashKeys;
+    std::vector<uint32_t> m_HashSegments;
+    std::vector<uint32_t> m_Successors;
+    std::vector<uint8_t> m_Flags;
+} sMeshSlicerScratch;
+
+#define MESHSLICER_FLAG_HASPREDECESSOR 1
+#define MESHSLICER_FLAG_VISITED 2
+
+static uint64_t meshSlicerEdgeKey(uint32_t nVertex1, uint32_t nVertex2)
+{
+    return (nVertex1 < nVertex2) ? (((uint64_t)nVertex1 << 32) | nVertex2) : (((uint64_t)nVertex2 << 32) | nVertex1);
+}
+
+static size_t meshSlicerHash(uint64_t nEdgeKey, uint32_t nShift)
+{
+    return (size_t)((nEdgeKey * 0x9e3779b97f4a7c15ull) >> nShift);
+}
+
+// Intersection of an edge with the plane, always computed from the vertex with the lower index so that both
+// triangles of an edge get the same point
+static Lib3MF::sPosition2D meshSlicerIntersect(const sToolpathMeshSlicerTriangle & triangle, uint32_t nFrom, uint32_t nTo, double dZ)
+{
+    if (triangle.m_nVertexIndices[nTo] < triangle.m_nVertexIndices[nFrom])
+        std::swap(nFrom, nTo);
+    const Lib3MF::sPosition & a = triangle.m_Vertices[nFrom];
+    const Lib3MF::sPosition & b = triangle.m_Vertices[nTo];
+    double dT = (dZ - a.m_Coordinates[2]) / ((double)b.m_Coordinates[2] - a.m_Coordinates[2]);
+
+    Lib3MF::sPosition2D point;
+    point.m_Coordinates[0] = a.m_Coordinates[0] + dT * ((double)b.m_Coordinates[0] - a.m_Coordinates[0]);
+    point.m_Coordinates[1] = a.m_Coordinates[1] + dT * ((double)b.m_Coordinates[1] - a.m_Coordinates[1]);
+    return point;
+}
+
+static void meshSlicerAddPoint(std::vector<Lib3MF::sPosition2D> & vertices, uint32_t nPolygonStart, const Lib3MF::sPosition2D & point)
+{
+    if ((vertices.size() > nPolygonStart) && (vertices.back().m_Coordinates[0] == point.m_Coordinates[0]) && (vertices.back().m_Coordinates[1] == point.m_Coordinates[1]))
+        return;
+    vertices.push_back(point);
+}
+
+CToolpathMeshSlice::CToolpathMeshSlice()
+{
+    m_PolygonStarts.push_back(0);
+}
+
+void CToolpathMeshSlice::Clear()
+{
+    m_Vertices.clear();
+    m_PolygonStarts.clear();
+    m_PolygonStarts.push_back(0);
+    m_PolygonClosed.clear();
+}
+
+// Cuts the triangles crossing a plane and links the segments into polygons
+static void meshSlicerCutPlane(double dZ, sMeshSlicerScratch & scratch, std::vector<Lib3MF::sPosition2D> & sliceVertices,
+    std::vector<uint32_t> & polygonStarts, std::vector<uint8_t> & polygonClosed)
+{
+    std::vector<sMeshSlicerSegment> & segments = scratch.m_Segments;
+    segments.clear();
+
+    // Seen from above, the outside of an outward oriented mesh is on the right of the segment that leaves the
+    // triangle over its downward edge and enters it over its upward edge
+    for (const sToolpathMeshSlicerTriangle & triangle : scratch.m_ActiveTriangles) {
+        sMeshSlicerSegment segment;
+        for (uint32_t nFrom = 0; nFrom < 3; nFrom++) {
+            uint32_t nTo = (nFrom + 1) % 3;
+            bool bFromAbove = triangle.m_Vertices[nFrom].m_Coordinates[2] > dZ;
+            bool bToAbove = triangle.m_Vertices[nTo].m_Coordinates[2] > dZ;
+            if (bFromAbove && !bToAbove) {
+                segment.m_nStartEdge = meshSlicerEdgeKey(triangle.m_nVertexIndices[nFrom], triangle.m_nVertexIndices[nTo]);
+                segment.m_Start = meshSlicerIntersect(triangle, nFrom, nTo, dZ);
+            }
+            else if (!bFromAbove && bToAbove) {
+                segment.m_nEndEdge = meshSlicerEdgeKey(triangle.m_nVertexIndices[nFrom], triangle.m_nVertexIndices[nTo]);
+                segment.m_End = meshSlicerIntersect(triangle, nFrom, nTo, dZ);
+            }
+        }
+        segments.push_back(segment);
+    }
+
+    // Every cut edge is shared by the segments of its two triangles, the one that starts on it is the successor of
+    // the one that ends on it. Segments are found by start edge in an open addressing hash table.
+    size_t nSegmentCount = segments.size();
+    uint32_t nShift = 63;
+    while ((((size_t)1) << (64 - nShift)) < nSegmentCount * 2)
+        nShift--;
+    size_t nHashMask = (((size_t)1) << (64 - nShift)) - 1;
+    scratch.m_HashKeys.assign(nHashMask + 1, MESHSLICER_EMPTYKEY);
+    scratch.m_HashSegments.resize(nHashMask + 1);
+    for (size_t nIndex = 0; nIndex < nSegmentCount; nIndex++) {
+        uint64_t nStartEdge = segments[nIndex].m_nStartEdge;
+        size_t nSlot = meshSlicerHash(nStartEdge, nShift);
+        while (scratch.m_HashKeys[nSlot] != MESHSLICER_EMPTYKEY)
+            nSlot = (nSlot + 1) & nHashMask;
+        scratch.m_HashKeys[nSlot] = nStartEdge;
+        scratch.m_HashSegments[nSlot] = (uint32_t)nIndex;
+    }
+
+    scratch.m_Successors.resize(nSegmentCount);
+    scratch.m_Flags.assign(nSegmentCount, 0);
+    for (size_t nIndex = 0; nIndex < nSegmentCount; nIndex++) {
+        uint64_t nEndEdge = segments[nIndex].m_nEndEdge;
+        uint32_t nSuccessor = MESHSLICER_NOSEGMENT;
+        for (size_t nSlot = meshSlicerHash(nEndEdge, nShift); scratch.m_HashKeys[nSlot] != MESHSLICER_EMPTYKEY; nSlot = (nSlot + 1) & nHashMask) {
+            if ((scratch.m_HashKeys[nSlot] == nEndEdge) && (scratch.m_HashSegments[nSlot] != nIndex)) {
+                nSuccessor = scratch.m_HashSegments[nSlot];
+                break;
+            }
+        }
+        scratch.m_Successors[nIndex] = nSuccessor;
+        if (nSuccessor != MESHSLICER_NOSEGMENT)
+            scratch.m_Flags[nSuccessor] |= MESHSLICER_FLAG_HASPREDECESSOR;
+    }
+
+    // Open chains start at segments without predecessor, all remaining segments form closed loops
+    for (uint32_t nPass = 0; nPass < 2; nPass++) {
+        for (uint32_t nFirst = 0; nFirst < (uint32_t)nSegmentCount; nFirst++) {
+            uint8_t nFlags = scratch.m_Flags[nFirst];
+            if ((nFlags & MESHSLICER_FLAG_VISITED) || ((nPass == 0) && (nFlags & MESHSLICER_FLAG_HASPREDECESSOR)))
+                continue;
+
+            uint32_t nPolygonStart = (uint32_t)sliceVertices.size();
+            uint32_t nSegment = nFirst;
+            uint32_t nLast = nFirst;
+            while ((nSegment != MESHSLICER_NOSEGMENT) && !(scratch.m_Flags[nSegment] & MESHSLICER_FLAG_VISITED)) {
+                scratch.m_Flags[nSegment] |= MESHSLICER_FLAG_VISITED;
+                meshSlicerAddPoint(sliceVertices, nPolygonStart, segments[nSegment].m_Start);
+                nLast = nSegment;
+                nSegment = scratch.m_Successors[nSegment];
+            }
+
+            bool bClosed = (nSegment == nFirst);
+            if (bClosed) {
+                while ((sliceVertices.size() > nPolygonStart + 1) && (sliceVertices.back().m_Coordinates[0] == sliceVertices[nPolygonStart].m_Coordinates[0])
+                    && (sliceVertices.back().m_Coordinates[1] == sliceVertices[nPolygonStart].m_Coordinates[1]))
+                    sliceVertices.pop_back();
+            }
+            else {
+                meshSlicerAddPoint(sliceVertices, nPolygonStart, segments[nLast].m_End);
+            }
+
+            if (sliceVertices.size() - nPolygonStart < (bClosed ? 3u : 2u)) {
+                sliceVertices.resize(nPolygonStart);
+                continue;
+            }
+            polygonStarts.push_back((uint32_t)sliceVertices.size());
+            polygonClosed.push_back(bClosed ? 1 : 0);
+        }
+    }
+}
+
+CToolpathMeshSlicer::CToolpathMeshSlicer()
+    : m_dBottomZ(0.0), m_dPlanePosition(0.5), m_nSortedTriangleCapacity(0)
+{
+}
+
+void CToolpathMeshSlicer::SetThreadPool(PToolpathThreadPool pThreadPool)
+{
+    m_pThreadPool = pThreadPool;
+}
+
+void CToolpathMeshSlicer::SetLayerHeights(double dBottomZ, const std::vector<double> & layerZTops)
+{
+    double dPreviousZ = dBottomZ;
+    for (double dZTop : layerZTops) {
+        if (!(dZTop > dPreviousZ))
+            throw std::invalid_argument("layer heights must be strictly increasing");
+        dPreviousZ = dZTop;
+    }
+    if (layerZTops.size() > (size_t)std::numeric_limits<uint32_t>::max() - 1)
+        throw std::range_error("too many layers");
+
+    m_dBottomZ = dBottomZ;
+    m_LayerZTops = layerZTops;
+    m_Slices.clear();
+}
+
+void CToolpathMeshSlicer::ReadLayerHeights(Lib3MF::PToolpath pToolpath)
+{
+    if (pToolpath.get() == nullptr)
+        throw std::invalid_argument("invalid toolpath");
+
+    double dUnits = pToolpath->GetUnits();
+    uint32_t nLayerCount = pToolpath->GetLayerCount();
+    std::vector<double> layerZTops(nLayerCount);
+    for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++)
+        layerZTops[nLayerIndex] = pToolpath->GetLayerZMax(nLayerIndex) * dUnits;
+
+    SetLayerHeights(pToolpath->GetBottomZ() * dUnits, layerZTops);
+}
+
+void CToolpathMeshSlicer::SetPlanePosition(double dPlanePosition)
+{
+    if ((dPlanePosition < 0.0) || (dPlanePosition > 1.0))
+        throw std::invalid_argument("invalid plane position");
+    m_dPlanePosition = dPlanePosition;
+}
+
+double CToolpathMeshSlicer::GetPlaneZ(size_t nLayerIndex) const
+{
+    double dLayerBottom = (nLayerIndex > 0) ? m_LayerZTops[nLayerIndex - 1] : m_dBottomZ;
+    return dLayerBottom + (m_LayerZTops[nLayerIndex] - dLayerBottom) * m_dPlanePosition;
+}
+
+void CToolpathMeshSlicer::SetMesh(const Lib3MF::sPosition * pVertices, size_t nVertexCount, const Lib3MF::sTriangle * pTriangles, size_t nTriangleCount)
+{
+    if (((pVertices == nullptr) && (nVertexCount > 0)) || ((pTriangles == nullptr) && (nTriangleCount > 0)))
+        throw std::invalid_argument("invalid mesh");
+    if ((nVertexCount > (size_t)std::numeric_limits<uint32_t>::max()) || (nTriangleCount > (size_t)std::numeric_limits<uint32_t>::max()))
+        throw std::range_error("mesh too large");
+
+    m_Vertices.assign(pVertices, pVertices + nVertexCount);
+    m_Triangles.assign(pTriangles, pTriangles + nTriangleCount);
+}
+
+void CToolpathMeshSlicer::ReadMesh(Lib3MF::PMeshObject pMeshObject)
+{
+    if (pMeshObject.get() == nullptr)
+        throw std::invalid_argument("invalid mesh object");
+
+    pMeshObject->GetVertices(m_Vertices);
+    pMeshObject->GetTriangleIndices(m_Triangles);
+}
+
+void CToolpathMeshSlicer::parallelFor(uint64_t nTaskCount, const CToolpathThreadPool::TaskFunction & fnTask)
+{
+    if ((m_pThreadPool.get() != nullptr) && (nTaskCount > 1)) {
+        m_pThreadPool->ParallelFor(nTaskCount, fnTask);
+    }
+    else {
+        for (uint64_t nTaskIndex = 0; nTaskIndex < nTaskCount; nTaskIndex++)
+            fnTask(nTaskIndex, 0);
+    }
+}
+
+void CToolpathMeshSlicer::findTrianglePlanes(const std::vector<double> & planes)
+{
+    size_t nTriangleCount = m_Triangles.size();
+    uint32_t nPlaneCount = (uint32_t)planes.size();
+    m_TriangleFirstPlanes.resize(nTriangleCount);
+    m_TriangleEndPlanes.resize(nTriangleCount);
+
+    // Equally wide cells between the lowest and the highest plane start the search at the first plane at or above
+    // the cell, so finding a plane takes a few steps instead of a binary search over all planes
+    size_t nCellCount = (size_t)nPlaneCount * MESHSLICER_LOOKUPCELLSPERPLANE;
+    double dCellScale = (nPlaneCount > 1) ? nCellCount / (planes.back() - planes.front()) : 0.0;
+    m_PlaneLookup.resize(nCellCount + 1);
+    for (size_t nCell = 0; nCell <= nCellCount; nCell++) {
+        double dCellZ = (nPlaneCount > 1) ? planes.front() + nCell / dCellScale : planes.front();
+        m_PlaneLookup[nCell] = (uint32_t)(std::lower_bound(planes.begin(), planes.end(), dCellZ) - planes.begin());
+    }
+
+    auto fnFirstPlaneAtOrAbove = [&](double dZ) {
+        double dCell = (dZ - planes.front()) * dCellScale;
+        uint32_t nPlane;
+        if (!(dCell > 0.0))
+            nPlane = 0;
+        else if (dCell >= (double)nCellCount)
+            nPlane = m_PlaneLookup[nCellCount];
+        else
+            nPlane = m_PlaneLookup[(size_t)dCell];
+
+        while ((nPlane < nPlaneCount) && (planes[nPlane] < dZ))
+            nPlane++;
+        while ((nPlane > 0) && (planes[nPlane - 1] >= dZ))
+            nPlane--;
+        return nPlane;
+    };
+
+    // A triangle crosses plane z if z_min <= z < z_max, vertices on the plane count as below it
+    uint64_t nChunkCount = (nTriangleCount + MESHSLICER_TRIANGLECHUNKSIZE - 1) / MESHSLICER_TRIANGLECHUNKSIZE;
+    parallelFor(nChunkCount, [&](uint64_t nChunkIndex, uint32_t nWorkerIndex) {
+        (void)nWorkerIndex;
+        size_t nBegin = (size_t)nChunkIndex * MESHSLICER_TRIANGLECHUNKSIZE;
+        size_t nEnd = std::min<size_t>(nBegin + MESHSLICER_TRIANGLECHUNKSIZE, nTriangleCount);
+        for (size_t nTriangleIndex = nBegin; nTriangleIndex < nEnd; nTriangleIndex++) {
+            const Lib3MF::sTriangle & triangle = m_Triangles[nTriangleIndex];
+            if ((triangle.m_Indices[0] >= m_Vertices.size()) || (triangle.m_Indices[1] >= m_Vertices.size()) || (triangle.m_Indices[2] >= m_Vertices.size()))
+                throw std::out_of_range("invalid triangle vertex index");
+
+            float fZ0 = m_Vertices[triangle.m_Indices[0]].m_Coordinates[2];
+            float fZ1 = m_Vertices[triangle.m_Indices[1]].m_Coordinates[2];
+            float fZ2 = m_Vertices[triangle.m_Indices[2]].m_Coordinates[2];
+            m_TriangleFirstPlanes[nTriangleIndex] = fnFirstPlaneAtOrAbove(std::min(fZ0, std::min(fZ1, fZ2)));
+            m_TriangleEndPlanes[nTriangleIndex] = fnFirstPlaneAtOrAbove(std::max(fZ0, std::max(fZ1, fZ2)));
+        }
+    });
+}
+
+void CToolpathMeshSlicer::sortTriangles(const std::vector<double> & planes, uint32_t nBandCount)
+{
+    size_t nTriangleCount = m_Triangles.size();
+    uint32_t nPlaneCount = (uint32_t)planes.size();
+    findTrianglePlanes(planes);
+
+    // Split the planes into bands with about the same number of cut triangles
+    std::vector<int64_t> planeWork(nPlaneCount + 1, 0);
+    for (size_t nTriangleIndex = 0; nTriangleIndex < nTriangleCount; nTriangleIndex++) {
+        if (m_TriangleFirstPlanes[nTriangleIndex] < m_TriangleEndPlanes[nTriangleIndex]) {
+            planeWork[m_TriangleFirstPlanes[nTriangleIndex]]++;
+            planeWork[m_TriangleEndPlanes[nTriangleIndex]]--;
+        }
+    }
+    int64_t nTotalWork = 0;
+    int64_t nCrossingCount = 0;
+    for (uint32_t nPlane = 0; nPlane < nPlaneCount; nPlane++) {
+        nCrossingCount += planeWork[nPlane];
+        planeWork[nPlane] = nCrossingCount;
+        nTotalWork += nCrossingCount;
+    }
+
+    m_BandStarts.clear();
+    m_BandStarts.push_back(0);
+    int64_t nAccumulatedWork = 0;
+    for (uint32_t nPlane = 0; nPlane < nPlaneCount; nPlane++) {
+        if ((nAccumulatedWork * nBandCount >= nTotalWork * (int64_t)m_BandStarts.size()) && (nPlane > m_BandStarts.back()) && (m_BandStarts.size() < nBandCount))
+            m_BandStarts.push_back(nPlane);
+        nAccumulatedWork += planeWork[nPlane];
+    }
+    m_BandStarts.push_back(nPlaneCount);
+
+    m_PlaneBands.resize(nPlaneCount);
+    for (uint32_t nBand = 0; nBand + 1 < (uint32_t)m_BandStarts.size(); nBand++)
+        std::fill(m_PlaneBands.begin() + m_BandStarts[nBand], m_PlaneBands.begin() + m_BandStarts[nBand + 1], nBand);
+
+    // Counting sort of the triangles by the first plane they cross within every band they reach. Every chunk of
+    // triangles counts and fills with its own offsets, so the order matches a sequential sort.
+    uint32_t nSortChunkCount = (m_pThreadPool.get() != nullptr) ? m_pThreadPool->GetThreadCount() : 1;
+    size_t nSortChunkSize = (nTriangleCount + nSortChunkCount - 1) / nSortChunkCount;
+    m_ChunkPlaneOffsets.assign((size_t)nSortChunkCount * nPlaneCount, 0);
+
+    auto fnSortChunk = [&](uint64_t nChunkIndex, bool bFill) {
+        uint32_t * pOffsets = m_ChunkPlaneOffsets.data() + (size_t)nChunkIndex * nPlaneCount;
+        size_t nBegin = (size_t)nChunkIndex * nSortChunkSize;
+        size_t nEnd = std::min(nBegin + nSortChunkSize, nTriangleCount);
+        for (size_t nTriangleIndex = nBegin; nTriangleIndex < nEnd; nTriangleIndex++) {
+            uint32_t nFirst = m_TriangleFirstPlanes[nTriangleIndex];
+            uint32_t nEndPlane = m_TriangleEndPlanes[nTriangleIndex];
+            if (nFirst >= nEndPlane)
+                continue;
+
+            const Lib3MF::sTriangle & triangle = m_Triangles[nTriangleIndex];
+            uint32_t nBand = m_PlaneBands[nFirst];
+            uint32_t nKey = nFirst;
+            for (;;) {
+                if (bFill) {
+                    sToolpathMeshSlicerTriangle & sorted = m_pSortedTriangles[pOffsets[nKey]++];
+                    for (uint32_t nCorner = 0; nCorner < 3; nCorner++) {
+                        sorted.m_Vertices[nCorner] = m_Vertices[triangle.m_Indices[nCorner]];
+                        sorted.m_nVertexIndices[nCorner] = triangle.m_Indices[nCorner];
+                    }
+                    sorted.m_nEndPlane = nEndPlane;
+                }
+                else {
+                    pOffsets[nKey]++;
+                }
+                nBand++;
+                if (m_BandStarts[nBand] >= nEndPlane)
+                    break;
+                nKey = m_BandStarts[nBand];
+            }
+        }
+    };
+
+    parallelFor(nSortChunkCount, [&](uint64_t nChunkIndex, uint32_t nWorkerIndex) {
+        (void)nWorkerIndex;
+        fnSortChunk(nChunkIndex, false);
+    });
+
+    m_PlaneOffsets.resize((size_t)nPlaneCount + 1);
+    uint64_t nEntryCount = 0;
+    for (uint32_t nPlane = 0; nPlane < nPlaneCount; nPlane++) {
+        m_PlaneOffsets[nPlane] = (uint32_t)nEntryCount;
+        for (uint32_t nChunk = 0; nChunk < nSortChunkCount; nChunk++) {
+            uint32_t & nOffset = m_ChunkPlaneOffsets[(size_t)nChunk * nPlaneCount + nPlane];
+            uint32_t nCount = nOffset;
+            nOffset = (uint32_t)nEntryCount;
+            nEntryCount += nCount;
+        }
+        if (nEntryCount > std::numeric_limits<uint32_t>::max())
+            throw std::range_error("too many triangle crossings");
+    }
+    m_PlaneOffsets[nPlaneCount] = (uint32_t)nEntryCount;
+
+    if (nEntryCount > m_nSortedTriangleCapacity) {
+        m_pSortedTriangles.reset();
+        m_pSortedTriangles.reset(new sToolpathMeshSlicerTriangle[(size_t)nEntryCount]);
+        m_nSortedTriangleCapacity = (size_t)nEntryCount;
+    }
+    parallelFor(nSortChunkCount, [&](uint64_t nChunkIndex, uint32_t nWorkerIndex) {
+        (void)nWorkerIndex;
+        fnSortChunk(nChunkIndex, true);
+    });
+}
+
+void CToolpathMeshSlicer::Slice()
+{
+    if (m_LayerZTops.empty())
+        throw std::runtime_error("no layers to slice");
+
+    uint32_t nPlaneCount = (uint32_t)m_LayerZTops.size();
+    std::vector<double> planes(nPlaneCount);
+    for (uint32_t nPlane = 0; nPlane < nPlaneCount; nPlane++)
+        planes[nPlane] = GetPlaneZ(nPlane);
+
+    uint32_t nThreadCount = (m_pThreadPool.get() != nullptr) ? m_pThreadPool->GetThreadCount() : 1;
+    uint32_t nBandCount = (nThreadCount > 1) ? std::min<uint32_t>(nPlaneCount, nThreadCount * MESHSLICER_BANDSPERTHREAD) : 1;
+    sortTriangles(planes, nBandCount);
+
+    m_Slices.resize(nPlaneCount);
+    std::vector<sMeshSlicerScratch> scratches(nThreadCount);
+
+    auto fnSliceBand = [&](uint64_t nBand, uint32_t nWorkerIndex) {
+        sMeshSlicerScratch & scratch = scratches[nWorkerIndex];
+        std::vector<sToolpathMeshSlicerTriangle> & activeTriangles = scratch.m_ActiveTriangles;
+        activeTriangles.clear();
+
+        for (uint32_t nPlane = m_BandStarts[(size_t)nBand]; nPlane < m_BandStarts[(size_t)nBand + 1]; nPlane++) {
+            size_t nKept = 0;
+            for (size_t nIndex = 0; nIndex < activeTriangles.size(); nIndex++) {
+                if (activeTriangles[nIndex].m_nEndPlane > nPlane)
+                    activeTriangles[nKept++] = activeTriangles[nIndex];
+            }
+            activeTriangles.resize(nKept);
+            activeTriangles.insert(activeTriangles.end(), m_pSortedTriangles.get() + m_PlaneOffsets[nPlane], m_pSortedTriangles.get() + m_PlaneOffsets[nPlane + 1]);
+
+            CToolpathMeshSlice & slice = m_Slices[nPlane];
+            slice.Clear();
+            meshSlicerCutPlane(planes[nPlane], scratch, slice.m_Vertices, slice.m_PolygonStarts, slice.m_PolygonClosed);
+        }
+    };
+
+    parallelFor(m_BandStarts.size() - 1, fnSliceBand);
+}
+
+const CToolpathMeshSlice & CToolpathMeshSlicer::GetSlice(size_t nLayerIndex) const
+{
+    if (nLayerIndex >= m_Slices.size())
+        throw std::out_of_range("invalid slice index");
+    return m_Slices[nLayerIndex];
+}
+
+void CToolpathMeshSlicer::WriteSliceStack(Lib3MF::PSliceStack pSliceStack)
+{
+    if (pSliceStack.get() == nullptr)
+        throw std::invalid_argument("invalid slice stack");
+    if (m_Slices.size() != m_LayerZTops.size())
+        throw std::runtime_error("mesh has not been sliced");
+
+    for (size_t nLayerIndex = 0; nLayerIndex < m_Slices.size(); nLayerIndex++) {
+        const CToolpathMeshSlice & slice = m_Slices[nLayerIndex];
+        Lib3MF::PSlice pSlice = pSliceStack->AddSlice(m_LayerZTops[nLayerIndex]);
+        if (slice.GetPolygonCount() == 0)
+            continue;
+
+        pSlice->SetVertices(Lib3MF::CInputVector<Lib3MF::sPosition2D>(slice.m_Vertices.data(), slice.m_Vertices.size()));
+        for (size_t nPolygonIndex = 0; nPolygonIndex < slice.GetPolygonCount(); nPolygonIndex++) {
+            uint32_t nStart = slice.GetPolygonStart(nPolygonIndex);
+            uint32_t nSize = slice.GetPolygonSize(nPolygonIndex);
+            m_PolygonIndices.resize(nSize);
+            for (uint32_t nIndex = 0; nIndex < nSize; nIndex++)
+                m_PolygonIndices[nIndex] = nStart + nIndex;
+            if (slice.IsPolygonClosed(nPolygonIndex))
+                m_PolygonIndices.push_back(nStart);
+            pSlice->AddPolygon(Lib3MF::CInputVector<Lib3MF_uint32>(m_PolygonIndices.data(), m_PolygonIndices.size()));
+        }
+    }
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,224 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#ifndef __TOOLPATHEXAMPLE_MESHSLICER
+#define __TOOLPATHEXAMPLE_MESHSLICER
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+#include "ToolpathThreadPool.hpp"
+
+namespace ToolpathExample {
+
+/*************************************************************************************************************************
+ Class CToolpathMeshSlice
+
+ Cross-section of a mesh at one plane in model units. Vertices of all polygons are stored in one array; closed
+ polygons do not repeat their first vertex. Polygons follow the orientation of the mesh: outlines of an outward
+ oriented mesh run counterclockwise, holes clockwise.
+**************************************************************************************************************************/
+class CToolpathMeshSlice {
+private:
+    std::vector<Lib3MF::sPosition2D> m_Vertices;
+    std::vector<uint32_t> m_PolygonStarts;
+    std::vector<uint8_t> m_PolygonClosed;
+
+    friend class CToolpathMeshSlicer;
+
+public:
+
+    /**
+    * CToolpathMeshSlice::CToolpathMeshSlice - Creates an empty cross-section.
+    */
+    CToolpathMeshSlice();
+
+    /**
+    * CToolpathMeshSlice::Clear - Removes all polygons and keeps the storage.
+    */
+    void Clear();
+
+    size_t GetPolygonCount() const { return m_PolygonStarts.size() - 1; }
+    const std::vector<Lib3MF::sPosition2D> & GetVertices() const { return m_Vertices; }
+    uint32_t GetPolygonStart(size_t nPolygonIndex) const { return m_PolygonStarts[nPolygonIndex]; }
+    uint32_t GetPolygonSize(size_t nPolygonIndex) const { return m_PolygonStarts[nPolygonIndex + 1] - m_PolygonStarts[nPolygonIndex]; }
+
+    /**
+    * CToolpathMeshSlice::IsPolygonClosed - Returns whether a polygon is closed. Open polylines occur where the mesh
+    *   has holes or non-manifold edges.
+    * @param[in] nPolygonIndex - Polygon index
+    * @return true, if the polygon is closed
+    */
+    bool IsPolygonClosed(size_t nPolygonIndex) const { return m_PolygonClosed[nPolygonIndex] != 0; }
+
+};
+
+/**
+* Triangle as stored in the plane order of CToolpathMeshSlicer. Copies of the vertices keep the sweep over a band
+*   on contiguous memory instead of gathering them from the whole mesh for every plane.
+*/
+typedef struct sToolpathMeshSlicerTriangle {
+    Lib3MF::sPosition m_Vertices[3];
+    uint32_t m_nVertexIndices[3];
+    uint32_t m_nEndPlane;
+} sToolpathMeshSlicerTriangle;
+
+/*************************************************************************************************************************
+ Class CToolpathMeshSlicer
+
+ Computes planar cross-sections of a triangle mesh at the layer heights of a toolpath and stores them in a slice
+ stack. Every layer is cut at a plane between its bottom and its top (in the middle by default); the slice is
+ stored with the top of the layer as Z.
+
+ Triangles are sorted by the first plane they cross and the layers are split into Z bands of equal work. Every band
+ sweeps its planes upwards with a list of the triangles that cross the current plane, so each triangle is sorted
+ once and visited once per plane it crosses. Bands are sliced in parallel on the thread pool. Cut segments are
+ linked into polygons by the mesh edges they end on, which needs no tolerances.
+
+ Coordinates are mesh coordinates; build item transforms are not applied.
+**************************************************************************************************************************/
+class CToolpathMeshSlicer {
+private:
+    PToolpathThreadPool m_pThreadPool;
+    double m_dBottomZ;
+    double m_dPlanePosition;
+    std::vector<double> m_LayerZTops;
+
+    std::vector<Lib3MF::sPosition> m_Vertices;
+    std::vector<Lib3MF::sTriangle> m_Triangles;
+
+    // Planes crossed by every triangle as [first, end) and triangles sorted by first plane per band
+    std::vector<uint32_t> m_PlaneLookup;
+    std::vector<uint32_t> m_TriangleFirstPlanes;
+    std::vector<uint32_t> m_TriangleEndPlanes;
+    std::vector<uint32_t> m_BandStarts;
+    std::vector<uint32_t> m_PlaneBands;
+    std::vector<uint32_t> m_ChunkPlaneOffsets;
+    std::vector<uint32_t> m_PlaneOffsets;
+    // Filled in parallel, so it is not value-initialized like a vector
+    std::unique_ptr<sToolpathMeshSlicerTriangle[]> m_pSortedTriangles;
+    size_t m_nSortedTriangleCapacity;
+
+    std::vector<CToolpathMeshSlice> m_Slices;
+    std::vector<Lib3MF_uint32> m_PolygonIndices;
+
+    void parallelFor(uint64_t nTaskCount, const CToolpathThreadPool::TaskFunction & fnTask);
+    void findTrianglePlanes(const std::vector<double> & planes);
+    void sortTriangles(const std::vector<double> & planes, uint32_t nBandCount);
+
+public:
+
+    /**
+    * CToolpathMeshSlicer::CToolpathMeshSlicer - Creates a slicer without layers and mesh.
+    */
+    CToolpathMeshSlicer();
+
+    /**
+    * CToolpathMeshSlicer::SetThreadPool - Sets the thread pool bands are sliced on.
+    * @param[in] pThreadPool - Thread pool, nullptr slices on the calling thread
+    */
+    void SetThreadPool(PToolpathThreadPool pThreadPool);
+
+    /**
+    * CToolpathMeshSlicer::SetLayerHeights - Sets the layers to slice.
+    * @param[in] dBottomZ - Bottom of the first layer in model units
+    * @param[in] layerZTops - Top of every layer in model units, strictly increasing and above dBottomZ
+    */
+    void SetLayerHeights(double dBottomZ, const std::vector<double> & layerZTops);
+
+    /**
+    * CToolpathMeshSlicer::ReadLayerHeights - Sets the layers to those of a toolpath, from GetBottomZ and GetLayerZMax.
+    * @param[in] pToolpath - Toolpath with at least one layer
+    */
+    void ReadLayerHeights(Lib3MF::PToolpath pToolpath);
+
+    /**
+    * CToolpathMeshSlicer::SetPlanePosition - Sets where layers are cut.
+    * @param[in] dPlanePosition - Position between bottom (0) and top (1) of a layer, 0.5 by default
+    */
+    void SetPlanePosition(double dPlanePosition);
+
+    size_t GetLayerCount() const { return m_LayerZTops.size(); }
+    double GetLayerZTop(size_t nLayerIndex) const { return m_LayerZTops[nLayerIndex]; }
+
+    /**
+    * CToolpathMeshSlicer::GetPlaneZ - Returns the height at which a layer is cut.
+    * @param[in] nLayerIndex - Layer index
+    * @return Height in model units
+    */
+    double GetPlaneZ(size_t nLayerIndex) const;
+
+    /**
+    * CToolpathMeshSlicer::SetMesh - Copies the geometry to slice.
+    * @param[in] pVertices - Vertices
+    * @param[in] nVertexCount - Number of vertices
+    * @param[in] pTriangles - Triangles, counterclockwise seen from outside
+    * @param[in] nTriangleCount - Number of triangles
+    */
+    void SetMesh(const Lib3MF::sPosition * pVertices, size_t nVertexCount, const Lib3MF::sTriangle * pTriangles, size_t nTriangleCount);
+
+    /**
+    * CToolpathMeshSlicer::ReadMesh - Reads the geometry to slice from a mesh object.
+    * @param[in] pMeshObject - Mesh object
+    */
+    void ReadMesh(Lib3MF::PMeshObject pMeshObject);
+
+    /**
+    * CToolpathMeshSlicer::Slice - Computes the cross-sections of the mesh at all layers.
+    */
+    void Slice();
+
+    /**
+    * CToolpathMeshSlicer::GetSlice - Returns a cross-section computed by Slice.
+    * @param[in] nLayerIndex - Layer index
+    * @return Cross-section, valid until the next call of Slice
+    */
+    const CToolpathMeshSlice & GetSlice(size_t nLayerIndex) const;
+
+    /**
+    * CToolpathMeshSlicer::WriteSliceStack - Adds a slice for every layer to a slice stack, with the cross-section
+    *   computed by Slice and the top of the layer as Z.
+    * @param[in] pSliceStack - Slice stack whose bottom is at or below the bottom of the first layer
+    */
+    void WriteSliceStack(Lib3MF::PSliceStack pSliceStack);
+
+};
+
+typedef std::shared_ptr<CToolpathMeshSlicer> PToolpathMeshSlicer;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_MESHSLICER
@@ -0,0 +1,135 @@
+'''++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract: Compares the list based toolpath getters of the Python binding with
+ the NumPy variants and, if the ToolpathLayerArrays library is given, with
+ exporting whole layers.
+
+Usage: ToolpathNumPyBenchmark.py <lib3mf library without extension> <toolpath 3mf> [ToolpathLayerArrays library without extension]
+
+'''
+
+import os
+import sys
+import time
+
+import numpy
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'include', 'Python'))
+import Lib3MF
+
+
+def readToolpath(wrapper, fileName):
+	model = wrapper.CreateModel()
+	reader = model.QueryReader('3mf')
+	reader.ReadFromFile(fileName)
+
+	toolpathIterator = model.GetToolpaths()
+	if not toolpathIterator.MoveNext():
+		raise Exception('file contains no toolpath')
+	return toolpathIterator.GetCurrentToolpath()
+
+
+def hatchLengthFromLists(layerData):
+	dLength = 0.0
+	nHatchCount = 0
+	for nSegmentIndex in range(layerData.GetSegmentCount()):
+		segmentType, nPointCount = layerData.GetSegmentInfo(nSegmentIndex)
+		if segmentType != Lib3MF.ToolpathSegmentType.Hatch:
+			continue
+		for hatch in layerData.GetSegmentHatchDataInModelUnits(nSegmentIndex):
+			dX = hatch.Point2Coordinates[0] - hatch.Point1Coordinates[0]
+			dY = hatch.Point2Coordinates[1] - hatch.Point1Coordinates[1]
+			dLength += (dX * dX + dY * dY) ** 0.5
+			nHatchCount += 1
+	return nHatchCount, dLength
+
+
+def hatchLengthFromArrays(layerData):
+	dLength = 0.0
+	nHatchCount = 0
+	for nSegmentIndex in range(layerData.GetSegmentCount()):
+		segmentType, nPointCount = layerData.GetSegmentInfo(nSegmentIndex)
+		if segmentType != Lib3MF.ToolpathSegmentType.Hatch:
+			continue
+		hatches = layerData.GetSegmentHatchDataInModelUnitsAsArray(nSegmentIndex)
+		delta = hatches['Point2Coordinates'] - hatches['Point1Coordinates']
+		dLength += float(numpy.hypot(delta[:, 0], delta[:, 1]).sum())
+		nHatchCount += len(hatches)
+	return nHatchCount, dLength
+
+
+def hatchLengthFromLayerArrays(layerData, layerArrays, dUnits):
+	arrays = layerData.ToArrays(layerArrays)
+	isHatch = arrays['SegmentTypes'] == Lib3MF.ToolpathSegmentType.Hatch.value
+	offsets = arrays['SegmentOffsets']
+	if not isHatch.any():
+		return 0, 0.0
+
+	# Hatch segments are the point ranges between the offsets of hatch segments and their successors
+	pointsPerSegment = numpy.diff(offsets)
+	isHatchPoint = numpy.repeat(isHatch, pointsPerSegment.astype(numpy.int64))
+	coordinates = arrays['Coordinates'][isHatchPoint].astype(numpy.float64).reshape(-1, 2, 2)
+	delta = coordinates[:, 1, :] - coordinates[:, 0, :]
+	return len(coordinates), float(numpy.hypot(delta[:, 0], delta[:, 1]).sum()) * dUnits
+
+
+def runBenchmark(toolpath, name, function):
+	nHatchCount = 0
+	dLength = 0.0
+	dStart = time.perf_counter()
+	for nLayerIndex in range(toolpath.GetLayerCount()):
+		layerData = toolpath.ReadLayerData(nLayerIndex)
+		nLayerHatchCount, dLayerLength = function(layerData)
+		nHatchCount += nLayerHatchCount
+		dLength += dLayerLength
+	dSeconds = time.perf_counter() - dStart
+
+	print('{:<8} {:>10} hatches  {:>10.3f} s  {:>12.0f} hatches/s  length {:.3f}'.format(
+		name, nHatchCount, dSeconds, nHatchCount / dSeconds if dSeconds > 0 else 0.0, dLength))
+
+
+def main():
+	if len(sys.argv) not in (3, 4):
+		print('Usage: ToolpathNumPyBenchmark.py <lib3mf library without extension> <toolpath 3mf> [ToolpathLayerArrays library without extension]')
+		return 1
+
+	wrapper = Lib3MF.Wrapper(sys.argv[1])
+	toolpath = readToolpath(wrapper, sys.argv[2])
+
+	runBenchmark(toolpath, 'list', hatchLengthFromLists)
+	runBenchmark(toolpath, 'numpy', hatchLengthFromArrays)
+	if len(sys.argv) == 4:
+		layerArrays = Lib3MF.ToolpathLayerArrays(wrapper, sys.argv[3])
+		dUnits = toolpath.GetUnits()
+		runBenchmark(toolpath, 'layer', lambda layerData: hatchLengthFromLayerArrays(layerData, layerArrays, dUnits))
+	return 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())
@@ -0,0 +1,1338 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathPackage.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef TOOLPATHEXAMPLE_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace ToolpathExample {
+
+#define PACKAGE_LOCALHEADER_SIGNATURE 0x04034b50
+#define PACKAGE_CENTRALHEADER_SIGNATURE 0x02014b50
+#define PACKAGE_ENDOFCENTRALDIR_SIGNATURE 0x06054b50
+#define PACKAGE_ZIP64ENDOFCENTRALDIR_SIGNATURE 0x06064b50
+#define PACKAGE_ZIP64LOCATOR_SIGNATURE 0x07064b50
+#define PACKAGE_ZIP64EXTRAFIELD_ID 0x0001
+#define PACKAGE_LOCALHEADER_SIZE 30
+#define PACKAGE_CENTRALHEADER_SIZE 46
+#define PACKAGE_ENDOFCENTRALDIR_SIZE 22
+#define PACKAGE_ZIP64ENDOFCENTRALDIR_SIZE 56
+#define PACKAGE_ZIP64LOCATOR_SIZE 20
+#define PACKAGE_MAXCOMMENT_SIZE 65535
+#define PACKAGE_VERSION_DEFAULT 20
+#define PACKAGE_VERSION_ZIP64 45
+#define PACKAGE_FLAG_DATADESCRIPTOR 0x0008
+#define PACKAGE_FLAG_ENCRYPTED 0x0001
+#define PACKAGE_COPY_CHUNKSIZE (1024 * 1024)
+#define PACKAGE_DEFAULT_CHUNKSIZE (1024 * 1024)
+#define PACKAGE_MIN_CHUNKSIZE 65536
+#define PACKAGE_RECOMPRESS_BATCHSIZE (256 * 1024 * 1024)
+#define PACKAGE_TEMPORARY_SUFFIX ".tmp"
+
+/* DOS date of 1980-01-01 00:00, used for new entries to keep output deterministic. */
+#define PACKAGE_DEFAULT_DOSDATE 0x0021
+#define PACKAGE_DEFAULT_DOSTIME 0x0000
+
+static inline uint16_t readUInt16(const uint8_t * pData)
+{
+    return (uint16_t)(pData[0] | (pData[1] << 8));
+}
+
+static inline uint32_t readUInt32(const uint8_t * pData)
+{
+    return (uint32_t)pData[0] | ((uint32_t)pData[1] << 8) | ((uint32_t)pData[2] << 16) | ((uint32_t)pData[3] << 24);
+}
+
+static inline uint64_t readUInt64(const uint8_t * pData)
+{
+    return (uint64_t)readUInt32(pData) | ((uint64_t)readUInt32(pData + 4) << 32);
+}
+
+static inline void appendUInt16(std::vector<uint8_t> & buffer, uint16_t nValue)
+{
+    buffer.push_back((uint8_t)(nValue & 0xff));
+    buffer.push_back((uint8_t)(nValue >> 8));
+}
+
+static inline void appendUInt32(std::vector<uint8_t> & buffer, uint32_t nValue)
+{
+    appendUInt16(buffer, (uint16_t)(nValue & 0xffff));
+    appendUInt16(buffer, (uint16_t)(nValue >> 16));
+}
+
+static inline void appendUInt64(std::vector<uint8_t> & buffer, uint64_t nValue)
+{
+    appendUInt32(buffer, (uint32_t)(nValue & 0xffffffff));
+    appendUInt32(buffer, (uint32_t)(nValue >> 32));
+}
+
+static inline uint32_t clampUInt32(uint64_t nValue)
+{
+    return (nValue >= 0xffffffffULL) ? 0xffffffff : (uint32_t)nValue;
+}
+
+std::string packagePartPathToEntryName(const std::string & sPartPath)
+{
+    size_t nStart = 0;
+    while ((nStart < sPartPath.length()) && (sPartPath[nStart] == '/'))
+        nStart++;
+
+    return sPartPath.substr(nStart);
+}
+
+uint32_t packageCalculateCRC32(uint32_t nCRC32, const uint8_t * pData, uint64_t nSize)
+{
+#ifdef TOOLPATHEXAMPLE_USE_ZLIB
+    while (nSize > 0) {
+        uInt nChunkSize = (uInt)std::min<uint64_t>(nSize, 0x40000000);
+        nCRC32 = (uint32_t)crc32(nCRC32, pData, nChunkSize);
+        pData += nChunkSize;
+        nSize -= nChunkSize;
+    }
+    return nCRC32;
+#else
+    static const std::vector<uint32_t> s_Table = [] {
+        std::vector<uint32_t> table(256);
+        for (uint32_t nIndex = 0; nIndex < 256; nIndex++) {
+            uint32_t nValue = nIndex;
+            for (uint32_t nBit = 0; nBit < 8; nBit++)
+                nValue = (nValue & 1) ? (0xedb88320 ^ (nValue >> 1)) : (nValue >> 1);
+            table[nIndex] = nValue;
+        }
+        return table;
+    }();
+
+    nCRC32 = ~nCRC32;
+    for (uint64_t nIndex = 0; nIndex < nSize; nIndex++)
+        nCRC32 = s_Table[(nCRC32 ^ pData[nIndex]) & 0xff] ^ (nCRC32 >> 8);
+    return ~nCRC32;
+#endif
+}
+
+bool packageIsCompressionAvailable(ePackageCompressionMethod method)
+{
+    switch (method) {
+    case ePackageCompressionMethod::Store:
+        return true;
+    case ePackageCompressionMethod::Deflate:
+#ifdef TOOLPATHEXAMPLE_USE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    default:
+        return false;
+    }
+}
+
+/*************************************************************************************************************************
+ Class CToolpathPackageReader
+**************************************************************************************************************************/
+
+CToolpathPackageReader::CToolpathPackageReader(const std::string & sFileName)
+    : m_sFileName(sFileName), m_nFileSize(0)
+{
+    m_Stream.open(sFileName, std::ios::binary);
+    if (!m_Stream.is_open())
+        throw std::runtime_error("could not open package " + sFileName);
+
+    m_Stream.seekg(0, std::ios::end);
+    m_nFileSize = (uint64_t)m_Stream.tellg();
+
+    readCentralDirectory();
+}
+
+void CToolpathPackageReader::Close()
+{
+    m_Stream.close();
+}
+
+void CToolpathPackageReader::readBytes(uint64_t nOffset, uint8_t * pBuffer, uint64_t nSize)
+{
+    if (!m_Stream.is_open())
+        throw std::logic_error("package " + m_sFileName + " is closed");
+    if ((nOffset > m_nFileSize) || (nSize > m_nFileSize - nOffset))
+        throw std::runtime_error("read beyond end of package " + m_sFileName);
+
+    m_Stream.clear();
+    m_Stream.seekg((std::streamoff)nOffset, std::ios::beg);
+    m_Stream.read((char *)pBuffer, (std::streamsize)nSize);
+    if (!m_Stream)
+        throw std::runtime_error("could not read from package " + m_sFileName);
+}
+
+void CToolpathPackageReader::readCentralDirectory()
+{
+    if (m_nFileSize < PACKAGE_ENDOFCENTRALDIR_SIZE)
+        throw std::runtime_error("invalid package " + m_sFileName);
+
+    // The end of central directory record is followed by a comment of at most 64k.
+    uint64_t nSearchSize = std::min<uint64_t>(m_nFileSize, PACKAGE_ENDOFCENTRALDIR_SIZE + PACKAGE_MAXCOMMENT_SIZE);
+    std::vector<uint8_t> tail((size_t)nSearchSize);
+    readBytes(m_nFileSize - nSearchSize, tail.data(), nSearchSize);
+
+    int64_t nRecordPosition = -1;
+    for (int64_t nPosition = (int64_t)nSearchSize - PACKAGE_ENDOFCENTRALDIR_SIZE; nPosition >= 0; nPosition--) {
+        if (readUInt32(&tail[(size_t)nPosition]) == PACKAGE_ENDOFCENTRALDIR_SIGNATURE) {
+            nRecordPosition = nPosition;
+            break;
+        }
+    }
+    if (nRecordPosition < 0)
+        throw std::runtime_error("no central directory found in package " + m_sFileName);
+
+    const uint8_t * pRecord = &tail[(size_t)nRecordPosition];
+    uint64_t nEntryCount = readUInt16(pRecord + 10);
+    uint64_t nDirectorySize = readUInt32(pRecord + 12);
+    uint64_t nDirectoryOffset = readUInt32(pRecord + 16);
+    uint64_t nRecordOffset = m_nFileSize - nSearchSize + (uint64_t)nRecordPosition;
+
+    // ZIP64 packages store the real values in a separate record referenced by a locator.
+    if (nRecordOffset >= PACKAGE_ZIP64LOCATOR_SIZE) {
+        uint8_t locator[PACKAGE_ZIP64LOCATOR_SIZE];
+        readBytes(nRecordOffset - PACKAGE_ZIP64LOCATOR_SIZE, locator, PACKAGE_ZIP64LOCATOR_SIZE);
+        if (readUInt32(locator) == PACKAGE_ZIP64LOCATOR_SIGNATURE) {
+            uint8_t zip64Record[PACKAGE_ZIP64ENDOFCENTRALDIR_SIZE];
+            readBytes(readUInt64(locator + 8), zip64Record, PACKAGE_ZIP64ENDOFCENTRALDIR_SIZE);
+            if (readUInt32(zip64Record) != PACKAGE_ZIP64ENDOFCENTRALDIR_SIGNATURE)
+                throw std::runtime_error("invalid zip64 record in package " + m_sFileName);
+
+            nEntryCount = readUInt64(zip64Record + 32);
+            nDirectorySize = readUInt64(zip64Record + 40);
+            nDirectoryOffset = readUInt64(zip64Record + 48);
+        }
+    }
+
+    std::vector<uint8_t> directory((size_t)nDirectorySize);
+    readBytes(nDirectoryOffset, directory.data(), nDirectorySize);
+
+    size_t nPosition = 0;
+    for (uint64_t nEntryIndex = 0; nEntryIndex < nEntryCount; nEntryIndex++) {
+        if ((nPosition + PACKAGE_CENTRALHEADER_SIZE > directory.size()) || (readUInt32(&directory[nPosition]) != PACKAGE_CENTRALHEADER_SIGNATURE))
+            throw std::runtime_error("invalid central directory in package " + m_sFileName);
+
+        const uint8_t * pHeader = &directory[nPosition];
+        uint16_t nNameLength = readUInt16(pHeader + 28);
+        uint16_t nExtraLength = readUInt16(pHeader + 30);
+        uint16_t nCommentLength = readUInt16(pHeader + 32);
+        if (nPosition + PACKAGE_CENTRALHEADER_SIZE + nNameLength + nExtraLength + nCommentLength > directory.size())
+            throw std::runtime_error("invalid central directory in package " + m_sFileName);
+
+        sPackageEntry entry;
+        entry.m_nFlags = readUInt16(pHeader + 8);
+        entry.m_nCompressionMethod = readUInt16(pHeader + 10);
+        entry.m_nModificationTime = readUInt16(pHeader + 12);
+        entry.m_nModificationDate = readUInt16(pHeader + 14);
+        entry.m_nCRC32 = readUInt32(pHeader + 16);
+        entry.m_nCompressedSize = readUInt32(pHeader + 20);
+        entry.m_nUncompressedSize = readUInt32(pHeader + 24);
+        entry.m_nLocalHeaderOffset = readUInt32(pHeader + 42);
+        entry.m_sName.assign((const char *)pHeader + PACKAGE_CENTRALHEADER_SIZE, nNameLength);
+
+        // The zip64 extra field only contains the values that overflowed, in fixed order.
+        const uint8_t * pExtra = pHeader + PACKAGE_CENTRALHEADER_SIZE + nNameLength;
+        const uint8_t * pExtraEnd = pExtra + nExtraLength;
+        while (pExtra + 4 <= pExtraEnd) {
+            uint16_t nFieldID = readUInt16(pExtra);
+            uint16_t nFieldSize = readUInt16(pExtra + 2);
+            const uint8_t * pField = pExtra + 4;
+            const uint8_t * pFieldEnd = std::min(pField + nFieldSize, pExtraEnd);
+
+            if (nFieldID == PACKAGE_ZIP64EXTRAFIELD_ID) {
+                if ((readUInt32(pHeader + 24) == 0xffffffff) && (pField + 8 <= pFieldEnd)) {
+                    entry.m_nUncompressedSize = readUInt64(pField);
+                    pField += 8;
+                }
+                if ((readUInt32(pHeader + 20) == 0xffffffff) && (pField + 8 <= pFieldEnd)) {
+                    entry.m_nCompressedSize = readUInt64(pField);
+                    pField += 8;
+                }
+                if ((readUInt32(pHeader + 42) == 0xffffffff) && (pField + 8 <= pFieldEnd)) {
+                    entry.m_nLocalHeaderOffset = readUInt64(pField);
+                    pField += 8;
+                }
+            }
+
+            pExtra += 4 + nFieldSize;
+        }
+
+        m_EntryIndices.insert(std::make_pair(entry.m_sName, (uint32_t)m_Entries.size()));
+        m_Entries.push_back(entry);
+
+        nPosition += PACKAGE_CENTRALHEADER_SIZE + nNameLength + nExtraLength + nCommentLength;
+    }
+}
+
+uint32_t CToolpathPackageReader::GetEntryCount() const
+{
+    return (uint32_t)m_Entries.size();
+}
+
+const sPackageEntry & CToolpathPackageReader::GetEntry(uint32_t nIndex) const
+{
+    if (nIndex >= m_Entries.size())
+        throw std::out_of_range("invalid package entry index");
+
+    return m_Entries[nIndex];
+}
+
+bool CToolpathPackageReader::FindEntry(const std::string & sPartPath, uint32_t & nIndex) const
+{
+    auto iEntry = m_EntryIndices.find(packagePartPathToEntryName(sPartPath));
+    if (iEntry == m_EntryIndices.end())
+        return false;
+
+    nIndex = iEntry->second;
+    return true;
+}
+
+uint64_t CToolpathPackageReader::GetEntryDataOffset(uint32_t nIndex)
+{
+    const sPackageEntry & entry = GetEntry(nIndex);
+
+    // Name and extra field lengths of the local header may differ from the central directory.
+    uint8_t header[PACKAGE_LOCALHEADER_SIZE];
+    readBytes(entry.m_nLocalHeaderOffset, header, PACKAGE_LOCALHEADER_SIZE);
+    if (readUInt32(header) != PACKAGE_LOCALHEADER_SIGNATURE)
+        throw std::runtime_error("invalid local header for " + entry.m_sName);
+
+    return entry.m_nLocalHeaderOffset + PACKAGE_LOCALHEADER_SIZE + readUInt16(header + 26) + readUInt16(header + 28);
+}
+
+void CToolpathPackageReader::ReadRawEntryData(uint32_t nIndex, uint64_t nOffset, uint8_t * pBuffer, uint64_t nSize)
+{
+    const sPackageEntry & entry = GetEntry(nIndex);
+    if ((nOffset > entry.m_nCompressedSize) || (nSize > entry.m_nCompressedSize - nOffset))
+        throw std::out_of_range("read beyond end of " + entry.m_sName);
+
+    readBytes(GetEntryDataOffset(nIndex) + nOffset, pBuffer, nSize);
+}
+
+void CToolpathPackageReader::ReadEntryData(uint32_t nIndex, std::vector<uint8_t> & buffer)
+{
+    const sPackageEntry & entry = GetEntry(nIndex);
+
+    std::vector<uint8_t> compressedData((size_t)entry.m_nCompressedSize);
+    ReadRawEntryData(nIndex, 0, compressedData.data(), entry.m_nCompressedSize);
+
+    if (entry.m_nCompressionMethod == (uint16_t)ePackageCompressionMethod::Store) {
+        if (entry.m_nFlags & PACKAGE_FLAG_ENCRYPTED)
+            throw std::runtime_error("encrypted entries are not supported: " + entry.m_sName);
+        if (packageCalculateCRC32(0, compressedData.data(), compressedData.size()) != entry.m_nCRC32)
+            throw std::runtime_error("checksum mismatch in " + entry.m_sName);
+
+        buffer.swap(compressedData);
+        return;
+    }
+
+    DecompressEntryData(entry, compressedData, buffer, m_pStatistics.get(), m_pTracer.get());
+}
+
+void CToolpathPackageReader::SetStatistics(PToolpathStatistics pStatistics)
+{
+    m_pStatistics = pStatistics;
+}
+
+void CToolpathPackageReader::SetTracer(PToolpathTracer pTracer)
+{
+    m_pTracer = pTracer;
+}
+
+void CToolpathPackageReader::StreamEntryData(uint32_t nIndex, uint64_t nChunkSize, const std::function<void(const uint8_t * pData, uint64_t nSize)> & fnChunk)
+{
+    const sPackageEntry & entry = GetEntry(nIndex);
+    if (entry.m_nFlags & PACKAGE_FLAG_ENCRYPTED)
+        throw std::runtime_error("encrypted entries are not supported: " + entry.m_sName);
+    if (nChunkSize == 0)
+        throw std::invalid_argument("invalid chunk size");
+
+    CToolpathTraceSpan span(m_pTracer.get(), "StreamEntry", "package", "bytes", entry.m_nUncompressedSize);
+
+    nChunkSize = std::min<uint64_t>(nChunkSize, 0x40000000);
+    std::vector<uint8_t> input((size_t)std::min<uint64_t>(std::max<uint64_t>(entry.m_nCompressedSize, 1), nChunkSize));
+    uint64_t nInputOffset = 0;
+    uint32_t nCRC32 = 0;
+    uint64_t nOutputSize = 0;
+
+    switch ((ePackageCompressionMethod)entry.m_nCompressionMethod) {
+    case ePackageCompressionMethod::Store:
+        while (nInputOffset < entry.m_nCompressedSize) {
+            uint64_t nSize = std::min<uint64_t>(entry.m_nCompressedSize - nInputOffset, input.size());
+            ReadRawEntryData(nIndex, nInputOffset, input.data(), nSize);
+            nInputOffset += nSize;
+
+            nCRC32 = packageCalculateCRC32(nCRC32, input.data(), nSize);
+            nOutputSize += nSize;
+            fnChunk(input.data(), nSize);
+        }
+        break;
+
+#ifdef TOOLPATHEXAMPLE_USE_ZLIB
+    case ePackageCompressionMethod::Deflate: {
+        CToolpathScopedTimer timer(m_pStatistics.get(), eToolpathTimer::Inflate);
+        std::vector<uint8_t> output((size_t)nChunkSize);
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+            throw std::runtime_error("could not initialize inflate");
+
+        int nResult = Z_OK;
+        try {
+            while (nResult != Z_STREAM_END) {
+                if ((stream.avail_in == 0) && (nInputOffset < entry.m_nCompressedSize)) {
+                    uint64_t nSize = std::min<uint64_t>(entry.m_nCompressedSize - nInputOffset, input.size());
+                    ReadRawEntryData(nIndex, nInputOffset, input.data(), nSize);
+                    nInputOffset += nSize;
+                    stream.next_in = input.data();
+                    stream.avail_in = (uInt)nSize;
+                }
+
+                stream.next_out = output.data();
+                stream.avail_out = (uInt)output.size();
+                nResult = inflate(&stream, Z_NO_FLUSH);
+                if ((nResult != Z_OK) && (nResult != Z_STREAM_END))
+                    throw std::runtime_error("could not inflate " + entry.m_sName);
+
+                uint64_t nSize = output.size() - stream.avail_out;
+                if (nSize > 0) {
+                    nCRC32 = packageCalculateCRC32(nCRC32, output.data(), nSize);
+                    nOutputSize += nSize;
+                    fnChunk(output.data(), nSize);
+                }
+                else if ((nResult == Z_OK) && (stream.avail_in == 0) && (nInputOffset >= entry.m_nCompressedSize)) {
+                    throw std::runtime_error("unexpected end of " + entry.m_sName);
+                }
+            }
+        }
+        catch (...) {
+            inflateEnd(&stream);
+            throw;
+        }
+        inflateEnd(&stream);
+
+        if (m_pStatistics.get() != nullptr) {
+            m_pStatistics->AddCount(eToolpathCounter::BytesInflatedIn, entry.m_nCompressedSize);
+            m_pStatistics->AddCount(eToolpathCounter::BytesInflatedOut, nOutputSize);
+        }
+        break;
+    }
+#endif
+
+    default:
+        throw std::runtime_error("unsupported compression method for " + entry.m_sName);
+    }
+
+    if ((nOutputSize != entry.m_nUncompressedSize) || (nCRC32 != entry.m_nCRC32))
+        throw std::runtime_error("checksum mismatch in " + entry.m_sName);
+}
+
+void CToolpathPackageReader::DecompressEntryData(const sPackageEntry & entry, const std::vector<uint8_t> & compressedData, std::vector<uint8_t> & buffer, CToolpathStatistics * pStatistics, CToolpathTracer * pTracer)
+{
+    CToolpathTraceSpan span(pTracer, "Inflate", "package", "bytes", entry.m_nUncompressedSize);
+
+    // Stored entries are only verified, they are not recorded as inflated.
+    if (entry.m_nCompressionMethod != (uint16_t)ePackageCompressionMethod::Deflate)
+        pStatistics = nullptr;
+
+    CToolpathScopedTimer timer(pStatistics, eToolpathTimer::Inflate);
+    if (pStatistics != nullptr) {
+        pStatistics->AddCount(eToolpathCounter::BytesInflatedIn, entry.m_nCompressedSize);
+        pStatistics->AddCount(eToolpathCounter::BytesInflatedOut, entry.m_nUncompressedSize);
+    }
+
+    if (entry.m_nFlags & PACKAGE_FLAG_ENCRYPTED)
+        throw std::runtime_error("encrypted entries are not supported: " + entry.m_sName);
+
+    switch ((ePackageCompressionMethod)entry.m_nCompressionMethod) {
+    case ePackageCompressionMethod::Store:
+        buffer = compressedData;
+        break;
+
+#ifdef TOOLPATHEXAMPLE_USE_ZLIB
+    case ePackageCompressionMethod::Deflate: {
+        buffer.resize((size_t)entry.m_nUncompressedSize);
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+            throw std::runtime_error("could not initialize inflate");
+
+        uint64_t nInputOffset = 0;
+        uint64_t nOutputOffset = 0;
+        int nResult = Z_OK;
+        while (nResult == Z_OK) {
+            // zlib counts in 32 bit, so feed large entries in chunks.
+            uInt nInputChunk = (uInt)std::min<uint64_t>(compressedData.size() - nInputOffset, 0x40000000);
+            uInt nOutputChunk = (uInt)std::min<uint64_t>(buffer.size() - nOutputOffset, 0x40000000);
+            stream.next_in = (Bytef *)compressedData.data() + nInputOffset;
+            stream.avail_in = nInputChunk;
+            stream.next_out = buffer.data() + nOutputOffset;
+            stream.avail_out = nOutputChunk;
+
+            nResult = inflate(&stream, Z_NO_FLUSH);
+            nInputOffset += nInputChunk - stream.avail_in;
+            nOutputOffset += nOutputChunk - stream.avail_out;
+
+            if ((nResult == Z_BUF_ERROR) && (nOutputOffset == buffer.size()))
+                break;
+        }
+        inflateEnd(&stream);
+
+        if (((nResult != Z_STREAM_END) && (nResult != Z_BUF_ERROR)) || (nOutputOffset != entry.m_nUncompressedSize))
+            throw std::runtime_error("could not inflate " + entry.m_sName);
+        break;
+    }
+#endif
+
+    default:
+        throw std::runtime_error("unsupported compression method for " + entry.m_sName);
+    }
+
+    if (packageCalculateCRC32(0, buffer.data(), buffer.size()) != entry.m_nCRC32)
+        throw std::runtime_error("checksum mismatch in " + entry.m_sName);
+}
+
+static bool stringEndsWith(const std::string & sValue, const std::string & sSuffix)
+{
+    return (sValue.length() >= sSuffix.length()) && (sValue.compare(sValue.length() - sSuffix.length(), sSuffix.length(), sSuffix) == 0);
+}
+
+static std::string findXMLAttribute(const std::string & sElement, const std::string & sAttributeName)
+{
+    size_t nPosition = 0;
+    while ((nPosition = sElement.find(sAttributeName, nPosition)) != std::string::npos) {
+        size_t nEquals = nPosition + sAttributeName.length();
+        bool bIsAttribute = (nPosition > 0) && isspace((unsigned char)sElement[nPosition - 1]) && (nEquals < sElement.length()) && (sElement[nEquals] == '=');
+        if (bIsAttribute && (nEquals + 1 < sElement.length())) {
+            char cQuote = sElement[nEquals + 1];
+            size_t nEnd = sElement.find(cQuote, nEquals + 2);
+            if (((cQuote == '"') || (cQuote == '\'')) && (nEnd != std::string::npos))
+                return sElement.substr(nEquals + 2, nEnd - nEquals - 2);
+        }
+        nPosition = nEquals;
+    }
+
+    return "";
+}
+
+void CToolpathPackageReader::classifyEntries()
+{
+    m_ContentTypes.assign(m_Entries.size(), ePackageContentType::Attachment);
+
+    // Relationship parts and their source directories, e.g. "3D/_rels/3dmodel.model.rels" belongs to "3D/3dmodel.model".
+    std::vector<uint32_t> relationshipEntries;
+    for (uint32_t nIndex = 0; nIndex < m_Entries.size(); nIndex++) {
+        const std::string & sName = m_Entries[nIndex].m_sName;
+        if ((sName == "[Content_Types].xml") || stringEndsWith(sName, ".rels")) {
+            m_ContentTypes[nIndex] = ePackageContentType::PackageMetadata;
+            if (stringEndsWith(sName, ".rels"))
+                relationshipEntries.push_back(nIndex);
+        }
+        else if (stringEndsWith(sName, ".model")) {
+            m_ContentTypes[nIndex] = ePackageContentType::RootModel;
+        }
+    }
+
+    // Binary streams are referenced by the layers, so relationships are evaluated until nothing changes.
+    bool bChanged = true;
+    for (uint32_t nPass = 0; bChanged && (nPass < 3); nPass++) {
+        bChanged = false;
+
+        for (uint32_t nRelationshipIndex : relationshipEntries) {
+            std::string sRelationshipName = m_Entries[nRelationshipIndex].m_sName;
+            size_t nRelsFolder = sRelationshipName.rfind("_rels/");
+            if (nRelsFolder == std::string::npos)
+                continue;
+            std::string sBaseFolder = sRelationshipName.substr(0, nRelsFolder);
+            std::string sSourceName = sBaseFolder + sRelationshipName.substr(nRelsFolder + 6, sRelationshipName.length() - nRelsFolder - 11);
+
+            uint32_t nSourceIndex = 0;
+            bool bSourceIsLayer = FindEntry(sSourceName, nSourceIndex) && (m_ContentTypes[nSourceIndex] == ePackageContentType::ToolpathLayer);
+
+            std::vector<uint8_t> buffer;
+            try {
+                ReadEntryData(nRelationshipIndex, buffer);
+            }
+            catch (std::exception &) {
+                // Without zlib, classification falls back to file extensions.
+                continue;
+            }
+            std::string sRelationships(buffer.begin(), buffer.end());
+
+            size_t nPosition = 0;
+            while ((nPosition = sRelationships.find("<Relationship ", nPosition)) != std::string::npos) {
+                size_t nEnd = sRelationships.find('>', nPosition);
+                if (nEnd == std::string::npos)
+                    break;
+                std::string sElement = sRelationships.substr(nPosition, nEnd - nPosition);
+                nPosition = nEnd;
+
+                std::string sType = findXMLAttribute(sElement, "Type");
+                std::string sTarget = findXMLAttribute(sElement, "Target");
+                if (sTarget.empty())
+                    continue;
+                if (sTarget[0] != '/')
+                    sTarget = sBaseFolder + sTarget;
+
+                uint32_t nTargetIndex = 0;
+                if (!FindEntry(sTarget, nTargetIndex))
+                    continue;
+
+                ePackageContentType contentType = m_ContentTypes[nTargetIndex];
+                if (stringEndsWith(sType, "/3dmodel"))
+                    contentType = ePackageContentType::RootModel;
+                else if (stringEndsWith(sType, "/toolpath") || bSourceIsLayer)
+                    contentType = ePackageContentType::ToolpathLayer;
+
+                if (contentType != m_ContentTypes[nTargetIndex]) {
+                    m_ContentTypes[nTargetIndex] = contentType;
+                    bChanged = true;
+                }
+            }
+        }
+    }
+}
+
+ePackageContentType CToolpathPackageReader::GetEntryContentType(uint32_t nIndex)
+{
+    if (nIndex >= m_Entries.size())
+        throw std::out_of_range("invalid package entry index");
+
+    if (m_ContentTypes.size() != m_Entries.size())
+        classifyEntries();
+
+    return m_ContentTypes[nIndex];
+}
+
+/*************************************************************************************************************************
+ Class CToolpathPackageCompressionPolicy
+**************************************************************************************************************************/
+
+CToolpathPackageCompressionPolicy::CToolpathPackageCompressionPolicy(ePackageCompressionMethod method, int32_t nLevel)
+{
+    for (uint32_t nIndex = 0; nIndex < PACKAGE_CONTENTTYPE_COUNT; nIndex++)
+        SetSettings((ePackageContentType)nIndex, method, nLevel);
+}
+
+CToolpathPackageCompressionPolicy CToolpathPackageCompressionPolicy::CreateFast()
+{
+    CToolpathPackageCompressionPolicy policy(ePackageCompressionMethod::Deflate, -1);
+    policy.SetSettings(ePackageContentType::ToolpathLayer, ePackageCompressionMethod::Deflate, 1);
+    policy.SetSettings(ePackageContentType::Attachment, ePackageCompressionMethod::Deflate, 1);
+    return policy;
+}
+
+CToolpathPackageCompressionPolicy CToolpathPackageCompressionPolicy::CreateArchive()
+{
+    return CToolpathPackageCompressionPolicy(ePackageCompressionMethod::Deflate, 9);
+}
+
+void CToolpathPackageCompressionPolicy::SetSettings(ePackageContentType contentType, ePackageCompressionMethod method, int32_t nLevel)
+{
+    if ((uint32_t)contentType >= PACKAGE_CONTENTTYPE_COUNT)
+        throw std::invalid_argument("invalid package content type");
+    if ((nLevel < -1) || (nLevel > 9))
+        throw std::invalid_argument("invalid compression level");
+
+    m_Settings[(uint32_t)contentType].m_Method = method;
+    m_Settings[(uint32_t)contentType].m_nLevel = nLevel;
+}
+
+const sPackageCompressionSettings & CToolpathPackageCompressionPolicy::GetSettings(ePackageContentType contentType) const
+{
+    if ((uint32_t)contentType >= PACKAGE_CONTENTTYPE_COUNT)
+        throw std::invalid_argument("invalid package content type");
+
+    return m_Settings[(uint32_t)contentType];
+}
+
+/*************************************************************************************************************************
+ Class CToolpathPackageWriter
+**************************************************************************************************************************/
+
+CToolpathPackageWriter::CToolpathPackageWriter(const std::string & sFileName)
+    : m_nOffset(0), m_bFinished(false), m_nChunkSize(PACKAGE_DEFAULT_CHUNKSIZE), m_nExpectedEntryCount(0)
+{
+    m_Stream.open(sFileName, std::ios::binary | std::ios::trunc);
+    if (!m_Stream.is_open())
+        throw std::runtime_error("could not create package " + sFileName);
+}
+
+void CToolpathPackageWriter::writeBytes(const uint8_t * pData, uint64_t nSize)
+{
+    m_Stream.write((const char *)pData, (std::streamsize)nSize);
+    if (!m_Stream)
+        throw std::runtime_error("could not write to package");
+
+    m_nOffset += nSize;
+}
+
+void CToolpathPackageWriter::reportEntry(const sPackageEntry & entry)
+{
+    if (m_pProgress.get() == nullptr)
+        return;
+
+    sToolpathProgressEvent event;
+    event.m_Stage = eToolpathProgressStage::WritePackageEntry;
+    event.m_nIndex = (uint32_t)(m_Entries.size() - 1);
+    event.m_nCount = m_nExpectedEntryCount;
+    event.m_nBytes = entry.m_nCompressedSize;
+    event.m_nSegmentCount = 0;
+    event.m_dProgress = (m_nExpectedEntryCount > 0) ? (double)m_Entries.size() / (double)m_nExpectedEntryCount : 0.0;
+    event.m_Lib3MFIdentifier = Lib3MF::eProgressIdentifier::QUERYCANCELED;
+    m_pProgress->ReportEvent(event);
+}
+
+void CToolpathPackageWriter::writeLocalHeader(sPackageEntry & entry)
+{
+    if (m_bFinished)
+        throw std::runtime_error("package has already been finished");
+    if (m_pProgress.get() != nullptr)
+        m_pProgress->CheckCancelled();
+
+    entry.m_nLocalHeaderOffset = m_nOffset;
+    entry.m_nFlags &= ~PACKAGE_FLAG_DATADESCRIPTOR;
+
+    bool bZip64 = (entry.m_nCompressedSize >= 0xffffffffULL) || (entry.m_nUncompressedSize >= 0xffffffffULL);
+
+    std::vector<uint8_t> header;
+    appendUInt32(header, PACKAGE_LOCALHEADER_SIGNATURE);
+    appendUInt16(header, bZip64 ? PACKAGE_VERSION_ZIP64 : PACKAGE_VERSION_DEFAULT);
+    appendUInt16(header, entry.m_nFlags);
+    appendUInt16(header, entry.m_nCompressionMethod);
+    appendUInt16(header, entry.m_nModificationTime);
+    appendUInt16(header, entry.m_nModificationDate);
+    appendUInt32(header, entry.m_nCRC32);
+    appendUInt32(header, bZip64 ? 0xffffffff : (uint32_t)entry.m_nCompressedSize);
+    appendUInt32(header, bZip64 ? 0xffffffff : (uint32_t)entry.m_nUncompressedSize);
+    appendUInt16(header, (uint16_t)entry.m_sName.length());
+    appendUInt16(header, bZip64 ? 20 : 0);
+    header.insert(header.end(), entry.m_sName.begin(), entry.m_sName.end());
+    if (bZip64) {
+        appendUInt16(header, PACKAGE_ZIP64EXTRAFIELD_ID);
+        appendUInt16(header, 16);
+        appendUInt64(header, entry.m_nUncompressedSize);
+        appendUInt64(header, entry.m_nCompressedSize);
+    }
+
+    writeBytes(header.data(), header.size());
+}
+
+#ifdef TOOLPATHEXAMPLE_USE_ZLIB
+// Deflates one chunk of a part. Chunks other than the last one end with a sync flush, so that the
+// raw outputs of consecutive chunks can simply be concatenated. The dictionary is the input that
+// precedes the chunk and keeps the compression ratio close to a single stream.
+static void deflateChunk(const uint8_t * pData, uint64_t nSize, const uint8_t * pDictionary, uint32_t nDictionarySize, bool bLastChunk, int32_t nCompressionLevel, std::vector<uint8_t> & output)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, (nCompressionLevel < 0) ? Z_DEFAULT_COMPRESSION : nCompressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw std::runtime_error("could not initialize deflate");
+
+    if ((nDictionarySize > 0) && (deflateSetDictionary(&stream, pDictionary, nDictionarySize) != Z_OK)) {
+        deflateEnd(&stream);
+        throw std::runtime_error("could not set deflate dictionary");
+    }
+
+    // Reserve the bound for the first 32 bit chunk, larger parts grow on demand.
+    output.resize((size_t)deflateBound(&stream, (uLong)std::min<uint64_t>(nSize, 0x40000000)) + 64);
+
+    uint64_t nInputOffset = 0;
+    uint64_t nOutputOffset = 0;
+    while (true) {
+        if (output.size() - nOutputOffset < 65536)
+            output.resize(output.size() * 2);
+
+        uInt nInputChunk = (uInt)std::min<uint64_t>(nSize - nInputOffset, 0x40000000);
+        uInt nOutputChunk = (uInt)std::min<uint64_t>(output.size() - nOutputOffset, 0x40000000);
+        stream.next_in = (Bytef *)(pData + nInputOffset);
+        stream.avail_in = nInputChunk;
+        stream.next_out = output.data() + nOutputOffset;
+        stream.avail_out = nOutputChunk;
+
+        bool bLastInput = (nInputOffset + nInputChunk == nSize);
+        int nFlush = bLastInput ? (bLastChunk ? Z_FINISH : Z_SYNC_FLUSH) : Z_NO_FLUSH;
+        int nResult = deflate(&stream, nFlush);
+        if ((nResult != Z_OK) && (nResult != Z_STREAM_END) && (nResult != Z_BUF_ERROR)) {
+            deflateEnd(&stream);
+            throw std::runtime_error("could not deflate package entry");
+        }
+
+        nInputOffset += nInputChunk - stream.avail_in;
+        nOutputOffset += nOutputChunk - stream.avail_out;
+
+        if (nResult == Z_STREAM_END)
+            break;
+        // A flush is complete once it did not fill the whole output buffer.
+        if ((nFlush == Z_SYNC_FLUSH) && (stream.avail_out > 0))
+            break;
+    }
+    deflateEnd(&stream);
+
+    output.resize((size_t)nOutputOffset);
+}
+#endif
+
+static void initializeCompressedEntry(const std::string & sPartPath, ePackageCompressionMethod method, uint64_t nSize, sPackageEntry & entry)
+{
+    if (!packageIsCompressionAvailable(method))
+        throw std::runtime_error("compression method is not available in this build");
+
+    entry.m_sName = packagePartPathToEntryName(sPartPath);
+    entry.m_nFlags = 0;
+    entry.m_nCompressionMethod = (uint16_t)method;
+    entry.m_nModificationTime = PACKAGE_DEFAULT_DOSTIME;
+    entry.m_nModificationDate = PACKAGE_DEFAULT_DOSDATE;
+    entry.m_nCRC32 = 0;
+    entry.m_nCompressedSize = 0;
+    entry.m_nUncompressedSize = nSize;
+    entry.m_nLocalHeaderOffset = 0;
+}
+
+void CToolpathPackageWriter::CompressEntry(const std::string & sPartPath, const uint8_t * pData, uint64_t nSize, ePackageCompressionMethod method, int32_t nCompressionLevel, sPackageCompressedEntry & compressedEntry, CToolpathStatistics * pStatistics, CToolpathTracer * pTracer)
+{
+    CToolpathTraceSpan span(pTracer, "Deflate", "package", "bytes", nSize);
+
+    sPackageEntry & entry = compressedEntry.m_Entry;
+    initializeCompressedEntry(sPartPath, method, nSize, entry);
+    entry.m_nCRC32 = packageCalculateCRC32(0, pData, nSize);
+
+    if (method == ePackageCompressionMethod::Store) {
+        compressedEntry.m_Data.assign(pData, pData + nSize);
+        entry.m_nCompressedSize = nSize;
+        return;
+    }
+
+#ifdef TOOLPATHEXAMPLE_USE_ZLIB
+    CToolpathScopedTimer timer(pStatistics, eToolpathTimer::Deflate);
+    deflateChunk(pData, nSize, nullptr, 0, true, nCompressionLevel, compressedEntry.m_Data);
+    entry.m_nCompressedSize = compressedEntry.m_Data.size();
+
+    if (pStatistics != nullptr) {
+        pStatistics->AddCount(eToolpathCounter::BytesDeflatedIn, nSize);
+        pStatistics->AddCount(eToolpathCounter::BytesDeflatedOut, entry.m_nCompressedSize);
+    }
+#else
+    (void)nCompressionLevel;
+    (void)pStatistics;
+#endif
+}
+
+void CToolpathPackageWriter::CompressEntries(const std::vector<sPackagePartData> & parts, CToolpathThreadPool * pThreadPool, uint64_t nChunkSize, std::vector<sPackageCompressedEntry> & compressedEntries, CToolpathStatistics * pStatistics, CToolpathTracer * pTracer)
+{
+    if (nChunkSize == 0)
+        throw std::invalid_argument("invalid compression chunk size");
+
+    compressedEntries.resize(parts.size());
+    if ((pThreadPool == nullptr) || (pThreadPool->GetThreadCount() == 1)) {
+        for (size_t nPartIndex = 0; nPartIndex < parts.size(); nPartIndex++) {
+            auto & part = parts[nPartIndex];
+            CompressEntry(part.m_sPartPath, part.m_pData, part.m_nSize, part.m_CompressionMethod, part.m_nCompressionLevel, compressedEntries[nPartIndex], pStatistics, pTracer);
+        }
+        return;
+    }
+
+    // Large deflated parts are split into independent chunks, everything else is one task per part.
+    struct sChunkTask {
+        size_t m_nPartIndex;
+        uint64_t m_nOffset;
+        uint64_t m_nSize;
+        bool m_bLastChunk;
+        uint32_t m_nCRC32;
+        std::vector<uint8_t> m_Output;
+    };
+
+    std::vector<sChunkTask> tasks;
+    for (size_t nPartIndex = 0; nPartIndex < parts.size(); nPartIndex++) {
+        auto & part = parts[nPartIndex];
+        initializeCompressedEntry(part.m_sPartPath, part.m_CompressionMethod, part.m_nSize, compressedEntries[nPartIndex].m_Entry);
+
+        uint64_t nPartChunkSize = (part.m_CompressionMethod == ePackageCompressionMethod::Deflate) ? nChunkSize : std::max<uint64_t>(part.m_nSize, 1);
+        uint64_t nOffset = 0;
+        do {
+            sChunkTask task;
+            task.m_nPartIndex = nPartIndex;
+            task.m_nOffset = nOffset;
+            task.m_nSize = std::min<uint64_t>(part.m_nSize - nOffset, nPartChunkSize);
+            task.m_bLastChunk = (nOffset + task.m_nSize == part.m_nSize);
+            task.m_nCRC32 = 0;
+            tasks.push_back(task);
+            nOffset += task.m_nSize;
+        } while (nOffset < part.m_nSize);
+    }
+
+    pThreadPool->ParallelFor(tasks.size(), [&](uint64_t nTaskIndex, uint32_t) {
+        auto & task = tasks[nTaskIndex];
+        auto & part = parts[task.m_nPartIndex];
+        const uint8_t * pChunk = part.m_pData + task.m_nOffset;
+        CToolpathTraceSpan span(pTracer, "DeflateChunk", "package", "bytes", task.m_nSize);
+
+        task.m_nCRC32 = packageCalculateCRC32(0, pChunk, task.m_nSize);
+
+        if (part.m_CompressionMethod == ePackageCompressionMethod::Store) {
+            task.m_Output.assign(pChunk, pChunk + task.m_nSize);
+            return;
+        }
+
+#ifdef TOOLPATHEXAMPLE_USE_ZLIB
+        CToolpathScopedTimer timer(pStatistics, eToolpathTimer::Deflate);
+        uint32_t nDictionarySize = (uint32_t)std::min<uint64_t>(task.m_nOffset, 32768);
+        deflateChunk(pChunk, task.m_nSize, pChunk - nDictionarySize, nDictionarySize, task.m_bLastChunk, part.m_nCompressionLevel, task.m_Output);
+
+        if (pStatistics != nullptr) {
+            pStatistics->AddCount(eToolpathCounter::BytesDeflatedIn, task.m_nSize);
+            pStatistics->AddCount(eToolpathCounter::BytesDeflatedOut, task.m_Output.size());
+        }
+#endif
+    });
+
+    // Concatenate chunk outputs and combine their checksums
+    for (auto & task : tasks) {
+        auto & compressedEntry = compressedEntries[task.m_nPartIndex];
+        auto & entry = compressedEntry.m_Entry;
+
+        if (task.m_nOffset == 0) {
+            entry.m_nCRC32 = task.m_nCRC32;
+            compressedEntry.m_Data.swap(task.m_Output);
+        }
+        else {
+#ifdef TOOLPATHEXAMPLE_USE_ZLIB
+            entry.m_nCRC32 = (uint32_t)crc32_combine(entry.m_nCRC32, task.m_nCRC32, (z_off_t)task.m_nSize);
+#endif
+            compressedEntry.m_Data.insert(compressedEntry.m_Data.end(), task.m_Output.begin(), task.m_Output.end());
+            std::vector<uint8_t>().swap(task.m_Output);
+        }
+
+        entry.m_nCompressedSize = compressedEntry.m_Data.size();
+    }
+}
+
+void CToolpathPackageWriter::WriteCompressedEntry(const sPackageCompressedEntry & compressedEntry)
+{
+    CToolpathTraceSpan span(m_pTracer.get(), "WriteEntry", "package", "bytes", compressedEntry.m_Data.size());
+
+    sPackageEntry entry = compressedEntry.m_Entry;
+    writeLocalHeader(entry);
+    writeBytes(compressedEntry.m_Data.data(), compressedEntry.m_Data.size());
+
+    m_Entries.push_back(entry);
+    reportEntry(entry);
+}
+
+void CToolpathPackageWriter::AddEntry(const std::string & sPartPath, const uint8_t * pData, uint64_t nSize, ePackageCompressionMethod method, int32_t nCompressionLevel)
+{
+    sPackageCompressedEntry compressedEntry;
+    CompressEntry(sPartPath, pData, nSize, method, nCompressionLevel, compressedEntry, m_pStatistics.get(), m_pTracer.get());
+    WriteCompressedEntry(compressedEntry);
+}
+
+void CToolpathPackageWriter::SetThreadPool(PToolpathThreadPool pThreadPool)
+{
+    m_pThreadPool = pThreadPool;
+}
+
+void CToolpathPackageWriter::SetThreadCount(uint32_t nThreadCount)
+{
+    m_pThreadPool = std::make_shared<CToolpathThreadPool>(nThreadCount);
+}
+
+void CToolpathPackageWriter::SetChunkSize(uint64_t nChunkSize)
+{
+    if (nChunkSize < PACKAGE_MIN_CHUNKSIZE)
+        throw std::invalid_argument("compression chunk size is too small");
+
+    m_nChunkSize = nChunkSize;
+}
+
+void CToolpathPackageWriter::SetProgress(PToolpathProgress pProgress, uint32_t nExpectedEntryCount)
+{
+    m_pProgress = pProgress;
+    m_nExpectedEntryCount = nExpectedEntryCount;
+}
+
+void CToolpathPackageWriter::SetStatistics(PToolpathStatistics pStatistics)
+{
+    m_pStatistics = pStatistics;
+}
+
+void CToolpathPackageWriter::SetTracer(PToolpathTracer pTracer)
+{
+    m_pTracer = pTracer;
+}
+
+void CToolpathPackageWriter::AddEntries(const std::vector<sPackagePartData> & parts)
+{
+    std::vector<sPackageCompressedEntry> compressedEntries;
+    CompressEntries(parts, m_pThreadPool.get(), m_nChunkSize, compressedEntries, m_pStatistics.get(), m_pTracer.get());
+
+    for (auto & compressedEntry : compressedEntries)
+        WriteCompressedEntry(compressedEntry);
+}
+
+void CToolpathPackageWriter::CopyEntry(CToolpathPackageReader & reader, uint32_t nIndex)
+{
+    sPackageEntry entry = reader.GetEntry(nIndex);
+    CToolpathTraceSpan span(m_pTracer.get(), "CopyEntry", "package", "bytes", entry.m_nCompressedSize);
+    writeLocalHeader(entry);
+
+    std::vector<uint8_t> chunk((size_t)std::min<uint64_t>(entry.m_nCompressedSize, PACKAGE_COPY_CHUNKSIZE));
+    uint64_t nCopied = 0;
+    while (nCopied < entry.m_nCompressedSize) {
+        uint64_t nChunkSize = std::min<uint64_t>(entry.m_nCompressedSize - nCopied, chunk.size());
+        reader.ReadRawEntryData(nIndex, nCopied, chunk.data(), nChunkSize);
+        writeBytes(chunk.data(), nChunkSize);
+        nCopied += nChunkSize;
+    }
+
+    if (m_pStatistics.get() != nullptr)
+        m_pStatistics->AddCount(eToolpathCounter::BytesCopied, entry.m_nCompressedSize);
+
+    m_Entries.push_back(entry);
+    reportEntry(entry);
+}
+
+void CToolpathPackageWriter::Finish()
+{
+    if (m_bFinished)
+        return;
+
+    uint64_t nDirectoryOffset = m_nOffset;
+
+    std::vector<uint8_t> directory;
+    for (auto & entry : m_Entries) {
+        bool bZip64Sizes = (entry.m_nCompressedSize >= 0xffffffffULL) || (entry.m_nUncompressedSize >= 0xffffffffULL);
+        bool bZip64Offset = (entry.m_nLocalHeaderOffset >= 0xffffffffULL);
+        uint16_t nExtraSize = (bZip64Sizes ? 16 : 0) + (bZip64Offset ? 8 : 0);
+
+        appendUInt32(directory, PACKAGE_CENTRALHEADER_SIGNATURE);
+        appendUInt16(directory, PACKAGE_VERSION_ZIP64);
+        appendUInt16(directory, (nExtraSize > 0) ? PACKAGE_VERSION_ZIP64 : PACKAGE_VERSION_DEFAULT);
+        appendUInt16(directory, entry.m_nFlags);
+        appendUInt16(directory, entry.m_nCompressionMethod);
+        appendUInt16(directory, entry.m_nModificationTime);
+        appendUInt16(directory, entry.m_nModificationDate);
+        appendUInt32(directory, entry.m_nCRC32);
+        appendUInt32(directory, bZip64Sizes ? 0xffffffff : (uint32_t)entry.m_nCompressedSize);
+        appendUInt32(directory, bZip64Sizes ? 0xffffffff : (uint32_t)entry.m_nUncompressedSize);
+        appendUInt16(directory, (uint16_t)entry.m_sName.length());
+        appendUInt16(directory, (nExtraSize > 0) ? nExtraSize + 4 : 0);
+        appendUInt16(directory, 0); // comment length
+        appendUInt16(directory, 0); // disk number
+        appendUInt16(directory, 0); // internal attributes
+        appendUInt32(directory, 0); // external attributes
+        appendUInt32(directory, clampUInt32(entry.m_nLocalHeaderOffset));
+        directory.insert(directory.end(), entry.m_sName.begin(), entry.m_sName.end());
+
+        if (nExtraSize > 0) {
+            appendUInt16(directory, PACKAGE_ZIP64EXTRAFIELD_ID);
+            appendUInt16(directory, nExtraSize);
+            if (bZip64Sizes) {
+                appendUInt64(directory, entry.m_nUncompressedSize);
+                appendUInt64(directory, entry.m_nCompressedSize);
+            }
+            if (bZip64Offset)
+                appendUInt64(directory, entry.m_nLocalHeaderOffset);
+        }
+    }
+    writeBytes(directory.data(), directory.size());
+
+    uint64_t nDirectorySize = directory.size();
+    uint64_t nEntryCount = m_Entries.size();
+    bool bZip64Directory = (nEntryCount >= 0xffff) || (nDirectorySize >= 0xffffffffULL) || (nDirectoryOffset >= 0xffffffffULL);
+
+    std::vector<uint8_t> trailer;
+    if (bZip64Directory) {
+        uint64_t nZip64RecordOffset = m_nOffset;
+
+        appendUInt32(trailer, PACKAGE_ZIP64ENDOFCENTRALDIR_SIGNATURE);
+        appendUInt64(trailer, PACKAGE_ZIP64ENDOFCENTRALDIR_SIZE - 12);
+        appendUInt16(trailer, PACKAGE_VERSION_ZIP64);
+        appendUInt16(trailer, PACKAGE_VERSION_ZIP64);
+        appendUInt32(trailer, 0);
+        appendUInt32(trailer, 0);
+        appendUInt64(trailer, nEntryCount);
+        appendUInt64(trailer, nEntryCount);
+        appendUInt64(trailer, nDirectorySize);
+        appendUInt64(trailer, nDirectoryOffset);
+
+        appendUInt32(trailer, PACKAGE_ZIP64LOCATOR_SIGNATURE);
+        appendUInt32(trailer, 0);
+        appendUInt64(trailer, nZip64RecordOffset);
+        appendUInt32(trailer, 1);
+    }
+
+    appendUInt32(trailer, PACKAGE_ENDOFCENTRALDIR_SIGNATURE);
+    appendUInt16(trailer, 0);
+    appendUInt16(trailer, 0);
+    appendUInt16(trailer, (uint16_t)std::min<uint64_t>(nEntryCount, 0xffff));
+    appendUInt16(trailer, (uint16_t)std::min<uint64_t>(nEntryCount, 0xffff));
+    appendUInt32(trailer, clampUInt32(nDirectorySize));
+    appendUInt32(trailer, clampUInt32(nDirectoryOffset));
+    appendUInt16(trailer, 0);
+    writeBytes(trailer.data(), trailer.size());
+
+    m_Stream.close();
+    if (m_Stream.fail())
+        throw std::runtime_error("could not close package");
+
+    m_bFinished = true;
+}
+
+/*************************************************************************************************************************
+ Class CToolpathPackageUpdater
+**************************************************************************************************************************/
+
+CToolpathPackageUpdater::CToolpathPackageUpdater(const std::string & sSourceFileName)
+    : m_Reader(sSourceFileName), m_bRecompressAll(false), m_bWritten(false)
+{
+    if (!packageIsCompressionAvailable(ePackageCompressionMethod::Deflate))
+        m_CompressionPolicy = CToolpathPackageCompressionPolicy(ePackageCompressionMethod::Store, -1);
+}
+
+void CToolpathPackageUpdater::SetThreadPool(PToolpathThreadPool pThreadPool)
+{
+    m_pThreadPool = pThreadPool;
+}
+
+void CToolpathPackageUpdater::SetProgress(PToolpathProgress pProgress)
+{
+    m_pProgress = pProgress;
+}
+
+void CToolpathPackageUpdater::SetStatistics(PToolpathStatistics pStatistics)
+{
+    m_pStatistics = pStatistics;
+    m_Reader.SetStatistics(pStatistics);
+}
+
+void CToolpathPackageUpdater::SetTracer(PToolpathTracer pTracer)
+{
+    m_pTracer = pTracer;
+    m_Reader.SetTracer(pTracer);
+}
+
+CToolpathPackageReader & CToolpathPackageUpdater::GetReader()
+{
+    return m_Reader;
+}
+
+void CToolpathPackageUpdater::SetCompressionLevel(int32_t nCompressionLevel)
+{
+    for (uint32_t nIndex = 0; nIndex < PACKAGE_CONTENTTYPE_COUNT; nIndex++) {
+        ePackageContentType contentType = (ePackageContentType)nIndex;
+        m_CompressionPolicy.SetSettings(contentType, m_CompressionPolicy.GetSettings(contentType).m_Method, nCompressionLevel);
+    }
+}
+
+void CToolpathPackageUpdater::SetCompressionPolicy(const CToolpathPackageCompressionPolicy & policy)
+{
+    m_CompressionPolicy = policy;
+}
+
+void CToolpathPackageUpdater::SetRecompressAll(bool bRecompressAll)
+{
+    m_bRecompressAll = bRecompressAll;
+}
+
+void CToolpathPackageUpdater::ReplacePart(const std::string & sPartPath, const std::vector<uint8_t> & data)
+{
+    // Adding parts would also require content types and relationships to be updated.
+    uint32_t nIndex = 0;
+    if (!m_Reader.FindEntry(sPartPath, nIndex))
+        throw std::runtime_error("part does not exist in package: " + sPartPath);
+
+    m_Replacements[m_Reader.GetEntry(nIndex).m_sName] = data;
+}
+
+void CToolpathPackageUpdater::writeBatch(CToolpathPackageWriter & writer, std::vector<uint32_t> & batchIndices, std::vector<std::vector<uint8_t>> & batchData)
+{
+    if (batchIndices.empty())
+        return;
+
+    std::vector<sPackagePartData> parts;
+    for (size_t nBatchIndex = 0; nBatchIndex < batchIndices.size(); nBatchIndex++) {
+        uint32_t nEntryIndex = batchIndices[nBatchIndex];
+        const sPackageEntry & sourceEntry = m_Reader.GetEntry(nEntryIndex);
+
+        auto iReplacement = m_Replacements.find(sourceEntry.m_sName);
+        const std::vector<uint8_t> & data = (iReplacement != m_Replacements.end()) ? iReplacement->second : batchData[nBatchIndex];
+        const sPackageCompressionSettings & settings = m_CompressionPolicy.GetSettings(m_Reader.GetEntryContentType(nEntryIndex));
+
+        sPackagePartData part;
+        part.m_sPartPath = sourceEntry.m_sName;
+        part.m_pData = data.data();
+        part.m_nSize = data.size();
+        part.m_CompressionMethod = settings.m_Method;
+        part.m_nCompressionLevel = settings.m_nLevel;
+        parts.push_back(part);
+    }
+
+    std::vector<sPackageCompressedEntry> compressedEntries;
+    CToolpathPackageWriter::CompressEntries(parts, m_pThreadPool.get(), PACKAGE_DEFAULT_CHUNKSIZE, compressedEntries, m_pStatistics.get(), m_pTracer.get());
+
+    for (size_t nBatchIndex = 0; nBatchIndex < batchIndices.size(); nBatchIndex++) {
+        const sPackageEntry & sourceEntry = m_Reader.GetEntry(batchIndices[nBatchIndex]);
+        sPackageCompressedEntry & compressedEntry = compressedEntries[nBatchIndex];
+        compressedEntry.m_Entry.m_nModificationTime = sourceEntry.m_nModificationTime;
+        compressedEntry.m_Entry.m_nModificationDate = sourceEntry.m_nModificationDate;
+        writer.WriteCompressedEntry(compressedEntry);
+    }
+
+    batchIndices.clear();
+    batchData.clear();
+}
+
+// Moves a file over an existing one in a single step, the target is never removed on its own
+static bool replaceFile(const std::string & sFileName, const std::string & sTargetFileName)
+{
+#ifdef _WIN32
+    // rename does not replace existing files on Windows. The names are converted with the ANSI code page,
+    // as the narrow file streams interpret them.
+    auto toWide = [](const std::string & sName) {
+        int nLength = MultiByteToWideChar(CP_ACP, 0, sName.c_str(), -1, nullptr, 0);
+        std::vector<wchar_t> wideName((nLength > 0) ? (size_t)nLength : 1, L'\0');
+        if (nLength > 0)
+            MultiByteToWideChar(CP_ACP, 0, sName.c_str(), -1, wideName.data(), nLength);
+        return std::wstring(wideName.data());
+    };
+    return MoveFileExW(toWide(sFileName).c_str(), toWide(sTargetFileName).c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(sFileName.c_str(), sTargetFileName.c_str()) == 0;
+#endif
+}
+
+void CToolpathPackageUpdater::WriteToFile(const std::string & sTargetFileName)
+{
+    if (m_bWritten)
+        throw std::logic_error("package update has already been written");
+
+    // The package is written next to the target and moved over it when it is complete, so that the target
+    // may be the source itself and a failed or cancelled update leaves the target untouched.
+    std::string sTemporaryFileName = sTargetFileName + PACKAGE_TEMPORARY_SUFFIX;
+    try {
+        writePackage(sTemporaryFileName);
+    }
+    catch (...) {
+        std::remove(sTemporaryFileName.c_str());
+        throw;
+    }
+
+    // The source must not be open while it is replaced
+    m_Reader.Close();
+    m_bWritten = true;
+
+    // The complete update is kept if it cannot be moved, as the target may already be gone
+    if (!replaceFile(sTemporaryFileName, sTargetFileName))
+        throw std::runtime_error("could not replace package " + sTargetFileName + ", the update was kept in " + sTemporaryFileName);
+}
+
+void CToolpathPackageUpdater::writePackage(const std::string & sFileName)
+{
+    CToolpathPackageWriter writer(sFileName);
+    writer.SetProgress(m_pProgress, m_Reader.GetEntryCount());
+    writer.SetStatistics(m_pStatistics);
+    writer.SetTracer(m_pTracer);
+
+    // Re-encoded entries are collected into batches that are compressed in parallel. Batches are limited
+    // in size, so that recompressing a large build does not hold the whole package in memory.
+    std::vector<uint32_t> batchIndices;
+    std::vector<std::vector<uint8_t>> batchData;
+    std::vector<std::vector<uint8_t>> rawData;
+    uint64_t nBatchSize = 0;
+
+    auto flushBatch = [&]() {
+        // Untouched entries of the batch are inflated in parallel, replaced ones have no raw data.
+        auto inflateEntry = [&](uint64_t nBatchIndex, uint32_t) {
+            if (m_pProgress.get() != nullptr)
+                m_pProgress->CheckCancelled();
+
+            const sPackageEntry & sourceEntry = m_Reader.GetEntry(batchIndices[nBatchIndex]);
+            if (m_Replacements.find(sourceEntry.m_sName) == m_Replacements.end())
+                CToolpathPackageReader::DecompressEntryData(sourceEntry, rawData[nBatchIndex], batchData[nBatchIndex], m_pStatistics.get(), m_pTracer.get());
+        };
+        if (m_pThreadPool.get() != nullptr) {
+            m_pThreadPool->ParallelFor(batchIndices.size(), inflateEntry);
+        }
+        else {
+            for (size_t nBatchIndex = 0; nBatchIndex < batchIndices.size(); nBatchIndex++)
+                inflateEntry(nBatchIndex, 0);
+        }
+
+        rawData.clear();
+        writeBatch(writer, batchIndices, batchData);
+        nBatchSize = 0;
+    };
+
+    uint32_t nEntryCount = m_Reader.GetEntryCount();
+    for (uint32_t nIndex = 0; nIndex < nEntryCount; nIndex++) {
+        const sPackageEntry & sourceEntry = m_Reader.GetEntry(nIndex);
+        bool bReplaced = (m_Replacements.find(sourceEntry.m_sName) != m_Replacements.end());
+
+        if (!bReplaced && !m_bRecompressAll) {
+            flushBatch();
+            writer.CopyEntry(m_Reader, nIndex);
+            continue;
+        }
+
+        batchIndices.push_back(nIndex);
+        batchData.push_back(std::vector<uint8_t>());
+        rawData.push_back(std::vector<uint8_t>());
+        if (!bReplaced) {
+            rawData.back().resize((size_t)sourceEntry.m_nCompressedSize);
+            m_Reader.ReadRawEntryData(nIndex, 0, rawData.back().data(), sourceEntry.m_nCompressedSize);
+            nBatchSize += sourceEntry.m_nUncompressedSize;
+        }
+
+        if (nBatchSize >= PACKAGE_RECOMPRESS_BATCHSIZE)
+            flushBatch();
+    }
+
+    flushBatch();
+    writer.Finish();
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,519 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef __TOOLPATHEXAMPLE_PACKAGE
+#define __TOOLPATHEXAMPLE_PACKAGE
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ToolpathThreadPool.hpp"
+#include "ToolpathProgress.hpp"
+#include "ToolpathStatistics.hpp"
+#include "ToolpathTrace.hpp"
+
+namespace ToolpathExample {
+
+/* ZIP compression methods that lib3mf can read back. Zstandard (method 93) is not offered, as the lib3mf
+   package reader only supports stored and deflated entries. */
+enum class ePackageCompressionMethod : uint16_t {
+    Store = 0,
+    Deflate = 8
+};
+
+/* Role of a part in a 3MF package, derived from the package relationships. */
+enum class ePackageContentType : uint32_t {
+    PackageMetadata = 0, /** Content types and relationships */
+    RootModel = 1, /** Model parts */
+    ToolpathLayer = 2, /** Toolpath layer parts and their binary streams */
+    Attachment = 3 /** Everything else */
+};
+
+#define PACKAGE_CONTENTTYPE_COUNT 4
+
+typedef struct sPackageCompressionSettings {
+    ePackageCompressionMethod m_Method;
+    int32_t m_nLevel;
+} sPackageCompressionSettings;
+
+/* Central directory information of a package entry. Names are ZIP names, i.e. part paths without leading slash. */
+typedef struct sPackageEntry {
+    std::string m_sName;
+    uint16_t m_nFlags;
+    uint16_t m_nCompressionMethod;
+    uint16_t m_nModificationTime;
+    uint16_t m_nModificationDate;
+    uint32_t m_nCRC32;
+    uint64_t m_nCompressedSize;
+    uint64_t m_nUncompressedSize;
+    uint64_t m_nLocalHeaderOffset;
+} sPackageEntry;
+
+/* Entry whose data is already compressed and ready to be written. */
+typedef struct sPackageCompressedEntry {
+    sPackageEntry m_Entry;
+    std::vector<uint8_t> m_Data;
+} sPackageCompressedEntry;
+
+/* Uncompressed part data to be added to a package. The data must stay valid until the entry has been compressed. */
+typedef struct sPackagePartData {
+    std::string m_sPartPath;
+    const uint8_t * m_pData;
+    uint64_t m_nSize;
+    ePackageCompressionMethod m_CompressionMethod;
+    int32_t m_nCompressionLevel;
+} sPackagePartData;
+
+/**
+* packagePartPathToEntryName - Converts a part path such as "/Toolpath/layer1.xml" into a ZIP entry name.
+* @param[in] sPartPath - OPC part path
+* @return ZIP entry name
+*/
+std::string packagePartPathToEntryName(const std::string & sPartPath);
+
+/**
+* packageCalculateCRC32 - Continues a CRC32 checksum as used by ZIP.
+* @param[in] nCRC32 - Previous checksum, 0 for the first block
+* @param[in] pData - Data
+* @param[in] nSize - Size of data in bytes
+* @return Updated checksum
+*/
+uint32_t packageCalculateCRC32(uint32_t nCRC32, const uint8_t * pData, uint64_t nSize);
+
+/**
+* packageIsCompressionAvailable - Returns if a compression method can be encoded and decoded by this build.
+* @param[in] method - Compression method
+* @return true if supported
+*/
+bool packageIsCompressionAvailable(ePackageCompressionMethod method);
+
+/*************************************************************************************************************************
+ Class CToolpathPackageCompressionPolicy
+
+ Compression method and deflate level per content type.
+**************************************************************************************************************************/
+class CToolpathPackageCompressionPolicy {
+private:
+    sPackageCompressionSettings m_Settings[PACKAGE_CONTENTTYPE_COUNT];
+
+public:
+
+    /**
+    * CToolpathPackageCompressionPolicy::CToolpathPackageCompressionPolicy - Creates a policy that uses the same settings for all content types.
+    * @param[in] method - Compression method
+    * @param[in] nLevel - Deflate level from 1 to 9, -1 for the zlib default
+    */
+    CToolpathPackageCompressionPolicy(ePackageCompressionMethod method = ePackageCompressionMethod::Deflate, int32_t nLevel = -1);
+
+    /**
+    * CToolpathPackageCompressionPolicy::CreateFast - Returns a policy for write heavy nodes: fastest deflate for layers and
+    *   attachments, default compression for the small model and metadata parts.
+    * @return Compression policy
+    */
+    static CToolpathPackageCompressionPolicy CreateFast();
+
+    /**
+    * CToolpathPackageCompressionPolicy::CreateArchive - Returns a policy with maximum compression for all parts.
+    * @return Compression policy
+    */
+    static CToolpathPackageCompressionPolicy CreateArchive();
+
+    /**
+    * CToolpathPackageCompressionPolicy::SetSettings - Sets method and level for a content type.
+    * @param[in] contentType - Content type
+    * @param[in] method - Compression method
+    * @param[in] nLevel - Deflate level from 1 to 9, -1 for the zlib default. Ignored for stored entries.
+    */
+    void SetSettings(ePackageContentType contentType, ePackageCompressionMethod method, int32_t nLevel);
+
+    /**
+    * CToolpathPackageCompressionPolicy::GetSettings - Returns method and level for a content type.
+    * @param[in] contentType - Content type
+    * @return Compression settings
+    */
+    const sPackageCompressionSettings & GetSettings(ePackageContentType contentType) const;
+
+};
+
+/*************************************************************************************************************************
+ Class CToolpathPackageReader
+
+ Reads the central directory of a 3MF (ZIP/ZIP64) package and gives access to raw and decompressed entry data.
+**************************************************************************************************************************/
+class CToolpathPackageReader {
+private:
+    std::string m_sFileName;
+    std::ifstream m_Stream;
+    uint64_t m_nFileSize;
+    std::vector<sPackageEntry> m_Entries;
+    std::map<std::string, uint32_t> m_EntryIndices;
+    std::vector<ePackageContentType> m_ContentTypes;
+    PToolpathStatistics m_pStatistics;
+    PToolpathTracer m_pTracer;
+
+    void readBytes(uint64_t nOffset, uint8_t * pBuffer, uint64_t nSize);
+    void readCentralDirectory();
+    void classifyEntries();
+
+public:
+
+    /**
+    * CToolpathPackageReader::CToolpathPackageReader - Opens a package and reads its central directory.
+    * @param[in] sFileName - Package file
+    */
+    explicit CToolpathPackageReader(const std::string & sFileName);
+
+    /**
+    * CToolpathPackageReader::GetEntryCount - Returns the number of entries in the package.
+    * @return Entry count
+    */
+    uint32_t GetEntryCount() const;
+
+    /**
+    * CToolpathPackageReader::GetEntry - Returns the central directory information of an entry.
+    * @param[in] nIndex - Entry index
+    * @return Entry information
+    */
+    const sPackageEntry & GetEntry(uint32_t nIndex) const;
+
+    /**
+    * CToolpathPackageReader::FindEntry - Looks up an entry by part path.
+    * @param[in] sPartPath - Part path, with or without leading slash
+    * @param[out] nIndex - Entry index, if found
+    * @return true if the entry exists
+    */
+    bool FindEntry(const std::string & sPartPath, uint32_t & nIndex) const;
+
+    /**
+    * CToolpathPackageReader::GetEntryDataOffset - Returns the file offset of the compressed data of an entry.
+    * @param[in] nIndex - Entry index
+    * @return File offset
+    */
+    uint64_t GetEntryDataOffset(uint32_t nIndex);
+
+    /**
+    * CToolpathPackageReader::ReadRawEntryData - Reads a chunk of the compressed data of an entry.
+    * @param[in] nIndex - Entry index
+    * @param[in] nOffset - Offset into the compressed data
+    * @param[out] pBuffer - Target buffer
+    * @param[in] nSize - Number of bytes to read
+    */
+    void ReadRawEntryData(uint32_t nIndex, uint64_t nOffset, uint8_t * pBuffer, uint64_t nSize);
+
+    /**
+    * CToolpathPackageReader::Close - Closes the package file. Entry information stays available, reading data throws.
+    */
+    void Close();
+
+    /**
+    * CToolpathPackageReader::ReadEntryData - Reads and decompresses an entry.
+    * @param[in] nIndex - Entry index
+    * @param[out] buffer - Uncompressed data
+    */
+    void ReadEntryData(uint32_t nIndex, std::vector<uint8_t> & buffer);
+
+    /**
+    * CToolpathPackageReader::SetStatistics - Sets the statistics that decompression is recorded in.
+    * @param[in] pStatistics - Statistics, null to disable
+    */
+    void SetStatistics(PToolpathStatistics pStatistics);
+
+    /**
+    * CToolpathPackageReader::StreamEntryData - Decompresses an entry in chunks without holding the whole entry in memory.
+    *   The checksum is verified after the last chunk.
+    * @param[in] nIndex - Entry index
+    * @param[in] nChunkSize - Maximum size of the chunks passed to the callback
+    * @param[in] fnChunk - Called with consecutive chunks of uncompressed data
+    */
+    void StreamEntryData(uint32_t nIndex, uint64_t nChunkSize, const std::function<void(const uint8_t * pData, uint64_t nSize)> & fnChunk);
+
+    /**
+    * CToolpathPackageReader::SetTracer - Sets the tracer that decompression spans are recorded in.
+    * @param[in] pTracer - Tracer, null to disable
+    */
+    void SetTracer(PToolpathTracer pTracer);
+
+    /**
+    * CToolpathPackageReader::DecompressEntryData - Decompresses and verifies raw entry data. Thread safe.
+    * @param[in] entry - Entry information
+    * @param[in] compressedData - Raw entry data as returned by ReadRawEntryData
+    * @param[out] buffer - Uncompressed data
+    * @param[in] pStatistics - Statistics to record decompression in, may be null
+    * @param[in] pTracer - Tracer to record decompression in, may be null
+    */
+    static void DecompressEntryData(const sPackageEntry & entry, const std::vector<uint8_t> & compressedData, std::vector<uint8_t> & buffer, CToolpathStatistics * pStatistics = nullptr, CToolpathTracer * pTracer = nullptr);
+
+    /**
+    * CToolpathPackageReader::GetEntryContentType - Returns the role of an entry, based on the relationships of the package.
+    * @param[in] nIndex - Entry index
+    * @return Content type
+    */
+    ePackageContentType GetEntryContentType(uint32_t nIndex);
+
+};
+
+typedef std::shared_ptr<CToolpathPackageReader> PToolpathPackageReader;
+
+/*************************************************************************************************************************
+ Class CToolpathPackageWriter
+
+ Writes a ZIP package entry by entry. Entries are written with sizes and CRC known upfront, so no data descriptors
+ are needed. ZIP64 records are added when sizes or offsets exceed 32 bits.
+**************************************************************************************************************************/
+class CToolpathPackageWriter {
+private:
+    std::ofstream m_Stream;
+    uint64_t m_nOffset;
+    std::vector<sPackageEntry> m_Entries;
+    bool m_bFinished;
+    PToolpathThreadPool m_pThreadPool;
+    uint64_t m_nChunkSize;
+    PToolpathProgress m_pProgress;
+    uint32_t m_nExpectedEntryCount;
+    PToolpathStatistics m_pStatistics;
+    PToolpathTracer m_pTracer;
+
+    void writeBytes(const uint8_t * pData, uint64_t nSize);
+    void writeLocalHeader(sPackageEntry & entry);
+    void reportEntry(const sPackageEntry & entry);
+
+public:
+
+    /**
+    * CToolpathPackageWriter::CToolpathPackageWriter - Creates a new package file.
+    * @param[in] sFileName - Target file, will be overwritten
+    */
+    explicit CToolpathPackageWriter(const std::string & sFileName);
+
+    /**
+    * CToolpathPackageWriter::CompressEntry - Compresses part data into an entry that can be written later. Thread safe.
+    * @param[in] sPartPath - Part path
+    * @param[in] pData - Uncompressed data
+    * @param[in] nSize - Size of uncompressed data
+    * @param[in] method - Compression method
+    * @param[in] nCompressionLevel - Deflate level from 1 to 9, -1 for the zlib default
+    * @param[out] compressedEntry - Entry information and compressed data
+    * @param[in] pStatistics - Statistics to record compression in, may be null
+    * @param[in] pTracer - Tracer to record compression in, may be null
+    */
+    static void CompressEntry(const std::string & sPartPath, const uint8_t * pData, uint64_t nSize, ePackageCompressionMethod method, int32_t nCompressionLevel, sPackageCompressedEntry & compressedEntry, CToolpathStatistics * pStatistics = nullptr, CToolpathTracer * pTracer = nullptr);
+
+    /**
+    * CToolpathPackageWriter::CompressEntries - Compresses several parts at once. Parts and chunks of large deflated parts
+    *   are compressed in parallel; chunks are sync flushed and primed with the preceding 32k as dictionary, so the
+    *   result is a single valid deflate stream per part.
+    * @param[in] parts - Parts to compress
+    * @param[in] pThreadPool - Thread pool, may be null for serial compression
+    * @param[in] nChunkSize - Size of the chunks that large parts are split into
+    * @param[out] compressedEntries - Compressed entries in the order of parts
+    * @param[in] pStatistics - Statistics to record compression in, may be null
+    * @param[in] pTracer - Tracer to record compression in, may be null
+    */
+    static void CompressEntries(const std::vector<sPackagePartData> & parts, CToolpathThreadPool * pThreadPool, uint64_t nChunkSize, std::vector<sPackageCompressedEntry> & compressedEntries, CToolpathStatistics * pStatistics = nullptr, CToolpathTracer * pTracer = nullptr);
+
+    /**
+    * CToolpathPackageWriter::SetThreadPool - Sets the thread pool that AddEntries compresses on.
+    * @param[in] pThreadPool - Thread pool, null for serial compression
+    */
+    void SetThreadPool(PToolpathThreadPool pThreadPool);
+
+    /**
+    * CToolpathPackageWriter::SetThreadCount - Creates a dedicated thread pool for compression.
+    * @param[in] nThreadCount - Number of threads, 0 for the hardware concurrency
+    */
+    void SetThreadCount(uint32_t nThreadCount);
+
+    /**
+    * CToolpathPackageWriter::SetChunkSize - Sets the size of the chunks that large parts are compressed in. Default is 1MB.
+    * @param[in] nChunkSize - Chunk size in bytes, at least 64k
+    */
+    void SetChunkSize(uint64_t nChunkSize);
+
+    /**
+    * CToolpathPackageWriter::SetProgress - Sets the progress instance that is notified once per written entry.
+    *   Writing stops with EToolpathCancelled before the next entry when the progress has been cancelled.
+    * @param[in] pProgress - Progress instance, null to disable
+    * @param[in] nExpectedEntryCount - Number of entries that will be written, 0 if unknown
+    */
+    void SetProgress(PToolpathProgress pProgress, uint32_t nExpectedEntryCount);
+
+    /**
+    * CToolpathPackageWriter::SetStatistics - Sets the statistics that compression and copying are recorded in.
+    * @param[in] pStatistics - Statistics, null to disable
+    */
+    void SetStatistics(PToolpathStatistics pStatistics);
+
+    /**
+    * CToolpathPackageWriter::SetTracer - Sets the tracer that compression and write spans are recorded in.
+    * @param[in] pTracer - Tracer, null to disable
+    */
+    void SetTracer(PToolpathTracer pTracer);
+
+    /**
+    * CToolpathPackageWriter::AddEntries - Compresses parts on the thread pool and writes them in the given order.
+    * @param[in] parts - Parts to add
+    */
+    void AddEntries(const std::vector<sPackagePartData> & parts);
+
+    /**
+    * CToolpathPackageWriter::WriteCompressedEntry - Writes an entry that has been compressed before.
+    * @param[in] compressedEntry - Entry information and compressed data
+    */
+    void WriteCompressedEntry(const sPackageCompressedEntry & compressedEntry);
+
+    /**
+    * CToolpathPackageWriter::AddEntry - Compresses and writes part data.
+    * @param[in] sPartPath - Part path
+    * @param[in] pData - Uncompressed data
+    * @param[in] nSize - Size of uncompressed data
+    * @param[in] method - Compression method
+    * @param[in] nCompressionLevel - Deflate level from 1 to 9, -1 for the zlib default
+    */
+    void AddEntry(const std::string & sPartPath, const uint8_t * pData, uint64_t nSize, ePackageCompressionMethod method, int32_t nCompressionLevel);
+
+    /**
+    * CToolpathPackageWriter::CopyEntry - Copies the compressed data of an entry of another package without recompressing it.
+    * @param[in] reader - Source package
+    * @param[in] nIndex - Entry index in the source package
+    */
+    void CopyEntry(CToolpathPackageReader & reader, uint32_t nIndex);
+
+    /**
+    * CToolpathPackageWriter::Finish - Writes the central directory and closes the file.
+    */
+    void Finish();
+
+};
+
+/*************************************************************************************************************************
+ Class CToolpathPackageUpdater
+
+ Writes a modified copy of an existing package. Replaced parts, typically the root model and a few toolpath layers,
+ are compressed anew according to the compression policy, all other entries are copied byte for byte.
+**************************************************************************************************************************/
+class CToolpathPackageUpdater {
+private:
+    CToolpathPackageReader m_Reader;
+    std::map<std::string, std::vector<uint8_t>> m_Replacements;
+    CToolpathPackageCompressionPolicy m_CompressionPolicy;
+    bool m_bRecompressAll;
+    bool m_bWritten;
+    PToolpathThreadPool m_pThreadPool;
+    PToolpathProgress m_pProgress;
+    PToolpathStatistics m_pStatistics;
+    PToolpathTracer m_pTracer;
+
+    void writeBatch(CToolpathPackageWriter & writer, std::vector<uint32_t> & batchIndices, std::vector<std::vector<uint8_t>> & batchData);
+    void writePackage(const std::string & sFileName);
+
+public:
+
+    /**
+    * CToolpathPackageUpdater::CToolpathPackageUpdater - Opens the package to update.
+    * @param[in] sSourceFileName - Existing package
+    */
+    explicit CToolpathPackageUpdater(const std::string & sSourceFileName);
+
+    /**
+    * CToolpathPackageUpdater::GetReader - Returns the reader of the source package.
+    * @return Source package reader
+    */
+    CToolpathPackageReader & GetReader();
+
+    /**
+    * CToolpathPackageUpdater::SetCompressionLevel - Sets the deflate level for replaced parts of all content types.
+    * @param[in] nCompressionLevel - Deflate level from 1 to 9, -1 for the zlib default
+    */
+    void SetCompressionLevel(int32_t nCompressionLevel);
+
+    /**
+    * CToolpathPackageUpdater::SetCompressionPolicy - Sets method and level per content type for re-encoded parts.
+    * @param[in] policy - Compression policy
+    */
+    void SetCompressionPolicy(const CToolpathPackageCompressionPolicy & policy);
+
+    /**
+    * CToolpathPackageUpdater::SetRecompressAll - Re-encodes all parts with the compression policy instead of copying them,
+    *   e.g. to turn a package written by fast slicing nodes into an archive package.
+    * @param[in] bRecompressAll - true to re-encode untouched parts as well
+    */
+    void SetRecompressAll(bool bRecompressAll);
+
+    /**
+    * CToolpathPackageUpdater::SetThreadPool - Sets the thread pool that replaced parts are compressed on.
+    * @param[in] pThreadPool - Thread pool, null for serial compression
+    */
+    void SetThreadPool(PToolpathThreadPool pThreadPool);
+
+    /**
+    * CToolpathPackageUpdater::SetProgress - Sets the progress instance that is notified once per written entry.
+    *   A cancelled update leaves the target file untouched.
+    * @param[in] pProgress - Progress instance, null to disable
+    */
+    void SetProgress(PToolpathProgress pProgress);
+
+    /**
+    * CToolpathPackageUpdater::SetStatistics - Sets the statistics that decompression, compression and copying are recorded in.
+    * @param[in] pStatistics - Statistics, null to disable
+    */
+    void SetStatistics(PToolpathStatistics pStatistics);
+
+    /**
+    * CToolpathPackageUpdater::SetTracer - Sets the tracer that decompression, compression and write spans are recorded in.
+    * @param[in] pTracer - Tracer, null to disable
+    */
+    void SetTracer(PToolpathTracer pTracer);
+
+    /**
+    * CToolpathPackageUpdater::ReplacePart - Replaces the content of an existing part.
+    * @param[in] sPartPath - Part path, e.g. "/Toolpath/layer3.xml"
+    * @param[in] data - New uncompressed content
+    */
+    void ReplacePart(const std::string & sPartPath, const std::vector<uint8_t> & data);
+
+    /**
+    * CToolpathPackageUpdater::WriteToFile - Writes the updated package into a temporary file next to the target and
+    *   moves it over the target when complete. The source is closed before, so the target may be the source package
+    *   itself; the updater and its reader cannot be used afterwards. If the move fails, the temporary file is kept.
+    * @param[in] sTargetFileName - Target file
+    */
+    void WriteToFile(const std::string & sTargetFileName);
+
+};
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_PACKAGE
@@ -0,0 +1,164 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathParallelReader.hpp"
+
+#include <stdexcept>
+
+namespace ToolpathExample {
+
+CToolpathParallelLayerReader::CToolpathParallelLayerReader(Lib3MF::PWrapper pWrapper, const std::string & sFileName, uint32_t nToolpathIndex, PToolpathThreadPool pThreadPool)
+    : m_pWrapper(pWrapper), m_sFileName(sFileName), m_nToolpathIndex(nToolpathIndex), m_pThreadPool(pThreadPool), m_nLayerCount(0)
+{
+    if (m_pWrapper.get() == nullptr)
+        throw std::invalid_argument("invalid lib3mf wrapper");
+
+    uint32_t nThreadCount = (m_pThreadPool.get() != nullptr) ? m_pThreadPool->GetThreadCount() : 1;
+    m_Contexts.resize(nThreadCount);
+
+    // The calling thread is worker 0 of the pool, so its context can be opened right away.
+    m_nLayerCount = getContext(0).m_pToolpath->GetLayerCount();
+}
+
+sLayerReadContext & CToolpathParallelLayerReader::getContext(uint32_t nWorkerIndex)
+{
+    if (nWorkerIndex >= m_Contexts.size())
+        throw std::out_of_range("invalid worker index");
+
+    // Each worker only ever touches its own slot, so no locking is needed.
+    auto & pContext = m_Contexts[nWorkerIndex];
+    if (pContext.get() == nullptr) {
+        CToolpathTraceSpan span(m_pTracer.get(), "OpenModel", "read", "worker", nWorkerIndex);
+        std::unique_ptr<sLayerReadContext> pNewContext(new sLayerReadContext());
+        pNewContext->m_pModel = m_pWrapper->CreateModel();
+        pNewContext->m_pSource = pNewContext->m_pModel->CreatePersistentSourceFromFile(m_sFileName);
+
+        auto pReader = pNewContext->m_pModel->QueryReader("3mf");
+        pReader->ReadFromPersistentSource(pNewContext->m_pSource);
+
+        auto toolpathIterator = pNewContext->m_pModel->GetToolpaths();
+        for (uint32_t nIndex = 0; nIndex <= m_nToolpathIndex; nIndex++) {
+            if (!toolpathIterator->MoveNext())
+                throw std::runtime_error("toolpath not found in " + m_sFileName);
+        }
+        pNewContext->m_pToolpath = toolpathIterator->GetCurrentToolpath();
+
+        pContext = std::move(pNewContext);
+    }
+
+    return *pContext;
+}
+
+void CToolpathParallelLayerReader::checkLayerRange(uint32_t nFirstLayer, uint32_t nLayerCount)
+{
+    if ((nFirstLayer > m_nLayerCount) || (nLayerCount > m_nLayerCount - nFirstLayer))
+        throw std::out_of_range("invalid layer range");
+}
+
+Lib3MF::PToolpath CToolpathParallelLayerReader::GetToolpath()
+{
+    return getContext(0).m_pToolpath;
+}
+
+uint32_t CToolpathParallelLayerReader::GetLayerCount() const
+{
+    return m_nLayerCount;
+}
+
+void CToolpathParallelLayerReader::SetProgress(PToolpathProgress pProgress)
+{
+    m_pProgress = pProgress;
+}
+
+void CToolpathParallelLayerReader::SetStatistics(PToolpathStatistics pStatistics)
+{
+    m_pStatistics = pStatistics;
+}
+
+void CToolpathParallelLayerReader::SetTracer(PToolpathTracer pTracer)
+{
+    m_pTracer = pTracer;
+}
+
+void CToolpathParallelLayerReader::ReadLayers(uint32_t nFirstLayer, uint32_t nLayerCount, std::vector<Lib3MF::PToolpathLayerReader> & layerReaders)
+{
+    checkLayerRange(nFirstLayer, nLayerCount);
+
+    layerReaders.clear();
+    layerReaders.resize(nLayerCount);
+
+    ProcessLayers(nFirstLayer, nLayerCount, [&](uint32_t nLayerIndex, Lib3MF::PToolpathLayerReader pLayerReader, uint32_t) {
+        layerReaders[nLayerIndex - nFirstLayer] = pLayerReader;
+    });
+}
+
+void CToolpathParallelLayerReader::ProcessLayers(uint32_t nFirstLayer, uint32_t nLayerCount, const LayerFunction & fnProcess)
+{
+    checkLayerRange(nFirstLayer, nLayerCount);
+
+    auto processLayer = [&](uint64_t nTaskIndex, uint32_t nWorkerIndex) {
+        uint32_t nLayerIndex = nFirstLayer + (uint32_t)nTaskIndex;
+        if (m_pProgress.get() != nullptr)
+            m_pProgress->CheckCancelled();
+
+        auto pToolpath = getContext(nWorkerIndex).m_pToolpath;
+        Lib3MF::PToolpathLayerReader pLayerReader;
+        {
+            CToolpathScopedTimer timer(m_pStatistics.get(), eToolpathTimer::LayerRead);
+            CToolpathTraceSpan span(m_pTracer.get(), "ReadLayerData", "read", "layer", nLayerIndex);
+            pLayerReader = pToolpath->ReadLayerData(nLayerIndex);
+        }
+        if (m_pStatistics.get() != nullptr) {
+            m_pStatistics->AddCount(eToolpathCounter::LayersRead, 1);
+            m_pStatistics->AddCount(eToolpathCounter::SegmentsRead, pLayerReader->GetSegmentCount());
+        }
+
+        {
+            CToolpathTraceSpan span(m_pTracer.get(), "ProcessLayer", "read", "layer", nLayerIndex);
+            fnProcess(nLayerIndex, pLayerReader, nWorkerIndex);
+        }
+
+        if (m_pProgress.get() != nullptr) {
+            uint64_t nBytes = pToolpath->GetLayerAttachment(nLayerIndex)->GetStreamSize();
+            m_pProgress->ReportLayer(eToolpathProgressStage::ReadLayer, nLayerIndex, m_nLayerCount, nBytes, pLayerReader->GetSegmentCount());
+        }
+    };
+
+    if (m_pThreadPool.get() != nullptr) {
+        m_pThreadPool->ParallelFor(nLayerCount, processLayer);
+    }
+    else {
+        for (uint32_t nTaskIndex = 0; nTaskIndex < nLayerCount; nTaskIndex++)
+            processLayer(nTaskIndex, 0);
+    }
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,146 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef __TOOLPATHEXAMPLE_PARALLELREADER
+#define __TOOLPATHEXAMPLE_PARALLELREADER
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+#include "ToolpathThreadPool.hpp"
+#include "ToolpathProgress.hpp"
+#include "ToolpathStatistics.hpp"
+#include "ToolpathTrace.hpp"
+
+namespace ToolpathExample {
+
+/* Independent model instance of the package, used by one worker at a time. */
+typedef struct sLayerReadContext {
+    Lib3MF::PModel m_pModel;
+    Lib3MF::PPersistentReaderSource m_pSource;
+    Lib3MF::PToolpath m_pToolpath;
+} sLayerReadContext;
+
+/*************************************************************************************************************************
+ Class CToolpathParallelLayerReader
+
+ Reads toolpath layers of a package concurrently. Every worker of the thread pool opens its own persistent source
+ and model, so layer parts are inflated and parsed in parallel without sharing reader state. Opening a context only
+ parses the root model, layers are read on demand.
+**************************************************************************************************************************/
+class CToolpathParallelLayerReader {
+public:
+    typedef std::function<void(uint32_t nLayerIndex, Lib3MF::PToolpathLayerReader pLayerReader, uint32_t nWorkerIndex)> LayerFunction;
+
+private:
+    Lib3MF::PWrapper m_pWrapper;
+    std::string m_sFileName;
+    uint32_t m_nToolpathIndex;
+    PToolpathThreadPool m_pThreadPool;
+    PToolpathProgress m_pProgress;
+    PToolpathStatistics m_pStatistics;
+    PToolpathTracer m_pTracer;
+    std::vector<std::unique_ptr<sLayerReadContext>> m_Contexts;
+    uint32_t m_nLayerCount;
+
+    sLayerReadContext & getContext(uint32_t nWorkerIndex);
+    void checkLayerRange(uint32_t nFirstLayer, uint32_t nLayerCount);
+
+public:
+
+    /**
+    * CToolpathParallelLayerReader::CToolpathParallelLayerReader - Opens a package for parallel layer reading.
+    * @param[in] pWrapper - lib3mf wrapper
+    * @param[in] sFileName - Package file
+    * @param[in] nToolpathIndex - Index of the toolpath in the model
+    * @param[in] pThreadPool - Thread pool to read on. May be null for single threaded operation.
+    */
+    CToolpathParallelLayerReader(Lib3MF::PWrapper pWrapper, const std::string & sFileName, uint32_t nToolpathIndex, PToolpathThreadPool pThreadPool);
+
+    /**
+    * CToolpathParallelLayerReader::GetToolpath - Returns the toolpath of the first context, e.g. for profile lookups.
+    * @return Toolpath instance
+    */
+    Lib3MF::PToolpath GetToolpath();
+
+    /**
+    * CToolpathParallelLayerReader::GetLayerCount - Returns the number of layers of the toolpath.
+    * @return Layer count
+    */
+    uint32_t GetLayerCount() const;
+
+    /**
+    * CToolpathParallelLayerReader::SetProgress - Sets the progress instance that is notified once per processed layer.
+    *   Reading stops with EToolpathCancelled when the progress has been cancelled.
+    * @param[in] pProgress - Progress instance, null to disable
+    */
+    void SetProgress(PToolpathProgress pProgress);
+
+    /**
+    * CToolpathParallelLayerReader::SetStatistics - Sets the statistics that layer reads are recorded in.
+    * @param[in] pStatistics - Statistics, null to disable
+    */
+    void SetStatistics(PToolpathStatistics pStatistics);
+
+    /**
+    * CToolpathParallelLayerReader::SetTracer - Sets the tracer that layer read and process spans are recorded in.
+    * @param[in] pTracer - Tracer, null to disable
+    */
+    void SetTracer(PToolpathTracer pTracer);
+
+    /**
+    * CToolpathParallelLayerReader::ReadLayers - Reads a range of layers in parallel into independent layer readers.
+    *   The readers stay valid as long as this instance exists.
+    * @param[in] nFirstLayer - First layer index
+    * @param[in] nLayerCount - Number of layers
+    * @param[out] layerReaders - One layer reader per layer in the range
+    */
+    void ReadLayers(uint32_t nFirstLayer, uint32_t nLayerCount, std::vector<Lib3MF::PToolpathLayerReader> & layerReaders);
+
+    /**
+    * CToolpathParallelLayerReader::ProcessLayers - Reads a range of layers in parallel and passes each layer to a callback
+    *   on the worker that read it. Only one layer per worker is in memory at a time.
+    * @param[in] nFirstLayer - First layer index
+    * @param[in] nLayerCount - Number of layers
+    * @param[in] fnProcess - Callback, called concurrently from different workers
+    */
+    void ProcessLayers(uint32_t nFirstLayer, uint32_t nLayerCount, const LayerFunction & fnProcess);
+
+};
+
+typedef std::shared_ptr<CToolpathParallelLayerReader> PToolpathParallelLayerReader;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_PARALLELREADER
@@ -0,0 +1,978 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#include "ToolpathPolygonOffsetter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// Largest coordinate magnitude of input and offset polygons, keeps all cross products of doubled coordinates within
+// 64 bits
+#define OFFSETTER_MAXCOORDINATE (int64_t(1) << 29)
+
+// Polygon tasks per thread, balanced by vertex count
+#define OFFSETTER_TASKSPERTHREAD 4
+
+// Largest distance of a skipped vertex from the line through the vertices kept around it, in toolpath units
+#define OFFSETTER_NOISETOLERANCE 1.0
+
+// Corners closer to a straight line than this cosine are joined at the intersection of the offset edges
+#define OFFSETTER_STRAIGHTCOSINE 0.99
+
+namespace ToolpathExample {
+
+static int64_t offsetterCross(int64_t nAX, int64_t nAY, int64_t nBX, int64_t nBY)
+{
+    return nAX * nBY - nAY * nBX;
+}
+
+static bool offsetterLess(int64_t nAX, int64_t nAY, int64_t nBX, int64_t nBY)
+{
+    return (nAX < nBX) || ((nAX == nBX) && (nAY < nBY));
+}
+
+CToolpathContours::CToolpathContours()
+{
+    m_LoopStarts.push_back(0);
+}
+
+void CToolpathContours::Clear()
+{
+    m_Points.clear();
+    m_LoopStarts.clear();
+    m_LoopStarts.push_back(0);
+    m_LoopContours.clear();
+}
+
+void CToolpathContours::Write(Lib3MF::PToolpathLayerData pLayer, const std::vector<uint32_t> & contourProfileIDs, uint32_t nPartID) const
+{
+    if (pLayer.get() == nullptr)
+        throw std::invalid_argument("invalid toolpath layer");
+    if ((GetLoopCount() > 0) && contourProfileIDs.empty())
+        throw std::invalid_argument("missing contour profile");
+
+    for (size_t nLoopIndex = 0; nLoopIndex < GetLoopCount(); nLoopIndex++) {
+        uint32_t nStart = m_LoopStarts[nLoopIndex];
+        uint32_t nEnd = m_LoopStarts[nLoopIndex + 1];
+        uint32_t nProfileID = contourProfileIDs[std::min<size_t>(m_LoopContours[nLoopIndex], contourProfileIDs.size() - 1)];
+        pLayer->WriteLoopDiscrete(nProfileID, nPartID, Lib3MF::CInputVector<Lib3MF::sDiscretePosition2D>(m_Points.data() + nStart, nEnd - nStart));
+    }
+}
+
+CToolpathPolygonOffsetter::CToolpathPolygonOffsetter()
+    : m_Join(eToolpathOffsetJoin::Miter), m_dMiterLimit(2.0), m_dArcTolerance(1.0), m_bEvenOdd(false), m_nBandMinY(0), m_nBandHeight(1), m_nBandCount(0)
+{
+}
+
+void CToolpathPolygonOffsetter::SetThreadPool(PToolpathThreadPool pThreadPool)
+{
+    m_pThreadPool = pThreadPool;
+}
+
+void CToolpathPolygonOffsetter::SetJoin(eToolpathOffsetJoin join)
+{
+    if ((join != eToolpathOffsetJoin::Miter) && (join != eToolpathOffsetJoin::Round))
+        throw std::invalid_argument("invalid offset join");
+    m_Join = join;
+}
+
+void CToolpathPolygonOffsetter::SetMiterLimit(double dMiterLimit)
+{
+    if (!(dMiterLimit >= 1.0) || (dMiterLimit > 100.0))
+        throw std::invalid_argument("invalid miter limit");
+    m_dMiterLimit = dMiterLimit;
+}
+
+void CToolpathPolygonOffsetter::SetArcTolerance(double dArcTolerance)
+{
+    if (!(dArcTolerance > 0.0))
+        throw std::invalid_argument("invalid arc tolerance");
+    m_dArcTolerance = dArcTolerance;
+}
+
+void CToolpathPolygonOffsetter::parallelFor(uint64_t nTaskCount, const CToolpathThreadPool::TaskFunction & fnTask)
+{
+    if ((m_pThreadPool.get() != nullptr) && (nTaskCount > 1)) {
+        m_pThreadPool->ParallelFor(nTaskCount, fnTask);
+    }
+    else {
+        for (uint64_t nTaskIndex = 0; nTaskIndex < nTaskCount; nTaskIndex++)
+            fnTask(nTaskIndex, 0);
+    }
+}
+
+void CToolpathPolygonOffsetter::buildBands()
+{
+    int64_t nMinY = std::numeric_limits<int64_t>::max();
+    int64_t nMaxY = std::numeric_limits<int64_t>::min();
+    for (const sOffsetEdge & edge : m_Edges) {
+        nMinY = std::min(nMinY, std::min(edge.m_A.m_nY, edge.m_B.m_nY));
+        nMaxY = std::max(nMaxY, std::max(edge.m_A.m_nY, edge.m_B.m_nY));
+    }
+
+    // About as many bands as edges per band
+    int64_t nTargetBandCount = std::max<int64_t>(1, (int64_t)std::sqrt((double)m_Edges.size()));
+    m_nBandMinY = nMinY;
+    m_nBandHeight = std::max<int64_t>(1, (nMaxY - nMinY + nTargetBandCount) / nTargetBandCount);
+    m_nBandCount = (uint32_t)((nMaxY - nMinY) / m_nBandHeight + 1);
+
+    m_BandOffsets.assign((size_t)m_nBandCount + 1, 0);
+    for (const sOffsetEdge & edge : m_Edges) {
+        uint32_t nFirstBand = (uint32_t)((std::min(edge.m_A.m_nY, edge.m_B.m_nY) - m_nBandMinY) / m_nBandHeight);
+        uint32_t nLastBand = (uint32_t)((std::max(edge.m_A.m_nY, edge.m_B.m_nY) - m_nBandMinY) / m_nBandHeight);
+        for (uint32_t nBand = nFirstBand; nBand <= nLastBand; nBand++)
+            m_BandOffsets[nBand + 1]++;
+    }
+    for (uint32_t nBand = 0; nBand < m_nBandCount; nBand++) {
+        if ((uint64_t)m_BandOffsets[nBand] + m_BandOffsets[nBand + 1] > std::numeric_limits<uint32_t>::max())
+            throw std::range_error("too many offset edges");
+        m_BandOffsets[nBand + 1] += m_BandOffsets[nBand];
+    }
+
+    m_BandEdges.resize(m_BandOffsets[m_nBandCount]);
+    for (uint32_t nEdgeIndex = 0; nEdgeIndex < (uint32_t)m_Edges.size(); nEdgeIndex++) {
+        const sOffsetEdge & edge = m_Edges[nEdgeIndex];
+        uint32_t nFirstBand = (uint32_t)((std::min(edge.m_A.m_nY, edge.m_B.m_nY) - m_nBandMinY) / m_nBandHeight);
+        uint32_t nLastBand = (uint32_t)((std::max(edge.m_A.m_nY, edge.m_B.m_nY) - m_nBandMinY) / m_nBandHeight);
+        for (uint32_t nBand = nFirstBand; nBand <= nLastBand; nBand++)
+            m_BandEdges[m_BandOffsets[nBand]++] = nEdgeIndex;
+    }
+    for (uint32_t nBand = m_nBandCount; nBand > 0; nBand--)
+        m_BandOffsets[nBand] = m_BandOffsets[nBand - 1];
+    m_BandOffsets[0] = 0;
+}
+
+uint32_t CToolpathPolygonOffsetter::getBand(double dY) const
+{
+    double dBand = std::floor((dY - (double)m_nBandMinY) / (double)m_nBandHeight);
+    if (dBand < 0.0)
+        return 0;
+    if (dBand >= (double)m_nBandCount)
+        return m_nBandCount - 1;
+    return (uint32_t)dBand;
+}
+
+void CToolpathPolygonOffsetter::orientPolygons(const CToolpathSlicePolygons & source)
+{
+    const std::vector<Lib3MF::sDiscretePosition2D> & vertices = source.GetVertices();
+    uint32_t nPolygonCount = (uint32_t)source.GetPolygonCount();
+
+    m_Edges.clear();
+    m_EdgePolygons.clear();
+    for (uint32_t nPolygonIndex = 0; nPolygonIndex < nPolygonCount; nPolygonIndex++) {
+        uint32_t nStart = source.GetPolygonStart(nPolygonIndex);
+        uint32_t nSize = source.GetPolygonSize(nPolygonIndex);
+        for (uint32_t nIndex = 0; nIndex < nSize; nIndex++) {
+            const Lib3MF::sDiscretePosition2D & a = vertices[nStart + nIndex];
+            const Lib3MF::sDiscretePosition2D & b = vertices[nStart + (nIndex + 1) % nSize];
+            if ((std::abs((int64_t)a.m_Coordinates[0]) >= OFFSETTER_MAXCOORDINATE) || (std::abs((int64_t)a.m_Coordinates[1]) >= OFFSETTER_MAXCOORDINATE))
+                throw std::range_error("polygon coordinate exceeds the range of the offsetter");
+
+            sOffsetEdge edge;
+            edge.m_A = { a.m_Coordinates[0], a.m_Coordinates[1] };
+            edge.m_B = { b.m_Coordinates[0], b.m_Coordinates[1] };
+            m_Edges.push_back(edge);
+            m_EdgePolygons.push_back(nPolygonIndex);
+        }
+    }
+    m_PolygonReversed.assign(nPolygonCount, 0);
+    if (m_Edges.empty())
+        return;
+    buildBands();
+
+    // A polygon is a hole if its first vertex lies inside an odd number of other polygons. Polygons are turned so that
+    // the material lies on their left: outlines counterclockwise, holes clockwise.
+    uint64_t nTaskCount = (nPolygonCount + 63) / 64;
+    parallelFor(nTaskCount, [&](uint64_t nTaskIndex, uint32_t nWorkerIndex) {
+        (void)nWorkerIndex;
+        uint32_t nEnd = std::min<uint32_t>((uint32_t)(nTaskIndex + 1) * 64, nPolygonCount);
+        for (uint32_t nPolygonIndex = (uint32_t)nTaskIndex * 64; nPolygonIndex < nEnd; nPolygonIndex++) {
+            const Lib3MF::sDiscretePosition2D & point = vertices[source.GetPolygonStart(nPolygonIndex)];
+            int64_t nX = point.m_Coordinates[0];
+            int64_t nY = point.m_Coordinates[1];
+
+            uint32_t nBand = getBand((double)nY);
+            bool bHole = false;
+            for (uint32_t nIndex = m_BandOffsets[nBand]; nIndex < m_BandOffsets[nBand + 1]; nIndex++) {
+                uint32_t nEdgeIndex = m_BandEdges[nIndex];
+                if (m_EdgePolygons[nEdgeIndex] == nPolygonIndex)
+                    continue;
+
+                const sOffsetEdge & edge = m_Edges[nEdgeIndex];
+                if ((edge.m_A.m_nY > nY) != (edge.m_B.m_nY > nY)) {
+                    int64_t nCross = offsetterCross(edge.m_B.m_nX - edge.m_A.m_nX, edge.m_B.m_nY - edge.m_A.m_nY, nX - edge.m_A.m_nX, nY - edge.m_A.m_nY);
+                    if ((edge.m_B.m_nY > edge.m_A.m_nY) ? (nCross > 0) : (nCross < 0))
+                        bHole = !bHole;
+                }
+            }
+
+            int64_t nArea = source.GetSignedArea(nPolygonIndex);
+            if ((nArea == 0) && !m_bEvenOdd)
+                m_PolygonReversed[nPolygonIndex] = 2;
+            else
+                m_PolygonReversed[nPolygonIndex] = ((nArea > 0) == bHole) ? 1 : 0;
+        }
+    });
+}
+
+void CToolpathPolygonOffsetter::offsetPolygon(const Lib3MF::sDiscretePosition2D * pVertices, uint32_t nSize, bool bReversed, double dDelta, std::vector<uint32_t> & keptVertices, std::vector<sOffsetPoint> & points) const
+{
+    size_t nFirstPoint = points.size();
+    auto fnSourceVertex = [&](uint32_t nIndex) -> const Lib3MF::sDiscretePosition2D & {
+        nIndex %= nSize;
+        return pVertices[bReversed ? nSize - 1 - nIndex : nIndex];
+    };
+
+    // Short edges with rounded vertices change direction by many degrees, and their miters would zigzag far across
+    // the offset edges. A vertex is skipped while the directions from the last kept vertex that pass within the
+    // tolerance of all skipped vertices still include the next one.
+    keptVertices.clear();
+    keptVertices.push_back(0);
+    uint32_t nAnchor = 0;
+    while ((dDelta != 0.0) && (nAnchor < nSize)) {
+        const Lib3MF::sDiscretePosition2D & anchor = fnSourceVertex(nAnchor);
+        double dReferenceX = 0.0;
+        double dReferenceY = 0.0;
+        double dLowAngle = -1.5707963267948966;
+        double dHighAngle = 1.5707963267948966;
+        double dMaxDistance = 0.0;
+        uint32_t nLast = nAnchor + 1;
+        for (uint32_t nCandidate = nAnchor + 1; nCandidate <= nSize; nCandidate++) {
+            const Lib3MF::sDiscretePosition2D & candidate = fnSourceVertex(nCandidate);
+            double dX = (double)candidate.m_Coordinates[0] - (double)anchor.m_Coordinates[0];
+            double dY = (double)candidate.m_Coordinates[1] - (double)anchor.m_Coordinates[1];
+            double dDistance = std::sqrt(dX * dX + dY * dY);
+            if ((dMaxDistance <= OFFSETTER_NOISETOLERANCE) && (dDistance <= OFFSETTER_NOISETOLERANCE)) {
+                nLast = nCandidate;
+                continue;
+            }
+            if (dMaxDistance <= OFFSETTER_NOISETOLERANCE) {
+                dReferenceX = dX / dDistance;
+                dReferenceY = dY / dDistance;
+            }
+
+            double dAngle = std::atan2(dReferenceX * dY - dReferenceY * dX, dReferenceX * dX + dReferenceY * dY);
+            if ((dAngle < dLowAngle) || (dAngle > dHighAngle) || (dDistance < dMaxDistance - OFFSETTER_NOISETOLERANCE))
+                break;
+            nLast = nCandidate;
+            if (dDistance > OFFSETTER_NOISETOLERANCE) {
+                double dWidth = std::asin(OFFSETTER_NOISETOLERANCE / dDistance);
+                dLowAngle = std::max(dLowAngle, dAngle - dWidth);
+                dHighAngle = std::min(dHighAngle, dAngle + dWidth);
+            }
+            dMaxDistance = std::max(dMaxDistance, dDistance);
+        }
+        if (nLast >= nSize)
+            break;
+        keptVertices.push_back(nLast);
+        nAnchor = nLast;
+    }
+    if ((dDelta == 0.0) || (keptVertices.size() < 3)) {
+        keptVertices.resize(nSize);
+        for (uint32_t nIndex = 0; nIndex < nSize; nIndex++)
+            keptVertices[nIndex] = nIndex;
+    }
+    uint32_t nKeptCount = (uint32_t)keptVertices.size();
+    auto fnVertex = [&](uint32_t nIndex) -> const Lib3MF::sDiscretePosition2D & {
+        return fnSourceVertex(keptVertices[nIndex % nKeptCount]);
+    };
+    auto fnAddPoint = [&](double dX, double dY) {
+        double dRoundedX = std::round(dX);
+        double dRoundedY = std::round(dY);
+        if ((std::fabs(dRoundedX) >= (double)OFFSETTER_MAXCOORDINATE) || (std::fabs(dRoundedY) >= (double)OFFSETTER_MAXCOORDINATE))
+            throw std::range_error("offset coordinate exceeds the range of the offsetter");
+
+        sOffsetPoint point = { (int64_t)dRoundedX, (int64_t)dRoundedY };
+        if ((points.size() > nFirstPoint) && (points.back().m_nX == point.m_nX) && (points.back().m_nY == point.m_nY))
+            return;
+        points.push_back(point);
+    };
+
+    double dStepAngle = 0.0;
+    if (m_Join == eToolpathOffsetJoin::Round)
+        dStepAngle = (m_dArcTolerance < std::fabs(dDelta)) ? 2.0 * std::acos(1.0 - m_dArcTolerance / std::fabs(dDelta)) : 1.5707963267948966;
+
+    for (uint32_t nIndex = 0; nIndex < nKeptCount; nIndex++) {
+        const Lib3MF::sDiscretePosition2D & previous = fnVertex(nIndex + nKeptCount - 1);
+        const Lib3MF::sDiscretePosition2D & vertex = fnVertex(nIndex);
+        const Lib3MF::sDiscretePosition2D & next = fnVertex(nIndex + 1);
+        double dX = vertex.m_Coordinates[0];
+        double dY = vertex.m_Coordinates[1];
+        if (dDelta == 0.0) {
+            fnAddPoint(dX, dY);
+            continue;
+        }
+
+        int64_t nDX1 = (int64_t)vertex.m_Coordinates[0] - previous.m_Coordinates[0];
+        int64_t nDY1 = (int64_t)vertex.m_Coordinates[1] - previous.m_Coordinates[1];
+        int64_t nDX2 = (int64_t)next.m_Coordinates[0] - vertex.m_Coordinates[0];
+        int64_t nDY2 = (int64_t)next.m_Coordinates[1] - vertex.m_Coordinates[1];
+        double dLength1 = std::sqrt((double)(nDX1 * nDX1 + nDY1 * nDY1));
+        double dLength2 = std::sqrt((double)(nDX2 * nDX2 + nDY2 * nDY2));
+        if ((dLength1 == 0.0) || (dLength2 == 0.0))
+            continue;
+
+        // Left normals of the incoming and the outgoing edge
+        double dNormal1X = -nDY1 / dLength1;
+        double dNormal1Y = nDX1 / dLength1;
+        double dNormal2X = -nDY2 / dLength2;
+        double dNormal2Y = nDX2 / dLength2;
+        double dCos = dNormal1X * dNormal2X + dNormal1Y * dNormal2Y;
+        int64_t nCross = offsetterCross(nDX1, nDY1, nDX2, nDY2);
+        bool bOverlapping = (nCross != 0) && ((nCross > 0) == (dDelta > 0.0));
+        bool bStraight = (dCos > OFFSETTER_STRAIGHTCOSINE);
+        if (bStraight && bOverlapping) {
+            // Overlapping edges are only cut at their intersection if it lies within both of them
+            double dShift = std::fabs(dDelta) * std::sqrt((1.0 - dCos) / (1.0 + dCos));
+            bStraight = (2.0 * dShift <= std::min(dLength1, dLength2));
+        }
+        bool bMiter = bStraight || (!bOverlapping && (m_Join == eToolpathOffsetJoin::Miter) && ((1.0 + dCos) * m_dMiterLimit * m_dMiterLimit >= 2.0));
+
+        if (bMiter) {
+            double dScale = dDelta / (1.0 + dCos);
+            fnAddPoint(dX + (dNormal1X + dNormal2X) * dScale, dY + (dNormal1Y + dNormal2Y) * dScale);
+        }
+        else if (bOverlapping) {
+            // Going back through the vertex gives loops of negative winding, which the cleanup removes
+            fnAddPoint(dX + dNormal1X * dDelta, dY + dNormal1Y * dDelta);
+            fnAddPoint(dX, dY);
+            fnAddPoint(dX + dNormal2X * dDelta, dY + dNormal2Y * dDelta);
+        }
+        else if (m_Join == eToolpathOffsetJoin::Round) {
+            double dAngle = std::atan2(dNormal1X * dNormal2Y - dNormal1Y * dNormal2X, dCos);
+            uint32_t nStepCount = std::max<uint32_t>(1, (uint32_t)std::ceil(std::fabs(dAngle) / dStepAngle));
+            for (uint32_t nStep = 0; nStep <= nStepCount; nStep++) {
+                double dStepCos = std::cos(dAngle * nStep / nStepCount);
+                double dStepSin = std::sin(dAngle * nStep / nStepCount);
+                fnAddPoint(dX + (dNormal1X * dStepCos - dNormal1Y * dStepSin) * dDelta, dY + (dNormal1X * dStepSin + dNormal1Y * dStepCos) * dDelta);
+            }
+        }
+        else {
+            fnAddPoint(dX + dNormal1X * dDelta, dY + dNormal1Y * dDelta);
+            fnAddPoint(dX + dNormal2X * dDelta, dY + dNormal2Y * dDelta);
+        }
+    }
+
+    while ((points.size() > nFirstPoint + 1) && (points.back().m_nX == points[nFirstPoint].m_nX) && (points.back().m_nY == points[nFirstPoint].m_nY))
+        points.pop_back();
+    if (points.size() < nFirstPoint + 3)
+        points.resize(nFirstPoint);
+}
+
+void CToolpathPolygonOffsetter::buildRawEdges(const CToolpathSlicePolygons & source, int32_t nInset)
+{
+    const std::vector<Lib3MF::sDiscretePosition2D> & vertices = source.GetVertices();
+    uint32_t nPolygonCount = (uint32_t)source.GetPolygonCount();
+    uint32_t nThreadCount = (m_pThreadPool.get() != nullptr) ? m_pThreadPool->GetThreadCount() : 1;
+
+    // Tasks cover consecutive polygons with about the same number of vertices
+    uint32_t nTaskCount = std::max<uint32_t>(1, std::min<uint32_t>(nPolygonCount, nThreadCount * OFFSETTER_TASKSPERTHREAD));
+    m_TaskFirstPolygons.resize(nTaskCount + 1);
+    for (uint32_t nTaskIndex = 0; nTaskIndex <= nTaskCount; nTaskIndex++) {
+        uint64_t nFirstVertex = (uint64_t)vertices.size() * nTaskIndex / nTaskCount;
+        uint32_t nLow = 0;
+        uint32_t nHigh = nPolygonCount;
+        while (nLow < nHigh) {
+            uint32_t nMiddle = (nLow + nHigh) / 2;
+            if (source.GetPolygonStart(nMiddle) < nFirstVertex)
+                nLow = nMiddle + 1;
+            else
+                nHigh = nMiddle;
+        }
+        m_TaskFirstPolygons[nTaskIndex] = (nTaskIndex == nTaskCount) ? nPolygonCount : nLow;
+    }
+    if (m_TaskPoints.size() < nTaskCount) {
+        m_TaskKeptVertices.resize(nTaskCount);
+        m_TaskPoints.resize(nTaskCount);
+        m_TaskPolygonSizes.resize(nTaskCount);
+    }
+
+    parallelFor(nTaskCount, [&](uint64_t nTaskIndex, uint32_t nWorkerIndex) {
+        (void)nWorkerIndex;
+        std::vector<sOffsetPoint> & points = m_TaskPoints[(size_t)nTaskIndex];
+        std::vector<uint32_t> & polygonSizes = m_TaskPolygonSizes[(size_t)nTaskIndex];
+        points.clear();
+        polygonSizes.clear();
+        for (uint32_t nPolygonIndex = m_TaskFirstPolygons[(size_t)nTaskIndex]; nPolygonIndex < m_TaskFirstPolygons[(size_t)nTaskIndex + 1]; nPolygonIndex++) {
+            if (m_PolygonReversed[nPolygonIndex] > 1)
+                continue;
+            size_t nPointCount = points.size();
+            offsetPolygon(vertices.data() + source.GetPolygonStart(nPolygonIndex), source.GetPolygonSize(nPolygonIndex), m_PolygonReversed[nPolygonIndex] != 0, (double)nInset, m_TaskKeptVertices[(size_t)nTaskIndex], points);
+            if (points.size() > nPointCount)
+                polygonSizes.push_back((uint32_t)(points.size() - nPointCount));
+        }
+    });
+
+    m_Edges.clear();
+    for (uint32_t nTaskIndex = 0; nTaskIndex < nTaskCount; nTaskIndex++) {
+        const std::vector<sOffsetPoint> & points = m_TaskPoints[nTaskIndex];
+        size_t nStart = 0;
+        for (uint32_t nSize : m_TaskPolygonSizes[nTaskIndex]) {
+            for (uint32_t nIndex = 0; nIndex < nSize; nIndex++)
+                m_Edges.push_back({ points[nStart + nIndex], points[nStart + (nIndex + 1) % nSize] });
+            nStart += nSize;
+        }
+    }
+    if (m_Edges.size() >= (size_t)std::numeric_limits<uint32_t>::max())
+        throw std::range_error("too many offset edges");
+}
+
+void CToolpathPolygonOffsetter::findIntersections()
+{
+    if (m_BandIntersections.size() < m_nBandCount)
+        m_BandIntersections.resize(m_nBandCount);
+
+    parallelFor(m_nBandCount, [&](uint64_t nBandIndex, uint32_t nWorkerIndex) {
+        (void)nWorkerIndex;
+        uint32_t nBand = (uint32_t)nBandIndex;
+        std::vector<sOffsetPoint> & intersections = m_BandIntersections[nBand];
+        intersections.clear();
+
+        uint32_t * pBandEdges = m_BandEdges.data() + m_BandOffsets[nBand];
+        uint32_t nBandEdgeCount = m_BandOffsets[nBand + 1] - m_BandOffsets[nBand];
+        auto fnMinX = [&](uint32_t nEdgeIndex) { return std::min(m_Edges[nEdgeIndex].m_A.m_nX, m_Edges[nEdgeIndex].m_B.m_nX); };
+        auto fnFirstBand = [&](uint32_t nEdgeIndex) {
+            return (uint32_t)((std::min(m_Edges[nEdgeIndex].m_A.m_nY, m_Edges[nEdgeIndex].m_B.m_nY) - m_nBandMinY) / m_nBandHeight);
+        };
+        std::sort(pBandEdges, pBandEdges + nBandEdgeCount, [&](uint32_t nEdge1, uint32_t nEdge2) {
+            int64_t nMinX1 = fnMinX(nEdge1);
+            int64_t nMinX2 = fnMinX(nEdge2);
+            return (nMinX1 < nMinX2) || ((nMinX1 == nMinX2) && (nEdge1 < nEdge2));
+        });
+
+        // Only proper crossings are needed, endpoints are hot pixels anyway. Every pair is tested in all bands both
+        // edges share, the first of them records it.
+        for (uint32_t nIndex1 = 0; nIndex1 < nBandEdgeCount; nIndex1++) {
+            uint32_t nEdge1 = pBandEdges[nIndex1];
+            const sOffsetEdge & edge1 = m_Edges[nEdge1];
+            int64_t nMaxX1 = std::max(edge1.m_A.m_nX, edge1.m_B.m_nX);
+            int64_t nMinY1 = std::min(edge1.m_A.m_nY, edge1.m_B.m_nY);
+            int64_t nMaxY1 = std::max(edge1.m_A.m_nY, edge1.m_B.m_nY);
+            uint32_t nFirstBand1 = fnFirstBand(nEdge1);
+
+            for (uint32_t nIndex2 = nIndex1 + 1; nIndex2 < nBandEdgeCount; nIndex2++) {
+                uint32_t nEdge2 = pBandEdges[nIndex2];
+                const sOffsetEdge & edge2 = m_Edges[nEdge2];
+                if (fnMinX(nEdge2) > nMaxX1)
+                    break;
+                if ((std::max(edge2.m_A.m_nY, edge2.m_B.m_nY) < nMinY1) || (std::min(edge2.m_A.m_nY, edge2.m_B.m_nY) > nMaxY1))
+                    continue;
+                if (std::max(nFirstBand1, fnFirstBand(nEdge2)) != nBand)
+                    continue;
+
+                const sOffsetPoint & a = edge1.m_A;
+                const sOffsetPoint & b = edge1.m_B;
+                const sOffsetPoint & c = edge2.m_A;
+                const sOffsetPoint & d = edge2.m_B;
+                int64_t nSideC = offsetterCross(b.m_nX - a.m_nX, b.m_nY - a.m_nY, c.m_nX - a.m_nX, c.m_nY - a.m_nY);
+                int64_t nSideD = offsetterCross(b.m_nX - a.m_nX, b.m_nY - a.m_nY, d.m_nX - a.m_nX, d.m_nY - a.m_nY);
+                int64_t nSideA = offsetterCross(d.m_nX - c.m_nX, d.m_nY - c.m_nY, a.m_nX - c.m_nX, a.m_nY - c.m_nY);
+                int64_t nSideB = offsetterCross(d.m_nX - c.m_nX, d.m_nY - c.m_nY, b.m_nX - c.m_nX, b.m_nY - c.m_nY);
+
+                if ((((nSideC > 0) && (nSideD < 0)) || ((nSideC < 0) && (nSideD > 0))) && (((nSideA > 0) && (nSideB < 0)) || ((nSideA < 0) && (nSideB > 0)))) {
+                    double dT = (double)nSideA / ((double)nSideA - (double)nSideB);
+                    intersections.push_back({ (int64_t)std::llround(a.m_nX + dT * (b.m_nX - a.m_nX)), (int64_t)std::llround(a.m_nY + dT * (b.m_nY - a.m_nY)) });
+                }
+            }
+        }
+    });
+}
+
+void CToolpathPolygonOffsetter::collectHotPixels()
+{
+    // Hot pixels are the unit squares around all edge endpoints and rounded intersections, sorted into the bands of
+    // their centers. An edge passing through a hot pixel covers the Y coordinate of its center, so it is listed in
+    // that band.
+    auto fnBand = [&](const sOffsetPoint & point) { return (uint32_t)((point.m_nY - m_nBandMinY) / m_nBandHeight); };
+    m_BandHotPixelOffsets.assign((size_t)m_nBandCount + 1, 0);
+    for (const sOffsetEdge & edge : m_Edges)
+        m_BandHotPixelOffsets[fnBand(edge.m_A) + 1]++;
+    for (uint32_t nBand = 0; nBand < m_nBandCount; nBand++) {
+        for (const sOffsetPoint & point : m_BandIntersections[nBand])
+            m_BandHotPixelOffsets[fnBand(point) + 1]++;
+    }
+    for (uint32_t nBand = 0; nBand < m_nBandCount; nBand++)
+        m_BandHotPixelOffsets[nBand + 1] += m_BandHotPixelOffsets[nBand];
+
+    m_HotPixels.resize(m_BandHotPixelOffsets[m_nBandCount]);
+    for (const sOffsetEdge & edge : m_Edges)
+        m_HotPixels[m_BandHotPixelOffsets[fnBand(edge.m_A)]++] = edge.m_A;
+    for (uint32_t nBand = 0; nBand < m_nBandCount; nBand++) {
+        for (const sOffsetPoint & point : m_BandIntersections[nBand])
+            m_HotPixels[m_BandHotPixelOffsets[fnBand(point)]++] = point;
+    }
+    for (uint32_t nBand = m_nBandCount; nBand > 0; nBand--)
+        m_BandHotPixelOffsets[nBand] = m_BandHotPixelOffsets[nBand - 1];
+    m_BandHotPixelOffsets[0] = 0;
+
+    // Sorted by X within each band; duplicates are harmless and only skipped when snapping
+    parallelFor(m_nBandCount, [&](uint64_t nBandIndex, uint32_t nWorkerIndex) {
+        (void)nWorkerIndex;
+        std::sort(m_HotPixels.begin() + m_BandHotPixelOffsets[(size_t)nBandIndex], m_HotPixels.begin() + m_BandHotPixelOffsets[(size_t)nBandIndex + 1], [](const sOffsetPoint & point1, const sOffsetPoint & point2) {
+            return offsetterLess(point1.m_nX, point1.m_nY, point2.m_nX, point2.m_nY);
+        });
+    });
+}
+
+void CToolpathPolygonOffsetter::snapEdges()
+{
+    if (m_BandSplits.size() < m_nBandCount)
+        m_BandSplits.resize(m_nBandCount);
+
+    parallelFor(m_nBandCount, [&](uint64_t nBandIndex, uint32_t nWorkerIndex) {
+        (void)nWorkerIndex;
+        uint32_t nBand = (uint32_t)nBandIndex;
+        std::vector<sOffsetSplit> & splits = m_BandSplits[nBand];
+        splits.clear();
+        const sOffsetPoint * pBegin = m_HotPixels.data() + m_BandHotPixelOffsets[nBand];
+        const sOffsetPoint * pEnd = m_HotPixels.data() + m_BandHotPixelOffsets[nBand + 1];
+
+        for (uint32_t nIndex = m_BandOffsets[nBand]; nIndex < m_BandOffsets[nBand + 1]; nIndex++) {
+            uint32_t nEdgeIndex = m_BandEdges[nIndex];
+            const sOffsetEdge & edge = m_Edges[nEdgeIndex];
+            int64_t nDX = edge.m_B.m_nX - edge.m_A.m_nX;
+            int64_t nDY = edge.m_B.m_nY - edge.m_A.m_nY;
+            int64_t nMinX = std::min(edge.m_A.m_nX, edge.m_B.m_nX);
+            int64_t nMaxX = std::max(edge.m_A.m_nX, edge.m_B.m_nX);
+            int64_t nMinY = std::min(edge.m_A.m_nY, edge.m_B.m_nY);
+            int64_t nMaxY = std::max(edge.m_A.m_nY, edge.m_B.m_nY);
+            double dLengthSquared = (double)nDX * (double)nDX + (double)nDY * (double)nDY;
+
+            // Steep edges only pass pixels near the part of them within the band
+            if (nDY != 0) {
+                double dBandLowY = (double)(m_nBandMinY + (int64_t)nBand * m_nBandHeight) - 0.5;
+                double dBandHighY = dBandLowY + (double)m_nBandHeight;
+                double dLowT = std::max(0.0, std::min(1.0, (dBandLowY - (double)edge.m_A.m_nY) / (double)nDY));
+                double dHighT = std::max(0.0, std::min(1.0, (dBandHighY - (double)edge.m_A.m_nY) / (double)nDY));
+                double dLowX = (double)edge.m_A.m_nX + dLowT * (double)nDX;
+                double dHighX = (double)edge.m_A.m_nX + dHighT * (double)nDX;
+                nMinX = std::max(nMinX, (int64_t)std::floor(std::min(dLowX, dHighX)) - 1);
+                nMaxX = std::min(nMaxX, (int64_t)std::ceil(std::max(dLowX, dHighX)) + 1);
+            }
+
+            const sOffsetPoint * pPixel = std::lower_bound(pBegin, pEnd, nMinX, [](const sOffsetPoint & point, int64_t nX) { return point.m_nX < nX; });
+            const sOffsetPoint * pPrevious = nullptr;
+            for (; (pPixel < pEnd) && (pPixel->m_nX <= nMaxX); pPixel++) {
+                if ((pPixel->m_nY < nMinY) || (pPixel->m_nY > nMaxY))
+                    continue;
+                if ((pPrevious != nullptr) && (pPrevious->m_nX == pPixel->m_nX) && (pPrevious->m_nY == pPixel->m_nY))
+                    continue;
+                if (((pPixel->m_nX == edge.m_A.m_nX) && (pPixel->m_nY == edge.m_A.m_nY)) || ((pPixel->m_nX == edge.m_B.m_nX) && (pPixel->m_nY == edge.m_B.m_nY)))
+                    continue;
+
+                // The edge passes through the closed pixel unless all its corners lie strictly on one side, tested in
+                // doubled coordinates
+                bool bPositive = false;
+                bool bNegative = false;
+                for (int32_t nCorner = 0; nCorner < 4; nCorner++) {
+                    int64_t nCornerX = 2 * (pPixel->m_nX - edge.m_A.m_nX) + (((nCorner & 1) != 0) ? 1 : -1);
+                    int64_t nCornerY = 2 * (pPixel->m_nY - edge.m_A.m_nY) + (((nCorner & 2) != 0) ? 1 : -1);
+                    int64_t nSide = offsetterCross(nDX, nDY, nCornerX, nCornerY);
+                    bPositive = bPositive || (nSide >= 0);
+                    bNegative = bNegative || (nSide <= 0);
+                }
+                if (bPositive && bNegative) {
+                    double dT = ((double)(pPixel->m_nX - edge.m_A.m_nX) * (double)nDX + (double)(pPixel->m_nY - edge.m_A.m_nY) * (double)nDY) / dLengthSquared;
+                    splits.push_back({ nEdgeIndex, dT, *pPixel });
+                }
+                pPrevious = pPixel;
+            }
+        }
+    });
+}
+
+void CToolpathPolygonOffsetter::buildPieces()
+{
+    size_t nEdgeCount = m_Edges.size();
+    m_EdgeSplitOffsets.assign(nEdgeCount + 1, 0);
+    for (uint32_t nBand = 0; nBand < m_nBandCount; nBand++) {
+        for (const sOffsetSplit & split : m_BandSplits[nBand])
+            m_EdgeSplitOffsets[split.m_nEdgeIndex + 1]++;
+    }
+    for (size_t nEdgeIndex = 0; nEdgeIndex < nEdgeCount; nEdgeIndex++)
+        m_EdgeSplitOffsets[nEdgeIndex + 1] += m_EdgeSplitOffsets[nEdgeIndex];
+    m_Splits.resize(m_EdgeSplitOffsets[nEdgeCount]);
+    for (uint32_t nBand = 0; nBand < m_nBandCount; nBand++) {
+        for (const sOffsetSplit & split : m_BandSplits[nBand])
+            m_Splits[m_EdgeSplitOffsets[split.m_nEdgeIndex]++] = split;
+    }
+    for (size_t nEdgeIndex = nEdgeCount; nEdgeIndex > 0; nEdgeIndex--)
+        m_EdgeSplitOffsets[nEdgeIndex] = m_EdgeSplitOffsets[nEdgeIndex - 1];
+    m_EdgeSplitOffsets[0] = 0;
+
+    m_Pieces.clear();
+    for (size_t nEdgeIndex = 0; nEdgeIndex < nEdgeCount; nEdgeIndex++) {
+        const sOffsetEdge & edge = m_Edges[nEdgeIndex];
+        sOffsetSplit * pBegin = m_Splits.data() + m_EdgeSplitOffsets[nEdgeIndex];
+        sOffsetSplit * pEnd = m_Splits.data() + m_EdgeSplitOffsets[nEdgeIndex + 1];
+        std::sort(pBegin, pEnd, [](const sOffsetSplit & split1, const sOffsetSplit & split2) {
+            if (split1.m_dT != split2.m_dT)
+                return split1.m_dT < split2.m_dT;
+            return offsetterLess(split1.m_Point.m_nX, split1.m_Point.m_nY, split2.m_Point.m_nX, split2.m_Point.m_nY);
+        });
+
+        sOffsetPoint from = edge.m_A;
+        for (sOffsetSplit * pSplit = pBegin; pSplit <= pEnd; pSplit++) {
+            const sOffsetPoint & to = (pSplit < pEnd) ? pSplit->m_Point : edge.m_B;
+            if ((to.m_nX == from.m_nX) && (to.m_nY == from.m_nY))
+                continue;
+
+            bool bForward = offsetterLess(from.m_nX, from.m_nY, to.m_nX, to.m_nY);
+            sOffsetPiece piece;
+            piece.m_Low = bForward ? from : to;
+            piece.m_High = bForward ? to : from;
+            piece.m_nMultiplicity = bForward ? 1 : -1;
+            m_Pieces.push_back(piece);
+            from = to;
+        }
+    }
+
+    // Coincident pieces are merged, their multiplicities add up
+    std::sort(m_Pieces.begin(), m_Pieces.end(), [](const sOffsetPiece & piece1, const sOffsetPiece & piece2) {
+        if ((piece1.m_Low.m_nX != piece2.m_Low.m_nX) || (piece1.m_Low.m_nY != piece2.m_Low.m_nY))
+            return offsetterLess(piece1.m_Low.m_nX, piece1.m_Low.m_nY, piece2.m_Low.m_nX, piece2.m_Low.m_nY);
+        return offsetterLess(piece1.m_High.m_nX, piece1.m_High.m_nY, piece2.m_High.m_nX, piece2.m_High.m_nY);
+    });
+    size_t nUniqueCount = 0;
+    for (size_t nIndex = 0; nIndex < m_Pieces.size(); nIndex++) {
+        const sOffsetPiece & piece = m_Pieces[nIndex];
+        if ((nUniqueCount > 0) && (m_Pieces[nUniqueCount - 1].m_Low.m_nX == piece.m_Low.m_nX) && (m_Pieces[nUniqueCount - 1].m_Low.m_nY == piece.m_Low.m_nY)
+            && (m_Pieces[nUniqueCount - 1].m_High.m_nX == piece.m_High.m_nX) && (m_Pieces[nUniqueCount - 1].m_High.m_nY == piece.m_High.m_nY))
+            m_Pieces[nUniqueCount - 1].m_nMultiplicity += piece.m_nMultiplicity;
+        else
+            m_Pieces[nUniqueCount++] = piece;
+    }
+    m_Pieces.resize(nUniqueCount);
+    if (m_Pieces.size() >= (size_t)std::numeric_limits<uint32_t>::max())
+        throw std::range_error("too many offset pieces");
+
+    // The bands are rebuilt on the pieces for the winding numbers
+    m_Edges.resize(m_Pieces.size());
+    for (size_t nIndex = 0; nIndex < m_Pieces.size(); nIndex++)
+        m_Edges[nIndex] = { m_Pieces[nIndex].m_Low, m_Pieces[nIndex].m_High };
+    buildBands();
+}
+
+// Winding number right of a piece, counted along a ray towards +X from just above its midpoint in doubled coordinates.
+// Snapped pieces only meet at their ends, so no other piece passes through the midpoint.
+int32_t CToolpathPolygonOffsetter::rightWinding(uint32_t nPieceIndex) const
+{
+    const sOffsetPiece & piece = m_Pieces[nPieceIndex];
+    int64_t nMidX = piece.m_Low.m_nX + piece.m_High.m_nX;
+    int64_t nMidY = piece.m_Low.m_nY + piece.m_High.m_nY;
+    uint32_t nBand = getBand(0.5 * (double)nMidY);
+
+    int32_t nWinding = 0;
+    for (uint32_t nIndex = m_BandOffsets[nBand]; nIndex < m_BandOffsets[nBand + 1]; nIndex++) {
+        uint32_t nOtherIndex = m_BandEdges[nIndex];
+        const sOffsetPiece & other = m_Pieces[nOtherIndex];
+        bool bUpward = other.m_Low.m_nY < other.m_High.m_nY;
+        const sOffsetPoint & bottom = bUpward ? other.m_Low : other.m_High;
+        const sOffsetPoint & top = bUpward ? other.m_High : other.m_Low;
+        if ((nOtherIndex == nPieceIndex) || (2 * bottom.m_nY > nMidY) || (2 * top.m_nY <= nMidY))
+            continue;
+
+        if (offsetterCross(top.m_nX - bottom.m_nX, top.m_nY - bottom.m_nY, nMidX - 2 * bottom.m_nX, nMidY - 2 * bottom.m_nY) > 0)
+            nWinding += bUpward ? other.m_nMultiplicity : -other.m_nMultiplicity;
+    }
+
+    // The ray starts on the +X side of the piece, which is its right side if it runs upwards; above horizontal pieces,
+    // which is their left side
+    return (piece.m_High.m_nY > piece.m_Low.m_nY) ? nWinding : nWinding - piece.m_nMultiplicity;
+}
+
+void CToolpathPolygonOffsetter::classifyPieces()
+{
+    // Half edges are sorted by their start point and counterclockwise by direction. Between two consecutive half edges
+    // of a node lies one face, and passing a half edge counterclockwise adds its outward multiplicity.
+    uint32_t nPieceCount = (uint32_t)m_Pieces.size();
+    m_HalfEdges.resize(2 * (size_t)nPieceCount);
+    for (uint32_t nPieceIndex = 0; nPieceIndex < nPieceCount; nPieceIndex++) {
+        const sOffsetPiece & piece = m_Pieces[nPieceIndex];
+        sOffsetPoint direction = { piece.m_High.m_nX - piece.m_Low.m_nX, piece.m_High.m_nY - piece.m_Low.m_nY };
+        m_HalfEdges[2 * (size_t)nPieceIndex] = { piece.m_Low, direction, nPieceIndex, piece.m_nMultiplicity };
+        m_HalfEdges[2 * (size_t)nPieceIndex + 1] = { piece.m_High, { -direction.m_nX, -direction.m_nY }, nPieceIndex, -piece.m_nMultiplicity };
+    }
+    std::sort(m_HalfEdges.begin(), m_HalfEdges.end(), [](const sOffsetHalfEdge & halfEdge1, const sOffsetHalfEdge & halfEdge2) {
+        if ((halfEdge1.m_From.m_nX != halfEdge2.m_From.m_nX) || (halfEdge1.m_From.m_nY != halfEdge2.m_From.m_nY))
+            return offsetterLess(halfEdge1.m_From.m_nX, halfEdge1.m_From.m_nY, halfEdge2.m_From.m_nX, halfEdge2.m_From.m_nY);
+        const sOffsetPoint & direction1 = halfEdge1.m_Direction;
+        const sOffsetPoint & direction2 = halfEdge2.m_Direction;
+        bool bUpper1 = (direction1.m_nY > 0) || ((direction1.m_nY == 0) && (direction1.m_nX > 0));
+        bool bUpper2 = (direction2.m_nY > 0) || ((direction2.m_nY == 0) && (direction2.m_nX > 0));
+        if (bUpper1 != bUpper2)
+            return bUpper1;
+        return offsetterCross(direction1.m_nX, direction1.m_nY, direction2.m_nX, direction2.m_nY) > 0;
+    });
+
+    size_t nHalfEdgeCount = m_HalfEdges.size();
+    m_PieceHalfEdges.resize(nHalfEdgeCount);
+    m_NodeStarts.resize(nHalfEdgeCount + 1);
+    for (uint32_t nIndex = 0; nIndex < (uint32_t)nHalfEdgeCount; nIndex++) {
+        const sOffsetHalfEdge & halfEdge = m_HalfEdges[nIndex];
+        bool bAtLow = (halfEdge.m_From.m_nX == m_Pieces[halfEdge.m_nPieceIndex].m_Low.m_nX) && (halfEdge.m_From.m_nY == m_Pieces[halfEdge.m_nPieceIndex].m_Low.m_nY);
+        m_PieceHalfEdges[2 * (size_t)halfEdge.m_nPieceIndex + (bAtLow ? 0 : 1)] = nIndex;
+        bool bNewNode = (nIndex == 0) || (m_HalfEdges[nIndex - 1].m_From.m_nX != halfEdge.m_From.m_nX) || (m_HalfEdges[nIndex - 1].m_From.m_nY != halfEdge.m_From.m_nY);
+        m_NodeStarts[nIndex] = bNewNode ? nIndex : m_NodeStarts[nIndex - 1];
+    }
+    m_NodeStarts[nHalfEdgeCount] = (uint32_t)nHalfEdgeCount;
+
+    // The face left of a half edge has the winding number of the face right of its piece if it starts at the high
+    // end, and that plus the multiplicity if it starts at the low end
+    m_NodeDone.assign(nHalfEdgeCount, 0);
+    m_RightWindings.resize(nPieceCount);
+    m_NodeStack.clear();
+    auto fnLeftWinding = [&](uint32_t nHalfEdgeIndex, int32_t nRightWinding) {
+        const sOffsetHalfEdge & halfEdge = m_HalfEdges[nHalfEdgeIndex];
+        bool bAtLow = (m_PieceHalfEdges[2 * (size_t)halfEdge.m_nPieceIndex] == nHalfEdgeIndex);
+        return bAtLow ? nRightWinding + halfEdge.m_nOutMultiplicity : nRightWinding;
+    };
+
+    for (uint32_t nSeed = 0; nSeed < (uint32_t)nHalfEdgeCount; nSeed++) {
+        if (m_NodeDone[m_NodeStarts[nSeed]] != 0)
+            continue;
+
+        // One ray per connected component
+        m_NodeStack.push_back(std::make_pair(nSeed, fnLeftWinding(nSeed, rightWinding(m_HalfEdges[nSeed].m_nPieceIndex))));
+        while (!m_NodeStack.empty()) {
+            uint32_t nFirst = m_NodeStack.back().first;
+            int32_t nWinding = m_NodeStack.back().second;
+            m_NodeStack.pop_back();
+            uint32_t nNodeStart = m_NodeStarts[nFirst];
+            if (m_NodeDone[nNodeStart] != 0)
+                continue;
+            m_NodeDone[nNodeStart] = 1;
+
+            uint32_t nNodeEnd = nFirst + 1;
+            while ((nNodeEnd < (uint32_t)nHalfEdgeCount) && (m_NodeStarts[nNodeEnd] == nNodeStart))
+                nNodeEnd++;
+            uint32_t nNodeSize = nNodeEnd - nNodeStart;
+
+            for (uint32_t nStep = 0; nStep < nNodeSize; nStep++) {
+                uint32_t nIndex = nNodeStart + (nFirst - nNodeStart + nStep) % nNodeSize;
+                const sOffsetHalfEdge & halfEdge = m_HalfEdges[nIndex];
+                if (nStep > 0)
+                    nWinding += halfEdge.m_nOutMultiplicity;
+
+                uint32_t nPieceIndex = halfEdge.m_nPieceIndex;
+                bool bAtLow = (m_PieceHalfEdges[2 * (size_t)nPieceIndex] == nIndex);
+                int32_t nRightWinding = bAtLow ? nWinding - halfEdge.m_nOutMultiplicity : nWinding;
+                m_RightWindings[nPieceIndex] = nRightWinding;
+
+                uint32_t nTwin = m_PieceHalfEdges[2 * (size_t)nPieceIndex + (bAtLow ? 1 : 0)];
+                if (m_NodeDone[m_NodeStarts[nTwin]] == 0)
+                    m_NodeStack.push_back(std::make_pair(nTwin, fnLeftWinding(nTwin, nRightWinding)));
+            }
+        }
+    }
+
+    // A piece bounds the result if the winding number is inside on one side only: positive for offsets, odd when the
+    // input is only cleaned up. Pieces are kept with the result on their left.
+    m_PieceDirections.resize(nPieceCount);
+    for (uint32_t nPieceIndex = 0; nPieceIndex < nPieceCount; nPieceIndex++) {
+        int32_t nRightWinding = m_RightWindings[nPieceIndex];
+        int32_t nLeftWinding = nRightWinding + m_Pieces[nPieceIndex].m_nMultiplicity;
+        bool bRightInside = m_bEvenOdd ? ((nRightWinding & 1) != 0) : (nRightWinding > 0);
+        bool bLeftInside = m_bEvenOdd ? ((nLeftWinding & 1) != 0) : (nLeftWinding > 0);
+        m_PieceDirections[nPieceIndex] = (bLeftInside == bRightInside) ? 0 : (bLeftInside ? 1 : -1);
+    }
+}
+
+void CToolpathPolygonOffsetter::linkLoops(CToolpathSlicePolygons & target)
+{
+    m_Links.clear();
+    for (size_t nIndex = 0; nIndex < m_Pieces.size(); nIndex++) {
+        if (m_PieceDirections[nIndex] > 0)
+            m_Links.push_back({ m_Pieces[nIndex].m_Low, m_Pieces[nIndex].m_High });
+        else if (m_PieceDirections[nIndex] < 0)
+            m_Links.push_back({ m_Pieces[nIndex].m_High, m_Pieces[nIndex].m_Low });
+    }
+    std::sort(m_Links.begin(), m_Links.end(), [](const sOffsetLink & link1, const sOffsetLink & link2) {
+        if ((link1.m_From.m_nX != link2.m_From.m_nX) || (link1.m_From.m_nY != link2.m_From.m_nY))
+            return offsetterLess(link1.m_From.m_nX, link1.m_From.m_nY, link2.m_From.m_nX, link2.m_From.m_nY);
+        return offsetterLess(link1.m_To.m_nX, link1.m_To.m_nY, link2.m_To.m_nX, link2.m_To.m_nY);
+    });
+    m_LinkUsed.assign(m_Links.size(), 0);
+
+    for (size_t nFirstLink = 0; nFirstLink < m_Links.size(); nFirstLink++) {
+        if (m_LinkUsed[nFirstLink] != 0)
+            continue;
+
+        m_LoopPoints.clear();
+        const sOffsetPoint start = m_Links[nFirstLink].m_From;
+        size_t nLink = nFirstLink;
+        bool bClosed = false;
+        while (true) {
+            m_LinkUsed[nLink] = 1;
+            const sOffsetLink & link = m_Links[nLink];
+            m_LoopPoints.push_back(link.m_From);
+            if ((link.m_To.m_nX == start.m_nX) && (link.m_To.m_nY == start.m_nY)) {
+                bClosed = true;
+                break;
+            }
+
+            // Where several loops touch, continue with the leftmost turn so that the loops stay apart
+            auto iRange = std::lower_bound(m_Links.begin(), m_Links.end(), link.m_To, [](const sOffsetLink & other, const sOffsetPoint & point) {
+                return offsetterLess(other.m_From.m_nX, other.m_From.m_nY, point.m_nX, point.m_nY);
+            });
+            size_t nNextLink = m_Links.size();
+            double dBestAngle = 0.0;
+            double dInX = (double)(link.m_To.m_nX - link.m_From.m_nX);
+            double dInY = (double)(link.m_To.m_nY - link.m_From.m_nY);
+            for (size_t nCandidate = (size_t)(iRange - m_Links.begin()); nCandidate < m_Links.size(); nCandidate++) {
+                const sOffsetLink & candidate = m_Links[nCandidate];
+                if ((candidate.m_From.m_nX != link.m_To.m_nX) || (candidate.m_From.m_nY != link.m_To.m_nY))
+                    break;
+                if (m_LinkUsed[nCandidate] != 0)
+                    continue;
+
+                double dOutX = (double)(candidate.m_To.m_nX - candidate.m_From.m_nX);
+                double dOutY = (double)(candidate.m_To.m_nY - candidate.m_From.m_nY);
+                double dAngle = std::atan2(dInX * dOutY - dInY * dOutX, dInX * dOutX + dInY * dOutY);
+                if ((nNextLink == m_Links.size()) || (dAngle > dBestAngle)) {
+                    nNextLink = nCandidate;
+                    dBestAngle = dAngle;
+                }
+            }
+            if (nNextLink == m_Links.size())
+                break;
+            nLink = nNextLink;
+        }
+        if (!bClosed)
+            continue;
+
+        // Rounding intersections to integers leaves slivers less than a unit wide where many pieces meet
+        size_t nPointCount = m_LoopPoints.size();
+        double dDoubleArea = 0.0;
+        double dPerimeter = 0.0;
+        for (size_t nIndex = 0; nIndex < nPointCount; nIndex++) {
+            const sOffsetPoint & point = m_LoopPoints[nIndex];
+            const sOffsetPoint & next = m_LoopPoints[(nIndex + 1) % nPointCount];
+            dDoubleArea += (double)(point.m_nX - m_LoopPoints[0].m_nX) * (double)(next.m_nY - m_LoopPoints[0].m_nY) - (double)(point.m_nY - m_LoopPoints[0].m_nY) * (double)(next.m_nX - m_LoopPoints[0].m_nX);
+            dPerimeter += std::sqrt((double)((next.m_nX - point.m_nX) * (next.m_nX - point.m_nX) + (next.m_nY - point.m_nY) * (next.m_nY - point.m_nY)));
+        }
+        if (std::fabs(dDoubleArea) < dPerimeter)
+            continue;
+
+        // Points between collinear pieces are dropped
+        target.BeginPolygon();
+        for (size_t nIndex = 0; nIndex < nPointCount; nIndex++) {
+            const sOffsetPoint & previous = m_LoopPoints[(nIndex + nPointCount - 1) % nPointCount];
+            const sOffsetPoint & point = m_LoopPoints[nIndex];
+            const sOffsetPoint & next = m_LoopPoints[(nIndex + 1) % nPointCount];
+            int64_t nDX1 = point.m_nX - previous.m_nX;
+            int64_t nDY1 = point.m_nY - previous.m_nY;
+            int64_t nDX2 = next.m_nX - point.m_nX;
+            int64_t nDY2 = next.m_nY - point.m_nY;
+            if ((offsetterCross(nDX1, nDY1, nDX2, nDY2) == 0) && (nDX1 * nDX2 + nDY1 * nDY2 > 0))
+                continue;
+            target.AddVertex((int32_t)point.m_nX, (int32_t)point.m_nY);
+        }
+        target.EndPolygon();
+    }
+}
+
+void CToolpathPolygonOffsetter::offsetPolygons(const CToolpathSlicePolygons & source, int32_t nInset, CToolpathSlicePolygons & target)
+{
+    target.Clear();
+    if (source.GetPolygonCount() == 0)
+        return;
+
+    m_bEvenOdd = (nInset == 0);
+    orientPolygons(source);
+    buildRawEdges(source, nInset);
+    if (m_Edges.empty())
+        return;
+
+    buildBands();
+    findIntersections();
+    collectHotPixels();
+    snapEdges();
+    buildPieces();
+    classifyPieces();
+    linkLoops(target);
+}
+
+void CToolpathPolygonOffsetter::resolvePolygons(const CToolpathSlicePolygons & source)
+{
+    // Polygons are oriented by their signed area, which is only meaningful for simple polygons. Self-intersecting
+    // and crossing input is therefore resolved under the even-odd rule before it is offset.
+    offsetPolygons(source, 0, m_ResolvedPolygons);
+}
+
+void CToolpathPolygonOffsetter::Offset(const CToolpathSlicePolygons & source, int32_t nInset, CToolpathSlicePolygons & target)
+{
+    if (&source == &target)
+        throw std::invalid_argument("offset source and target must differ");
+    if ((int64_t)std::abs((int64_t)nInset) >= OFFSETTER_MAXCOORDINATE)
+        throw std::range_error("offset exceeds the range of the offsetter");
+
+    if (nInset == 0) {
+        offsetPolygons(source, 0, target);
+        return;
+    }
+
+    resolvePolygons(source);
+    offsetPolygons(m_ResolvedPolygons, nInset, target);
+}
+
+void CToolpathPolygonOffsetter::GenerateContours(const CToolpathSlicePolygons & source, const std::vector<int32_t> & insets, CToolpathContours & contours)
+{
+    for (int32_t nInset : insets) {
+        if ((int64_t)std::abs((int64_t)nInset) >= OFFSETTER_MAXCOORDINATE)
+            throw std::range_error("offset exceeds the range of the offsetter");
+    }
+
+    // The source is resolved once for all insets
+    contours.Clear();
+    if (insets.empty())
+        return;
+    resolvePolygons(source);
+
+    for (size_t nContourIndex = 0; nContourIndex < insets.size(); nContourIndex++) {
+        offsetPolygons(m_ResolvedPolygons, insets[nContourIndex], m_InsetPolygons);
+
+        const std::vector<Lib3MF::sDiscretePosition2D> & vertices = m_InsetPolygons.GetVertices();
+        for (size_t nPolygonIndex = 0; nPolygonIndex < m_InsetPolygons.GetPolygonCount(); nPolygonIndex++) {
+            auto iBegin = vertices.begin() + m_InsetPolygons.GetPolygonStart(nPolygonIndex);
+            auto iEnd = vertices.begin() + m_InsetPolygons.GetPolygonStart(nPolygonIndex + 1);
+            contours.m_Points.insert(contours.m_Points.end(), iBegin, iEnd);
+            contours.m_LoopStarts.push_back((uint32_t)contours.m_Points.size());
+            contours.m_LoopContours.push_back((uint32_t)nContourIndex);
+        }
+    }
+}
+
+} // namespace ToolpathExample
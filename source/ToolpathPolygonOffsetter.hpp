@@ -0,0 +1,277 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#ifndef __TOOLPATHEXAMPLE_POLYGONOFFSETTER
+#define __TOOLPATHEXAMPLE_POLYGONOFFSETTER
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+#include "ToolpathSlicePolygons.hpp"
+#include "ToolpathThreadPool.hpp"
+
+namespace ToolpathExample {
+
+/* Shape of offset corners on the side where the offset edges move apart. */
+enum class eToolpathOffsetJoin : uint8_t {
+    Miter = 0, /** Offset edges are extended to their intersection, cut off beyond the miter limit */
+    Round = 1 /** Circular arc around the original corner */
+};
+
+/*************************************************************************************************************************
+ Class CToolpathContours
+
+ Contour loops of a slice at several insets, in toolpath units. Loops of an inset follow the loops of the previous
+ inset; outlines run counterclockwise and holes clockwise. All buffers keep their capacity when the object is reused.
+**************************************************************************************************************************/
+class CToolpathContours {
+private:
+    std::vector<Lib3MF::sDiscretePosition2D> m_Points;
+    std::vector<uint32_t> m_LoopStarts;
+    std::vector<uint32_t> m_LoopContours;
+
+    friend class CToolpathPolygonOffsetter;
+
+public:
+
+    /**
+    * CToolpathContours::CToolpathContours - Creates an empty contour set.
+    */
+    CToolpathContours();
+
+    /**
+    * CToolpathContours::Clear - Removes all loops and keeps the storage.
+    */
+    void Clear();
+
+    size_t GetLoopCount() const { return m_LoopStarts.size() - 1; }
+    size_t GetPointCount() const { return m_Points.size(); }
+    const std::vector<Lib3MF::sDiscretePosition2D> & GetPoints() const { return m_Points; }
+
+    /**
+    * CToolpathContours::GetLoopStart - Returns the index of the first point of a loop.
+    * @param[in] nLoopIndex - Loop index, GetLoopCount() returns the point count
+    * @return Point index
+    */
+    uint32_t GetLoopStart(size_t nLoopIndex) const { return m_LoopStarts[nLoopIndex]; }
+
+    /**
+    * CToolpathContours::GetLoopContour - Returns the index of the inset a loop belongs to.
+    * @param[in] nLoopIndex - Loop index
+    * @return Index into the insets passed to CToolpathPolygonOffsetter::GenerateContours
+    */
+    uint32_t GetLoopContour(size_t nLoopIndex) const { return m_LoopContours[nLoopIndex]; }
+
+    /**
+    * CToolpathContours::Write - Writes every loop as loop segment, in order.
+    * @param[in] pLayer - Layer data to write to
+    * @param[in] contourProfileIDs - Profile ID of every inset, the last one is used for further insets
+    * @param[in] nPartID - Part ID as registered in the layer
+    */
+    void Write(Lib3MF::PToolpathLayerData pLayer, const std::vector<uint32_t> & contourProfileIDs, uint32_t nPartID) const;
+
+};
+
+/*************************************************************************************************************************
+ Class CToolpathPolygonOffsetter
+
+ Offsets slice polygons (even-odd rule) in integer coordinates. Every polygon is oriented with the material on its
+ left, vertices within half a unit of the line through their neighbours are skipped as rounding noise, and its
+ edges are moved by the offset; corners where the edges move apart get a miter or round join, corners
+ where they overlap are connected through the original vertex. The resulting raw polygons intersect themselves and
+ each other wherever the offset removes a feature, so they are cleaned up: intersections are found by a sweep within
+ horizontal bands and rounded to hot pixels, every edge is snapped to all hot pixels it passes through, and the pieces
+ that separate a positive winding number on their left from a non-positive one on their right are linked into the
+ result. Snap rounding keeps the pieces from crossing each other, so they form a planar graph: the winding number of
+ one piece per connected component is counted exactly along a ray, and the winding numbers of all other pieces follow
+ around the nodes. An offset of 0 only resolves self-intersections and overlaps of the input under the even-odd rule;
+ other offsets start from input resolved this way, so self-intersecting and crossing polygons are offset as the
+ regions they enclose under the even-odd rule.
+ Raw polygons, band sweeps and snapping are computed in parallel if a thread pool is set; the
+ result does not depend on the number of threads. Coordinates must stay below 2^29 in magnitude. Storage is kept
+ across calls.
+**************************************************************************************************************************/
+class CToolpathPolygonOffsetter {
+private:
+    typedef struct sOffsetPoint {
+        int64_t m_nX;
+        int64_t m_nY;
+    } sOffsetPoint;
+
+    typedef struct sOffsetEdge {
+        sOffsetPoint m_A;
+        sOffsetPoint m_B;
+    } sOffsetEdge;
+
+    typedef struct sOffsetSplit {
+        uint32_t m_nEdgeIndex;
+        double m_dT;
+        sOffsetPoint m_Point;
+    } sOffsetSplit;
+
+    // Piece of a snapped edge between hot pixels, from the lower to the higher point. m_nMultiplicity counts
+    // coincident pieces in that direction minus those in the opposite direction.
+    typedef struct sOffsetPiece {
+        sOffsetPoint m_Low;
+        sOffsetPoint m_High;
+        int32_t m_nMultiplicity;
+    } sOffsetPiece;
+
+    // Piece seen from one of its ends, m_nOutMultiplicity counts it in the direction away from that end
+    typedef struct sOffsetHalfEdge {
+        sOffsetPoint m_From;
+        sOffsetPoint m_Direction;
+        uint32_t m_nPieceIndex;
+        int32_t m_nOutMultiplicity;
+    } sOffsetHalfEdge;
+
+    typedef struct sOffsetLink {
+        sOffsetPoint m_From;
+        sOffsetPoint m_To;
+    } sOffsetLink;
+
+    PToolpathThreadPool m_pThreadPool;
+    eToolpathOffsetJoin m_Join;
+    double m_dMiterLimit;
+    double m_dArcTolerance;
+    bool m_bEvenOdd;
+
+    // Edges sorted into horizontal bands, an edge is listed in every band its Y range touches
+    std::vector<sOffsetEdge> m_Edges;
+    std::vector<uint32_t> m_EdgePolygons;
+    std::vector<uint32_t> m_BandOffsets;
+    std::vector<uint32_t> m_BandEdges;
+    int64_t m_nBandMinY;
+    int64_t m_nBandHeight;
+    uint32_t m_nBandCount;
+
+    std::vector<uint8_t> m_PolygonReversed;
+    std::vector<uint32_t> m_TaskFirstPolygons;
+    std::vector<std::vector<uint32_t>> m_TaskKeptVertices;
+    std::vector<std::vector<sOffsetPoint>> m_TaskPoints;
+    std::vector<std::vector<uint32_t>> m_TaskPolygonSizes;
+    std::vector<std::vector<sOffsetPoint>> m_BandIntersections;
+    std::vector<sOffsetPoint> m_HotPixels;
+    std::vector<uint32_t> m_BandHotPixelOffsets;
+    std::vector<std::vector<sOffsetSplit>> m_BandSplits;
+    std::vector<uint32_t> m_EdgeSplitOffsets;
+    std::vector<sOffsetSplit> m_Splits;
+    std::vector<sOffsetPiece> m_Pieces;
+    std::vector<sOffsetHalfEdge> m_HalfEdges;
+    std::vector<uint32_t> m_PieceHalfEdges;
+    std::vector<uint32_t> m_NodeStarts;
+    std::vector<uint8_t> m_NodeDone;
+    std::vector<int32_t> m_RightWindings;
+    std::vector<std::pair<uint32_t, int32_t>> m_NodeStack;
+    std::vector<int8_t> m_PieceDirections;
+    std::vector<sOffsetLink> m_Links;
+    std::vector<uint8_t> m_LinkUsed;
+    std::vector<sOffsetPoint> m_LoopPoints;
+    CToolpathSlicePolygons m_ResolvedPolygons;
+    CToolpathSlicePolygons m_InsetPolygons;
+
+    void parallelFor(uint64_t nTaskCount, const CToolpathThreadPool::TaskFunction & fnTask);
+    void buildBands();
+    uint32_t getBand(double dY) const;
+    int32_t rightWinding(uint32_t nPieceIndex) const;
+    void orientPolygons(const CToolpathSlicePolygons & source);
+    void offsetPolygon(const Lib3MF::sDiscretePosition2D * pVertices, uint32_t nSize, bool bReversed, double dDelta, std::vector<uint32_t> & keptVertices, std::vector<sOffsetPoint> & points) const;
+    void buildRawEdges(const CToolpathSlicePolygons & source, int32_t nInset);
+    void findIntersections();
+    void collectHotPixels();
+    void snapEdges();
+    void buildPieces();
+    void classifyPieces();
+    void linkLoops(CToolpathSlicePolygons & target);
+    void offsetPolygons(const CToolpathSlicePolygons & source, int32_t nInset, CToolpathSlicePolygons & target);
+    void resolvePolygons(const CToolpathSlicePolygons & source);
+
+public:
+
+    /**
+    * CToolpathPolygonOffsetter::CToolpathPolygonOffsetter - Creates an offsetter with miter joins up to twice the offset.
+    */
+    CToolpathPolygonOffsetter();
+
+    /**
+    * CToolpathPolygonOffsetter::SetThreadPool - Sets the pool the stages of an offset are run on.
+    * @param[in] pThreadPool - Thread pool, nullptr runs on the calling thread
+    */
+    void SetThreadPool(PToolpathThreadPool pThreadPool);
+
+    /**
+    * CToolpathPolygonOffsetter::SetJoin - Sets the shape of corners where offset edges move apart.
+    * @param[in] join - Miter or round join
+    */
+    void SetJoin(eToolpathOffsetJoin join);
+
+    /**
+    * CToolpathPolygonOffsetter::SetMiterLimit - Sets the longest miter, relative to the offset distance. Longer miters
+    *   are cut off flat.
+    * @param[in] dMiterLimit - Miter limit, at least 1
+    */
+    void SetMiterLimit(double dMiterLimit);
+
+    /**
+    * CToolpathPolygonOffsetter::SetArcTolerance - Sets the largest distance between round joins and the exact arc.
+    * @param[in] dArcTolerance - Tolerance in toolpath units, greater than 0
+    */
+    void SetArcTolerance(double dArcTolerance);
+
+    /**
+    * CToolpathPolygonOffsetter::Offset - Offsets polygons and removes all self-intersections.
+    * @param[in] source - Polygons in toolpath units, even-odd rule
+    * @param[in] nInset - Distance towards the material in toolpath units, negative values grow the polygons
+    * @param[out] target - Cleared and filled with the offset polygons, outlines counterclockwise and holes clockwise
+    */
+    void Offset(const CToolpathSlicePolygons & source, int32_t nInset, CToolpathSlicePolygons & target);
+
+    /**
+    * CToolpathPolygonOffsetter::GenerateContours - Offsets polygons by several insets, each from the source.
+    * @param[in] source - Polygons in toolpath units, even-odd rule
+    * @param[in] insets - Distances towards the material in toolpath units, usually increasing
+    * @param[out] contours - Cleared and filled with the loops of all insets, in the order of the insets
+    */
+    void GenerateContours(const CToolpathSlicePolygons & source, const std::vector<int32_t> & insets, CToolpathContours & contours);
+
+};
+
+typedef std::shared_ptr<CToolpathPolygonOffsetter> PToolpathPolygonOffsetter;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_POLYGONOFFSETTER
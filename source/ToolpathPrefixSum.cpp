@@ -0,0 +1,249 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathPrefixSum.hpp"
+
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PREFIXSUM_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PREFIXSUM_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PREFIXSUM_NEON
+#endif
+
+namespace ToolpathExample {
+
+void toolpathPrefixSumScalar(uint32_t * pValues, size_t nCount, size_t nStride)
+{
+    if ((pValues == nullptr) && (nCount > 0))
+        throw std::invalid_argument("invalid prefix sum values");
+    if (nStride == 0)
+        throw std::invalid_argument("invalid prefix sum stride");
+
+    for (size_t nIndex = nStride; nIndex < nCount; nIndex++)
+        pValues[nIndex] += pValues[nIndex - nStride];
+}
+
+// Every vector block is summed within the register in log2(lanes / stride) shifted additions, then the running
+// total of the previous block (per stride phase) is added. The remaining tail continues from that total.
+
+#if defined(PREFIXSUM_AVX2)
+
+static size_t prefixSumVector(uint32_t * pValues, size_t nCount, size_t nStride)
+{
+    __m256i carry = _mm256_setzero_si256();
+    size_t nIndex = 0;
+
+    if (nStride == 1) {
+        const __m256i lastLane = _mm256_set1_epi32(7);
+        for (; nIndex + 8 <= nCount; nIndex += 8) {
+            __m256i values = _mm256_loadu_si256((const __m256i *)(pValues + nIndex));
+            values = _mm256_add_epi32(values, _mm256_slli_si256(values, 4));
+            values = _mm256_add_epi32(values, _mm256_slli_si256(values, 8));
+            // Carry the total of the lower 128 bit lane into the upper one
+            __m256i lowTotal = _mm256_shuffle_epi32(values, 0xff);
+            values = _mm256_add_epi32(values, _mm256_permute2x128_si256(lowTotal, lowTotal, 0x08));
+            values = _mm256_add_epi32(values, carry);
+            _mm256_storeu_si256((__m256i *)(pValues + nIndex), values);
+            carry = _mm256_permutevar8x32_epi32(values, lastLane);
+        }
+    }
+    else {
+        const __m256i lastLanes = _mm256_setr_epi32(6, 7, 6, 7, 6, 7, 6, 7);
+        for (; nIndex + 8 <= nCount; nIndex += 8) {
+            __m256i values = _mm256_loadu_si256((const __m256i *)(pValues + nIndex));
+            values = _mm256_add_epi32(values, _mm256_slli_si256(values, 8));
+            __m256i lowTotal = _mm256_shuffle_epi32(values, 0xee);
+            values = _mm256_add_epi32(values, _mm256_permute2x128_si256(lowTotal, lowTotal, 0x08));
+            values = _mm256_add_epi32(values, carry);
+            _mm256_storeu_si256((__m256i *)(pValues + nIndex), values);
+            carry = _mm256_permutevar8x32_epi32(values, lastLanes);
+        }
+    }
+
+    return nIndex;
+}
+
+static size_t unzigzagVector(uint32_t * pValues, size_t nCount)
+{
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i zero = _mm256_setzero_si256();
+    size_t nIndex = 0;
+    for (; nIndex + 8 <= nCount; nIndex += 8) {
+        __m256i values = _mm256_loadu_si256((const __m256i *)(pValues + nIndex));
+        __m256i sign = _mm256_sub_epi32(zero, _mm256_and_si256(values, one));
+        _mm256_storeu_si256((__m256i *)(pValues + nIndex), _mm256_xor_si256(_mm256_srli_epi32(values, 1), sign));
+    }
+    return nIndex;
+}
+
+#elif defined(PREFIXSUM_SSE2)
+
+static size_t prefixSumVector(uint32_t * pValues, size_t nCount, size_t nStride)
+{
+    __m128i carry = _mm_setzero_si128();
+    size_t nIndex = 0;
+
+    if (nStride == 1) {
+        for (; nIndex + 4 <= nCount; nIndex += 4) {
+            __m128i values = _mm_loadu_si128((const __m128i *)(pValues + nIndex));
+            values = _mm_add_epi32(values, _mm_slli_si128(values, 4));
+            values = _mm_add_epi32(values, _mm_slli_si128(values, 8));
+            values = _mm_add_epi32(values, carry);
+            _mm_storeu_si128((__m128i *)(pValues + nIndex), values);
+            carry = _mm_shuffle_epi32(values, 0xff);
+        }
+    }
+    else {
+        for (; nIndex + 4 <= nCount; nIndex += 4) {
+            __m128i values = _mm_loadu_si128((const __m128i *)(pValues + nIndex));
+            values = _mm_add_epi32(values, _mm_slli_si128(values, 8));
+            values = _mm_add_epi32(values, carry);
+            _mm_storeu_si128((__m128i *)(pValues + nIndex), values);
+            carry = _mm_shuffle_epi32(values, 0xee);
+        }
+    }
+
+    return nIndex;
+}
+
+static size_t unzigzagVector(uint32_t * pValues, size_t nCount)
+{
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i zero = _mm_setzero_si128();
+    size_t nIndex = 0;
+    for (; nIndex + 4 <= nCount; nIndex += 4) {
+        __m128i values = _mm_loadu_si128((const __m128i *)(pValues + nIndex));
+        __m128i sign = _mm_sub_epi32(zero, _mm_and_si128(values, one));
+        _mm_storeu_si128((__m128i *)(pValues + nIndex), _mm_xor_si128(_mm_srli_epi32(values, 1), sign));
+    }
+    return nIndex;
+}
+
+#elif defined(PREFIXSUM_NEON)
+
+static size_t prefixSumVector(uint32_t * pValues, size_t nCount, size_t nStride)
+{
+    const uint32x4_t zero = vdupq_n_u32(0);
+    uint32x4_t carry = zero;
+    size_t nIndex = 0;
+
+    if (nStride == 1) {
+        for (; nIndex + 4 <= nCount; nIndex += 4) {
+            uint32x4_t values = vld1q_u32(pValues + nIndex);
+            values = vaddq_u32(values, vextq_u32(zero, values, 3));
+            values = vaddq_u32(values, vextq_u32(zero, values, 2));
+            values = vaddq_u32(values, carry);
+            vst1q_u32(pValues + nIndex, values);
+            carry = vdupq_n_u32(vgetq_lane_u32(values, 3));
+        }
+    }
+    else {
+        for (; nIndex + 4 <= nCount; nIndex += 4) {
+            uint32x4_t values = vld1q_u32(pValues + nIndex);
+            values = vaddq_u32(values, vextq_u32(zero, values, 2));
+            values = vaddq_u32(values, carry);
+            vst1q_u32(pValues + nIndex, values);
+            carry = vcombine_u32(vget_high_u32(values), vget_high_u32(values));
+        }
+    }
+
+    return nIndex;
+}
+
+static size_t unzigzagVector(uint32_t * pValues, size_t nCount)
+{
+    const uint32x4_t one = vdupq_n_u32(1);
+    size_t nIndex = 0;
+    for (; nIndex + 4 <= nCount; nIndex += 4) {
+        uint32x4_t values = vld1q_u32(pValues + nIndex);
+        uint32x4_t sign = vreinterpretq_u32_s32(vnegq_s32(vreinterpretq_s32_u32(vandq_u32(values, one))));
+        vst1q_u32(pValues + nIndex, veorq_u32(vshrq_n_u32(values, 1), sign));
+    }
+    return nIndex;
+}
+
+#else
+
+static size_t prefixSumVector(uint32_t * pValues, size_t nCount, size_t nStride)
+{
+    return 0;
+}
+
+static size_t unzigzagVector(uint32_t * pValues, size_t nCount)
+{
+    return 0;
+}
+
+#endif
+
+void toolpathPrefixSum(uint32_t * pValues, size_t nCount, size_t nStride)
+{
+    if ((pValues == nullptr) && (nCount > 0))
+        throw std::invalid_argument("invalid prefix sum values");
+    if ((nStride == 0) || (nStride > 2)) {
+        toolpathPrefixSumScalar(pValues, nCount, nStride);
+        return;
+    }
+
+    size_t nIndex = prefixSumVector(pValues, nCount, nStride);
+    for (nIndex = (nIndex < nStride) ? nStride : nIndex; nIndex < nCount; nIndex++)
+        pValues[nIndex] += pValues[nIndex - nStride];
+}
+
+void toolpathUnzigzag(uint32_t * pValues, size_t nCount)
+{
+    if ((pValues == nullptr) && (nCount > 0))
+        throw std::invalid_argument("invalid zigzag values");
+
+    for (size_t nIndex = unzigzagVector(pValues, nCount); nIndex < nCount; nIndex++)
+        pValues[nIndex] = (pValues[nIndex] >> 1) ^ (0 - (pValues[nIndex] & 1));
+}
+
+const char * toolpathPrefixSumImplementation()
+{
+#if defined(PREFIXSUM_AVX2)
+    return "AVX2";
+#elif defined(PREFIXSUM_SSE2)
+    return "SSE2";
+#elif defined(PREFIXSUM_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace ToolpathExample
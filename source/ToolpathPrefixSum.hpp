@@ -0,0 +1,73 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+#ifndef __TOOLPATHEXAMPLE_PREFIXSUM
+#define __TOOLPATHEXAMPLE_PREFIXSUM
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ToolpathExample {
+
+/**
+* toolpathPrefixSum - Replaces every value by the sum of itself and all preceding values of the same stride, wrapping
+*   around at 32 bits. Uses AVX2, SSE2 or NEON where the compiler targets them.
+* @param[in,out] pValues - Values
+* @param[in] nCount - Number of values
+* @param[in] nStride - Distance of summed values, 1 or 2
+*/
+void toolpathPrefixSum(uint32_t * pValues, size_t nCount, size_t nStride);
+
+/**
+* toolpathPrefixSumScalar - Computes the same as toolpathPrefixSum without vector instructions.
+* @param[in,out] pValues - Values
+* @param[in] nCount - Number of values
+* @param[in] nStride - Distance of summed values
+*/
+void toolpathPrefixSumScalar(uint32_t * pValues, size_t nCount, size_t nStride);
+
+/**
+* toolpathUnzigzag - Maps zigzag encoded values (0, 1, 2, 3, ...) back to signed values (0, -1, 1, -2, ...).
+* @param[in,out] pValues - Values
+* @param[in] nCount - Number of values
+*/
+void toolpathUnzigzag(uint32_t * pValues, size_t nCount);
+
+/**
+* toolpathPrefixSumImplementation - Returns the instruction set used by toolpathPrefixSum.
+* @return "AVX2", "SSE2", "NEON" or "scalar"
+*/
+const char * toolpathPrefixSumImplementation();
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_PREFIXSUM
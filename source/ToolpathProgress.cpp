@@ -0,0 +1,109 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathProgress.hpp"
+
+namespace ToolpathExample {
+
+CToolpathProgress::CToolpathProgress(const ProgressFunction & fnProgress)
+    : m_fnProgress(fnProgress), m_bCancelled(false)
+{
+}
+
+bool CToolpathProgress::ReportEvent(const sToolpathProgressEvent & event)
+{
+    if (m_fnProgress) {
+        std::lock_guard<std::mutex> lock(m_CallbackMutex);
+        if (!m_fnProgress(event))
+            m_bCancelled.store(true);
+    }
+
+    return !m_bCancelled.load();
+}
+
+bool CToolpathProgress::ReportLayer(eToolpathProgressStage stage, uint32_t nLayerIndex, uint32_t nLayerCount, uint64_t nBytes, uint64_t nSegmentCount)
+{
+    sToolpathProgressEvent event;
+    event.m_Stage = stage;
+    event.m_nIndex = nLayerIndex;
+    event.m_nCount = nLayerCount;
+    event.m_nBytes = nBytes;
+    event.m_nSegmentCount = nSegmentCount;
+    event.m_dProgress = (nLayerCount > 0) ? (double)(nLayerIndex + 1) / (double)nLayerCount : 0.0;
+    event.m_Lib3MFIdentifier = Lib3MF::eProgressIdentifier::QUERYCANCELED;
+
+    return ReportEvent(event);
+}
+
+void CToolpathProgress::Cancel()
+{
+    m_bCancelled.store(true);
+}
+
+bool CToolpathProgress::IsCancelled() const
+{
+    return m_bCancelled.load();
+}
+
+void CToolpathProgress::CheckCancelled() const
+{
+    if (m_bCancelled.load())
+        throw EToolpathCancelled();
+}
+
+void CToolpathProgress::Lib3MFProgressCallback(bool * pAbort, Lib3MF_double dProgress, Lib3MF::eProgressIdentifier eIdentifier, Lib3MF_pvoid pUserData)
+{
+    CToolpathProgress * pProgress = (CToolpathProgress *)pUserData;
+    if (pProgress == nullptr)
+        return;
+
+    bool bContinue = true;
+    if (eIdentifier == Lib3MF::eProgressIdentifier::QUERYCANCELED) {
+        // Pure cancellation polls are not forwarded to keep the overhead low.
+        bContinue = !pProgress->IsCancelled();
+    }
+    else {
+        sToolpathProgressEvent event;
+        event.m_Stage = eToolpathProgressStage::Lib3MF;
+        event.m_nIndex = 0;
+        event.m_nCount = 0;
+        event.m_nBytes = 0;
+        event.m_nSegmentCount = 0;
+        event.m_dProgress = dProgress;
+        event.m_Lib3MFIdentifier = eIdentifier;
+        bContinue = pProgress->ReportEvent(event);
+    }
+
+    if (pAbort != nullptr)
+        *pAbort = !bContinue;
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,143 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef __TOOLPATHEXAMPLE_PROGRESS
+#define __TOOLPATHEXAMPLE_PROGRESS
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#include "lib3mf_dynamic.hpp"
+
+namespace ToolpathExample {
+
+enum class eToolpathProgressStage : int32_t {
+    ReadLayer = 0, /** A toolpath layer has been read */
+    WriteLayer = 1, /** A toolpath layer has been written */
+    WritePackageEntry = 2, /** A package entry has been written */
+    Lib3MF = 3 /** Coarse progress reported by a lib3mf reader or writer */
+};
+
+/* Progress event. Layer and entry events are fired at most once per layer or entry. */
+typedef struct sToolpathProgressEvent {
+    eToolpathProgressStage m_Stage;
+    uint32_t m_nIndex; /** Layer or entry index */
+    uint32_t m_nCount; /** Total number of layers or entries, 0 if unknown */
+    uint64_t m_nBytes; /** Size of the layer or entry, the segment data passed to lib3mf for written layers */
+    uint64_t m_nSegmentCount; /** Number of segments of the layer, 0 for entries */
+    double m_dProgress; /** lib3mf progress between 0 and 1, only for lib3mf events */
+    Lib3MF::eProgressIdentifier m_Lib3MFIdentifier; /** lib3mf stage, only for lib3mf events */
+} sToolpathProgressEvent;
+
+/* Thrown by helpers that have been cancelled through a CToolpathProgress instance. */
+class EToolpathCancelled : public std::runtime_error {
+public:
+    EToolpathCancelled()
+        : std::runtime_error("toolpath operation has been cancelled")
+    {
+    }
+};
+
+/*************************************************************************************************************************
+ Class CToolpathProgress
+
+ Forwards progress events to a callback and carries a cancellation flag. Events may come from several worker
+ threads, the callback is never called concurrently.
+**************************************************************************************************************************/
+class CToolpathProgress {
+public:
+    /* Returns false to cancel the operation. */
+    typedef std::function<bool(const sToolpathProgressEvent & event)> ProgressFunction;
+
+private:
+    ProgressFunction m_fnProgress;
+    std::mutex m_CallbackMutex;
+    std::atomic<bool> m_bCancelled;
+
+public:
+
+    /**
+    * CToolpathProgress::CToolpathProgress - Creates a progress instance.
+    * @param[in] fnProgress - Callback, may be empty if only cancellation is needed
+    */
+    explicit CToolpathProgress(const ProgressFunction & fnProgress = ProgressFunction());
+
+    /**
+    * CToolpathProgress::ReportEvent - Passes an event to the callback.
+    * @param[in] event - Progress event
+    * @return false if the operation has been cancelled
+    */
+    bool ReportEvent(const sToolpathProgressEvent & event);
+
+    /**
+    * CToolpathProgress::ReportLayer - Convenience function for layer events.
+    * @param[in] stage - ReadLayer or WriteLayer
+    * @param[in] nLayerIndex - Layer index
+    * @param[in] nLayerCount - Total number of layers, 0 if unknown
+    * @param[in] nBytes - Size of the layer part
+    * @param[in] nSegmentCount - Number of segments of the layer
+    * @return false if the operation has been cancelled
+    */
+    bool ReportLayer(eToolpathProgressStage stage, uint32_t nLayerIndex, uint32_t nLayerCount, uint64_t nBytes, uint64_t nSegmentCount);
+
+    /**
+    * CToolpathProgress::Cancel - Requests cancellation. Can be called from any thread.
+    */
+    void Cancel();
+
+    /**
+    * CToolpathProgress::IsCancelled - Returns if cancellation has been requested.
+    * @return true if cancelled
+    */
+    bool IsCancelled() const;
+
+    /**
+    * CToolpathProgress::CheckCancelled - Throws EToolpathCancelled if cancellation has been requested.
+    */
+    void CheckCancelled() const;
+
+    /**
+    * CToolpathProgress::Lib3MFProgressCallback - Progress callback for CReader/CWriter::SetProgressCallback.
+    *   Pass the CToolpathProgress instance as user data; cancellation aborts the lib3mf operation.
+    */
+    static void Lib3MFProgressCallback(bool * pAbort, Lib3MF_double dProgress, Lib3MF::eProgressIdentifier eIdentifier, Lib3MF_pvoid pUserData);
+
+};
+
+typedef std::shared_ptr<CToolpathProgress> PToolpathProgress;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_PROGRESS
@@ -0,0 +1,250 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#include "ToolpathScanStrategy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// Largest number of cells in the grid around a layer
+#define SCANSTRATEGY_MAXCELLCOUNT (1 << 26)
+
+namespace ToolpathExample {
+
+CToolpathScanLayer::CToolpathScanLayer()
+{
+    m_CellStarts.push_back(0);
+}
+
+void CToolpathScanLayer::Clear()
+{
+    m_Hatches.clear();
+    m_CellStarts.clear();
+    m_CellStarts.push_back(0);
+    m_CellColumns.clear();
+    m_CellRows.clear();
+}
+
+void CToolpathScanLayer::Write(Lib3MF::PToolpathLayerData pLayer, const std::vector<uint32_t> & cellProfileIDs, uint32_t nPartID) const
+{
+    if (pLayer.get() == nullptr)
+        throw std::invalid_argument("invalid toolpath layer");
+    if ((GetCellCount() > 0) && cellProfileIDs.empty())
+        throw std::invalid_argument("missing cell profile");
+
+    for (size_t nCellIndex = 0; nCellIndex < GetCellCount(); nCellIndex++) {
+        uint32_t nStart = m_CellStarts[nCellIndex];
+        uint32_t nEnd = m_CellStarts[nCellIndex + 1];
+        uint32_t nProfileID = cellProfileIDs[std::min<size_t>(GetCellParity(nCellIndex), cellProfileIDs.size() - 1)];
+        pLayer->WriteHatchDataDiscrete(nProfileID, nPartID, Lib3MF::CInputVector<Lib3MF::sDiscreteHatch2D>(m_Hatches.data() + nStart, nEnd - nStart));
+    }
+}
+
+CToolpathScanStrategy::CToolpathScanStrategy(const sToolpathScanStrategyParameters & parameters)
+    : m_Parameters(parameters)
+{
+    if ((m_Parameters.m_Pattern != eToolpathScanPattern::Stripes) && (m_Parameters.m_Pattern != eToolpathScanPattern::Chessboard))
+        throw std::invalid_argument("invalid scan pattern");
+    if (m_Parameters.m_nCellSize <= 0)
+        throw std::invalid_argument("invalid cell size");
+    if ((m_Parameters.m_nCellOverlap < 0) || (m_Parameters.m_nCellOverlap >= m_Parameters.m_nCellSize))
+        throw std::invalid_argument("invalid cell overlap");
+    if (m_Parameters.m_nHatchDistance <= 0)
+        throw std::invalid_argument("invalid hatch distance");
+    if (m_Parameters.m_nMinHatchLength < 0)
+        throw std::invalid_argument("invalid minimum hatch length");
+}
+
+void CToolpathScanStrategy::SetThreadPool(PToolpathThreadPool pThreadPool)
+{
+    m_pThreadPool = pThreadPool;
+}
+
+double CToolpathScanStrategy::GetAngle(uint32_t nLayerIndex) const
+{
+    double dAngle = std::fmod(m_Parameters.m_dAngle + m_Parameters.m_dAngleIncrement * nLayerIndex, 180.0);
+    if (dAngle < 0.0)
+        dAngle += 180.0;
+    return dAngle;
+}
+
+void CToolpathScanStrategy::GenerateLayer(const CToolpathSlicePolygons & region, uint32_t nLayerIndex, CToolpathScanLayer & layer) const
+{
+    layer.Clear();
+    const std::vector<Lib3MF::sDiscretePosition2D> & vertices = region.GetVertices();
+    if (vertices.empty())
+        return;
+
+    // Cell grid: columns along u = the grid direction, rows along v = the grid direction turned by 90 degrees
+    double dAngle = GetAngle(nLayerIndex);
+    double dRadians = dAngle * 3.14159265358979323846 / 180.0;
+    double dCos = std::cos(dRadians);
+    double dSin = std::sin(dRadians);
+    double dCellSize = (double)m_Parameters.m_nCellSize;
+    double dHalfOverlap = 0.5 * m_Parameters.m_nCellOverlap;
+    bool bChessboard = (m_Parameters.m_Pattern == eToolpathScanPattern::Chessboard);
+
+    double dMinU = std::numeric_limits<double>::max();
+    double dMaxU = std::numeric_limits<double>::lowest();
+    double dMinV = std::numeric_limits<double>::max();
+    double dMaxV = std::numeric_limits<double>::lowest();
+    for (const Lib3MF::sDiscretePosition2D & vertex : vertices) {
+        double dU = vertex.m_Coordinates[0] * dCos + vertex.m_Coordinates[1] * dSin;
+        double dV = vertex.m_Coordinates[1] * dCos - vertex.m_Coordinates[0] * dSin;
+        dMinU = std::min(dMinU, dU);
+        dMaxU = std::max(dMaxU, dU);
+        dMinV = std::min(dMinV, dV);
+        dMaxV = std::max(dMaxV, dV);
+    }
+    int64_t nFirstColumn = (int64_t)std::floor((dMinU - dHalfOverlap) / dCellSize);
+    int64_t nColumnCount = (int64_t)std::floor((dMaxU + dHalfOverlap) / dCellSize) - nFirstColumn + 1;
+    int64_t nFirstRow = (int64_t)std::floor((dMinV - dHalfOverlap) / dCellSize);
+    int64_t nRowCount = (int64_t)std::floor((dMaxV + dHalfOverlap) / dCellSize) - nFirstRow + 1;
+    int64_t nCellCount = bChessboard ? nColumnCount * nRowCount : nColumnCount;
+    if (nCellCount > SCANSTRATEGY_MAXCELLCOUNT)
+        throw std::range_error("too many scan cells");
+
+    // Rows are hatched along u. Stripes take every row, a chessboard the even cells and the odd cells along v, column
+    // by column. Row windows of a chessboard include the overlap with the neighbouring rows.
+    uint64_t nTaskCount = (uint64_t)(bChessboard ? nRowCount + nColumnCount : nRowCount);
+    uint32_t nWorkerCount = (m_pThreadPool.get() != nullptr) ? m_pThreadPool->GetThreadCount() : 1;
+    if (layer.m_TaskHatches.size() < nTaskCount)
+        layer.m_TaskHatches.resize((size_t)nTaskCount);
+    if (layer.m_WorkerClippers.size() < nWorkerCount) {
+        layer.m_WorkerClippers.resize(nWorkerCount);
+        layer.m_WorkerHatches.resize(nWorkerCount);
+    }
+
+    double dMinLength = (double)m_Parameters.m_nMinHatchLength;
+    auto fnTask = [&](uint64_t nTaskIndex, uint32_t nWorkerIndex) {
+        std::vector<CToolpathScanLayer::sCellHatch> & cellHatches = layer.m_TaskHatches[(size_t)nTaskIndex];
+        std::vector<Lib3MF::sDiscreteHatch2D> & hatches = layer.m_WorkerHatches[nWorkerIndex];
+        CToolpathHatchClipper & clipper = layer.m_WorkerClippers[nWorkerIndex];
+        cellHatches.clear();
+        hatches.clear();
+
+        bool bRowTask = (nTaskIndex < (uint64_t)nRowCount);
+        int64_t nTaskCell = bRowTask ? nFirstRow + (int64_t)nTaskIndex : nFirstColumn + (int64_t)nTaskIndex - nRowCount;
+        double dWindowMargin = bChessboard ? dHalfOverlap : 0.0;
+        clipper.SetHatching(bRowTask ? dAngle : dAngle - 90.0, m_Parameters.m_nHatchDistance);
+        clipper.SetMinHatchLength(m_Parameters.m_nMinHatchLength);
+        clipper.ClipWindow(region, nTaskCell * dCellSize - dWindowMargin, (nTaskCell + 1) * dCellSize + dWindowMargin, hatches);
+
+        // Row hatches are cut at column boundaries and column hatches at row boundaries
+        double dAxisX = bRowTask ? dCos : -dSin;
+        double dAxisY = bRowTask ? dSin : dCos;
+        for (const Lib3MF::sDiscreteHatch2D & hatch : hatches) {
+            double dS1 = hatch.m_Point1Coordinates[0] * dAxisX + hatch.m_Point1Coordinates[1] * dAxisY;
+            double dS2 = hatch.m_Point2Coordinates[0] * dAxisX + hatch.m_Point2Coordinates[1] * dAxisY;
+            double dLow = std::min(dS1, dS2);
+            double dHigh = std::max(dS1, dS2);
+            int64_t nFirstCut = (int64_t)std::floor((dLow - dHalfOverlap) / dCellSize);
+            int64_t nLastCut = (int64_t)std::floor((dHigh + dHalfOverlap) / dCellSize);
+
+            for (int64_t nCut = nFirstCut; nCut <= nLastCut; nCut++) {
+                int64_t nColumn = bRowTask ? nCut : nTaskCell;
+                int64_t nRow = bRowTask ? nTaskCell : nCut;
+                if (bChessboard && ((((nColumn + nRow) & 1) != 0) == bRowTask))
+                    continue;
+                if ((nColumn < nFirstColumn) || (nColumn >= nFirstColumn + nColumnCount) || (nRow < nFirstRow) || (nRow >= nFirstRow + nRowCount))
+                    continue;
+
+                double dPieceLow = std::max(dLow, nCut * dCellSize - dHalfOverlap);
+                double dPieceHigh = std::min(dHigh, (nCut + 1) * dCellSize + dHalfOverlap);
+                if (!(dPieceHigh > dPieceLow) || (dPieceHigh - dPieceLow < dMinLength))
+                    continue;
+
+                CToolpathScanLayer::sCellHatch cellHatch;
+                cellHatch.m_nCellIndex = (uint32_t)(bChessboard ? (nRow - nFirstRow) * nColumnCount + (nColumn - nFirstColumn) : nColumn - nFirstColumn);
+                cellHatch.m_Hatch = hatch;
+                if ((dPieceLow > dLow) || (dPieceHigh < dHigh)) {
+                    // Keep the direction of the hatch
+                    double dStart = (dS1 <= dS2) ? dPieceLow : dPieceHigh;
+                    double dEnd = (dS1 <= dS2) ? dPieceHigh : dPieceLow;
+                    double dStartFactor = (dStart - dS1) / (dS2 - dS1);
+                    double dEndFactor = (dEnd - dS1) / (dS2 - dS1);
+                    for (int nCoordinate = 0; nCoordinate < 2; nCoordinate++) {
+                        double dP1 = hatch.m_Point1Coordinates[nCoordinate];
+                        double dP2 = hatch.m_Point2Coordinates[nCoordinate];
+                        cellHatch.m_Hatch.m_Point1Coordinates[nCoordinate] = (int32_t)std::lround(dP1 + dStartFactor * (dP2 - dP1));
+                        cellHatch.m_Hatch.m_Point2Coordinates[nCoordinate] = (int32_t)std::lround(dP1 + dEndFactor * (dP2 - dP1));
+                    }
+                    if ((cellHatch.m_Hatch.m_Point1Coordinates[0] == cellHatch.m_Hatch.m_Point2Coordinates[0]) && (cellHatch.m_Hatch.m_Point1Coordinates[1] == cellHatch.m_Hatch.m_Point2Coordinates[1]))
+                        continue;
+                }
+                cellHatches.push_back(cellHatch);
+            }
+        }
+    };
+
+    if ((m_pThreadPool.get() != nullptr) && (nTaskCount > 1)) {
+        m_pThreadPool->ParallelFor(nTaskCount, fnTask);
+    }
+    else {
+        for (uint64_t nTaskIndex = 0; nTaskIndex < nTaskCount; nTaskIndex++)
+            fnTask(nTaskIndex, 0);
+    }
+
+    // Counting sort by cell in task order, so every cell lists its hatches line by line
+    std::vector<uint32_t> & cellOffsets = layer.m_CellOffsets;
+    cellOffsets.assign((size_t)nCellCount + 1, 0);
+    size_t nHatchCount = 0;
+    for (uint64_t nTaskIndex = 0; nTaskIndex < nTaskCount; nTaskIndex++) {
+        for (const CToolpathScanLayer::sCellHatch & cellHatch : layer.m_TaskHatches[(size_t)nTaskIndex])
+            cellOffsets[cellHatch.m_nCellIndex + 1]++;
+        nHatchCount += layer.m_TaskHatches[(size_t)nTaskIndex].size();
+    }
+    if (nHatchCount >= (size_t)std::numeric_limits<uint32_t>::max())
+        throw std::range_error("too many hatches in layer");
+
+    for (size_t nCellIndex = 0; nCellIndex < (size_t)nCellCount; nCellIndex++) {
+        uint32_t nCellHatchCount = cellOffsets[nCellIndex + 1];
+        cellOffsets[nCellIndex + 1] = cellOffsets[nCellIndex] + nCellHatchCount;
+        if (nCellHatchCount == 0)
+            continue;
+
+        layer.m_CellStarts.push_back(cellOffsets[nCellIndex + 1]);
+        layer.m_CellColumns.push_back((int32_t)(nFirstColumn + (bChessboard ? (int64_t)nCellIndex % nColumnCount : (int64_t)nCellIndex)));
+        layer.m_CellRows.push_back(bChessboard ? (int32_t)(nFirstRow + (int64_t)nCellIndex / nColumnCount) : 0);
+    }
+
+    layer.m_Hatches.resize(nHatchCount);
+    for (uint64_t nTaskIndex = 0; nTaskIndex < nTaskCount; nTaskIndex++) {
+        for (const CToolpathScanLayer::sCellHatch & cellHatch : layer.m_TaskHatches[(size_t)nTaskIndex])
+            layer.m_Hatches[cellOffsets[cellHatch.m_nCellIndex]++] = cellHatch.m_Hatch;
+    }
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,198 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#ifndef __TOOLPATHEXAMPLE_SCANSTRATEGY
+#define __TOOLPATHEXAMPLE_SCANSTRATEGY
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+#include "ToolpathHatchClipper.hpp"
+#include "ToolpathSlicePolygons.hpp"
+#include "ToolpathThreadPool.hpp"
+
+namespace ToolpathExample {
+
+/* Partition of the hatched area into cells. */
+enum class eToolpathScanPattern : uint8_t {
+    Stripes = 0, /** Parallel stripes of the cell width, hatches run across the stripes */
+    Chessboard = 1 /** Square islands of the cell size, the hatch direction turns by 90 degrees from island to island */
+};
+
+/**
+* Settings of CToolpathScanStrategy. Distances are given in toolpath units, angles in degrees.
+*/
+typedef struct sToolpathScanStrategyParameters {
+    eToolpathScanPattern m_Pattern;
+    int32_t m_nCellSize;                // Stripe width or island size
+    int32_t m_nCellOverlap;             // Hatches of neighbouring cells overlap by this distance
+    int32_t m_nHatchDistance;           // Distance between neighbouring hatches
+    double m_dAngle;                    // Direction of the cell grid in layer 0, measured from the X axis
+    double m_dAngleIncrement;           // Rotation of the cell grid from one layer to the next
+    int32_t m_nMinHatchLength;          // Shorter hatches are dropped
+} sToolpathScanStrategyParameters;
+
+/*************************************************************************************************************************
+ Class CToolpathScanLayer
+
+ Hatches of one layer grouped by scan cell, in toolpath units, together with the scratch storage of the scan
+ strategy. Cells without hatches are left out; the remaining cells are ordered row by row along the cell grid.
+ All buffers keep their capacity when the object is reused for another layer.
+**************************************************************************************************************************/
+class CToolpathScanLayer {
+private:
+    typedef struct sCellHatch {
+        uint32_t m_nCellIndex;
+        Lib3MF::sDiscreteHatch2D m_Hatch;
+    } sCellHatch;
+
+    std::vector<Lib3MF::sDiscreteHatch2D> m_Hatches;
+    std::vector<uint32_t> m_CellStarts;
+    std::vector<int32_t> m_CellColumns;
+    std::vector<int32_t> m_CellRows;
+
+    // Scratch storage of CToolpathScanStrategy, per task and per worker
+    std::vector<std::vector<sCellHatch>> m_TaskHatches;
+    std::vector<CToolpathHatchClipper> m_WorkerClippers;
+    std::vector<std::vector<Lib3MF::sDiscreteHatch2D>> m_WorkerHatches;
+    std::vector<uint32_t> m_CellOffsets;
+
+    friend class CToolpathScanStrategy;
+
+public:
+
+    /**
+    * CToolpathScanLayer::CToolpathScanLayer - Creates an empty layer.
+    */
+    CToolpathScanLayer();
+
+    /**
+    * CToolpathScanLayer::Clear - Removes all cells and keeps the storage.
+    */
+    void Clear();
+
+    size_t GetCellCount() const { return m_CellStarts.size() - 1; }
+    size_t GetHatchCount() const { return m_Hatches.size(); }
+    const std::vector<Lib3MF::sDiscreteHatch2D> & GetHatches() const { return m_Hatches; }
+
+    /**
+    * CToolpathScanLayer::GetCellStart - Returns the index of the first hatch of a cell.
+    * @param[in] nCellIndex - Cell index, GetCellCount() returns the hatch count
+    * @return Hatch index
+    */
+    uint32_t GetCellStart(size_t nCellIndex) const { return m_CellStarts[nCellIndex]; }
+
+    /**
+    * CToolpathScanLayer::GetCellColumn - Returns the position of a cell across the stripes or islands.
+    * @param[in] nCellIndex - Cell index
+    * @return Column in the cell grid, cell 0 starts at the origin
+    */
+    int32_t GetCellColumn(size_t nCellIndex) const { return m_CellColumns[nCellIndex]; }
+
+    /**
+    * CToolpathScanLayer::GetCellRow - Returns the position of a cell along the stripes or islands.
+    * @param[in] nCellIndex - Cell index
+    * @return Row in the cell grid, 0 for stripes
+    */
+    int32_t GetCellRow(size_t nCellIndex) const { return m_CellRows[nCellIndex]; }
+
+    /**
+    * CToolpathScanLayer::GetCellParity - Returns whether a cell is a black or a white field of the cell grid.
+    * @param[in] nCellIndex - Cell index
+    * @return 0 or 1
+    */
+    uint32_t GetCellParity(size_t nCellIndex) const { return (uint32_t)(m_CellColumns[nCellIndex] + m_CellRows[nCellIndex]) & 1; }
+
+    /**
+    * CToolpathScanLayer::Write - Writes one hatch segment per cell.
+    * @param[in] pLayer - Layer data to write to
+    * @param[in] cellProfileIDs - Profile ID by cell parity, a single profile is used for all cells
+    * @param[in] nPartID - Part ID as registered in the layer
+    */
+    void Write(Lib3MF::PToolpathLayerData pLayer, const std::vector<uint32_t> & cellProfileIDs, uint32_t nPartID) const;
+
+};
+
+/*************************************************************************************************************************
+ Class CToolpathScanStrategy
+
+ Splits the hatches of a layer into stripes or chessboard islands on a square grid through the origin, which rotates
+ from layer to layer. Hatches along the grid direction are clipped row by row and cut where they cross a column
+ boundary; in chessboard mode the other islands are hatched column by column along the perpendicular direction.
+ Rows and columns are independent tasks that run in parallel if a thread pool is set. Every task writes to its own
+ buffer and the buffers are merged in task order, so the result does not depend on the number of threads.
+**************************************************************************************************************************/
+class CToolpathScanStrategy {
+private:
+    sToolpathScanStrategyParameters m_Parameters;
+    PToolpathThreadPool m_pThreadPool;
+
+public:
+
+    /**
+    * CToolpathScanStrategy::CToolpathScanStrategy - Creates a scan strategy.
+    * @param[in] parameters - Pattern, cell and hatch settings
+    */
+    CToolpathScanStrategy(const sToolpathScanStrategyParameters & parameters);
+
+    /**
+    * CToolpathScanStrategy::SetThreadPool - Sets the pool the cells of a layer are generated on.
+    * @param[in] pThreadPool - Thread pool, nullptr generates on the calling thread
+    */
+    void SetThreadPool(PToolpathThreadPool pThreadPool);
+
+    /**
+    * CToolpathScanStrategy::GetAngle - Returns the direction of the cell grid in a layer.
+    * @param[in] nLayerIndex - Layer index
+    * @return Angle in [0, 180) degrees
+    */
+    double GetAngle(uint32_t nLayerIndex) const;
+
+    /**
+    * CToolpathScanStrategy::GenerateLayer - Generates the hatches of a layer, grouped by cell.
+    * @param[in] region - Area to hatch in toolpath units, polygons under the even-odd rule
+    * @param[in] nLayerIndex - Layer index, selects the grid direction
+    * @param[out] layer - Receives the cells, scratch storage is reused
+    */
+    void GenerateLayer(const CToolpathSlicePolygons & region, uint32_t nLayerIndex, CToolpathScanLayer & layer) const;
+
+};
+
+typedef std::shared_ptr<CToolpathScanStrategy> PToolpathScanStrategy;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_SCANSTRATEGY
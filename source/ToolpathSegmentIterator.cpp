@@ -0,0 +1,197 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathSegmentIterator.hpp"
+
+#include <stdexcept>
+
+#define SEGMENTITERATOR_LOADED_POINTS 0x01
+#define SEGMENTITERATOR_LOADED_DISCRETEPOINTS 0x02
+#define SEGMENTITERATOR_LOADED_POINTFACTORS 0x04
+#define SEGMENTITERATOR_LOADED_HATCHES 0x08
+#define SEGMENTITERATOR_LOADED_DISCRETEHATCHES 0x10
+#define SEGMENTITERATOR_LOADED_HATCHFACTORS 0x20
+#define SEGMENTITERATOR_LOADED_SUBINTERPOLATION 0x40
+#define SEGMENTITERATOR_LOADED_ARCPATH 0x80
+
+namespace ToolpathExample {
+
+CToolpathSegmentIterator::CToolpathSegmentIterator()
+    : m_nSegmentCount(0), m_nSegmentIndex(0), m_bValid(false), m_Type(Lib3MF::eToolpathSegmentType::Unknown),
+    m_nPointCount(0), m_nProfileID(0), m_nPartID(0), m_nLoadedMask(0),
+    m_PointFactor(Lib3MF::eToolpathProfileModificationFactor::Unknown),
+    m_HatchFactor(Lib3MF::eToolpathProfileModificationFactor::Unknown),
+    m_SubInterpolationFactor(Lib3MF::eToolpathProfileModificationFactor::Unknown), m_bArcPath(false)
+{
+}
+
+CToolpathSegmentIterator::CToolpathSegmentIterator(Lib3MF::PToolpathLayerReader pLayerReader)
+    : CToolpathSegmentIterator()
+{
+    SetLayer(pLayerReader);
+}
+
+void CToolpathSegmentIterator::checkValid() const
+{
+    if (!m_bValid)
+        throw std::runtime_error("segment iterator is not positioned on a segment");
+}
+
+void CToolpathSegmentIterator::SetLayer(Lib3MF::PToolpathLayerReader pLayerReader)
+{
+    m_Extractor.SetLayer(pLayerReader);
+    m_pLayerReader = pLayerReader;
+    m_nSegmentCount = pLayerReader->GetSegmentCount();
+    m_nSegmentIndex = 0;
+    m_bValid = false;
+    m_nLoadedMask = 0;
+}
+
+bool CToolpathSegmentIterator::Next()
+{
+    if (m_pLayerReader.get() == nullptr)
+        throw std::runtime_error("no layer has been set");
+
+    m_nLoadedMask = 0;
+    if (m_bValid)
+        m_nSegmentIndex++;
+    else if (m_nSegmentIndex < m_nSegmentCount)
+        // First call after SetLayer
+        m_nSegmentIndex = 0;
+
+    m_bValid = (m_nSegmentIndex < m_nSegmentCount);
+    if (!m_bValid) {
+        m_nSegmentIndex = m_nSegmentCount;
+        return false;
+    }
+
+    m_pLayerReader->GetSegmentInfo(m_nSegmentIndex, m_Type, m_nPointCount);
+    m_nProfileID = m_pLayerReader->GetSegmentDefaultProfileID(m_nSegmentIndex);
+    m_nPartID = m_pLayerReader->GetSegmentPartID(m_nSegmentIndex);
+
+    return true;
+}
+
+const std::string & CToolpathSegmentIterator::GetProfileUUID()
+{
+    checkValid();
+    return m_Extractor.GetSegmentProfileUUID(m_nSegmentIndex);
+}
+
+// Every kind of data is retrieved at most once per segment, factors once per segment and factor.
+
+bool CToolpathSegmentIterator::IsArcPath()
+{
+    checkValid();
+    if (!(m_nLoadedMask & SEGMENTITERATOR_LOADED_ARCPATH)) {
+        m_bArcPath = ((m_Type == Lib3MF::eToolpathSegmentType::Loop) || (m_Type == Lib3MF::eToolpathSegmentType::Polyline))
+            && CToolpathArcPath::IsArcPath(m_pLayerReader, m_nSegmentIndex);
+        m_nLoadedMask |= SEGMENTITERATOR_LOADED_ARCPATH;
+    }
+    return m_bArcPath;
+}
+
+CToolpathArrayView<Lib3MF::sPosition2D> CToolpathSegmentIterator::GetPoints()
+{
+    checkValid();
+    if (!(m_nLoadedMask & SEGMENTITERATOR_LOADED_POINTS)) {
+        m_Points = m_Extractor.GetPoints(m_nSegmentIndex);
+        m_nLoadedMask |= SEGMENTITERATOR_LOADED_POINTS;
+    }
+    return m_Points;
+}
+
+CToolpathArrayView<Lib3MF::sDiscretePosition2D> CToolpathSegmentIterator::GetDiscretePoints()
+{
+    checkValid();
+    if (!(m_nLoadedMask & SEGMENTITERATOR_LOADED_DISCRETEPOINTS)) {
+        m_DiscretePoints = m_Extractor.GetDiscretePoints(m_nSegmentIndex);
+        m_nLoadedMask |= SEGMENTITERATOR_LOADED_DISCRETEPOINTS;
+    }
+    return m_DiscretePoints;
+}
+
+CToolpathArrayView<double> CToolpathSegmentIterator::GetPointFactors(Lib3MF::eToolpathProfileModificationFactor factor)
+{
+    checkValid();
+    if (!(m_nLoadedMask & SEGMENTITERATOR_LOADED_POINTFACTORS) || (m_PointFactor != factor)) {
+        m_PointFactors = m_Extractor.GetPointFactors(m_nSegmentIndex, factor);
+        m_PointFactor = factor;
+        m_nLoadedMask |= SEGMENTITERATOR_LOADED_POINTFACTORS;
+    }
+    return m_PointFactors;
+}
+
+CToolpathArrayView<Lib3MF::sHatch2D> CToolpathSegmentIterator::GetHatches()
+{
+    checkValid();
+    if (!(m_nLoadedMask & SEGMENTITERATOR_LOADED_HATCHES)) {
+        m_Hatches = m_Extractor.GetHatches(m_nSegmentIndex);
+        m_nLoadedMask |= SEGMENTITERATOR_LOADED_HATCHES;
+    }
+    return m_Hatches;
+}
+
+CToolpathArrayView<Lib3MF::sDiscreteHatch2D> CToolpathSegmentIterator::GetDiscreteHatches()
+{
+    checkValid();
+    if (!(m_nLoadedMask & SEGMENTITERATOR_LOADED_DISCRETEHATCHES)) {
+        m_DiscreteHatches = m_Extractor.GetDiscreteHatches(m_nSegmentIndex);
+        m_nLoadedMask |= SEGMENTITERATOR_LOADED_DISCRETEHATCHES;
+    }
+    return m_DiscreteHatches;
+}
+
+CToolpathArrayView<Lib3MF::sHatch2DFactors> CToolpathSegmentIterator::GetHatchFactors(Lib3MF::eToolpathProfileModificationFactor factor)
+{
+    checkValid();
+    if (!(m_nLoadedMask & SEGMENTITERATOR_LOADED_HATCHFACTORS) || (m_HatchFactor != factor)) {
+        m_HatchFactors = m_Extractor.GetHatchFactors(m_nSegmentIndex, factor);
+        m_HatchFactor = factor;
+        m_nLoadedMask |= SEGMENTITERATOR_LOADED_HATCHFACTORS;
+    }
+    return m_HatchFactors;
+}
+
+void CToolpathSegmentIterator::GetSubInterpolation(Lib3MF::eToolpathProfileModificationFactor factor, CToolpathArrayView<Lib3MF_uint32> & counts, CToolpathArrayView<Lib3MF::sHatchModificationInterpolationData> & data)
+{
+    checkValid();
+    if (!(m_nLoadedMask & SEGMENTITERATOR_LOADED_SUBINTERPOLATION) || (m_SubInterpolationFactor != factor)) {
+        m_SubInterpolationData = m_Extractor.GetSubInterpolationData(m_nSegmentIndex, factor);
+        m_SubInterpolationCounts = m_Extractor.GetSubInterpolationCounts();
+        m_SubInterpolationFactor = factor;
+        m_nLoadedMask |= SEGMENTITERATOR_LOADED_SUBINTERPOLATION;
+    }
+    counts = m_SubInterpolationCounts;
+    data = m_SubInterpolationData;
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,229 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+#ifndef __TOOLPATHEXAMPLE_SEGMENTITERATOR
+#define __TOOLPATHEXAMPLE_SEGMENTITERATOR
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+#include "ToolpathArcFitter.hpp"
+#include "ToolpathLayerExtractor.hpp"
+
+namespace ToolpathExample {
+
+/*************************************************************************************************************************
+ Class CToolpathArrayView
+
+ Non-owning view of a contiguous array.
+**************************************************************************************************************************/
+template <typename T> class CToolpathArrayView {
+private:
+    const T * m_pData;
+    size_t m_nSize;
+
+public:
+
+    CToolpathArrayView()
+        : m_pData(nullptr), m_nSize(0)
+    {
+    }
+
+    CToolpathArrayView(const T * pData, size_t nSize)
+        : m_pData(pData), m_nSize(nSize)
+    {
+    }
+
+    CToolpathArrayView(const std::vector<T> & buffer)
+        : m_pData(buffer.data()), m_nSize(buffer.size())
+    {
+    }
+
+    const T * data() const { return m_pData; }
+    size_t size() const { return m_nSize; }
+    bool empty() const { return m_nSize == 0; }
+    const T * begin() const { return m_pData; }
+    const T * end() const { return m_pData + m_nSize; }
+    const T & operator[](size_t nIndex) const { return m_pData[nIndex]; }
+};
+
+/*************************************************************************************************************************
+ Class CToolpathSegmentIterator
+
+ Pulls the segments of a layer reader one after another. Segment information is read once per segment; point, hatch
+ and factor data is retrieved on first access and returned as views into buffers that are reused for all segments.
+ Views stay valid until the iterator advances or is set to another layer.
+**************************************************************************************************************************/
+class CToolpathSegmentIterator {
+private:
+    CToolpathLayerExtractor m_Extractor;
+    Lib3MF::PToolpathLayerReader m_pLayerReader;
+
+    uint32_t m_nSegmentCount;
+    uint32_t m_nSegmentIndex;
+    bool m_bValid;
+
+    Lib3MF::eToolpathSegmentType m_Type;
+    uint32_t m_nPointCount;
+    uint32_t m_nProfileID;
+    uint32_t m_nPartID;
+
+    // Data already retrieved for the current segment
+    uint32_t m_nLoadedMask;
+    Lib3MF::eToolpathProfileModificationFactor m_PointFactor;
+    Lib3MF::eToolpathProfileModificationFactor m_HatchFactor;
+    Lib3MF::eToolpathProfileModificationFactor m_SubInterpolationFactor;
+    bool m_bArcPath;
+    CToolpathArrayView<Lib3MF::sPosition2D> m_Points;
+    CToolpathArrayView<Lib3MF::sDiscretePosition2D> m_DiscretePoints;
+    CToolpathArrayView<double> m_PointFactors;
+    CToolpathArrayView<Lib3MF::sHatch2D> m_Hatches;
+    CToolpathArrayView<Lib3MF::sDiscreteHatch2D> m_DiscreteHatches;
+    CToolpathArrayView<Lib3MF::sHatch2DFactors> m_HatchFactors;
+    CToolpathArrayView<Lib3MF_uint32> m_SubInterpolationCounts;
+    CToolpathArrayView<Lib3MF::sHatchModificationInterpolationData> m_SubInterpolationData;
+
+    void checkValid() const;
+
+public:
+
+    /**
+    * CToolpathSegmentIterator::CToolpathSegmentIterator - Creates an iterator without a layer.
+    */
+    CToolpathSegmentIterator();
+
+    /**
+    * CToolpathSegmentIterator::CToolpathSegmentIterator - Creates an iterator positioned before the first segment of a layer.
+    * @param[in] pLayerReader - Layer reader
+    */
+    CToolpathSegmentIterator(Lib3MF::PToolpathLayerReader pLayerReader);
+
+    /**
+    * CToolpathSegmentIterator::SetLayer - Positions the iterator before the first segment of a layer. Buffers are kept.
+    * @param[in] pLayerReader - Layer reader
+    */
+    void SetLayer(Lib3MF::PToolpathLayerReader pLayerReader);
+
+    /**
+    * CToolpathSegmentIterator::Next - Advances to the next segment and invalidates all views of the previous one.
+    * @return false, if there are no more segments
+    */
+    bool Next();
+
+    uint32_t GetSegmentCount() const { return m_nSegmentCount; }
+    uint32_t GetSegmentIndex() const { checkValid(); return m_nSegmentIndex; }
+    Lib3MF::eToolpathSegmentType GetType() const { checkValid(); return m_Type; }
+    uint32_t GetPointCount() const { checkValid(); return m_nPointCount; }
+
+    /**
+    * CToolpathSegmentIterator::GetProfileID - Returns the local ID of the default profile of the segment.
+    * @return Local profile ID
+    */
+    uint32_t GetProfileID() const { checkValid(); return m_nProfileID; }
+
+    /**
+    * CToolpathSegmentIterator::GetPartID - Returns the local part ID of the segment.
+    * @return Local part ID
+    */
+    uint32_t GetPartID() const { checkValid(); return m_nPartID; }
+
+    /**
+    * CToolpathSegmentIterator::GetProfileUUID - Returns the UUID of the default profile of the segment.
+    * @return Profile UUID, cached per local profile ID and layer
+    */
+    const std::string & GetProfileUUID();
+
+    /**
+    * CToolpathSegmentIterator::IsArcPath - Returns whether a loop or polyline holds an arc path, see CToolpathArcPath.
+    *   The attribute has to be registered with the toolpath before the layer is read.
+    * @return true for arc paths
+    */
+    bool IsArcPath();
+
+    /**
+    * CToolpathSegmentIterator::GetPoints - Returns the points of a loop or polyline in model units.
+    * @return Point view
+    */
+    CToolpathArrayView<Lib3MF::sPosition2D> GetPoints();
+
+    /**
+    * CToolpathSegmentIterator::GetDiscretePoints - Returns the points of a loop or polyline in toolpath units.
+    * @return Point view
+    */
+    CToolpathArrayView<Lib3MF::sDiscretePosition2D> GetDiscretePoints();
+
+    /**
+    * CToolpathSegmentIterator::GetPointFactors - Returns a modification factor for all points of a loop or polyline.
+    * @param[in] factor - Modification factor
+    * @return Factor view, also invalidated by requesting another factor
+    */
+    CToolpathArrayView<double> GetPointFactors(Lib3MF::eToolpathProfileModificationFactor factor);
+
+    /**
+    * CToolpathSegmentIterator::GetHatches - Returns the hatches of a hatch segment in model units.
+    * @return Hatch view
+    */
+    CToolpathArrayView<Lib3MF::sHatch2D> GetHatches();
+
+    /**
+    * CToolpathSegmentIterator::GetDiscreteHatches - Returns the hatches of a hatch segment in toolpath units.
+    * @return Hatch view
+    */
+    CToolpathArrayView<Lib3MF::sDiscreteHatch2D> GetDiscreteHatches();
+
+    /**
+    * CToolpathSegmentIterator::GetHatchFactors - Returns the linear modification factors of all hatches.
+    * @param[in] factor - Modification factor
+    * @return Factor view, also invalidated by requesting another factor
+    */
+    CToolpathArrayView<Lib3MF::sHatch2DFactors> GetHatchFactors(Lib3MF::eToolpathProfileModificationFactor factor);
+
+    /**
+    * CToolpathSegmentIterator::GetSubInterpolation - Returns the nonlinear modification factors of all hatches.
+    * @param[in] factor - Modification factor
+    * @param[out] counts - Sample count per hatch
+    * @param[out] data - Samples of all hatches in hatch order
+    * Both views are also invalidated by requesting another factor.
+    */
+    void GetSubInterpolation(Lib3MF::eToolpathProfileModificationFactor factor, CToolpathArrayView<Lib3MF_uint32> & counts, CToolpathArrayView<Lib3MF::sHatchModificationInterpolationData> & data);
+
+};
+
+typedef std::shared_ptr<CToolpathSegmentIterator> PToolpathSegmentIterator;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_SEGMENTITERATOR
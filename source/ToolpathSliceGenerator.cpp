@@ -0,0 +1,228 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#include "ToolpathSliceGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// Number of slices read ahead per thread before a batch of layers is generated
+#define SLICEGENERATOR_BATCHSLICESPERTHREAD 4
+
+namespace ToolpathExample {
+
+CToolpathGeneratedLayer::CToolpathGeneratedLayer()
+{
+    m_LoopStarts.push_back(0);
+}
+
+void CToolpathGeneratedLayer::Clear()
+{
+    m_LoopPoints.clear();
+    m_LoopStarts.clear();
+    m_LoopStarts.push_back(0);
+    m_LoopContours.clear();
+    m_Hatches.clear();
+}
+
+void CToolpathGeneratedLayer::Write(Lib3MF::PToolpathLayerData pLayer, const std::vector<uint32_t> & contourProfileIDs, uint32_t nHatchProfileID, uint32_t nPartID) const
+{
+    if (pLayer.get() == nullptr)
+        throw std::invalid_argument("invalid toolpath layer");
+    if ((GetLoopCount() > 0) && contourProfileIDs.empty())
+        throw std::invalid_argument("missing contour profile");
+
+    for (size_t nLoopIndex = 0; nLoopIndex < GetLoopCount(); nLoopIndex++) {
+        uint32_t nStart = m_LoopStarts[nLoopIndex];
+        uint32_t nEnd = m_LoopStarts[nLoopIndex + 1];
+        uint32_t nProfileID = contourProfileIDs[std::min<size_t>(m_LoopContours[nLoopIndex], contourProfileIDs.size() - 1)];
+        pLayer->WriteLoopDiscrete(nProfileID, nPartID, Lib3MF::CInputVector<Lib3MF::sDiscretePosition2D>(m_LoopPoints.data() + nStart, nEnd - nStart));
+    }
+
+    if (!m_Hatches.empty())
+        pLayer->WriteHatchDataDiscrete(nHatchProfileID, nPartID, Lib3MF::CInputVector<Lib3MF::sDiscreteHatch2D>(m_Hatches.data(), m_Hatches.size()));
+}
+
+CToolpathSliceGenerator::CToolpathSliceGenerator(const sToolpathSliceGeneratorParameters & parameters)
+    : m_Parameters(parameters)
+{
+    if (m_Parameters.m_nHatchDistance <= 0)
+        throw std::invalid_argument("invalid hatch distance");
+    if (m_Parameters.m_nMinHatchLength < 0)
+        throw std::invalid_argument("invalid minimum hatch length");
+    if (m_Parameters.m_nContourTolerance < 0)
+        throw std::invalid_argument("invalid contour tolerance");
+}
+
+void CToolpathSliceGenerator::SetThreadPool(PToolpathThreadPool pThreadPool)
+{
+    m_pThreadPool = pThreadPool;
+}
+
+void CToolpathSliceGenerator::SetProgress(PToolpathProgress pProgress)
+{
+    m_pProgress = pProgress;
+}
+
+void CToolpathSliceGenerator::SetStatistics(PToolpathStatistics pStatistics)
+{
+    m_pStatistics = pStatistics;
+}
+
+double CToolpathSliceGenerator::GetHatchAngle(uint32_t nLayerIndex) const
+{
+    double dAngle = std::fmod(m_Parameters.m_dHatchAngle + m_Parameters.m_dHatchAngleIncrement * nLayerIndex, 180.0);
+    if (dAngle < 0.0)
+        dAngle += 180.0;
+    return dAngle;
+}
+
+void CToolpathSliceGenerator::GenerateLayer(const CToolpathSlicePolygons & slice, uint32_t nLayerIndex, CToolpathGeneratedLayer & layer) const
+{
+    layer.Clear();
+    layer.m_Simplifier.SetTolerance(m_Parameters.m_nContourTolerance, 0.0);
+
+    for (size_t nContourIndex = 0; nContourIndex < m_Parameters.m_ContourOffsets.size(); nContourIndex++) {
+        layer.m_Offsetter.Offset(slice, m_Parameters.m_ContourOffsets[nContourIndex], layer.m_OffsetPolygons);
+
+        const std::vector<Lib3MF::sDiscretePosition2D> & vertices = layer.m_OffsetPolygons.GetVertices();
+        for (size_t nPolygonIndex = 0; nPolygonIndex < layer.m_OffsetPolygons.GetPolygonCount(); nPolygonIndex++) {
+            auto iBegin = vertices.begin() + layer.m_OffsetPolygons.GetPolygonStart(nPolygonIndex);
+            auto iEnd = vertices.begin() + layer.m_OffsetPolygons.GetPolygonStart(nPolygonIndex + 1);
+            size_t nStart = layer.m_LoopPoints.size();
+            layer.m_LoopPoints.insert(layer.m_LoopPoints.end(), iBegin, iEnd);
+            if (m_Parameters.m_nContourTolerance > 0)
+                layer.m_LoopPoints.resize(nStart + layer.m_Simplifier.Simplify(layer.m_LoopPoints.data() + nStart, nullptr, iEnd - iBegin, true));
+            layer.m_LoopStarts.push_back((uint32_t)layer.m_LoopPoints.size());
+            layer.m_LoopContours.push_back((uint32_t)nContourIndex);
+        }
+    }
+
+    layer.m_HatchClipper.SetHatching(GetHatchAngle(nLayerIndex), m_Parameters.m_nHatchDistance);
+    layer.m_HatchClipper.SetMinHatchLength(m_Parameters.m_nMinHatchLength);
+    if (m_Parameters.m_nHatchOffset != 0) {
+        layer.m_Offsetter.Offset(slice, m_Parameters.m_nHatchOffset, layer.m_OffsetPolygons);
+        layer.m_HatchClipper.Clip(layer.m_OffsetPolygons, layer.m_Hatches);
+    }
+    else {
+        layer.m_HatchClipper.Clip(slice, layer.m_Hatches);
+    }
+}
+
+void CToolpathSliceGenerator::GenerateLayers(const std::vector<CToolpathSlicePolygons> & slices, size_t nSliceCount, uint32_t nFirstLayerIndex, std::vector<CToolpathGeneratedLayer> & layers) const
+{
+    if (nSliceCount > slices.size())
+        throw std::invalid_argument("invalid slice count");
+    if (layers.size() < nSliceCount)
+        layers.resize(nSliceCount);
+
+    if ((m_pThreadPool.get() == nullptr) || (nSliceCount < 2)) {
+        for (size_t nSliceIndex = 0; nSliceIndex < nSliceCount; nSliceIndex++)
+            GenerateLayer(slices[nSliceIndex], nFirstLayerIndex + (uint32_t)nSliceIndex, layers[nSliceIndex]);
+        return;
+    }
+
+    m_pThreadPool->ParallelFor(nSliceCount, [&](uint64_t nTaskIndex, uint32_t nWorkerIndex) {
+        (void)nWorkerIndex;
+        GenerateLayer(slices[(size_t)nTaskIndex], nFirstLayerIndex + (uint32_t)nTaskIndex, layers[(size_t)nTaskIndex]);
+    });
+}
+
+void CToolpathSliceGenerator::WriteSliceStack(Lib3MF::PSliceStack pSliceStack, Lib3MF::PToolpath pToolpath, Lib3MF::PWriter pWriter, const sToolpathSliceTargets & targets, const std::string & sLayerPathPrefix)
+{
+    if ((pSliceStack.get() == nullptr) || (pToolpath.get() == nullptr) || (pWriter.get() == nullptr))
+        throw std::invalid_argument("invalid slice stack, toolpath or writer");
+    if (targets.m_pBuildItem.get() == nullptr)
+        throw std::invalid_argument("missing build item");
+    if (!m_Parameters.m_ContourOffsets.empty() && targets.m_ContourProfiles.empty())
+        throw std::invalid_argument("missing contour profile");
+    if (targets.m_pHatchProfile.get() == nullptr)
+        throw std::invalid_argument("missing hatch profile");
+
+    double dUnits = pToolpath->GetUnits();
+    uint32_t nThreadCount = (m_pThreadPool.get() != nullptr) ? m_pThreadPool->GetThreadCount() : 1;
+    size_t nBatchSize = (size_t)nThreadCount * SLICEGENERATOR_BATCHSLICESPERTHREAD;
+
+    std::vector<CToolpathSlicePolygons> slices(nBatchSize);
+    std::vector<uint32_t> zMaxValues(nBatchSize);
+    std::vector<CToolpathGeneratedLayer> layers(nBatchSize);
+    std::vector<uint32_t> contourProfileIDs;
+
+    uint64_t nSliceCount = pSliceStack->GetSliceCount();
+    for (uint64_t nBatchStart = 0; nBatchStart < nSliceCount; nBatchStart += nBatchSize) {
+        size_t nBatchCount = (size_t)std::min<uint64_t>(nBatchSize, nSliceCount - nBatchStart);
+
+        for (size_t nIndex = 0; nIndex < nBatchCount; nIndex++) {
+            Lib3MF::PSlice pSlice = pSliceStack->GetSlice(nBatchStart + nIndex);
+            slices[nIndex].ReadSlice(pSlice, dUnits);
+
+            double dZMax = std::round(pSlice->GetZTop() / dUnits);
+            if ((dZMax < 0.0) || (dZMax > (double)std::numeric_limits<uint32_t>::max()))
+                throw std::range_error("slice height exceeds the range of toolpath units");
+            zMaxValues[nIndex] = (uint32_t)dZMax;
+        }
+
+        GenerateLayers(slices, nBatchCount, (uint32_t)nBatchStart, layers);
+
+        for (size_t nIndex = 0; nIndex < nBatchCount; nIndex++) {
+            std::string sLayerPath = sLayerPathPrefix + std::to_string(nBatchStart + nIndex + 1) + ".xml";
+            auto pLayer = pToolpath->AddLayer(zMaxValues[nIndex], sLayerPath, pWriter);
+
+            contourProfileIDs.clear();
+            for (auto pProfile : targets.m_ContourProfiles)
+                contourProfileIDs.push_back(pLayer->RegisterProfile(pProfile));
+            uint32_t nHatchProfileID = pLayer->RegisterProfile(targets.m_pHatchProfile);
+            uint32_t nPartID = pLayer->RegisterBuildItem(targets.m_pBuildItem);
+
+            const CToolpathGeneratedLayer & layer = layers[nIndex];
+            layer.Write(pLayer, contourProfileIDs, nHatchProfileID, nPartID);
+            pLayer->Finish();
+
+            if (m_pStatistics.get() != nullptr) {
+                m_pStatistics->AddCount(eToolpathCounter::LayersWritten, 1);
+                m_pStatistics->AddCount(eToolpathCounter::SegmentsWritten, layer.GetSegmentCount());
+                m_pStatistics->AddCount(eToolpathCounter::PointsWritten, layer.GetLoopPointCount() + 2 * (uint64_t)layer.GetHatchCount());
+            }
+
+            if (m_pProgress.get() != nullptr) {
+                uint64_t nBytes = (uint64_t)layer.GetLoopPointCount() * sizeof(Lib3MF::sDiscretePosition2D) + (uint64_t)layer.GetHatchCount() * sizeof(Lib3MF::sDiscreteHatch2D);
+                m_pProgress->ReportLayer(eToolpathProgressStage::WriteLayer, (uint32_t)(nBatchStart + nIndex), (uint32_t)nSliceCount, nBytes, layer.GetSegmentCount());
+                m_pProgress->CheckCancelled();
+            }
+        }
+    }
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,233 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#ifndef __TOOLPATHEXAMPLE_SLICEGENERATOR
+#define __TOOLPATHEXAMPLE_SLICEGENERATOR
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+#include "ToolpathCurveSimplifier.hpp"
+#include "ToolpathHatchClipper.hpp"
+#include "ToolpathPolygonOffsetter.hpp"
+#include "ToolpathProgress.hpp"
+#include "ToolpathSlicePolygons.hpp"
+#include "ToolpathStatistics.hpp"
+#include "ToolpathThreadPool.hpp"
+
+namespace ToolpathExample {
+
+/**
+* Settings of CToolpathSliceGenerator. Distances are given in toolpath units, angles in degrees.
+*/
+typedef struct sToolpathSliceGeneratorParameters {
+    int32_t m_nHatchDistance;           // Distance between neighbouring hatches
+    double m_dHatchAngle;               // Hatch direction of layer 0, measured from the X axis
+    double m_dHatchAngleIncrement;      // Rotation of the hatch direction from one layer to the next
+    int32_t m_nHatchOffset;             // Inset of the hatched area from the slice outline
+    int32_t m_nMinHatchLength;          // Shorter hatches are dropped
+    std::vector<int32_t> m_ContourOffsets; // Inset of every contour from the slice outline, one loop per polygon each
+    int32_t m_nContourTolerance;        // Loops are simplified within this distance, 0 keeps all points
+} sToolpathSliceGeneratorParameters;
+
+/**
+* Profiles and build item the generated segments are written with. Contour i uses m_ContourProfiles[i], or the last
+* profile if there are fewer profiles than contours.
+*/
+typedef struct sToolpathSliceTargets {
+    std::vector<Lib3MF::PToolpathProfile> m_ContourProfiles;
+    Lib3MF::PToolpathProfile m_pHatchProfile;
+    Lib3MF::PBuildItem m_pBuildItem;
+} sToolpathSliceTargets;
+
+/*************************************************************************************************************************
+ Class CToolpathGeneratedLayer
+
+ Loops and hatches generated for one slice, in toolpath units, together with the scratch storage of the generator.
+ All buffers keep their capacity when the object is reused for another layer.
+**************************************************************************************************************************/
+class CToolpathGeneratedLayer {
+private:
+    std::vector<Lib3MF::sDiscretePosition2D> m_LoopPoints;
+    std::vector<uint32_t> m_LoopStarts;
+    std::vector<uint32_t> m_LoopContours;
+    std::vector<Lib3MF::sDiscreteHatch2D> m_Hatches;
+
+    // Scratch storage of CToolpathSliceGenerator
+    CToolpathSlicePolygons m_OffsetPolygons;
+    CToolpathPolygonOffsetter m_Offsetter;
+    CToolpathHatchClipper m_HatchClipper;
+    CToolpathCurveSimplifier m_Simplifier;
+
+    friend class CToolpathSliceGenerator;
+
+public:
+
+    /**
+    * CToolpathGeneratedLayer::CToolpathGeneratedLayer - Creates an empty layer.
+    */
+    CToolpathGeneratedLayer();
+
+    /**
+    * CToolpathGeneratedLayer::Clear - Removes all loops and hatches and keeps the storage.
+    */
+    void Clear();
+
+    size_t GetLoopCount() const { return m_LoopStarts.size() - 1; }
+    size_t GetLoopPointCount() const { return m_LoopPoints.size(); }
+    size_t GetHatchCount() const { return m_Hatches.size(); }
+    size_t GetSegmentCount() const { return GetLoopCount() + (m_Hatches.empty() ? 0 : 1); }
+    const std::vector<Lib3MF::sDiscreteHatch2D> & GetHatches() const { return m_Hatches; }
+    const std::vector<Lib3MF::sDiscretePosition2D> & GetLoopPoints() const { return m_LoopPoints; }
+
+    /**
+    * CToolpathGeneratedLayer::GetLoopStart - Returns the index of the first point of a loop.
+    * @param[in] nLoopIndex - Loop index, GetLoopCount() returns the point count
+    * @return Point index
+    */
+    uint32_t GetLoopStart(size_t nLoopIndex) const { return m_LoopStarts[nLoopIndex]; }
+
+    /**
+    * CToolpathGeneratedLayer::GetLoopContour - Returns the index of the contour offset a loop belongs to.
+    * @param[in] nLoopIndex - Loop index
+    * @return Index into sToolpathSliceGeneratorParameters::m_ContourOffsets
+    */
+    uint32_t GetLoopContour(size_t nLoopIndex) const { return m_LoopContours[nLoopIndex]; }
+
+    /**
+    * CToolpathGeneratedLayer::Write - Writes every loop as loop segment, contours from the outside in, followed by
+    *   one hatch segment.
+    * @param[in] pLayer - Layer data to write to
+    * @param[in] contourProfileIDs - Profile ID of every contour, the last one is used for further contours
+    * @param[in] nHatchProfileID - Profile ID of the hatches
+    * @param[in] nPartID - Part ID as registered in the layer
+    */
+    void Write(Lib3MF::PToolpathLayerData pLayer, const std::vector<uint32_t> & contourProfileIDs, uint32_t nHatchProfileID, uint32_t nPartID) const;
+
+};
+
+/*************************************************************************************************************************
+ Class CToolpathSliceGenerator
+
+ Turns slice polygons into contour loops and a hatch infill. Contours are the slice outline inset by the contour
+ offsets with a CToolpathPolygonOffsetter, simplified with a CToolpathCurveSimplifier if a contour tolerance is set;
+ hatches are parallel lines clipped against the outline inset by the hatch offset with a CToolpathHatchClipper,
+ rotated from layer to layer and connected in alternating directions. Hatch lines lie on a grid through the origin,
+ so the infill of neighbouring parts lines up.
+ Layers are generated independently of each other, in parallel if a thread pool is set, and written in order.
+**************************************************************************************************************************/
+class CToolpathSliceGenerator {
+private:
+    sToolpathSliceGeneratorParameters m_Parameters;
+    PToolpathThreadPool m_pThreadPool;
+    PToolpathProgress m_pProgress;
+    PToolpathStatistics m_pStatistics;
+
+public:
+
+    /**
+    * CToolpathSliceGenerator::CToolpathSliceGenerator - Creates a generator.
+    * @param[in] parameters - Hatch and contour settings
+    */
+    CToolpathSliceGenerator(const sToolpathSliceGeneratorParameters & parameters);
+
+    /**
+    * CToolpathSliceGenerator::SetThreadPool - Sets the thread pool layers are generated on.
+    * @param[in] pThreadPool - Thread pool, nullptr generates on the calling thread
+    */
+    void SetThreadPool(PToolpathThreadPool pThreadPool);
+
+    /**
+    * CToolpathSliceGenerator::SetProgress - Sets the progress instance that WriteSliceStack reports a WriteLayer event
+    *   to for every written layer. Cancellation stops writing after the current layer with EToolpathCancelled.
+    * @param[in] pProgress - Progress instance, null to disable
+    */
+    void SetProgress(PToolpathProgress pProgress);
+
+    /**
+    * CToolpathSliceGenerator::SetStatistics - Sets the statistics that WriteSliceStack counts written layers, segments
+    *   and points in. Hatches count as two points.
+    * @param[in] pStatistics - Statistics, null to disable
+    */
+    void SetStatistics(PToolpathStatistics pStatistics);
+
+    const sToolpathSliceGeneratorParameters & GetParameters() const { return m_Parameters; }
+
+    /**
+    * CToolpathSliceGenerator::GetHatchAngle - Returns the hatch direction of a layer.
+    * @param[in] nLayerIndex - Layer index
+    * @return Angle in degrees between 0 and 180
+    */
+    double GetHatchAngle(uint32_t nLayerIndex) const;
+
+    /**
+    * CToolpathSliceGenerator::GenerateLayer - Generates the loops and hatches of one slice. Can be called
+    *   concurrently for different layer objects.
+    * @param[in] slice - Slice polygons
+    * @param[in] nLayerIndex - Layer index, selects the hatch angle
+    * @param[out] layer - Generated layer
+    */
+    void GenerateLayer(const CToolpathSlicePolygons & slice, uint32_t nLayerIndex, CToolpathGeneratedLayer & layer) const;
+
+    /**
+    * CToolpathSliceGenerator::GenerateLayers - Generates consecutive layers on the thread pool.
+    * @param[in] slices - Slice polygons
+    * @param[in] nSliceCount - Number of slices to generate, at most the size of slices
+    * @param[in] nFirstLayerIndex - Layer index of the first slice
+    * @param[out] layers - Generated layers, resized to at least nSliceCount
+    */
+    void GenerateLayers(const std::vector<CToolpathSlicePolygons> & slices, size_t nSliceCount, uint32_t nFirstLayerIndex, std::vector<CToolpathGeneratedLayer> & layers) const;
+
+    /**
+    * CToolpathSliceGenerator::WriteSliceStack - Generates a toolpath layer for every slice of a slice stack and
+    *   adds it to the toolpath. Slices are read and layers are written on the calling thread in batches; the
+    *   layers of a batch are generated in parallel.
+    * @param[in] pSliceStack - Slice stack in model units
+    * @param[in] pToolpath - Toolpath to add the layers to, its top layer must be below the first slice
+    * @param[in] pWriter - Model writer the layers are written with
+    * @param[in] targets - Profiles and build item of the segments
+    * @param[in] sLayerPathPrefix - Layer parts are named <prefix><layer number>.xml
+    */
+    void WriteSliceStack(Lib3MF::PSliceStack pSliceStack, Lib3MF::PToolpath pToolpath, Lib3MF::PWriter pWriter, const sToolpathSliceTargets & targets, const std::string & sLayerPathPrefix);
+
+};
+
+typedef std::shared_ptr<CToolpathSliceGenerator> PToolpathSliceGenerator;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_SLICEGENERATOR
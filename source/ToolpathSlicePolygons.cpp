@@ -0,0 +1,189 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+#include "ToolpathSlicePolygons.hpp"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace ToolpathExample {
+
+static int32_t slicePolygonsToUnits(double dValue, double dUnits)
+{
+    double dScaled = std::round(dValue / dUnits);
+    if ((dScaled < (double)std::numeric_limits<int32_t>::min()) || (dScaled > (double)std::numeric_limits<int32_t>::max()))
+        throw std::range_error("slice vertex exceeds the range of toolpath units");
+    return (int32_t)dScaled;
+}
+
+static bool slicePolygonsSameVertex(const Lib3MF::sDiscretePosition2D & a, const Lib3MF::sDiscretePosition2D & b)
+{
+    return (a.m_Coordinates[0] == b.m_Coordinates[0]) && (a.m_Coordinates[1] == b.m_Coordinates[1]);
+}
+
+CToolpathSlicePolygons::CToolpathSlicePolygons()
+{
+    m_PolygonStarts.push_back(0);
+}
+
+void CToolpathSlicePolygons::Clear()
+{
+    m_Vertices.clear();
+    m_PolygonStarts.clear();
+    m_PolygonStarts.push_back(0);
+}
+
+void CToolpathSlicePolygons::AddPolygon(const Lib3MF::sDiscretePosition2D * pVertices, size_t nVertexCount)
+{
+    if ((pVertices == nullptr) && (nVertexCount > 0))
+        throw std::invalid_argument("invalid polygon vertices");
+
+    BeginPolygon();
+    m_Vertices.insert(m_Vertices.end(), pVertices, pVertices + nVertexCount);
+    EndPolygon();
+}
+
+void CToolpathSlicePolygons::BeginPolygon()
+{
+    m_Vertices.resize(m_PolygonStarts.back());
+}
+
+void CToolpathSlicePolygons::EndPolygon()
+{
+    size_t nStart = m_PolygonStarts.back();
+    size_t nEnd = nStart;
+    for (size_t nIndex = nStart; nIndex < m_Vertices.size(); nIndex++) {
+        if ((nEnd == nStart) || !slicePolygonsSameVertex(m_Vertices[nEnd - 1], m_Vertices[nIndex]))
+            m_Vertices[nEnd++] = m_Vertices[nIndex];
+    }
+    while ((nEnd - nStart > 1) && slicePolygonsSameVertex(m_Vertices[nEnd - 1], m_Vertices[nStart]))
+        nEnd--;
+
+    if (nEnd - nStart < 3)
+        nEnd = nStart;
+    if (nEnd > (size_t)std::numeric_limits<uint32_t>::max())
+        throw std::range_error("too many slice vertices");
+
+    m_Vertices.resize(nEnd);
+    if (nEnd > nStart)
+        m_PolygonStarts.push_back((uint32_t)nEnd);
+}
+
+void CToolpathSlicePolygons::ReadSlice(Lib3MF::PSlice pSlice, double dUnits)
+{
+    if (pSlice.get() == nullptr)
+        throw std::invalid_argument("invalid slice");
+    if (dUnits <= 0.0)
+        throw std::invalid_argument("invalid toolpath units");
+
+    std::vector<Lib3MF::sPosition2D> vertices;
+    std::vector<Lib3MF_uint32> indices;
+    pSlice->GetVertices(vertices);
+
+    Clear();
+    uint64_t nPolygonCount = pSlice->GetPolygonCount();
+    for (uint64_t nPolygonIndex = 0; nPolygonIndex < nPolygonCount; nPolygonIndex++) {
+        pSlice->GetPolygonIndices(nPolygonIndex, indices);
+        if ((indices.size() < 2) || (indices.front() != indices.back()))
+            continue;
+
+        BeginPolygon();
+        for (Lib3MF_uint32 nVertexIndex : indices) {
+            if (nVertexIndex >= vertices.size())
+                throw std::out_of_range("invalid slice polygon index");
+            const Lib3MF::sPosition2D & vertex = vertices[nVertexIndex];
+            AddVertex(slicePolygonsToUnits(vertex.m_Coordinates[0], dUnits), slicePolygonsToUnits(vertex.m_Coordinates[1], dUnits));
+        }
+        EndPolygon();
+    }
+}
+
+int64_t CToolpathSlicePolygons::GetSignedArea(size_t nPolygonIndex) const
+{
+    uint32_t nStart = GetPolygonStart(nPolygonIndex);
+    uint32_t nSize = GetPolygonSize(nPolygonIndex);
+
+    int64_t nArea = 0;
+    for (uint32_t nIndex = 0; nIndex < nSize; nIndex++) {
+        const Lib3MF::sDiscretePosition2D & a = m_Vertices[nStart + nIndex];
+        const Lib3MF::sDiscretePosition2D & b = m_Vertices[nStart + (nIndex + 1) % nSize];
+        nArea += (int64_t)a.m_Coordinates[0] * b.m_Coordinates[1] - (int64_t)b.m_Coordinates[0] * a.m_Coordinates[1];
+    }
+    return nArea;
+}
+
+double CToolpathSlicePolygons::GetArea() const
+{
+    double dArea = 0.0;
+    for (size_t nPolygonIndex = 0; nPolygonIndex < GetPolygonCount(); nPolygonIndex++) {
+        double dPolygonArea = std::fabs((double)GetSignedArea(nPolygonIndex)) * 0.5;
+        dArea += IsHole(nPolygonIndex) ? -dPolygonArea : dPolygonArea;
+    }
+    return dArea;
+}
+
+bool CToolpathSlicePolygons::IsHole(size_t nPolygonIndex) const
+{
+    const Lib3MF::sDiscretePosition2D & point = m_Vertices[GetPolygonStart(nPolygonIndex)];
+    int64_t nX = point.m_Coordinates[0];
+    int64_t nY = point.m_Coordinates[1];
+
+    bool bHole = false;
+    for (size_t nOtherIndex = 0; nOtherIndex < GetPolygonCount(); nOtherIndex++) {
+        if (nOtherIndex == nPolygonIndex)
+            continue;
+
+        uint32_t nStart = GetPolygonStart(nOtherIndex);
+        uint32_t nSize = GetPolygonSize(nOtherIndex);
+        bool bInside = false;
+        for (uint32_t nIndex = 0; nIndex < nSize; nIndex++) {
+            const Lib3MF::sDiscretePosition2D & a = m_Vertices[nStart + nIndex];
+            const Lib3MF::sDiscretePosition2D & b = m_Vertices[nStart + (nIndex + 1) % nSize];
+            int64_t nAY = a.m_Coordinates[1];
+            int64_t nBY = b.m_Coordinates[1];
+            if ((nAY > nY) != (nBY > nY)) {
+                // Compare nX with the crossing point of the edge without dividing
+                int64_t nAX = a.m_Coordinates[0];
+                int64_t nBX = b.m_Coordinates[0];
+                int64_t nCross = (nBX - nAX) * (nY - nAY) - (nX - nAX) * (nBY - nAY);
+                if ((nBY > nAY) ? (nCross > 0) : (nCross < 0))
+                    bInside = !bInside;
+            }
+        }
+        if (bInside)
+            bHole = !bHole;
+    }
+    return bHole;
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,140 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+
+
+#ifndef __TOOLPATHEXAMPLE_SLICEPOLYGONS
+#define __TOOLPATHEXAMPLE_SLICEPOLYGONS
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "lib3mf_dynamic.hpp"
+
+namespace ToolpathExample {
+
+/*************************************************************************************************************************
+ Class CToolpathSlicePolygons
+
+ Closed polygons of one slice in toolpath units. The area of the slice is given by the even-odd rule, so holes are
+ polygons nested inside outer polygons regardless of their orientation. Vertices of all polygons are stored in one
+ array; polygons do not repeat their first vertex at the end.
+**************************************************************************************************************************/
+class CToolpathSlicePolygons {
+private:
+    std::vector<Lib3MF::sDiscretePosition2D> m_Vertices;
+    std::vector<uint32_t> m_PolygonStarts;
+
+public:
+
+    /**
+    * CToolpathSlicePolygons::CToolpathSlicePolygons - Creates an empty slice.
+    */
+    CToolpathSlicePolygons();
+
+    /**
+    * CToolpathSlicePolygons::Clear - Removes all polygons and keeps the storage.
+    */
+    void Clear();
+
+    /**
+    * CToolpathSlicePolygons::AddPolygon - Appends a closed polygon. Consecutive duplicate vertices and a repeated
+    *   first vertex are dropped; polygons with less than 3 remaining vertices are ignored.
+    * @param[in] pVertices - Vertices in toolpath units
+    * @param[in] nVertexCount - Number of vertices
+    */
+    void AddPolygon(const Lib3MF::sDiscretePosition2D * pVertices, size_t nVertexCount);
+
+    /**
+    * CToolpathSlicePolygons::BeginPolygon - Starts a polygon whose vertices are added with AddVertex.
+    */
+    void BeginPolygon();
+
+    inline void AddVertex(int32_t nX, int32_t nY)
+    {
+        m_Vertices.push_back({ { nX, nY } });
+    }
+
+    /**
+    * CToolpathSlicePolygons::EndPolygon - Finishes the polygon started with BeginPolygon, with the same cleanup
+    *   as AddPolygon.
+    */
+    void EndPolygon();
+
+    /**
+    * CToolpathSlicePolygons::ReadSlice - Replaces the polygons with the closed polygons of a slice. Open polylines
+    *   are skipped.
+    * @param[in] pSlice - Slice with vertices in model units
+    * @param[in] dUnits - Size of a toolpath unit in model units
+    */
+    void ReadSlice(Lib3MF::PSlice pSlice, double dUnits);
+
+    size_t GetPolygonCount() const { return m_PolygonStarts.size() - 1; }
+    size_t GetVertexCount() const { return m_Vertices.size(); }
+    const std::vector<Lib3MF::sDiscretePosition2D> & GetVertices() const { return m_Vertices; }
+
+    /**
+    * CToolpathSlicePolygons::GetPolygonStart - Returns the index of the first vertex of a polygon.
+    * @param[in] nPolygonIndex - Polygon index, GetPolygonCount() returns the vertex count
+    * @return Vertex index
+    */
+    uint32_t GetPolygonStart(size_t nPolygonIndex) const { return m_PolygonStarts[nPolygonIndex]; }
+    uint32_t GetPolygonSize(size_t nPolygonIndex) const { return m_PolygonStarts[nPolygonIndex + 1] - m_PolygonStarts[nPolygonIndex]; }
+
+    /**
+    * CToolpathSlicePolygons::GetSignedArea - Returns twice the signed area of a polygon, positive if counterclockwise.
+    * @param[in] nPolygonIndex - Polygon index
+    * @return Twice the area in square toolpath units
+    */
+    int64_t GetSignedArea(size_t nPolygonIndex) const;
+
+    /**
+    * CToolpathSlicePolygons::GetArea - Returns the area covered by the slice under the even-odd rule.
+    * @return Area in square toolpath units
+    */
+    double GetArea() const;
+
+    /**
+    * CToolpathSlicePolygons::IsHole - Returns whether a polygon lies inside an odd number of other polygons.
+    * @param[in] nPolygonIndex - Polygon index
+    * @return true, if the polygon bounds a hole
+    */
+    bool IsHole(size_t nPolygonIndex) const;
+
+};
+
+typedef std::shared_ptr<CToolpathSlicePolygons> PToolpathSlicePolygons;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_SLICEPOLYGONS
@@ -0,0 +1,153 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathStatistics.hpp"
+
+#include <iomanip>
+
+namespace ToolpathExample {
+
+CToolpathStatistics::CToolpathStatistics()
+{
+    Reset();
+}
+
+void CToolpathStatistics::AddTime(eToolpathTimer timer, uint64_t nNanoseconds)
+{
+    sTimerData & timerData = m_Timers[(uint32_t)timer];
+    timerData.m_nCount.fetch_add(1, std::memory_order_relaxed);
+    timerData.m_nTotalNanoseconds.fetch_add(nNanoseconds, std::memory_order_relaxed);
+
+    uint64_t nMax = timerData.m_nMaxNanoseconds.load(std::memory_order_relaxed);
+    while ((nNanoseconds > nMax) && !timerData.m_nMaxNanoseconds.compare_exchange_weak(nMax, nNanoseconds, std::memory_order_relaxed)) {
+    }
+
+    // Logarithmic buckets in microseconds
+    uint64_t nMicroseconds = nNanoseconds / 1000;
+    uint32_t nBucket = 0;
+    while ((nMicroseconds > 1) && (nBucket < TOOLPATHSTATISTICS_HISTOGRAM_BUCKETS - 1)) {
+        nMicroseconds >>= 1;
+        nBucket++;
+    }
+    timerData.m_Histogram[nBucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t CToolpathStatistics::GetCount(eToolpathCounter counter) const
+{
+    return m_Counters[(uint32_t)counter].load(std::memory_order_relaxed);
+}
+
+sToolpathTimerSnapshot CToolpathStatistics::GetTimer(eToolpathTimer timer) const
+{
+    const sTimerData & timerData = m_Timers[(uint32_t)timer];
+
+    sToolpathTimerSnapshot snapshot;
+    snapshot.m_nCount = timerData.m_nCount.load(std::memory_order_relaxed);
+    snapshot.m_nTotalNanoseconds = timerData.m_nTotalNanoseconds.load(std::memory_order_relaxed);
+    snapshot.m_nMaxNanoseconds = timerData.m_nMaxNanoseconds.load(std::memory_order_relaxed);
+    snapshot.m_Histogram.resize(TOOLPATHSTATISTICS_HISTOGRAM_BUCKETS);
+    for (uint32_t nBucket = 0; nBucket < TOOLPATHSTATISTICS_HISTOGRAM_BUCKETS; nBucket++)
+        snapshot.m_Histogram[nBucket] = timerData.m_Histogram[nBucket].load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+void CToolpathStatistics::Reset()
+{
+    for (auto & counter : m_Counters)
+        counter.store(0, std::memory_order_relaxed);
+
+    for (auto & timerData : m_Timers) {
+        timerData.m_nCount.store(0, std::memory_order_relaxed);
+        timerData.m_nTotalNanoseconds.store(0, std::memory_order_relaxed);
+        timerData.m_nMaxNanoseconds.store(0, std::memory_order_relaxed);
+        for (auto & bucket : timerData.m_Histogram)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void CToolpathStatistics::WriteReport(std::ostream & stream) const
+{
+    for (uint32_t nCounter = 0; nCounter < (uint32_t)eToolpathCounter::COUNT; nCounter++) {
+        uint64_t nValue = GetCount((eToolpathCounter)nCounter);
+        if (nValue > 0)
+            stream << "  " << std::left << std::setw(20) << GetCounterName((eToolpathCounter)nCounter) << nValue << std::endl;
+    }
+
+    for (uint32_t nTimer = 0; nTimer < (uint32_t)eToolpathTimer::COUNT; nTimer++) {
+        sToolpathTimerSnapshot snapshot = GetTimer((eToolpathTimer)nTimer);
+        if (snapshot.m_nCount == 0)
+            continue;
+
+        stream << "  " << std::left << std::setw(20) << GetTimerName((eToolpathTimer)nTimer)
+            << snapshot.m_nCount << " calls, " << snapshot.m_nTotalNanoseconds / 1000 << " us total, "
+            << snapshot.m_nTotalNanoseconds / snapshot.m_nCount / 1000 << " us mean, "
+            << snapshot.m_nMaxNanoseconds / 1000 << " us max" << std::endl;
+
+        for (uint32_t nBucket = 0; nBucket < TOOLPATHSTATISTICS_HISTOGRAM_BUCKETS; nBucket++) {
+            if (snapshot.m_Histogram[nBucket] > 0)
+                stream << "    below " << ((uint64_t)2 << nBucket) << " us: " << snapshot.m_Histogram[nBucket] << std::endl;
+        }
+    }
+}
+
+const char * CToolpathStatistics::GetCounterName(eToolpathCounter counter)
+{
+    switch (counter) {
+        case eToolpathCounter::LayersRead: return "layers read";
+        case eToolpathCounter::LayersWritten: return "layers written";
+        case eToolpathCounter::SegmentsRead: return "segments read";
+        case eToolpathCounter::PointsRead: return "points read";
+        case eToolpathCounter::SegmentsWritten: return "segments written";
+        case eToolpathCounter::PointsWritten: return "points written";
+        case eToolpathCounter::BytesInflatedIn: return "bytes inflated in";
+        case eToolpathCounter::BytesInflatedOut: return "bytes inflated out";
+        case eToolpathCounter::BytesDeflatedIn: return "bytes deflated in";
+        case eToolpathCounter::BytesDeflatedOut: return "bytes deflated out";
+        case eToolpathCounter::BytesCopied: return "bytes copied";
+        default: return "unknown";
+    }
+}
+
+const char * CToolpathStatistics::GetTimerName(eToolpathTimer timer)
+{
+    switch (timer) {
+        case eToolpathTimer::LayerRead: return "layer read";
+        case eToolpathTimer::LayerWrite: return "layer write";
+        case eToolpathTimer::ModelWrite: return "model write";
+        case eToolpathTimer::Inflate: return "inflate";
+        case eToolpathTimer::Deflate: return "deflate";
+        case eToolpathTimer::Rasterize: return "rasterize";
+        default: return "unknown";
+    }
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,203 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef __TOOLPATHEXAMPLE_STATISTICS
+#define __TOOLPATHEXAMPLE_STATISTICS
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace ToolpathExample {
+
+#define TOOLPATHSTATISTICS_HISTOGRAM_BUCKETS 32
+
+enum class eToolpathCounter : uint32_t {
+    LayersRead = 0, /** Number of layers read */
+    LayersWritten = 1, /** Number of layers written */
+    SegmentsRead = 2, /** Number of segments of read layers */
+    PointsRead = 3, /** Number of points of read segments, only counted where segments are traversed */
+    SegmentsWritten = 4, /** Number of segments passed to the layer writer */
+    PointsWritten = 5, /** Number of points passed to the layer writer */
+    BytesInflatedIn = 6, /** Compressed bytes of inflated package entries */
+    BytesInflatedOut = 7, /** Uncompressed bytes of inflated package entries */
+    BytesDeflatedIn = 8, /** Uncompressed bytes of compressed package entries */
+    BytesDeflatedOut = 9, /** Compressed bytes of compressed package entries */
+    BytesCopied = 10, /** Bytes of package entries copied without recompression */
+    COUNT = 11
+};
+
+enum class eToolpathTimer : uint32_t {
+    LayerRead = 0, /** ReadLayerData, including inflating and parsing the layer part */
+    LayerWrite = 1, /** Passing the segments of one layer to lib3mf */
+    ModelWrite = 2, /** CWriter::WriteToFile */
+    Inflate = 3, /** Inflating one package entry */
+    Deflate = 4, /** Deflating one package entry or chunk */
+    Rasterize = 5, /** Rasterizing one layer */
+    COUNT = 6
+};
+
+/* Snapshot of a timer. Bucket i of the histogram counts durations below 2^(i+1) microseconds. */
+typedef struct sToolpathTimerSnapshot {
+    uint64_t m_nCount;
+    uint64_t m_nTotalNanoseconds;
+    uint64_t m_nMaxNanoseconds;
+    std::vector<uint64_t> m_Histogram;
+} sToolpathTimerSnapshot;
+
+/*************************************************************************************************************************
+ Class CToolpathStatistics
+
+ Cumulative counters and latency histograms of the toolpath helpers. All helpers take the statistics as an optional
+ pointer; without one, no clock is read and no counter is touched. Counters are updated with relaxed atomics, so
+ they can be read at any time from any thread.
+**************************************************************************************************************************/
+class CToolpathStatistics {
+private:
+    struct sTimerData {
+        std::atomic<uint64_t> m_nCount;
+        std::atomic<uint64_t> m_nTotalNanoseconds;
+        std::atomic<uint64_t> m_nMaxNanoseconds;
+        std::atomic<uint64_t> m_Histogram[TOOLPATHSTATISTICS_HISTOGRAM_BUCKETS];
+    };
+
+    std::atomic<uint64_t> m_Counters[(uint32_t)eToolpathCounter::COUNT];
+    sTimerData m_Timers[(uint32_t)eToolpathTimer::COUNT];
+
+public:
+
+    /**
+    * CToolpathStatistics::CToolpathStatistics - Creates statistics with all counters set to zero.
+    */
+    CToolpathStatistics();
+
+    CToolpathStatistics(const CToolpathStatistics &) = delete;
+    CToolpathStatistics & operator=(const CToolpathStatistics &) = delete;
+
+    /**
+    * CToolpathStatistics::AddCount - Adds to a counter. Thread safe.
+    * @param[in] counter - Counter
+    * @param[in] nValue - Value to add
+    */
+    inline void AddCount(eToolpathCounter counter, uint64_t nValue)
+    {
+        m_Counters[(uint32_t)counter].fetch_add(nValue, std::memory_order_relaxed);
+    }
+
+    /**
+    * CToolpathStatistics::AddTime - Records one duration of a timer. Thread safe.
+    * @param[in] timer - Timer
+    * @param[in] nNanoseconds - Duration
+    */
+    void AddTime(eToolpathTimer timer, uint64_t nNanoseconds);
+
+    /**
+    * CToolpathStatistics::GetCount - Returns the value of a counter.
+    * @param[in] counter - Counter
+    * @return Current value
+    */
+    uint64_t GetCount(eToolpathCounter counter) const;
+
+    /**
+    * CToolpathStatistics::GetTimer - Returns a snapshot of a timer.
+    * @param[in] timer - Timer
+    * @return Count, total, maximum and histogram of the recorded durations
+    */
+    sToolpathTimerSnapshot GetTimer(eToolpathTimer timer) const;
+
+    /**
+    * CToolpathStatistics::Reset - Sets all counters and timers to zero.
+    */
+    void Reset();
+
+    /**
+    * CToolpathStatistics::WriteReport - Writes all non-zero counters and timers in human readable form.
+    * @param[in] stream - Output stream
+    */
+    void WriteReport(std::ostream & stream) const;
+
+    /**
+    * CToolpathStatistics::GetCounterName - Returns the name of a counter.
+    * @param[in] counter - Counter
+    * @return Name
+    */
+    static const char * GetCounterName(eToolpathCounter counter);
+
+    /**
+    * CToolpathStatistics::GetTimerName - Returns the name of a timer.
+    * @param[in] timer - Timer
+    * @return Name
+    */
+    static const char * GetTimerName(eToolpathTimer timer);
+
+};
+
+typedef std::shared_ptr<CToolpathStatistics> PToolpathStatistics;
+
+/*************************************************************************************************************************
+ Class CToolpathScopedTimer
+
+ Records the lifetime of the instance in a timer. Does nothing if no statistics are given.
+**************************************************************************************************************************/
+class CToolpathScopedTimer {
+private:
+    CToolpathStatistics * m_pStatistics;
+    eToolpathTimer m_Timer;
+    std::chrono::steady_clock::time_point m_StartTime;
+
+public:
+
+    CToolpathScopedTimer(CToolpathStatistics * pStatistics, eToolpathTimer timer)
+        : m_pStatistics(pStatistics), m_Timer(timer)
+    {
+        if (m_pStatistics != nullptr)
+            m_StartTime = std::chrono::steady_clock::now();
+    }
+
+    ~CToolpathScopedTimer()
+    {
+        if (m_pStatistics != nullptr) {
+            auto duration = std::chrono::steady_clock::now() - m_StartTime;
+            m_pStatistics->AddTime(m_Timer, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+        }
+    }
+
+    CToolpathScopedTimer(const CToolpathScopedTimer &) = delete;
+    CToolpathScopedTimer & operator=(const CToolpathScopedTimer &) = delete;
+
+};
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_STATISTICS
@@ -0,0 +1,159 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathThreadPool.hpp"
+
+namespace ToolpathExample {
+
+CToolpathThreadPool::CToolpathThreadPool(uint32_t nThreadCount)
+    : m_pCurrentTask(nullptr), m_nTaskCount(0), m_nNextTaskIndex(0), m_nActiveWorkers(0), m_nGeneration(0), m_bShutdown(false)
+{
+    if (nThreadCount == 0)
+        nThreadCount = std::thread::hardware_concurrency();
+    if (nThreadCount == 0)
+        nThreadCount = 1;
+
+    // The calling thread acts as worker 0, so only spawn the remaining ones.
+    for (uint32_t nWorkerIndex = 1; nWorkerIndex < nThreadCount; nWorkerIndex++)
+        m_Workers.push_back(std::thread(&CToolpathThreadPool::workerLoop, this, nWorkerIndex));
+}
+
+CToolpathThreadPool::~CToolpathThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_bShutdown = true;
+    }
+    m_WorkAvailable.notify_all();
+
+    for (auto & worker : m_Workers)
+        worker.join();
+}
+
+uint32_t CToolpathThreadPool::GetThreadCount() const
+{
+    return (uint32_t)m_Workers.size() + 1;
+}
+
+void CToolpathThreadPool::runTasks(const TaskFunction & fnTask, uint32_t nWorkerIndex)
+{
+    while (true) {
+        uint64_t nTaskIndex = m_nNextTaskIndex.fetch_add(1);
+        if (nTaskIndex >= m_nTaskCount)
+            break;
+
+        try {
+            fnTask(nTaskIndex, nWorkerIndex);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (!m_pFirstException)
+                m_pFirstException = std::current_exception();
+
+            // Skip all remaining tasks
+            m_nNextTaskIndex.store(m_nTaskCount);
+        }
+    }
+}
+
+void CToolpathThreadPool::workerLoop(uint32_t nWorkerIndex)
+{
+    uint64_t nLastGeneration = 0;
+
+    while (true) {
+        const TaskFunction * pTask = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkAvailable.wait(lock, [&] { return m_bShutdown || (m_nGeneration != nLastGeneration); });
+            if (m_bShutdown)
+                return;
+
+            nLastGeneration = m_nGeneration;
+            pTask = m_pCurrentTask;
+
+            // The job may already have finished before this worker woke up.
+            if (pTask == nullptr)
+                continue;
+
+            m_nActiveWorkers++;
+        }
+
+        runTasks(*pTask, nWorkerIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_nActiveWorkers--;
+        }
+        m_WorkDone.notify_all();
+    }
+}
+
+void CToolpathThreadPool::ParallelFor(uint64_t nTaskCount, const TaskFunction & fnTask)
+{
+    if (nTaskCount == 0)
+        return;
+
+    // Small jobs and single threaded pools do not need to wake anybody up.
+    if (m_Workers.empty() || nTaskCount == 1) {
+        for (uint64_t nTaskIndex = 0; nTaskIndex < nTaskCount; nTaskIndex++)
+            fnTask(nTaskIndex, 0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> jobLock(m_JobMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_pCurrentTask = &fnTask;
+        m_nTaskCount = nTaskCount;
+        m_nNextTaskIndex.store(0);
+        m_pFirstException = nullptr;
+        m_nGeneration++;
+    }
+    m_WorkAvailable.notify_all();
+
+    runTasks(fnTask, 0);
+
+    std::exception_ptr pException;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        // Workers that have not picked up this generation yet will find no tasks left.
+        m_WorkDone.wait(lock, [&] { return m_nActiveWorkers == 0; });
+        m_pCurrentTask = nullptr;
+        pException = m_pFirstException;
+        m_pFirstException = nullptr;
+    }
+
+    if (pException)
+        std::rethrow_exception(pException);
+}
+
+} // namespace ToolpathExample
@@ -0,0 +1,108 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef __TOOLPATHEXAMPLE_THREADPOOL
+#define __TOOLPATHEXAMPLE_THREADPOOL
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ToolpathExample {
+
+/*************************************************************************************************************************
+ Class CToolpathThreadPool
+**************************************************************************************************************************/
+class CToolpathThreadPool {
+public:
+    typedef std::function<void(uint64_t nTaskIndex, uint32_t nWorkerIndex)> TaskFunction;
+
+private:
+    std::vector<std::thread> m_Workers;
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkAvailable;
+    std::condition_variable m_WorkDone;
+
+    /* Current job. Only one ParallelFor may run at a time. */
+    std::mutex m_JobMutex;
+    const TaskFunction * m_pCurrentTask;
+    uint64_t m_nTaskCount;
+    std::atomic<uint64_t> m_nNextTaskIndex;
+    uint32_t m_nActiveWorkers;
+    uint64_t m_nGeneration;
+    bool m_bShutdown;
+    std::exception_ptr m_pFirstException;
+
+    void workerLoop(uint32_t nWorkerIndex);
+    void runTasks(const TaskFunction & fnTask, uint32_t nWorkerIndex);
+
+public:
+
+    /**
+    * CToolpathThreadPool::CToolpathThreadPool - Creates a pool with a fixed number of workers.
+    * @param[in] nThreadCount - Number of threads including the calling thread. 0 uses the hardware concurrency.
+    */
+    explicit CToolpathThreadPool(uint32_t nThreadCount = 0);
+
+    ~CToolpathThreadPool();
+
+    CToolpathThreadPool(const CToolpathThreadPool &) = delete;
+    CToolpathThreadPool & operator=(const CToolpathThreadPool &) = delete;
+
+    /**
+    * CToolpathThreadPool::GetThreadCount - Returns the number of threads that execute tasks, including the caller.
+    * @return Thread count
+    */
+    uint32_t GetThreadCount() const;
+
+    /**
+    * CToolpathThreadPool::ParallelFor - Runs fnTask for every index in [0, nTaskCount) and blocks until all tasks are done.
+    *   The calling thread participates as worker 0. The first exception thrown by a task is rethrown after all
+    *   workers have stopped. Tasks must not call ParallelFor on the same pool, such a nested call deadlocks
+    *   because only one job can run at a time.
+    * @param[in] nTaskCount - Number of tasks
+    * @param[in] fnTask - Task function, receives the task index and the index of the executing worker
+    */
+    void ParallelFor(uint64_t nTaskCount, const TaskFunction & fnTask);
+
+};
+
+typedef std::shared_ptr<CToolpathThreadPool> PToolpathThreadPool;
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_THREADPOOL
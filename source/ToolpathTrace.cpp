@@ -0,0 +1,163 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ToolpathTrace.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+
+namespace ToolpathExample {
+
+// IDs instead of addresses identify tracers in the thread cache, so a new tracer at the address of a
+// destroyed one never sees a stale buffer.
+static std::atomic<uint64_t> s_nNextTracerID(1);
+
+typedef struct sThreadTraceCache {
+    uint64_t m_nTracerID;
+    sToolpathTraceBuffer * m_pBuffer;
+} sThreadTraceCache;
+
+static thread_local sThreadTraceCache s_ThreadTraceCache = { 0, nullptr };
+
+static void writeJSONString(std::ostream & stream, const char * pString)
+{
+    stream << '"';
+    for (const char * pChar = pString; *pChar != 0; pChar++) {
+        if ((*pChar == '"') || (*pChar == '\\'))
+            stream << '\\';
+        stream << *pChar;
+    }
+    stream << '"';
+}
+
+static void writeMicroseconds(std::ostream & stream, uint64_t nNanoseconds)
+{
+    uint64_t nFraction = nNanoseconds % 1000;
+    stream << nNanoseconds / 1000 << '.' << (char)('0' + nFraction / 100) << (char)('0' + (nFraction / 10) % 10) << (char)('0' + nFraction % 10);
+}
+
+CToolpathTracer::CToolpathTracer()
+    : m_nTracerID(s_nNextTracerID.fetch_add(1)), m_StartTime(std::chrono::steady_clock::now())
+{
+}
+
+uint64_t CToolpathTracer::GetTimestamp() const
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_StartTime).count();
+}
+
+sToolpathTraceBuffer * CToolpathTracer::registerThread()
+{
+    std::lock_guard<std::mutex> lock(m_BufferMutex);
+
+    std::unique_ptr<sToolpathTraceBuffer> pBuffer(new sToolpathTraceBuffer());
+    pBuffer->m_nThreadIndex = (uint32_t)m_Buffers.size();
+    pBuffer->m_Events.reserve(4096);
+    m_Buffers.push_back(std::move(pBuffer));
+
+    return m_Buffers.back().get();
+}
+
+sToolpathTraceBuffer * CToolpathTracer::GetThreadBuffer()
+{
+    // A thread that alternates between tracers registers again; its spans are then split over two buffers.
+    if (s_ThreadTraceCache.m_nTracerID != m_nTracerID) {
+        s_ThreadTraceCache.m_pBuffer = registerThread();
+        s_ThreadTraceCache.m_nTracerID = m_nTracerID;
+    }
+
+    return s_ThreadTraceCache.m_pBuffer;
+}
+
+void CToolpathTracer::AddEvent(const sToolpathTraceEvent & event)
+{
+    GetThreadBuffer()->m_Events.push_back(event);
+}
+
+uint64_t CToolpathTracer::GetEventCount()
+{
+    std::lock_guard<std::mutex> lock(m_BufferMutex);
+
+    uint64_t nCount = 0;
+    for (auto & pBuffer : m_Buffers)
+        nCount += pBuffer->m_Events.size();
+    return nCount;
+}
+
+void CToolpathTracer::WriteChromeTrace(std::ostream & stream)
+{
+    std::lock_guard<std::mutex> lock(m_BufferMutex);
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+
+    bool bFirst = true;
+    for (auto & pBuffer : m_Buffers) {
+        uint32_t nThreadID = pBuffer->m_nThreadIndex + 1;
+
+        stream << (bFirst ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << nThreadID
+            << ",\"args\":{\"name\":\"thread " << nThreadID << "\"}}";
+        bFirst = false;
+
+        for (auto & event : pBuffer->m_Events) {
+            stream << ",\n{\"name\":";
+            writeJSONString(stream, event.m_pName);
+            stream << ",\"cat\":";
+            writeJSONString(stream, event.m_pCategory);
+            stream << ",\"ph\":\"X\",\"ts\":";
+            writeMicroseconds(stream, event.m_nStartNanoseconds);
+            stream << ",\"dur\":";
+            writeMicroseconds(stream, event.m_nDurationNanoseconds);
+            stream << ",\"pid\":1,\"tid\":" << nThreadID;
+            if (event.m_pArgumentName != nullptr) {
+                stream << ",\"args\":{";
+                writeJSONString(stream, event.m_pArgumentName);
+                stream << ":" << event.m_nArgument << "}";
+            }
+            stream << "}";
+        }
+    }
+
+    stream << "\n]}" << std::endl;
+}
+
+void CToolpathTracer::WriteChromeTraceToFile(const std::string & sFileName)
+{
+    std::ofstream stream(sFileName, std::ios::trunc);
+    if (!stream.is_open())
+        throw std::runtime_error("could not create trace file " + sFileName);
+
+    WriteChromeTrace(stream);
+    if (!stream)
+        throw std::runtime_error("could not write trace file " + sFileName);
+}
+
+} // namespace ToolpathExample
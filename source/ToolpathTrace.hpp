@@ -0,0 +1,175 @@
+/*++
+
+Copyright (C) 2025 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Autodesk Inc. nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL AUTODESK INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef __TOOLPATHEXAMPLE_TRACE
+#define __TOOLPATHEXAMPLE_TRACE
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ToolpathExample {
+
+/* Completed span. Name, category and argument name must be string literals or otherwise outlive the tracer. */
+typedef struct sToolpathTraceEvent {
+    const char * m_pName;
+    const char * m_pCategory;
+    const char * m_pArgumentName;
+    uint64_t m_nArgument;
+    uint64_t m_nStartNanoseconds;
+    uint64_t m_nDurationNanoseconds;
+} sToolpathTraceEvent;
+
+/* Events of one thread. Only the owning thread appends to it. */
+typedef struct sToolpathTraceBuffer {
+    uint32_t m_nThreadIndex;
+    std::vector<sToolpathTraceEvent> m_Events;
+} sToolpathTraceBuffer;
+
+/*************************************************************************************************************************
+ Class CToolpathTracer
+
+ Records timed spans of the toolpath helpers and writes them in Chrome trace JSON format, which can be opened in
+ Perfetto or chrome://tracing. Every thread records into its own buffer, the mutex is only taken once per thread
+ and tracer to register the buffer. Export the trace after the traced operations have finished.
+**************************************************************************************************************************/
+class CToolpathTracer {
+private:
+    uint64_t m_nTracerID;
+    std::chrono::steady_clock::time_point m_StartTime;
+    std::mutex m_BufferMutex;
+    std::vector<std::unique_ptr<sToolpathTraceBuffer>> m_Buffers;
+
+    sToolpathTraceBuffer * registerThread();
+
+public:
+
+    /**
+    * CToolpathTracer::CToolpathTracer - Creates a tracer. Timestamps are relative to its creation.
+    */
+    CToolpathTracer();
+
+    CToolpathTracer(const CToolpathTracer &) = delete;
+    CToolpathTracer & operator=(const CToolpathTracer &) = delete;
+
+    /**
+    * CToolpathTracer::GetTimestamp - Returns the time since creation of the tracer.
+    * @return Time in nanoseconds
+    */
+    uint64_t GetTimestamp() const;
+
+    /**
+    * CToolpathTracer::GetThreadBuffer - Returns the buffer of the calling thread, registering it on first use.
+    * @return Buffer of the calling thread
+    */
+    sToolpathTraceBuffer * GetThreadBuffer();
+
+    /**
+    * CToolpathTracer::AddEvent - Records a completed span on the calling thread.
+    * @param[in] event - Span
+    */
+    void AddEvent(const sToolpathTraceEvent & event);
+
+    /**
+    * CToolpathTracer::GetEventCount - Returns the number of recorded spans of all threads.
+    * @return Event count
+    */
+    uint64_t GetEventCount();
+
+    /**
+    * CToolpathTracer::WriteChromeTrace - Writes all spans as Chrome trace JSON.
+    * @param[in] stream - Output stream
+    */
+    void WriteChromeTrace(std::ostream & stream);
+
+    /**
+    * CToolpathTracer::WriteChromeTraceToFile - Writes all spans as Chrome trace JSON file.
+    * @param[in] sFileName - Target file, e.g. "write.trace.json"
+    */
+    void WriteChromeTraceToFile(const std::string & sFileName);
+
+};
+
+typedef std::shared_ptr<CToolpathTracer> PToolpathTracer;
+
+/*************************************************************************************************************************
+ Class CToolpathTraceSpan
+
+ Records its own lifetime as span. Does nothing if no tracer is given.
+**************************************************************************************************************************/
+class CToolpathTraceSpan {
+private:
+    CToolpathTracer * m_pTracer;
+    sToolpathTraceEvent m_Event;
+
+public:
+
+    /**
+    * CToolpathTraceSpan::CToolpathTraceSpan - Starts a span.
+    * @param[in] pTracer - Tracer, may be null
+    * @param[in] pName - Span name, e.g. "ReadLayerData"
+    * @param[in] pCategory - Category, e.g. "read"
+    * @param[in] pArgumentName - Name of an optional argument, e.g. "layer", or null
+    * @param[in] nArgument - Argument value
+    */
+    CToolpathTraceSpan(CToolpathTracer * pTracer, const char * pName, const char * pCategory, const char * pArgumentName = nullptr, uint64_t nArgument = 0)
+        : m_pTracer(pTracer)
+    {
+        if (m_pTracer != nullptr) {
+            m_Event.m_pName = pName;
+            m_Event.m_pCategory = pCategory;
+            m_Event.m_pArgumentName = pArgumentName;
+            m_Event.m_nArgument = nArgument;
+            m_Event.m_nStartNanoseconds = m_pTracer->GetTimestamp();
+            m_Event.m_nDurationNanoseconds = 0;
+        }
+    }
+
+    ~CToolpathTraceSpan()
+    {
+        if (m_pTracer != nullptr) {
+            m_Event.m_nDurationNanoseconds = m_pTracer->GetTimestamp() - m_Event.m_nStartNanoseconds;
+            m_pTracer->AddEvent(m_Event);
+        }
+    }
+
+    CToolpathTraceSpan(const CToolpathTraceSpan &) = delete;
+    CToolpathTraceSpan & operator=(const CToolpathTraceSpan &) = delete;
+
+};
+
+} // namespace ToolpathExample
+
+#endif // __TOOLPATHEXAMPLE_TRACE